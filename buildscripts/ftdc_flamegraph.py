@@ -0,0 +1,422 @@
+#!/usr/bin/env python3
+"""Script for turning the sampling profiler stacks in FTDC files into flame graph input.
+
+When the diagnosticDataCollectionSamplingProfilerRate server parameter is set, mongod and mongos
+sample the stacks of the threads using CPU, and FTDC collects the folded stacks under
+"samplingProfiler.stacks", and the cumulative number of samples of each under
+"samplingProfiler.counts". This script reads those counts from the files of a diagnostic.data
+directory, and prints how many samples of each stack were taken in the time they cover, as the
+"<folded stack> <count>" lines that flamegraph.pl and speedscope read.
+
+The frames of the stacks are offsets into the executable or a shared library. To replace them
+with function names, pass the directory holding those binaries, with their debug symbols, as
+--binary-dir. Shared libraries of the operating system are looked up by their file name only, so
+copy them into that directory too if their frames matter.
+
+Sample usage:
+
+ftdc_flamegraph.py --binary-dir=/path/to/bin /path/to/diagnostic.data | flamegraph.pl >cpu.svg
+
+You can also pass --start and --end, as UTC times such as 2019-07-01T14:02:00, to only count the
+samples taken in between.
+"""
+
+import datetime
+import math
+import optparse
+import os
+import struct
+import subprocess
+import sys
+import zlib
+
+FTDC_TYPE_METRIC_CHUNK = 1
+FTDC_TYPE_COLUMNAR_METRIC_CHUNK = 2
+
+UINT64_MASK = (1 << 64) - 1
+
+BSON_DOUBLE = 0x01
+BSON_STRING = 0x02
+BSON_OBJECT = 0x03
+BSON_ARRAY = 0x04
+BSON_BINARY = 0x05
+BSON_OBJECT_ID = 0x07
+BSON_BOOL = 0x08
+BSON_DATE = 0x09
+BSON_REGEX = 0x0B
+BSON_DB_POINTER = 0x0C
+BSON_CODE = 0x0D
+BSON_SYMBOL = 0x0E
+BSON_CODE_WITH_SCOPE = 0x0F
+BSON_INT = 0x10
+BSON_TIMESTAMP = 0x11
+BSON_LONG = 0x12
+BSON_DECIMAL = 0x13
+
+PROFILER_PATH = ("samplingProfiler", )
+START_PATH = ("start", )
+
+
+def _read_cstring(buf, offset):
+    end = buf.index(b"\x00", offset)
+    return buf[offset:end].decode("utf-8", "replace"), end + 1
+
+
+def _parse_value(buf, offset, bson_type):  # pylint: disable=too-many-return-statements
+    """Return the value of the given BSON type at offset, and the offset following it."""
+    if bson_type == BSON_DOUBLE:
+        return struct.unpack_from("<d", buf, offset)[0], offset + 8
+    if bson_type in (BSON_STRING, BSON_CODE, BSON_SYMBOL):
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        return buf[offset + 4:offset + 3 + length].decode("utf-8", "replace"), offset + 4 + length
+    if bson_type in (BSON_OBJECT, BSON_ARRAY):
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        return parse_document(buf, offset), offset + length
+    if bson_type == BSON_BINARY:
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        return bytes(buf[offset + 5:offset + 5 + length]), offset + 5 + length
+    if bson_type == BSON_OBJECT_ID:
+        return None, offset + 12
+    if bson_type == BSON_BOOL:
+        return buf[offset] != 0, offset + 1
+    if bson_type in (BSON_DATE, BSON_LONG):
+        return struct.unpack_from("<q", buf, offset)[0], offset + 8
+    if bson_type == BSON_REGEX:
+        _, offset = _read_cstring(buf, offset)
+        _, offset = _read_cstring(buf, offset)
+        return None, offset
+    if bson_type == BSON_DB_POINTER:
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        return None, offset + 4 + length + 12
+    if bson_type == BSON_CODE_WITH_SCOPE:
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        return None, offset + length
+    if bson_type == BSON_INT:
+        return struct.unpack_from("<i", buf, offset)[0], offset + 4
+    if bson_type == BSON_TIMESTAMP:
+        (value, ) = struct.unpack_from("<Q", buf, offset)
+        return (value >> 32, value & 0xFFFFFFFF), offset + 8
+    if bson_type == BSON_DECIMAL:
+        return None, offset + 16
+    # Undefined, null, MinKey and MaxKey have no value.
+    return None, offset
+
+
+def parse_document(buf, offset=0):
+    """Return the elements of the BSON document at offset, as a list of (name, type, value)."""
+    (length, ) = struct.unpack_from("<i", buf, offset)
+    end = offset + length - 1
+    offset += 4
+    elements = []
+    while offset < end:
+        bson_type = buf[offset]
+        name, offset = _read_cstring(buf, offset + 1)
+        value, offset = _parse_value(buf, offset, bson_type)
+        elements.append((name, bson_type, value))
+    return elements
+
+
+def read_bson_documents(buf):
+    """Yield the BSON documents stored back to back in buf."""
+    offset = 0
+    while offset + 4 <= len(buf):
+        (length, ) = struct.unpack_from("<i", buf, offset)
+        if length < 5 or offset + length > len(buf):
+            # The server was writing the last document when the file was copied.
+            return
+        yield parse_document(buf, offset)
+        offset += length
+
+
+def _number_long(value):
+    """Convert a double the way BSONElement::numberLong does."""
+    if math.isnan(value):
+        return 0
+    return max(min(int(value), (1 << 63) - 1), -(1 << 63))
+
+
+def extract_metrics(elements, path, names, values):
+    """Append the metrics of a document, in the order FTDC stores them, to names and values."""
+    for name, bson_type, value in elements:
+        if bson_type == BSON_DOUBLE:
+            names.append(path + (name, ))
+            values.append(_number_long(value) & UINT64_MASK)
+        elif bson_type in (BSON_INT, BSON_LONG, BSON_DATE, BSON_BOOL):
+            names.append(path + (name, ))
+            values.append(int(value) & UINT64_MASK)
+        elif bson_type == BSON_DECIMAL:
+            # The value of a decimal metric does not matter here, only its place.
+            names.append(path + (name, ))
+            values.append(0)
+        elif bson_type == BSON_TIMESTAMP:
+            names.append(path + (name, "t"))
+            values.append(value[0])
+            names.append(path + (name, "i"))
+            values.append(value[1])
+        elif bson_type in (BSON_OBJECT, BSON_ARRAY):
+            extract_metrics(value, path + (name, ), names, values)
+
+
+def _read_varint(buf, offset):
+    result = 0
+    shift = 0
+    while True:
+        byte = buf[offset]
+        offset += 1
+        result |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return result, offset
+        shift += 7
+
+
+def read_metric_chunk(data, wanted):
+    """Decompress the metric chunk in data.
+
+    Return the names of its metrics for which wanted(name) is true, a list holding the values of
+    those metrics in each sample of the chunk, the reference document first, and the elements of
+    the reference document.
+    """
+    buf = zlib.decompress(data[4:])
+    (ref_length, ) = struct.unpack_from("<i", buf, 0)
+    names = []
+    ref_values = []
+    reference = parse_document(buf)
+    extract_metrics(reference, (), names, ref_values)
+    metrics_count, sample_count = struct.unpack_from("<II", buf, ref_length)
+    if metrics_count != len(names):
+        raise ValueError("The metrics in the reference document and metrics count do not match")
+
+    positions = [i for i, name in enumerate(names) if wanted(name)]
+    deltas = {i: [0] * sample_count for i in positions}
+
+    # The deltas are stored metric by metric. A zero delta is followed by the number of zero deltas
+    # after it.
+    offset = ref_length + 8
+    zeroes = 0
+    for i in range(metrics_count):
+        row = deltas.get(i)
+        for j in range(sample_count):
+            if zeroes:
+                zeroes -= 1
+                continue
+            delta, offset = _read_varint(buf, offset)
+            if delta == 0:
+                zeroes, offset = _read_varint(buf, offset)
+            elif row is not None:
+                row[j] = delta
+
+    samples = [[ref_values[i] for i in positions]]
+    for j in range(sample_count):
+        previous = samples[-1]
+        samples.append([(previous[k] + deltas[i][j]) & UINT64_MASK
+                        for k, i in enumerate(positions)])
+    return [names[i] for i in positions], samples, reference
+
+
+def _find_value(elements, path):
+    """Return the value at path in the parsed document elements, or None."""
+    for name, _, value in elements:
+        if name == path[0]:
+            return value if len(path) == 1 else _find_value(value, path[1:])
+    return None
+
+
+def read_profiler_samples(directory):
+    """Yield (start millis, table start millis, folded stacks, counts) for each FTDC sample.
+
+    FTDC only keeps the strings of the first sample of each chunk, so the folded stacks are those
+    of that sample. Stacks seen later in the chunk are empty strings.
+    """
+
+    def wanted(name):
+        return name == START_PATH or name[:1] == PROFILER_PATH
+
+    # The archive files sort in the order they were written, before metrics.interim, which holds
+    # the samples of the chunk that was being filled.
+    for file_name in sorted(os.listdir(directory)):
+        if not file_name.startswith("metrics."):
+            continue
+        with open(os.path.join(directory, file_name), "rb") as ftdc_file:
+            buf = ftdc_file.read()
+
+        for doc in read_bson_documents(buf):
+            fields = {name: value for name, _, value in doc}
+            if fields.get("type") == FTDC_TYPE_COLUMNAR_METRIC_CHUNK:
+                # The columnar chunks are compressed with zstd, which Python does not ship with.
+                raise ValueError("%s holds columnar metric chunks, which this script cannot read;"
+                                 " set diagnosticDataCollectionFormatVersion to 1 to profile" %
+                                 file_name)
+            if fields.get("type") != FTDC_TYPE_METRIC_CHUNK:
+                continue
+
+            names, samples, reference = read_metric_chunk(fields["data"], wanted)
+            if PROFILER_PATH + ("since", ) not in names:
+                continue
+
+            stacks = [value for _, _, value in _find_value(reference, PROFILER_PATH + ("stacks", ))]
+            start_position = names.index(START_PATH)
+            since_position = names.index(PROFILER_PATH + ("since", ))
+            count_positions = [
+                i for i, name in enumerate(names)
+                if len(name) == 3 and name[:2] == PROFILER_PATH + ("counts", )
+            ]
+            for values in samples:
+                yield (values[start_position], values[since_position], stacks,
+                       [values[i] for i in count_positions])
+
+
+def count_stacks(directory, start_millis=None, end_millis=None):
+    """Return the number of samples of each folded stack taken in the given time range.
+
+    FTDC holds the cumulative number of samples of each stack of a table, so the samples taken
+    between two FTDC samples are the difference of their counts. The counts restart from zero when
+    the server clears its table of stacks or restarts, which the start time of the table changing
+    reveals. A stack keeps its position in a table, so its name is taken from any chunk which
+    recorded it. The samples of a stack no chunk recorded are counted as "[unknown]".
+    """
+    samples = list(read_profiler_samples(directory))
+
+    names = {}
+    for _, since, stacks, _ in samples:
+        for position, stack in enumerate(stacks):
+            if stack:
+                names[(since, position)] = stack
+
+    totals = {}
+    previous_since = None
+    previous_counts = []
+    for when, since, _, counts in samples:
+        in_range = ((start_millis is None or when >= start_millis)
+                    and (end_millis is None or when <= end_millis))
+        if since != previous_since:
+            previous_counts = [0] * len(counts) if previous_since is not None else counts
+        if in_range:
+            for position, count in enumerate(counts):
+                delta = count - previous_counts[position]
+                if delta > 0:
+                    stack = names.get((since, position), "[unknown]")
+                    totals[stack] = totals.get(stack, 0) + delta
+        previous_since = since
+        previous_counts = counts
+    return totals
+
+
+def _elf_load_base(path):
+    """Return the address an executable which is not position independent is loaded at, else 0.
+
+    The server writes frames as offsets from the address their module is loaded at, while the
+    symbols of such executables are at absolute addresses.
+    """
+    with open(path, "rb") as elf_file:
+        header = elf_file.read(64)
+        if len(header) < 64 or header[:4] != b"\x7fELF" or header[4] != 2 or header[5] != 1:
+            return 0
+        (elf_type, ) = struct.unpack_from("<H", header, 16)
+        if elf_type != 2:
+            return 0
+        (phoff, ) = struct.unpack_from("<Q", header, 32)
+        phentsize, phnum = struct.unpack_from("<HH", header, 54)
+        elf_file.seek(phoff)
+        program_headers = elf_file.read(phentsize * phnum)
+
+    load_addresses = []
+    for i in range(phnum):
+        p_type, = struct.unpack_from("<I", program_headers, i * phentsize)
+        p_vaddr, = struct.unpack_from("<Q", program_headers, i * phentsize + 16)
+        if p_type == 1:
+            load_addresses.append(p_vaddr)
+    return min(load_addresses) & ~0xFFF if load_addresses else 0
+
+
+def symbolize_stacks(stacks, binary_dir, symbolizer_path):
+    """Return the given folded stacks with the frames llvm-symbolizer resolves replaced.
+
+    A frame for which llvm-symbolizer reports inlined functions becomes a frame for each of them.
+    """
+    load_bases = {}
+    requests = []
+
+    def request_for(frame, is_leaf):
+        module, sep, offset = frame.rpartition("+0x")
+        if not sep:
+            return None
+        path = os.path.join(binary_dir, module)
+        if path not in load_bases:
+            load_bases[path] = _elf_load_base(path) if os.path.isfile(path) else None
+        if load_bases[path] is None:
+            return None
+        # A return address is the instruction after the call, which may belong to the next line.
+        # The interrupted instruction of the leaf frame is exact.
+        address = load_bases[path] + int(offset, 16) - (0 if is_leaf else 1)
+        return "CODE {} 0x{:X}".format(path, address)
+
+    split_stacks = []
+    for stack, count in stacks.items():
+        frames = stack.split(";")
+        requests_of_stack = [None] + [
+            request_for(frame, i == len(frames) - 1) for i, frame in enumerate(frames) if i > 0
+        ]
+        split_stacks.append((frames, requests_of_stack, count))
+        requests.extend(request for request in requests_of_stack if request is not None)
+
+    unique_requests = sorted(set(requests))
+    if not unique_requests:
+        return stacks
+
+    symbolizer = subprocess.Popen(args=[symbolizer_path], stdin=subprocess.PIPE,
+                                  stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    output, _ = symbolizer.communicate("\n".join(unique_requests).encode() + b"\n")
+
+    # For each request, llvm-symbolizer prints pairs of function and source location lines, the
+    # innermost inlined function first, then a blank line.
+    functions = {}
+    blocks = output.decode("utf-8", "replace").split("\n\n")
+    for request, block in zip(unique_requests, blocks):
+        names = block.strip("\n").split("\n")[::2]
+        if names and "??" not in names:
+            functions[request] = list(reversed(names))
+
+    symbolized = {}
+    for frames, requests_of_stack, count in split_stacks:
+        folded = [frames[0]]
+        for frame, request in zip(frames[1:], requests_of_stack[1:]):
+            folded.extend(functions.get(request, [frame]))
+        key = ";".join(folded)
+        symbolized[key] = symbolized.get(key, 0) + count
+    return symbolized
+
+
+def _parse_time(value):
+    when = datetime.datetime.strptime(value, "%Y-%m-%dT%H:%M:%S")
+    return int((when - datetime.datetime(1970, 1, 1)).total_seconds() * 1000)
+
+
+def main():
+    """Execute Main program."""
+
+    parser = optparse.OptionParser(usage="usage: %prog [options] diagnostic.data")
+    parser.add_option("--binary-dir", dest="binary_dir", default=None,
+                      help="Directory holding the binaries to look up the frames in")
+    parser.add_option(
+        "--symbolizer-path", dest="symbolizer_path",
+        default=os.environ.get("MONGOSYMB_SYMBOLIZER_PATH", "llvm-symbolizer"),
+        help="Path to llvm-symbolizer")
+    parser.add_option("--start", dest="start", default=None,
+                      help="Only count the samples taken from this UTC time on")
+    parser.add_option("--end", dest="end", default=None,
+                      help="Only count the samples taken until this UTC time")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.error("Expected the path of a diagnostic.data directory")
+
+    stacks = count_stacks(args[0], _parse_time(options.start) if options.start else None,
+                          _parse_time(options.end) if options.end else None)
+    if options.binary_dir:
+        stacks = symbolize_stacks(stacks, options.binary_dir, options.symbolizer_path)
+
+    for stack, count in sorted(stacks.items()):
+        sys.stdout.write("{} {}\n".format(stack, count))
+
+
+if __name__ == "__main__":
+    main()
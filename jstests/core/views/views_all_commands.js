@@ -112,6 +112,7 @@
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
+        analyze: {command: {analyze: "view"}, expectFailure: true},
         appendOplogNote: {skip: isUnrelated},
         applyOps: {
             command: {applyOps: [{op: "i", o: {_id: 1}, ns: "test.view"}]},
@@ -483,6 +484,7 @@
         shardConnPoolStats: {skip: isUnrelated},
         shardingState: {skip: isUnrelated},
         shutdown: {skip: isUnrelated},
+        skipIndex: {command: {skipIndex: "view", keys: ["a"]}, expectFailure: true},
         sleep: {skip: isUnrelated},
         split: {
             command: {split: "test.view", find: {_id: 1}},
@@ -63,6 +63,8 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
     assert.eq(getparam("diagnosticDataCollectionFileSizeMB"), 10);
     assert.eq(getparam("diagnosticDataCollectionSamplesPerChunk"), 300);
     assert.eq(getparam("diagnosticDataCollectionSamplesPerInterimUpdate"), 10);
+    assert.eq(getparam("diagnosticDataCollectionSamplingProfilerRate"), 0);
+    assert.eq(getparam("diagnosticDataCollectionFormatVersion"), 1);
 
     function setparam(obj) {
         var ret = adminDb.runCommand(Object.extend({setParameter: 1}, obj));
@@ -85,6 +87,11 @@ function verifyCommonFTDCParameters(adminDb, isEnabled) {
     assert.commandFailed(setparam({"diagnosticDataCollectionDirectorySizeMB": 1}));
     assert.commandFailed(setparam({"diagnosticDataCollectionSamplesPerChunk": 1}));
     assert.commandFailed(setparam({"diagnosticDataCollectionSamplesPerInterimUpdate": 1}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionSamplingProfilerRate": -1}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionSamplingProfilerRate": 10001}));
+
+    // The format version can only be set at startup
+    assert.commandFailed(setparam({"diagnosticDataCollectionFormatVersion": 2}));
 
     // Negative test - set file size bigger then directory size
     assert.commandWorked(setparam({"diagnosticDataCollectionDirectorySizeMB": 10}));
@@ -0,0 +1,48 @@
+// Tests that mongod writes diagnostic data in the columnar format when
+// diagnosticDataCollectionFormatVersion is 2, and reads it back when it restarts.
+(function() {
+    'use strict';
+
+    const dbpath = MongoRunner.dataPath + "ftdc_columnar_format";
+    resetDbpath(dbpath);
+
+    const options = {
+        dbpath: dbpath,
+        noCleanData: true,
+        setParameter: {
+            diagnosticDataCollectionFormatVersion: 2,
+            diagnosticDataCollectionPeriodMillis: 100,
+            diagnosticDataCollectionSamplesPerChunk: 5,
+            diagnosticDataCollectionSamplesPerInterimUpdate: 2,
+        },
+    };
+
+    let conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, "mongod failed to start with the columnar FTDC format");
+
+    const admin = conn.getDB("admin");
+    assert.eq(2,
+              assert.commandWorked(admin.runCommand(
+                  {getParameter: 1, diagnosticDataCollectionFormatVersion: 1}))
+                  .diagnosticDataCollectionFormatVersion);
+    assert.commandFailed(
+        admin.runCommand({setParameter: 1, diagnosticDataCollectionFormatVersion: 1}));
+
+    // Wait for a few chunks to be written to the archive file.
+    const diagnosticData = dbpath + "/diagnostic.data";
+    assert.soon(() => listFiles(diagnosticData).some(file => file.baseName !== "metrics.interim" &&
+                                                         file.size > 1024));
+    assert.commandWorked(admin.runCommand({getDiagnosticData: 1}));
+
+    // The restarted mongod recovers the interim file, which holds columnar chunks, and appends to
+    // a new archive file.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, "mongod failed to restart with the columnar FTDC format");
+    assert.commandWorked(conn.getDB("admin").runCommand({getDiagnosticData: 1}));
+    MongoRunner.stopMongod(conn);
+
+    // Only versions 1 and 2 exist.
+    conn = MongoRunner.runMongod({setParameter: {diagnosticDataCollectionFormatVersion: 3}});
+    assert.eq(null, conn, "mongod started with an unknown FTDC format version");
+})();
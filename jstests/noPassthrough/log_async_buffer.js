@@ -0,0 +1,43 @@
+/**
+ * Tests that a mongod started with logAsyncBufferSizeKB writes every slow query log line, that the
+ * lines queued when it shuts down are not lost, and that the shutdown itself is still logged.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod(
+        {useLogFiles: true, setParameter: {logAsyncBufferSizeKB: 256}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const db = conn.getDB("test");
+    assert.eq(256,
+              assert.commandWorked(db.adminCommand({getParameter: 1, logAsyncBufferSizeKB: 1}))
+                  .logAsyncBufferSizeKB);
+    assert.commandFailed(db.adminCommand({setParameter: 1, logAsyncBufferSizeKB: 0}));
+
+    // Log every operation as slow.
+    assert.commandWorked(db.setProfilingLevel(0, -1));
+    const coll = db.log_async_buffer;
+    assert.writeOK(coll.insert({_id: 1}));
+
+    const kQueries = 200;
+    for (let i = 0; i < kQueries; i++) {
+        assert.eq(1, coll.find().comment("async_log_query_" + i).itcount());
+    }
+
+    // The writer thread catches up shortly.
+    const logFile = conn.fullOptions.logFile;
+    assert.soon(() => cat(logFile).includes("async_log_query_" + (kQueries - 1)));
+    const log = cat(logFile);
+    for (let i = 0; i < kQueries; i++) {
+        assert(log.includes('comment: "async_log_query_' + i + '"'), "missing query " + i);
+    }
+
+    // Lines still queued at shutdown are written before the process exits.
+    assert.eq(1, coll.find().comment("async_log_last_query").itcount());
+    MongoRunner.stopMongod(conn);
+
+    const finalLog = cat(logFile);
+    assert(finalLog.includes("async_log_last_query"), finalLog);
+    assert(/shutting down with code:0/.test(finalLog), finalLog);
+})();
@@ -0,0 +1,52 @@
+// Tests that the analyze command gathers field statistics, and that the planner uses them to choose
+// a plan without a trial period once internalQueryPlannerUseCollectionStatistics is enabled.
+(function() {
+    "use strict";
+
+    const coll = db.analyze_command;
+    coll.drop();
+
+    // 'a' is unique while 'b' is the same in every document.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({a: i, b: 1});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    // Without 'keys', the leading fields of the btree indexes are analyzed.
+    let res = assert.commandWorked(db.runCommand({analyze: coll.getName()}));
+    assert.eq(1000, res.fields.a.numDocuments, tojson(res));
+    assert.eq(1000, res.fields.b.numDocuments, tojson(res));
+    assert.gt(res.fields.a.distinctValues, 900, tojson(res));
+    assert.lt(res.fields.b.distinctValues, 2, tojson(res));
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), keys: "a"}),
+                                 ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(db.runCommand({analyze: "analyze_command_missing"}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    const query = {a: 10, b: 1};
+
+    // The candidate plans are multi-planned while the statistics are not used.
+    let explain = coll.find(query).explain();
+    assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlannerUseCollectionStatistics: true}));
+    try {
+        explain = coll.find(query).explain();
+        assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+        assert.eq(
+            {a: 1}, explain.queryPlanner.winningPlan.inputStage.keyPattern, tojson(explain));
+
+        // Once the statistics are cleared, the planner goes back to the trial period.
+        assert.commandWorked(db.runCommand({analyze: coll.getName(), clear: true}));
+        explain = coll.find(query).explain();
+        assert.gt(explain.queryPlanner.rejectedPlans.length, 0, tojson(explain));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryPlannerUseCollectionStatistics: false}));
+    }
+}());
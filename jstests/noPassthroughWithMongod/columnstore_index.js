@@ -0,0 +1,107 @@
+// Tests that columnstore indexes are maintained by writes and that queries which need only a few
+// fields read those fields from the columns of the index instead of scanning the collection.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.columnstore_index;
+    coll.drop();
+
+    // Invalid index specifications are rejected.
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}, {sparse: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}, {unique: true}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore"}, {v: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(
+        coll.createIndex({a: "columnstore"}, {partialFilterExpression: {a: 1}}),
+        ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "columnstore", b: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({"$**": "columnstore", a: "columnstore"}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; i++) {
+        bulk.insert({_id: i, a: i, b: {c: i % 10, d: "x"}, e: "unused"});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.insert({_id: 200}));
+    assert.commandWorked(coll.insert({_id: 201, a: 201, b: [{c: 1}, {c: 2}]}));
+
+    assert.commandWorked(coll.createIndex({a: "columnstore", "b.c": "columnstore"}));
+
+    function assertColumnScan(explain, expectedColumns) {
+        const columnScan = getPlanStage(explain.queryPlanner.winningPlan, "COLUMN_SCAN");
+        assert.neq(null, columnScan, tojson(explain));
+        assert.eq(expectedColumns, columnScan.columns, tojson(explain));
+    }
+
+    // A find whose projection and filter are covered by the columns uses a column scan, and
+    // returns the same documents as a collection scan.
+    const filter = {a: {$gte: 195}, "b.c": {$ne: 3}};
+    const projection = {a: 1};
+    assertColumnScan(coll.find(filter, projection).explain(), ["a", "b.c"]);
+    assert.sameMembers(
+        [
+            {_id: 195, a: 195},
+            {_id: 196, a: 196},
+            {_id: 197, a: 197},
+            {_id: 198, a: 198},
+            {_id: 199, a: 199},
+            {_id: 201, a: 201},
+        ],
+        coll.find(filter, projection).toArray());
+
+    // The array along the path "b.c" of the last document requires it to be fetched.
+    const execStats = getPlanStage(
+        coll.find(filter, projection).explain("executionStats").executionStats.executionStages,
+        "COLUMN_SCAN");
+    assert.eq(1, execStats.docsFetched, tojson(execStats));
+
+    // The column for "b.c" cannot tell whether a document missing "b.c" has a subdocument "b",
+    // which the projection would keep, so projecting "b.c" scans the collection.
+    assert(isCollscan(db, coll.find(filter, {"b.c": 1}).explain().queryPlanner.winningPlan));
+    assert.commandWorked(coll.insert({_id: 202, a: 202, b: {d: "x"}}));
+    assert.eq([{_id: 202, b: {}}], coll.find({a: 202}, {"b.c": 1}).toArray());
+    assert.commandWorked(coll.remove({_id: 202}));
+
+    // Documents missing every indexed path are still returned.
+    assert.eq(202, coll.find({}, {_id: 1}).itcount());
+    assert.eq([{_id: 200}], coll.find({a: {$exists: false}}, {_id: 1}).toArray());
+
+    // A query needing a field which has no column scans the collection.
+    assert(isCollscan(db, coll.find({}, {e: 1}).explain().queryPlanner.winningPlan));
+    assert(isCollscan(db, coll.find({}).explain().queryPlanner.winningPlan));
+
+    // Aggregations read only the fields their pipeline depends on.
+    const pipeline = [{$match: {a: {$lt: 20}}}, {$group: {_id: null, total: {$sum: "$a"}}}];
+    assert.neq(null, getAggPlanStage(coll.explain().aggregate(pipeline), "COLUMN_SCAN"));
+    assert.eq([{_id: null, total: 190}], coll.aggregate(pipeline).toArray());
+
+    // Updates and deletes keep the columns up to date.
+    assert.commandWorked(coll.update({_id: 0}, {$set: {a: 1000}}));
+    assert.commandWorked(coll.update({_id: 1}, {$unset: {a: 1}}));
+    assert.commandWorked(coll.remove({_id: 2}));
+    assert.eq([{_id: 0, a: 1000}], coll.find({a: {$gte: 1000}}, {a: 1}).toArray());
+    assert.eq([{_id: 1}, {_id: 200}],
+              coll.find({a: {$exists: false}}, {_id: 1}).sort({_id: 1}).toArray());
+    assert.eq(0, coll.find({_id: 2}, {a: 1}).itcount());
+    assert.commandWorked(coll.validate(true));
+
+    // A "$**" columnstore index has a column for every top-level field.
+    assert.commandWorked(coll.dropIndexes());
+    assert.commandWorked(coll.createIndex({"$**": "columnstore"}));
+    assertColumnScan(coll.find({e: "unused"}, {_id: 0, "b.d": 1}).explain(), ["b", "e"]);
+    assert.eq(199, coll.find({e: "unused"}, {_id: 0, "b.d": 1}).itcount());
+
+    // The columns cannot restore the stored order of fields from several of them.
+    assert(isCollscan(db, coll.find({}, {e: 1, a: 1}).explain().queryPlanner.winningPlan));
+
+    // A column scan never competes with an index which can answer the query.
+    assert.commandWorked(coll.createIndex({e: 1}));
+    assert(isIxscan(db, coll.find({e: "unused"}, {a: 1}).explain().queryPlanner.winningPlan));
+    assert.commandWorked(coll.validate(true));
+})();
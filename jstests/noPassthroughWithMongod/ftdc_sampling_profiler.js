@@ -0,0 +1,63 @@
+// Tests that FTDC collects the stacks sampled by the sampling profiler, tagged with the command and
+// namespace of the operation they were sampled in.
+load('jstests/libs/ftdc.js');
+
+(function() {
+    'use strict';
+
+    // The profiler relies on SIGPROF and on unwinding stacks by frame pointers.
+    const buildEnvironment = getBuildInfo().buildEnvironment;
+    if (buildEnvironment.target_os !== "linux" ||
+        !["x86_64", "aarch64"].includes(buildEnvironment.target_arch)) {
+        return;
+    }
+
+    const admin = db.getSiblingDB("admin");
+    const coll = db.ftdc_sampling_profiler;
+    coll.drop();
+
+    const docs = [];
+    for (let i = 0; i < 1000; i++) {
+        docs.push({_id: i, s: "x".repeat(100)});
+    }
+    assert.commandWorked(coll.insert(docs));
+
+    function getProfilerData() {
+        return assert.commandWorked(admin.runCommand("getDiagnosticData")).data.samplingProfiler;
+    }
+
+    verifyGetDiagnosticData(admin);
+    assert.eq(false, getProfilerData().running);
+
+    // The stacks are reported in arrays of a fixed size, so that the schema of FTDC does not
+    // change as stacks are seen.
+    const numStacks = getProfilerData().stacks.length;
+    assert.gt(numStacks, 0);
+    assert.eq(numStacks, getProfilerData().counts.length);
+
+    assert.commandWorked(
+        admin.runCommand({setParameter: 1, diagnosticDataCollectionSamplingProfilerRate: 1000}));
+    try {
+        const tag = "aggregate " + coll.getFullName();
+        assert.soon(() => {
+            // Keep the server using CPU in an aggregation, so that it is sampled.
+            for (let i = 0; i < 20; i++) {
+                coll.aggregate([
+                        {$project: {n: {$strLenCP: {$concat: ["$s", "$s"]}}}},
+                        {$group: {_id: null, total: {$sum: "$n"}}}
+                    ])
+                    .toArray();
+            }
+
+            const profilerData = getProfilerData();
+            assert(profilerData.running, tojson(profilerData));
+            assert.eq(numStacks, profilerData.stacks.length, tojson(profilerData));
+            return profilerData.stacks.some(stack => stack.startsWith(tag + ";"));
+        }, "no stack was sampled in an aggregation on " + coll.getFullName());
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, diagnosticDataCollectionSamplingProfilerRate: 0}));
+    }
+
+    assert.soon(() => !getProfilerData().running);
+})();
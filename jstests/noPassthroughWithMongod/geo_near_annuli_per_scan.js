@@ -0,0 +1,73 @@
+// Tests that a 2dsphere geoNear returns the same documents and distances whether each index scan
+// covers one annulus or several, and whether the stored geometries are points or other shapes.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.geo_near_annuli_per_scan;
+    coll.drop();
+
+    // Each location holds a legacy point, a GeoJSON point and a single point MultiPoint. The
+    // distances of the first two are computed without parsing them into a GeometryContainer.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 150; i++) {
+        const coordinates = [(i % 15) * 0.05, Math.floor(i / 15) * 0.05];
+        bulk.insert({_id: i * 3, location: i, loc: coordinates});
+        bulk.insert({_id: i * 3 + 1, location: i, loc: {type: "Point", coordinates: coordinates}});
+        bulk.insert(
+            {_id: i * 3 + 2, location: i, loc: {type: "MultiPoint", coordinates: [coordinates]}});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.createIndex({loc: "2dsphere"}));
+
+    const near = {type: "Point", coordinates: [0.42, 0.37]};
+
+    function geoNear() {
+        return coll
+            .aggregate([
+                {$geoNear: {near: near, distanceField: "dist", spherical: true}},
+                {$limit: 300}
+            ])
+            .toArray();
+    }
+
+    function countIndexScans() {
+        const explain =
+            coll.find({loc: {$nearSphere: {$geometry: near}}}).explain("executionStats");
+        return getPlanStages(explain.executionStats.executionStages, "IXSCAN").length;
+    }
+
+    const getParam = {getParameter: 1, internalQueryS2GeoNearAnnuliPerScan: 1};
+    const originalValue =
+        assert.commandWorked(db.adminCommand(getParam)).internalQueryS2GeoNearAnnuliPerScan;
+
+    try {
+        const oneAnnulusPerScan = geoNear();
+        const oneAnnulusIndexScans = countIndexScans();
+        assert.eq(300, oneAnnulusPerScan.length);
+
+        // Documents at the same location have the same distance, however they are stored.
+        const distanceByLocation = {};
+        oneAnnulusPerScan.forEach(doc => {
+            if (distanceByLocation.hasOwnProperty(doc.location)) {
+                assert.eq(distanceByLocation[doc.location], doc.dist, tojson(doc));
+            }
+            distanceByLocation[doc.location] = doc.dist;
+        });
+
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryS2GeoNearAnnuliPerScan: 4}));
+        const fourAnnuliPerScan = geoNear();
+        assert.eq(oneAnnulusPerScan.map(doc => doc.dist), fourAnnuliPerScan.map(doc => doc.dist));
+        assert.sameMembers(oneAnnulusPerScan.map(doc => doc._id),
+                           fourAnnuliPerScan.map(doc => doc._id));
+        assert.lt(countIndexScans(), oneAnnulusIndexScans);
+
+        assert.commandFailed(
+            db.adminCommand({setParameter: 1, internalQueryS2GeoNearAnnuliPerScan: 0}));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryS2GeoNearAnnuliPerScan: originalValue}));
+    }
+})();
@@ -0,0 +1,93 @@
+// Tests that the profiler, the slow query log and $currentOp break down where the time of an
+// operation went: on a CPU, waiting for locks, and so on.
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const coll = db.operation_time_breakdown;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, a: i % 100, b: "x".repeat(20)});
+    }
+    assert.commandWorked(bulk.execute());
+
+    // The CPU time of a thread can only be measured on Linux.
+    const measuresCPUTime = getBuildInfo().buildEnvironment.target_os === "linux";
+
+    assert.commandWorked(db.setProfilingLevel(2));
+    try {
+        // A collection scan is spent almost entirely on a CPU, which cannot take longer than the
+        // operation itself.
+        assert.eq(100, coll.find({a: 7}).comment("cpu").itcount());
+        const findEntry = db.system.profile.findOne({"command.comment": "cpu"});
+        assert.neq(null, findEntry);
+        if (measuresCPUTime) {
+            assert.gt(findEntry.timeBreakdown.cpuMicros, 0, tojson(findEntry));
+            assert.lte(findEntry.timeBreakdown.cpuMicros,
+                       (findEntry.millis + 1) * 1000,
+                       tojson(findEntry));
+        }
+
+        // An insert queued behind an exclusive lock on its collection reports the wait.
+        const awaitSleep = startParallelShell(() => {
+            assert.commandWorked(db.adminCommand({
+                sleep: 1,
+                millis: 1000,
+                lock: "w",
+                lockTarget: db.operation_time_breakdown.getFullName()
+            }));
+        });
+        assert.soon(() => db.getSiblingDB("admin")
+                              .aggregate([
+                                  {$currentOp: {}},
+                                  {$match: {"command.sleep": 1, "locks.Collection": "W"}}
+                              ])
+                              .itcount() === 1);
+        assert.commandWorked(coll.insert({_id: "blocked"}));
+        awaitSleep();
+
+        const insertEntry =
+            db.system.profile.findOne({op: "insert", "command.documents._id": "blocked"});
+        assert.neq(null, insertEntry);
+        assert.gt(insertEntry.timeBreakdown.lockWaitMicros.Collection, 0, tojson(insertEntry));
+
+        // The breakdown is also written to the slow query log.
+        checkLog.contains(db.getMongo(), "timeBreakdown:");
+    } finally {
+        assert.commandWorked(db.setProfilingLevel(0));
+    }
+
+    // A running operation reports where its time has gone so far.
+    const awaitFind = startParallelShell(() => {
+        const res = db.runCommand({
+            find: "operation_time_breakdown",
+            filter: {
+                $where: function() {
+                    sleep(1000);
+                    return true;
+                }
+            }
+        });
+        assert.commandFailedWithCode(res, ErrorCodes.Interrupted);
+    });
+    assert.soon(() => {
+        const ops = db.getSiblingDB("admin")
+                        .aggregate([
+                            {$currentOp: {}},
+                            {$match: {ns: coll.getFullName(), "command.filter": {$exists: true}}}
+                        ])
+                        .toArray();
+        if (ops.length === 0 || !ops[0].hasOwnProperty("timeBreakdown")) {
+            return false;
+        }
+        if (measuresCPUTime) {
+            assert.gt(ops[0].timeBreakdown.cpuMicros, 0, tojson(ops[0]));
+        }
+        assert.commandWorked(db.killOp(ops[0].opid));
+        return true;
+    });
+    awaitFind();
+})();
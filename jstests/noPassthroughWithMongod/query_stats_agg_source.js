@@ -0,0 +1,98 @@
+// Tests that $queryStats reports the executions, getMores and resource use of each query shape, and
+// that the statistics stay within internalQueryStatsMaxMemoryBytes.
+(function() {
+    "use strict";
+
+    const coll = db.query_stats_agg_source;
+    coll.drop();
+    const otherColl = db.query_stats_agg_source_other;
+    otherColl.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    for (let i = 0; i < 20; i++) {
+        assert.commandWorked(coll.insert({_id: i, a: i, b: i % 2}));
+    }
+    assert.commandWorked(otherColl.insert({a: 1}));
+
+    function statsFor(queryHash) {
+        return coll.aggregate([{$queryStats: {}}, {$match: {queryHash: queryHash}}]).toArray();
+    }
+
+    // Two finds with the same shape but different values share an entry. Explain does not record
+    // anything.
+    const queryHash = coll.find({a: {$gte: 2}}).explain().queryPlanner.queryHash;
+    assert.eq(20, coll.find({a: {$gte: 0}}).batchSize(5).itcount());
+    assert.eq(10, coll.find({a: {$gte: 10}}).batchSize(5).itcount());
+
+    let stats = statsFor(queryHash);
+    assert.eq(1, stats.length, tojson(stats));
+    let entry = stats[0];
+    assert.eq(coll.getFullName(), entry.ns, tojson(entry));
+    assert.eq(2, entry.execCount, tojson(entry));
+    // The two finds need at least three and one getMores respectively, which are recorded against
+    // the shape of the find that created the cursor.
+    assert.gte(entry.getMoreCount, 4, tojson(entry));
+    assert.eq(30, entry.nreturned.sum, tojson(entry));
+    assert.eq(30, entry.docsExamined.sum, tojson(entry));
+    assert.gte(entry.keysExamined.sum, 30, tojson(entry));
+    assert.gt(entry.bytesReturned.sum, 0, tojson(entry));
+    assert.lte(entry.firstSeen, entry.lastSeen, tojson(entry));
+    assert.eq(entry.execCount + entry.getMoreCount,
+              entry.latencyMicros.reduce((total, bucket) => total + bucket.count, 0),
+              tojson(entry));
+
+    // A different shape has a different entry.
+    assert.eq(10, coll.find({b: 1}).itcount());
+    assert.eq(1, statsFor(coll.find({b: 1}).explain().queryPlanner.queryHash).length);
+
+    // Run against a collection, the stage returns only that collection's shapes. Run against the
+    // admin database, it returns every collection's.
+    assert.eq(1, otherColl.find({a: 1}).itcount());
+    coll.aggregate([{$queryStats: {}}]).forEach(doc => assert.eq(coll.getFullName(), doc.ns));
+    const namespaces = db.getSiblingDB("admin")
+                           .aggregate([{$queryStats: {}}])
+                           .toArray()
+                           .map(doc => doc.ns);
+    assert.contains(coll.getFullName(), namespaces);
+    assert.contains(otherColl.getFullName(), namespaces);
+
+    // Collectionless aggregations must run on the admin database, and the stage must come first.
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: 1, pipeline: [{$queryStats: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$match: {}}, {$queryStats: {}}], cursor: {}}),
+        40602);
+
+    const getParam = {getParameter: 1, internalQueryStatsMaxMemoryBytes: 1};
+    const originalValue =
+        assert.commandWorked(db.adminCommand(getParam)).internalQueryStatsMaxMemoryBytes;
+
+    try {
+        // With a limit of zero nothing more is recorded.
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryStatsMaxMemoryBytes: 0}));
+        const before = statsFor(queryHash)[0].execCount;
+        assert.eq(20, coll.find({a: {$gte: 0}}).itcount());
+        assert.eq(before, statsFor(queryHash)[0].execCount);
+
+        // A small limit evicts the least recently used shapes.
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryStatsMaxMemoryBytes: 128 * 1024}));
+        for (let i = 0; i < 200; i++) {
+            const filter = {};
+            filter["field" + i] = 1;
+            coll.find(filter).itcount();
+        }
+        const numShapes = coll.aggregate([{$queryStats: {}}]).itcount();
+        assert.lt(numShapes, 200);
+        assert.gt(numShapes, 0);
+
+        assert.commandFailed(
+            db.adminCommand({setParameter: 1, internalQueryStatsMaxMemoryBytes: -1}));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryStatsMaxMemoryBytes: originalValue}));
+    }
+})();
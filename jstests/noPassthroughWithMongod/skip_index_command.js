@@ -0,0 +1,84 @@
+// Tests that the skipIndex command builds per-block summaries which collection scans use to pass
+// over blocks of records that cannot match, and that writes keep the summaries up to date.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.skip_index_command;
+    coll.drop();
+
+    const originalRecordsPerBlock =
+        assert
+            .commandWorked(
+                db.adminCommand({getParameter: 1, internalQuerySkipIndexRecordsPerBlock: 1}))
+            .internalQuerySkipIndexRecordsPerBlock;
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQuerySkipIndexRecordsPerBlock: 100}));
+
+    try {
+        // Documents are inserted in increasing order of 'a', so each block of records holds a
+        // narrow range of values.
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 1000; i++) {
+            bulk.insert({_id: i, a: i, b: {c: i % 10}});
+        }
+        assert.commandWorked(bulk.execute());
+
+        assert.commandFailedWithCode(db.runCommand({skipIndex: coll.getName(), keys: "a"}),
+                                     ErrorCodes.TypeMismatch);
+        assert.commandFailedWithCode(
+            db.runCommand({skipIndex: "skip_index_command_missing", keys: ["a"]}),
+            ErrorCodes.NamespaceNotFound);
+
+        const res =
+            assert.commandWorked(db.runCommand({skipIndex: coll.getName(), keys: ["a", "b.c"]}));
+        assert.eq(["a", "b.c"], res.skipIndex.keys, tojson(res));
+        assert.eq(100, res.skipIndex.recordsPerBlock, tojson(res));
+        assert(res.skipIndex.ready, tojson(res));
+
+        function runQuery(query, expectedCount) {
+            assert.eq(expectedCount, coll.find(query).itcount(), tojson(query));
+            const explain = coll.find(query).explain("executionStats");
+            const collScan = getPlanStage(explain.executionStats.executionStages, "COLLSCAN");
+            assert.neq(null, collScan, tojson(explain));
+            assert(collScan.usedSkipIndex, tojson(explain));
+            return collScan;
+        }
+
+        // Only the block holding the value is tested against the filter. The scan seeks past the
+        // other blocks, reading only the first record of each run of blocks it skips.
+        let collScan = runQuery({a: 550}, 1);
+        assert.gte(collScan.blocksSkipped, 8, tojson(collScan));
+        assert.lte(collScan.docsSkipped, 2, tojson(collScan));
+        assert.lte(collScan.docsExamined, 200, tojson(collScan));
+
+        collScan = runQuery({a: {$gte: 990}}, 10);
+        assert.gte(collScan.blocksSkipped, 8, tojson(collScan));
+        assert.lte(collScan.docsSkipped, 1, tojson(collScan));
+
+        // A scan whose seek finds the first record of a block deleted reads on from the record
+        // before it.
+        assert.commandWorked(coll.remove({_id: 699}));
+        runQuery({a: 750}, 1);
+
+        // A predicate on a path without a skip index does not prevent the use of the others.
+        runQuery({a: {$in: [5, 995]}, "b.c": 5, _id: {$gte: 0}}, 2);
+
+        // Inserted and updated documents are found.
+        assert.commandWorked(coll.insert({_id: 1000, a: 5000}));
+        assert.commandWorked(coll.update({_id: 10}, {$set: {a: 7777}}));
+        runQuery({a: 5000}, 1);
+        runQuery({a: 7777}, 1);
+        runQuery({a: 10}, 0);
+
+        // Once dropped, the skip index is no longer used.
+        assert.commandWorked(db.runCommand({skipIndex: coll.getName(), drop: true}));
+        const explain = coll.find({a: 550}).explain("executionStats");
+        const collScan2 = getPlanStage(explain.executionStats.executionStages, "COLLSCAN");
+        assert(!collScan2.hasOwnProperty("usedSkipIndex"), tojson(explain));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQuerySkipIndexRecordsPerBlock: originalRecordsPerBlock}));
+    }
+}());
@@ -0,0 +1,76 @@
+// Tests that a find sorted by text score with a limit stops scoring documents once no unread index
+// key can reach the top k, and returns the same documents and scores as an unlimited sort.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.text_score_sort_limit;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 300; i++) {
+        // Most documents mention "apple" once among many other words, and so score low. A few
+        // short documents score high.
+        const filler = Array(10 + i % 20).fill("orchard").join(" ");
+        bulk.insert({_id: i, a: "apple " + (i % 3 === 0 ? "banana " : "") + filler, b: i % 2});
+    }
+    for (let i = 300; i < 320; i++) {
+        bulk.insert({_id: i, a: Array(1 + i % 4).fill("apple").join(" ") + " banana", b: i % 2});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: "text"}));
+
+    const projection = {score: {$meta: "textScore"}};
+    const sort = {score: {$meta: "textScore"}};
+
+    function assertSameTopK(filter, limit) {
+        const all = coll.find(filter, projection).sort(sort).toArray();
+        const topK = coll.find(filter, projection).sort(sort).limit(limit).toArray();
+        assert.eq(Math.min(limit, all.length), topK.length, tojson(topK));
+
+        const scoresById = {};
+        all.forEach(doc => scoresById[doc._id] = doc.score);
+        topK.forEach((doc, i) => {
+            assert.eq(scoresById[doc._id], doc.score, tojson(doc));
+            assert.eq(all[i].score, doc.score, tojson(topK));
+        });
+    }
+
+    // The text scorer is told about the limit, and stops before it has read every key.
+    const filter = {$text: {$search: "apple banana"}};
+    const explain =
+        coll.find(filter, projection).sort(sort).limit(5).explain("executionStats").executionStats;
+    const textOr = getPlanStage(explain.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert.eq(5, textOr.topKLimit, tojson(textOr));
+    assert(textOr.stoppedEarly, tojson(textOr));
+    assert.lt(textOr.docsExamined, 320, tojson(textOr));
+    assertSameTopK(filter, 5);
+    assertSameTopK(filter, 50);
+    assertSameTopK(filter, 1000);
+
+    // Documents failing a negated term or a phrase do not take a place in the top k.
+    assertSameTopK({$text: {$search: "apple -banana"}}, 5);
+    assertSameTopK({$text: {$search: "\"apple banana\""}}, 5);
+
+    // A predicate the text index does not cover is applied above the text stage, so the limit is
+    // not pushed down.
+    const filterWithPredicate = {$text: {$search: "apple banana"}, b: 1};
+    const predicateExplain = coll.find(filterWithPredicate, projection)
+                                 .sort(sort)
+                                 .limit(5)
+                                 .explain("executionStats")
+                                 .executionStats;
+    const predicateTextOr = getPlanStage(predicateExplain.executionStages, "TEXT_OR");
+    assert.eq(undefined, predicateTextOr.topKLimit, tojson(predicateTextOr));
+    assertSameTopK(filterWithPredicate, 5);
+
+    // Neither is it pushed down when the sort is not by text score alone.
+    const mixedSortExplain = coll.find(filter, projection)
+                                 .sort({score: {$meta: "textScore"}, _id: 1})
+                                 .limit(5)
+                                 .explain()
+                                 .queryPlanner.winningPlan;
+    assert.eq(undefined, getPlanStage(mixedSortExplain, "TEXT_OR").topKLimit);
+})();
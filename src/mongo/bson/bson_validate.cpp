@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/oid.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/decimal128.h"
 
@@ -42,6 +44,84 @@ namespace mongo {
 
 namespace {
 
+/**
+ * Returns true if 'c' is a UTF-8 continuation byte, 10xxxxxx.
+ */
+bool isContinuationByte(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+/**
+ * Returns the length of the well-formed multi-byte UTF-8 sequence at the start of 'data', or 0 if
+ * there is none. Overlong encodings, surrogates and code points above U+10FFFF are rejected.
+ */
+size_t validUTF8SequenceLength(const unsigned char* data, size_t length) {
+    const unsigned char c = data[0];
+    if (c < 0xC2) {
+        // Either a continuation byte, or the start of an overlong encoding of an ASCII character.
+        return 0;
+    }
+    if (c < 0xE0) {
+        return (length >= 2 && isContinuationByte(data[1])) ? 2 : 0;
+    }
+    if (c < 0xF0) {
+        if (length < 3 || !isContinuationByte(data[1]) || !isContinuationByte(data[2]))
+            return 0;
+        if ((c == 0xE0 && data[1] < 0xA0) || (c == 0xED && data[1] > 0x9F))
+            return 0;  // Overlong, or a UTF-16 surrogate.
+        return 3;
+    }
+    if (c < 0xF5) {
+        if (length < 4 || !isContinuationByte(data[1]) || !isContinuationByte(data[2]) ||
+            !isContinuationByte(data[3]))
+            return 0;
+        if ((c == 0xF0 && data[1] < 0x90) || (c == 0xF4 && data[1] > 0x8F))
+            return 0;  // Overlong, or above U+10FFFF.
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * Returns true if the 'length' bytes at 'str' are well-formed UTF-8. Runs of ASCII, which make up
+ * most strings, are checked a vector at a time, and only the multi-byte sequences are decoded.
+ */
+bool isValidUTF8(const char* str, size_t length) {
+    auto data = reinterpret_cast<const unsigned char*>(str);
+    const auto end = data + length;
+    while (data != end) {
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+        using unicode::ByteVector;
+        if (size_t(end - data) >= ByteVector::size) {
+            const auto highBits = ByteVector::load(data).maskHigh();
+            if (!highBits) {
+                data += ByteVector::size;
+                continue;
+            }
+            data += ByteVector::countInitialZeros(highBits);
+        }
+#else
+        if (size_t(end - data) >= sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            if (!(word & 0x8080808080808080ULL)) {
+                data += sizeof(word);
+                continue;
+            }
+        }
+#endif
+        if (*data < 0x80) {
+            ++data;
+            continue;
+        }
+        const size_t sequenceLength = validUTF8SequenceLength(data, end - data);
+        if (!sequenceLength)
+            return false;
+        data += sequenceLength;
+    }
+    return true;
+}
+
 /**
  * Creates a status with InvalidBSON code and adds information about _id if available.
  * WARNING: only pass in a non-EOO idElem if it has been fully validated already!
@@ -68,8 +148,12 @@ Status NOINLINE_DECL makeError(StringData baseMsg, BSONElement idElem, StringDat
 
 class Buffer {
 public:
-    Buffer(const char* buffer, uint64_t maxLength, BSONVersion version)
-        : _buffer(buffer), _position(0), _maxLength(maxLength), _version(version) {}
+    Buffer(const char* buffer, uint64_t maxLength, BSONVersion version, BSONUTF8Check utf8Check)
+        : _buffer(buffer),
+          _position(0),
+          _maxLength(maxLength),
+          _version(version),
+          _utf8Check(utf8Check) {}
 
     template <typename N>
     bool readNumber(N* out) {
@@ -117,8 +201,9 @@ public:
             return makeError("invalid bson", _idElem, elemName);
         }
 
+        const char* start = _buffer + _position;
         if (out) {
-            *out = StringData(_buffer + _position, sz);
+            *out = StringData(start, sz);
         }
 
         if (!skip(sz - 1))
@@ -131,6 +216,9 @@ public:
         if (c != 0)
             return makeError("not null terminated string", _idElem, elemName);
 
+        if (_utf8Check == BSONUTF8Check::kEnforce && !isValidUTF8(start, sz - 1))
+            return makeError("invalid UTF-8 string", _idElem, elemName);
+
         return Status::OK();
     }
 
@@ -164,6 +252,7 @@ private:
     uint64_t _maxLength;
     BSONElement _idElem;
     BSONVersion _version;
+    BSONUTF8Check _utf8Check;
 };
 
 struct ValidationState {
@@ -413,14 +502,197 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * Checks the same rules as validateBSONIterative(), but does not keep the _id element or field
+ * names needed to describe an error, and keeps its frames on the stack. This makes it much cheaper
+ * for the common case of a valid document. Returns false if the document is invalid, or nested too
+ * deeply to be checked here, in which case the caller repeats the validation with
+ * validateBSONIterative() to learn the outcome and the reason for it.
+ */
+bool validateBSONFast(const char* buffer, uint64_t maxLength, BSONUTF8Check utf8Check) {
+    struct Frame {
+        uint64_t startPosition;
+        int expectedSize;
+        bool isCodeWithScope;
+    };
+    static constexpr size_t kMaxFrames = 32;
+    Frame frames[kMaxFrames];
+    size_t depth = 0;
+
+    const size_t maxDepth = std::min<size_t>(BSONDepth::getMaxAllowableDepth(), kMaxFrames - 1);
+    uint64_t position = 0;
+
+    auto readInt = [&](int* out) {
+        if (position + sizeof(int) > maxLength)
+            return false;
+        *out = ConstDataView(buffer).read<LittleEndian<int>>(position);
+        position += sizeof(int);
+        return true;
+    };
+    auto skip = [&](uint64_t size) {
+        position += size;
+        return position < maxLength;
+    };
+    auto readCString = [&]() {
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+        // Field names are short, so look for the terminator in the next vector before calling
+        // memchr().
+        using unicode::ByteVector;
+        if (maxLength - position >= ByteVector::size) {
+            const auto nulls = ByteVector::load(buffer + position).compareEQ(0).maskAny();
+            if (nulls) {
+                position += ByteVector::countInitialZeros(nulls) + 1;
+                return true;
+            }
+        }
+#endif
+        auto end =
+            static_cast<const char*>(memchr(buffer + position, 0, maxLength - position));
+        if (!end)
+            return false;
+        position = end - buffer + 1;
+        return true;
+    };
+    auto readString = [&]() {
+        int size;
+        if (!readInt(&size) || size <= 0)
+            return false;
+        const uint64_t start = position;
+        if (!skip(size - 1) || buffer[position] != 0)
+            return false;
+        ++position;
+        return utf8Check == BSONUTF8Check::kSkip || isValidUTF8(buffer + start, size - 1);
+    };
+    auto beginObject = [&](bool isCodeWithScope) {
+        Frame& frame = frames[depth++];
+        frame.startPosition = position;
+        frame.isCodeWithScope = isCodeWithScope;
+        return readInt(&frame.expectedSize);
+    };
+    auto endObject = [&]() {
+        const Frame& frame = frames[--depth];
+        return static_cast<int>(position - frame.startPosition) == frame.expectedSize;
+    };
+
+    if (!beginObject(false))
+        return false;
+
+    while (depth) {
+        if (position >= maxLength)
+            return false;
+        const auto type = static_cast<signed char>(buffer[position++]);
+
+        if (type == EOO) {
+            if (!endObject())
+                return false;
+            if (depth && frames[depth - 1].isCodeWithScope) {
+                if (!endObject() || !depth)
+                    return false;
+            }
+            continue;
+        }
+
+        if (!readCString())
+            return false;
+
+        switch (type) {
+            case MinKey:
+            case MaxKey:
+            case jstNULL:
+            case Undefined:
+                break;
+
+            case jstOID:
+                if (!skip(OID::kOIDSize))
+                    return false;
+                break;
+
+            case NumberInt:
+                if (!skip(sizeof(int32_t)))
+                    return false;
+                break;
+
+            case Bool:
+                if (position >= maxLength || static_cast<uint8_t>(buffer[position]) > 1)
+                    return false;
+                ++position;
+                break;
+
+            case NumberDouble:
+            case NumberLong:
+            case bsonTimestamp:
+            case Date:
+                if (!skip(sizeof(int64_t)))
+                    return false;
+                break;
+
+            case NumberDecimal:
+                if (!skip(sizeof(Decimal128::Value)))
+                    return false;
+                break;
+
+            case DBRef:
+                if (!readString() || !skip(OID::kOIDSize))
+                    return false;
+                break;
+
+            case RegEx:
+                if (!readCString() || !readCString())
+                    return false;
+                break;
+
+            case Code:
+            case Symbol:
+            case String:
+                if (!readString())
+                    return false;
+                break;
+
+            case BinData: {
+                int size;
+                if (!readInt(&size) || size < 0 || size == std::numeric_limits<int>::max())
+                    return false;
+                if (!skip(1 + static_cast<uint64_t>(size)))
+                    return false;
+                break;
+            }
+
+            case CodeWScope:
+                if (depth > maxDepth || !beginObject(true) || !readString())
+                    return false;
+                if (depth > maxDepth || !beginObject(false))
+                    return false;
+                break;
+
+            case Object:
+            case Array:
+                if (depth > maxDepth || !beginObject(false))
+                    return false;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
 }  // namespace
 
-Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
+Status validateBSON(const char* originalBuffer,
+                    uint64_t maxLength,
+                    BSONVersion version,
+                    BSONUTF8Check utf8Check) {
     if (maxLength < 5) {
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
-    Buffer buf(originalBuffer, maxLength, version);
+    if (validateBSONFast(originalBuffer, maxLength, utf8Check)) {
+        return Status::OK();
+    }
+
+    Buffer buf(originalBuffer, maxLength, version, utf8Check);
     return validateBSONIterative(&buf);
 }
 
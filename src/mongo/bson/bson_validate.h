@@ -38,12 +38,22 @@ namespace mongo {
 class BSONObj;
 class Status;
 
+/**
+ * Whether validateBSON() also requires the contents of strings to be well-formed UTF-8.
+ */
+enum class BSONUTF8Check { kSkip, kEnforce };
+
 /**
  * @param buf - bson data
  * @param maxLength - maxLength of buffer
  *                    this is NOT the bson size, but how far we know the buffer is valid
  * @param version - newest version to accept
+ * @param utf8Check - whether the values of String, Code, Symbol, DBRef and CodeWScope elements
+ *                    must be well-formed UTF-8
  */
-Status validateBSON(const char* buf, uint64_t maxLength, BSONVersion version);
+Status validateBSON(const char* buf,
+                    uint64_t maxLength,
+                    BSONVersion version,
+                    BSONUTF8Check utf8Check = BSONUTF8Check::kSkip);
 
 }  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document shaped like a typical insert: an _id, a few scalars, a short array and a
+ * nested subdocument per field, with strings of the given length.
+ */
+BSONObj makeDocument(int numFields, int stringLength) {
+    const std::string str(stringLength, 'x');
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    for (int i = 0; i < numFields; ++i) {
+        const std::string name = "field" + std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                builder.append(name, i);
+                break;
+            case 1:
+                builder.append(name, str);
+                break;
+            case 2:
+                builder.append(name, BSON_ARRAY(i << i * 0.5 << str));
+                break;
+            case 3:
+                builder.append(name, BSON("a" << i << "b" << str << "c" << true));
+                break;
+        }
+    }
+    return builder.obj();
+}
+
+void runValidateBenchmark(benchmark::State& state, const BSONObj& obj, BSONUTF8Check utf8Check) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest, utf8Check));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_validate(benchmark::State& state) {
+    runValidateBenchmark(
+        state, makeDocument(state.range(0), state.range(1)), BSONUTF8Check::kSkip);
+}
+
+void BM_validateUTF8(benchmark::State& state) {
+    runValidateBenchmark(
+        state, makeDocument(state.range(0), state.range(1)), BSONUTF8Check::kEnforce);
+}
+
+void BM_validateNonASCII(benchmark::State& state) {
+    // Every string is made of two byte sequences, so none of it takes the ASCII fast path.
+    std::string str;
+    for (int i = 0; i < state.range(0); ++i) {
+        str += "\xc3\xa9";
+    }
+    const BSONObj obj = BSON("_id" << 1 << "a" << str << "b" << BSON("c" << str));
+    runValidateBenchmark(state, obj, BSONUTF8Check::kEnforce);
+}
+
+void BM_validateInvalid(benchmark::State& state) {
+    // An error falls back to the validation which describes it, so measure that path as well.
+    const BSONObj obj = makeDocument(state.range(0), 16);
+    std::string buffer(obj.objdata(), obj.objsize());
+    // Replace the terminating EOO with the type of an element which has no field name.
+    buffer.back() = NumberDouble;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            validateBSON(buffer.data(), buffer.size(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(BM_validate)
+    ->Args({10, 8})
+    ->Args({10, 256})
+    ->Args({100, 8})
+    ->Args({100, 256})
+    ->Args({1000, 32});
+BENCHMARK(BM_validateUTF8)
+    ->Args({10, 8})
+    ->Args({10, 256})
+    ->Args({100, 8})
+    ->Args({100, 256})
+    ->Args({1000, 32});
+BENCHMARK(BM_validateNonASCII)->Arg(16)->Arg(1024);
+BENCHMARK(BM_validateInvalid)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace mongo
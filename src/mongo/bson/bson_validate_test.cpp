@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -356,4 +357,71 @@ TEST(BSONValidateBool, BoolValuesAreValidated) {
     }
 }
 
+TEST(BSONValidateUTF8, WellFormedStringsAreValid) {
+    // ASCII longer than a vector, two, three and four byte sequences, and an embedded NUL.
+    const std::string strings[] = {"",
+                                   "an ASCII string which is longer than a vector register",
+                                   "caf\xc3\xa9",
+                                   "\xe2\x82\xac and \xf0\x9f\x98\x80 after ASCII of some length",
+                                   std::string("a\0b", 3)};
+    for (const auto& str : strings) {
+        const BSONObj obj = BSON("s" << str << "code" << BSONCode(str) << "nested"
+                                     << BSON_ARRAY(BSONSymbol(str)));
+        ASSERT_OK(validateBSON(
+            obj.objdata(), obj.objsize(), BSONVersion::kLatest, BSONUTF8Check::kEnforce));
+    }
+}
+
+TEST(BSONValidateUTF8, MalformedStringsAreRejectedOnlyWhenChecked) {
+    const std::string strings[] = {
+        "\x80",                                                   // Unexpected continuation byte.
+        "\xc3",                                                   // Truncated sequence.
+        "\xc0\xaf",                                               // Overlong '/'.
+        "\xe0\x80\xaf",                                           // Overlong '/'.
+        "\xed\xa0\x80",                                           // UTF-16 surrogate.
+        "\xf4\x90\x80\x80",                                       // Above U+10FFFF.
+        "\xff",                                                   // Never valid.
+        "an ASCII prefix which is longer than a vector \xe2\x82"  // Truncated after a vector.
+    };
+    for (const auto& str : strings) {
+        const BSONObj obj = BSON("_id" << 1 << "s" << str);
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+        const Status status = validateBSON(
+            obj.objdata(), obj.objsize(), BSONVersion::kLatest, BSONUTF8Check::kEnforce);
+        ASSERT_EQ(ErrorCodes::InvalidBSON, status.code());
+        ASSERT_EQ(status.reason(),
+                  "invalid UTF-8 string in element with field name 's' in object with _id: 1");
+    }
+}
+
+TEST(BSONValidate, DeeplyNestedObjectsAreValid) {
+    // Deeper than validateBSON() checks without allocating, but within the maximum depth.
+    BSONObj obj = BSON("x" << 1);
+    for (int i = 0; i < 100; ++i) {
+        obj = BSON("a" << obj << "b" << BSON_ARRAY(i));
+    }
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    for (uint32_t i = 0; i < BSONDepth::getMaxAllowableDepth(); ++i) {
+        obj = BSON("a" << obj);
+    }
+    ASSERT_EQ(ErrorCodes::Overflow,
+              validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+}
+
+TEST(BSONValidate, CodeWithScopeIsValidated) {
+    const BSONObj obj = BSON("c" << BSONCodeWScope("return x;", BSON("x" << 1 << "y"
+                                                                          << "z"))
+                                 << "after"
+                                 << 1);
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    // Corrupt the length of the scope.
+    std::string copy(obj.objdata(), obj.objsize());
+    const auto scopeLengthOffset = obj["c"].codeWScopeScopeDataUnsafe() - obj.objdata();
+    copy[scopeLengthOffset] += 1;
+    ASSERT_EQ(ErrorCodes::InvalidBSON,
+              validateBSON(copy.data(), copy.size(), BSONVersion::kLatest));
+}
+
 }  // namespace
@@ -127,6 +127,41 @@ public:
         _b.reserveBytes(1);
     }
 
+    /**
+     * Builds in memory drawn from 'arena', which must outlive this builder. Growing the object does
+     * not copy it while it is the most recent allocation in the arena. obj() copies the finished
+     * object into memory of its own, while done() returns a view into the arena which is only
+     * valid as long as this builder. Use the BSONSizeTracker overload to size the initial buffer
+     * from previously built objects.
+     */
+    BSONObjBuilder(BufferArena* arena, int initsize = 512)
+        : _b(_buf),
+          _buf(arena, initsize),
+          _offset(0),
+          _s(this),
+          _tracker(nullptr),
+          _doneCalled(false) {
+        // See the comments in the first constructor for details.
+        _b.skip(sizeof(int));
+
+        // Reserve space for the EOO byte. This means _done() can't fail.
+        _b.reserveBytes(1);
+    }
+
+    BSONObjBuilder(BufferArena* arena, const BSONSizeTracker& tracker)
+        : _b(_buf),
+          _buf(arena, tracker.getSize()),
+          _offset(0),
+          _s(this),
+          _tracker(const_cast<BSONSizeTracker*>(&tracker)),
+          _doneCalled(false) {
+        // See the comments in the first constructor for details.
+        _b.skip(sizeof(int));
+
+        // Reserve space for the EOO byte. This means _done() can't fail.
+        _b.reserveBytes(1);
+    }
+
     /**
      * Creates a new BSONObjBuilder prefixed with the fields in 'prefix'.
      *
@@ -667,7 +702,12 @@ public:
     BSONObj obj() {
         massert(10335, "builder does not own memory", owned());
         auto out = done<BSONTraits>();
-        out.shareOwnershipWith(_b.release());
+        auto buf = _b.release();
+        if (buf.get() + _offset != out.objdata()) {
+            // The object was built in an arena, and release() copied it out.
+            out = BSONObj(buf.get() + _offset, BSONTraits{});
+        }
+        out.shareOwnershipWith(std::move(buf));
         return out;
     }
 
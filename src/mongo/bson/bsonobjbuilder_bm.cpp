@@ -32,6 +32,7 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/buffer_arena.h"
 
 namespace mongo {
 
@@ -50,4 +51,60 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+/**
+ * Builds objects with the given number of string fields, one after another, as a reply or a
+ * pipeline stage would. Owned objects are released from the builder with obj(), while temporary
+ * ones are only viewed with done() before the builder goes away.
+ */
+template <typename MakeBuilder>
+void buildObjects(benchmark::State& state, MakeBuilder makeBuilder, bool owned = true) {
+    const std::string value(32, 'x');
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        auto builder = makeBuilder();
+        for (auto j = 0; j < state.range(0); j++)
+            builder.append("field", value);
+        BSONObj obj = owned ? builder.obj() : builder.done();
+        totalBytes += obj.objsize();
+        benchmark::DoNotOptimize(obj);
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+void BM_objBuilder(benchmark::State& state) {
+    buildObjects(state, [] { return BSONObjBuilder(); });
+}
+
+void BM_objBuilderSizeTracker(benchmark::State& state) {
+    BSONSizeTracker tracker;
+    buildObjects(state, [&] { return BSONObjBuilder(tracker); });
+}
+
+void BM_objBuilderArena(benchmark::State& state) {
+    BufferArena arena;
+    buildObjects(state, [&] { return BSONObjBuilder(&arena); });
+}
+
+void BM_objBuilderArenaSizeTracker(benchmark::State& state) {
+    BufferArena arena;
+    BSONSizeTracker tracker;
+    buildObjects(state, [&] { return BSONObjBuilder(&arena, tracker); });
+}
+
+void BM_objBuilderTemporary(benchmark::State& state) {
+    buildObjects(state, [] { return BSONObjBuilder(); }, false);
+}
+
+void BM_objBuilderArenaTemporary(benchmark::State& state) {
+    BufferArena arena;
+    buildObjects(state, [&] { return BSONObjBuilder(&arena); }, false);
+}
+
+BENCHMARK(BM_objBuilder)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_objBuilderSizeTracker)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_objBuilderArena)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_objBuilderArenaSizeTracker)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_objBuilderTemporary)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_objBuilderArenaTemporary)->Ranges({{{1}, {10'000}}});
+
 }  // namespace mongo
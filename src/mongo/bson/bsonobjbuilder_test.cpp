@@ -510,5 +510,59 @@ TEST(BSONObjBuilderTest, SizeChecks) {
 }
 
 
+TEST(BSONObjBuilderTest, ArenaBuilderObjOutlivesArena) {
+    BSONObj obj;
+    {
+        BufferArena arena;
+        BSONObjBuilder bob(&arena);
+        bob.append("a", 1);
+        bob.append("b", std::string(1000, 'x'));
+
+        // asTempObj() is a view into the arena.
+        ASSERT_BSONOBJ_EQ(bob.asTempObj(), BSON("a" << 1 << "b" << std::string(1000, 'x')));
+
+        obj = bob.obj();
+    }
+    ASSERT(obj.isOwned());
+    ASSERT_BSONOBJ_EQ(obj, BSON("a" << 1 << "b" << std::string(1000, 'x')));
+}
+
+TEST(BSONObjBuilderTest, ArenaBuildersReuseTheArena) {
+    BufferArena arena;
+    BSONSizeTracker tracker;
+    for (int i = 0; i < 100; ++i) {
+        BSONObjBuilder bob(&arena, tracker);
+        bob.append("i", i);
+        bob.append("s", std::string(i, 'x'));
+        {
+            BSONObjBuilder sub(bob.subobjStart("sub"));
+            sub.append("i", i);
+        }
+        const BSONObj obj = bob.obj();
+        ASSERT_EQ(obj["i"].numberInt(), i);
+        ASSERT_EQ(obj["s"].valueStringData().size(), static_cast<size_t>(i));
+        ASSERT_EQ(obj["sub"]["i"].numberInt(), i);
+    }
+
+    // Each builder gave its memory back to the arena when it finished.
+    ASSERT_EQ(arena.bytesReserved(), BufferArena::kDefaultChunkSize);
+}
+
+TEST(BSONObjBuilderTest, SizeTrackerPredictsTheSizeOfTheNextObject) {
+    BSONSizeTracker tracker;
+    const std::string str(2000, 'x');
+    {
+        BSONObjBuilder bob(tracker);
+        bob.append("s", str);
+        bob.obj();
+    }
+
+    BSONObjBuilder bob(tracker);
+    const char* start = bob.bb().buf();
+    bob.append("s", str);
+    ASSERT_EQ(start, bob.bb().buf());
+    ASSERT_GTE(bob.bb().getSize(), bob.len());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include <cstring>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include <boost/optional.hpp>
 
@@ -49,6 +50,7 @@
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/buffer_arena.h"
 #include "mongo/util/concepts.h"
 #include "mongo/util/itoa.h"
 #include "mongo/util/shared_buffer.h"
@@ -85,30 +87,91 @@ public:
         invariant(!_buf.isShared());
     }
 
+    /**
+     * Draws memory from 'arena' instead of the global allocator. Growing the buffer does not copy
+     * it while it is the most recent allocation in the arena, and release() copies its contents
+     * into a SharedBuffer of exactly the used size. A null 'arena' draws from the global allocator
+     * as usual.
+     */
+    explicit SharedBufferAllocator(BufferArena* arena) : _arena(arena) {}
+
+    ~SharedBufferAllocator() {
+        free();
+    }
+
     // Allow moving but not copying. It would be an error for two SharedBufferAllocators to use the
     // same underlying buffer.
-    SharedBufferAllocator(SharedBufferAllocator&&) = default;
-    SharedBufferAllocator& operator=(SharedBufferAllocator&&) = default;
+    SharedBufferAllocator(SharedBufferAllocator&& other) noexcept
+        : _buf(std::move(other._buf)),
+          _arena(other._arena),
+          _arenaBuf(std::exchange(other._arenaBuf, nullptr)),
+          _arenaBufSize(std::exchange(other._arenaBufSize, 0)) {}
+
+    SharedBufferAllocator& operator=(SharedBufferAllocator&& other) noexcept {
+        if (this != &other) {
+            free();
+            _buf = std::move(other._buf);
+            _arena = other._arena;
+            _arenaBuf = std::exchange(other._arenaBuf, nullptr);
+            _arenaBufSize = std::exchange(other._arenaBufSize, 0);
+        }
+        return *this;
+    }
 
     void malloc(size_t sz) {
+        if (_arena) {
+            _arenaBuf = static_cast<char*>(_arena->allocate(sz));
+            _arenaBufSize = sz;
+            return;
+        }
         _buf = SharedBuffer::allocate(sz);
     }
     void realloc(size_t sz) {
+        if (_arena) {
+            if (!_arenaBuf || !_arena->tryResize(_arenaBuf, _arenaBufSize, sz)) {
+                auto newBuf = static_cast<char*>(_arena->allocate(sz));
+                if (_arenaBuf)
+                    memcpy(newBuf, _arenaBuf, std::min(_arenaBufSize, sz));
+                _arenaBuf = newBuf;
+            }
+            _arenaBufSize = sz;
+            return;
+        }
         _buf.realloc(sz);
     }
     void free() {
+        if (_arenaBuf) {
+            _arena->deallocate(_arenaBuf, _arenaBufSize);
+            _arenaBuf = nullptr;
+            _arenaBufSize = 0;
+        }
         _buf = {};
     }
-    SharedBuffer release() {
+
+    /**
+     * Returns the buffer, of which the first 'usedBytes' bytes are in use. Memory drawn from an
+     * arena cannot outlive it, so in that case only the used bytes are copied to a new buffer.
+     */
+    SharedBuffer release(size_t usedBytes) {
+        if (_arenaBuf) {
+            auto buf = SharedBuffer::allocate(usedBytes);
+            memcpy(buf.get(), _arenaBuf, usedBytes);
+            free();
+            return buf;
+        }
         return std::move(_buf);
     }
 
     char* get() const {
-        return _buf.get();
+        return _arena ? _arenaBuf : _buf.get();
     }
 
 private:
     SharedBuffer _buf;
+
+    BufferArena* _arena = nullptr;
+    char* _arenaBuf = nullptr;
+    size_t _arenaBufSize = 0;
 };
 
 class StackAllocator {
@@ -165,6 +228,19 @@ public:
         reservedBytes = 0;
     }
 
+    /**
+     * Builds in memory drawn from 'arena', which must outlive this builder. See
+     * SharedBufferAllocator.
+     */
+    REQUIRES_FOR_NON_TEMPLATE(std::is_same_v<BufferAllocator, SharedBufferAllocator>)
+    _BufBuilder(BufferArena* arena, int initsize = 512) : _buf(arena), size(initsize) {
+        if (size > 0) {
+            _buf.malloc(size);
+        }
+        l = 0;
+        reservedBytes = 0;
+    }
+
     void kill() {
         _buf.free();
     }
@@ -202,7 +278,7 @@ public:
     /* assume ownership of the buffer */
     REQUIRES_FOR_NON_TEMPLATE(std::is_same_v<BufferAllocator, SharedBufferAllocator>)
     SharedBuffer release() {
-        return _buf.release();
+        return _buf.release(l);
     }
 
     void appendUChar(unsigned char j) {
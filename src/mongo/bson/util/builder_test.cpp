@@ -124,4 +124,34 @@ TEST(Builder, AppendUnsignedLongLong) {
 TEST(Builder, AppendShort) {
     testStringBuilderIntegral<short>();
 }
+TEST(Builder, ArenaBufBuilderGrowsInPlace) {
+    BufferArena arena;
+    BufBuilder bb(&arena, 64);
+    bb.appendStr("eliot was here", false);
+    const char* start = bb.buf();
+
+    // The buffer is the arena's most recent allocation, so it grows without moving.
+    for (int i = 0; i < 1000; ++i) {
+        bb.appendNum(i);
+    }
+    ASSERT_EQ(start, bb.buf());
+    ASSERT_EQ(0, memcmp(bb.buf(), "eliot was here", 14));
+
+    // Releasing copies the used bytes out of the arena.
+    SharedBuffer released = bb.release();
+    ASSERT_NE(start, released.get());
+    ASSERT_EQ(14 + 1000 * sizeof(int), released.capacity());
+    ASSERT_EQ(0, memcmp(released.get(), "eliot was here", 14));
+}
+
+TEST(Builder, ArenaBufBuilderCopiesWhenNotMostRecent) {
+    BufferArena arena;
+    BufBuilder bb(&arena, 64);
+    bb.appendStr("abc");
+    arena.allocate(8);
+
+    // Another allocation follows the buffer, so growing it has to move it.
+    bb.skip(128);
+    ASSERT_EQ(0, strcmp(bb.buf(), "abc"));
+}
 }
@@ -472,6 +472,11 @@ Status CollectionImpl::insertDocumentForBulkLoader(OperationContext* opCtx,
     if (!loc.isOK())
         return loc.getStatus();
 
+    if (auto skipIndex = _infoCache->getSkipIndex()) {
+        skipIndex->addDocument(loc.getValue(), doc);
+    }
+    _infoCache->getCollectionStatistics()->notifyOfWrites(1);
+
     status = onRecordInserted(loc.getValue());
 
     if (MONGO_FAIL_POINT(failAfterBulkLoadDocInsert)) {
@@ -548,6 +553,13 @@ Status CollectionImpl::_insertDocuments(OperationContext* opCtx,
         bsonRecords.push_back(bsonRecord);
     }
 
+    if (auto skipIndex = _infoCache->getSkipIndex()) {
+        for (auto&& bsonRecord : bsonRecords) {
+            skipIndex->addDocument(bsonRecord.id, *bsonRecord.docPtr);
+        }
+    }
+    _infoCache->getCollectionStatistics()->notifyOfWrites(bsonRecords.size());
+
     int64_t keysInserted;
     status = _indexCatalog->indexRecords(opCtx, bsonRecords, &keysInserted);
     if (opDebug) {
@@ -616,6 +628,7 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
     int64_t keysDeleted;
     _indexCatalog->unindexRecord(opCtx, doc.value(), loc, noWarn, &keysDeleted);
     _recordStore->deleteRecord(opCtx, loc);
+    _infoCache->getCollectionStatistics()->notifyOfWrites(1);
 
     getGlobalServiceContext()->getOpObserver()->onDelete(
         opCtx, ns(), uuid(), stmtId, fromMigrate, deletedDoc);
@@ -689,6 +702,11 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     uassertStatusOK(
         _recordStore->updateRecord(opCtx, oldLocation, newDoc.objdata(), newDoc.objsize()));
 
+    if (auto skipIndex = _infoCache->getSkipIndex()) {
+        skipIndex->addDocument(oldLocation, newDoc);
+    }
+    _infoCache->getCollectionStatistics()->notifyOfWrites(1);
+
     if (indexesAffected) {
         int64_t keysInserted, keysDeleted;
 
@@ -735,6 +753,11 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
 
+        if (auto skipIndex = _infoCache->getSkipIndex()) {
+            skipIndex->addDocument(loc, args->updatedDoc);
+        }
+        _infoCache->getCollectionStatistics()->notifyOfWrites(1);
+
         invariant(uuid());
         OplogUpdateEntryArgs entryArgs(*args, ns(), *uuid());
         getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, entryArgs);
@@ -821,6 +844,7 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     auto status = _recordStore->truncate(opCtx);
     if (!status.isOK())
         return status;
+    _infoCache->getCollectionStatistics()->clear();
 
     // 4) re-create indexes
     for (size_t i = 0; i < indexSpecs.size(); i++) {
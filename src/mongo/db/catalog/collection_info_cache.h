@@ -30,8 +30,10 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
+#include "mongo/db/query/skip_index.h"
 #include "mongo/db/update_index_data.h"
 
 namespace mongo {
@@ -62,6 +64,24 @@ public:
      */
     virtual QuerySettings* getQuerySettings() const = 0;
 
+    /**
+     * Get the field statistics gathered by the analyze command for this collection.
+     */
+    virtual CollectionStatistics* getCollectionStatistics() const = 0;
+
+    /**
+     * Get the skip index of this collection, or nullptr if it has none. Must be called under a
+     * collection lock.
+     */
+    virtual std::shared_ptr<SkipIndex> getSkipIndex() const = 0;
+
+    /**
+     * Replaces the skip index of this collection, or drops it if 'skipIndex' is nullptr.
+     *
+     * Must be called under exclusive collection lock.
+     */
+    virtual void setSkipIndex(std::shared_ptr<SkipIndex> skipIndex) = 0;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -58,6 +58,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(std::make_unique<PlanCache>(ns.ns())),
       _querySettings(std::make_unique<QuerySettings>()),
+      _collectionStatistics(std::make_unique<CollectionStatistics>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -124,6 +125,10 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
                 // language of a subdocument.  Add the override field as a path component.
                 _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
             }
+        } else if (descriptor->getAccessMethodName() == IndexNames::COLUMN &&
+                   descriptor->keyPattern().firstElementFieldNameStringData() == "$**") {
+            // A $** columnstore index has a column for every top-level field.
+            _indexedPaths.allPathsIndexed();
         } else {
             BSONObj key = descriptor->keyPattern();
             const BSONObj& infoObj = descriptor->infoObj();
@@ -188,6 +193,18 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+CollectionStatistics* CollectionInfoCacheImpl::getCollectionStatistics() const {
+    return _collectionStatistics.get();
+}
+
+std::shared_ptr<SkipIndex> CollectionInfoCacheImpl::getSkipIndex() const {
+    return _skipIndex;
+}
+
+void CollectionInfoCacheImpl::setSkipIndex(std::shared_ptr<SkipIndex> skipIndex) {
+    _skipIndex = std::move(skipIndex);
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<CoreIndexInfo> indexCores;
 
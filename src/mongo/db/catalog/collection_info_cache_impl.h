@@ -62,6 +62,24 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the field statistics gathered by the analyze command for this collection.
+     */
+    CollectionStatistics* getCollectionStatistics() const;
+
+    /**
+     * Get the skip index of this collection, or nullptr if it has none. Must be called under a
+     * collection lock.
+     */
+    std::shared_ptr<SkipIndex> getSkipIndex() const;
+
+    /**
+     * Replaces the skip index of this collection, or drops it if 'skipIndex' is nullptr.
+     *
+     * Must be called under exclusive collection lock.
+     */
+    void setSkipIndex(std::shared_ptr<SkipIndex> skipIndex);
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -135,6 +153,13 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Field statistics used to estimate the cost of candidate plans.
+    std::unique_ptr<CollectionStatistics> _collectionStatistics;
+
+    // Summaries of the values of a few fields per block of records, which collection scans use to
+    // skip blocks. Written under the exclusive collection lock and read under any collection lock.
+    std::shared_ptr<SkipIndex> _skipIndex;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
@@ -609,7 +609,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
 
     const bool isSparse = spec["sparse"].trueValue();
 
-    if (pluginName == IndexNames::WILDCARD) {
+    if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
         if (isSparse) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
@@ -627,6 +627,12 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
                           str::stream() << "Index type '" << pluginName
                                         << "' cannot be a TTL index");
         }
+
+        if (pluginName == IndexNames::COLUMN && spec.getField("partialFilterExpression")) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          str::stream() << "Index type '" << pluginName
+                                        << "' does not support a partialFilterExpression");
+        }
     }
 
     // Ensure if there is a filter, its valid.
@@ -1303,8 +1309,12 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
         BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
         MultikeyPaths multikeyPaths;
 
-        index->accessMethod()->getKeys(
-            *bsonRecord.docPtr, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+        index->accessMethod()->getKeys(*bsonRecord.docPtr,
+                                       options.getKeysMode,
+                                       &keys,
+                                       &multikeyMetadataKeys,
+                                       &multikeyPaths,
+                                       bsonRecord.id);
 
         Status status = _indexKeys(opCtx,
                                    index,
@@ -1458,8 +1468,12 @@ void IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
     // deleted.
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
 
-    entry->accessMethod()->getKeys(
-        obj, IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered, &keys, nullptr, nullptr);
+    entry->accessMethod()->getKeys(obj,
+                                   IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
+                                   &keys,
+                                   nullptr,
+                                   nullptr,
+                                   loc);
 
     _unindexKeys(opCtx, entry, {keys.begin(), keys.end()}, obj, loc, logIfError, keysDeletedOut);
 }
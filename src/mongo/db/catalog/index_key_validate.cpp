@@ -139,7 +139,7 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                                           << static_cast<int>(indexVersion)};
                 }
 
-                if (pluginName == IndexNames::WILDCARD) {
+                if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
                     return {code,
                             str::stream() << "'" << pluginName
                                           << "' index plugin is not allowed with index version v:"
@@ -186,6 +186,24 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
             return Status(code, "wildcard indexes do not allow compounding");
         }
 
+        // Every field of a columnstore index is stored as a column of its own, so every field must
+        // name the plugin. A "$**" columnstore index stores every top-level field and so cannot
+        // list other fields.
+        if (pluginName == IndexNames::COLUMN) {
+            if (keyElement.type() != String || keyElement.valueStringData() != IndexNames::COLUMN) {
+                return Status(code,
+                              "Every value in a columnstore index key pattern must be "
+                              "'columnstore'");
+            }
+            if (keyElement.fieldNameStringData() == "$**") {
+                if (key.nFields() != 1) {
+                    return Status(code,
+                                  "A $** columnstore index cannot include any other fields");
+                }
+                continue;
+            }
+        }
+
         // Ensure that the fields on which we are building the index are valid: a field must not
         // begin with a '$' unless it is part of a wildcard, DBRef or text index, and a field path
         // cannot contain an empty field. If a field cannot be created or updated, it should not be
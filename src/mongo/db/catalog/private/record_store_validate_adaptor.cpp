@@ -106,7 +106,8 @@ Status RecordStoreValidateAdaptor::validate(const RecordId& recordId,
                      IndexAccessMethod::GetKeysMode::kEnforceConstraints,
                      &documentKeySet,
                      &multikeyMetadataKeys,
-                     &multikeyPaths);
+                     &multikeyPaths,
+                     recordId);
 
         if (!descriptor->isMultikey(_opCtx) &&
             iam->shouldMarkIndexAsMultikey(
@@ -286,10 +287,11 @@ void RecordStoreValidateAdaptor::validateIndexKeyCount(const IndexDescriptor* id
 
     // Confirm that the number of index entries is not greater than the number of documents in the
     // collection. This check is only valid for indexes that are not multikey (indexed arrays
-    // produce an index key per array entry) and not $** indexes which can produce index keys for
-    // multiple paths within a single document.
+    // produce an index key per array entry) and not $** or columnstore indexes which can produce
+    // index keys for multiple paths within a single document.
     if (results.valid && !idx->isMultikey(_opCtx) &&
-        idx->getIndexType() != IndexType::INDEX_WILDCARD && totalKeys > numRecs) {
+        idx->getIndexType() != IndexType::INDEX_WILDCARD &&
+        idx->getIndexType() != IndexType::INDEX_COLUMN && totalKeys > numRecs) {
         std::string err = str::stream()
             << "index " << idx->indexName() << " is not multi-key, but has more entries ("
             << numIndexedKeys << ") than documents in the index (" << numRecs - numLongKeys << ")";
@@ -265,6 +265,22 @@ public:
         return StringData(_planSummary);
     }
 
+    /**
+     * The queryHash, planCacheKey and shape of the query which created this cursor, if it had one,
+     * so that the getMores on the cursor are reported against the same shape.
+     */
+    boost::optional<uint32_t> getQueryHash() const {
+        return _queryHash;
+    }
+
+    boost::optional<uint32_t> getPlanCacheKey() const {
+        return _planCacheKey;
+    }
+
+    StringData getQueryShape() const {
+        return _queryShape;
+    }
+
     ClientCursorParams::LockPolicy lockPolicy() const {
         return _lockPolicy;
     }
@@ -429,6 +445,11 @@ private:
 
     // A string with the plan summary of the cursor's query.
     std::string _planSummary;
+
+    // The shape of the cursor's query, copied from the CurOp of the operation which created it.
+    const boost::optional<uint32_t> _queryHash;
+    const boost::optional<uint32_t> _planCacheKey;
+    const std::string _queryShape;
 };
 
 /**
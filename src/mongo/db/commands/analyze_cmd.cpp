@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Gathers the field statistics the planner uses to estimate the cost of candidate plans.
+ *
+ * { analyze: <collection>, keys: [<path>, ...] }
+ *     Scans the collection once, and replaces the statistics of each of the given field paths.
+ *     Without 'keys', the leading fields of the collection's btree indexes are analyzed.
+ *
+ * { analyze: <collection>, clear: true }
+ *     Drops all statistics of the collection.
+ *
+ * Statistics are held in memory on the node the command runs on, like index filters.
+ */
+class AnalyzeCmd : public BasicCommand {
+public:
+    AnalyzeCmd() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    std::string help() const override {
+        return "Gathers histograms and distinct value counts of fields of a collection, for the "
+               "query planner.\n"
+               "{ analyze: <collection>, keys: [<path>, ...] } or { analyze: <collection>, "
+               "clear: true }";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound, "ns not found", collection);
+
+        CollectionStatistics* stats = collection->infoCache()->getCollectionStatistics();
+        if (cmdObj["clear"].trueValue()) {
+            stats->clear();
+            return true;
+        }
+
+        std::vector<FieldStatisticsBuilder> builders;
+        const auto sampleSize = static_cast<size_t>(internalQueryStatisticsSampleSize.load());
+        const auto addPath = [&](const std::string& path) {
+            for (auto&& builder : builders) {
+                if (builder.path() == path) {
+                    return;
+                }
+            }
+            builders.emplace_back(path, sampleSize, opCtx->getClient()->getPrng().nextInt64());
+        };
+
+        if (auto keysElem = cmdObj["keys"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'keys' must be an array of field paths",
+                    keysElem.type() == Array);
+            for (auto&& keyElem : keysElem.Obj()) {
+                uassert(ErrorCodes::TypeMismatch,
+                        "'keys' must be an array of field paths",
+                        keyElem.type() == String && !keyElem.valueStringData().empty());
+                addPath(keyElem.str());
+            }
+        } else {
+            auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+            while (it->more()) {
+                const IndexDescriptor* desc = it->next()->descriptor();
+                if (IndexNames::findPluginName(desc->keyPattern()) == IndexNames::BTREE) {
+                    addPath(desc->keyPattern().firstElementFieldName());
+                }
+            }
+        }
+
+        uassert(ErrorCodes::BadValue, "There are no fields to analyze", !builders.empty());
+
+        auto exec = InternalPlanner::collectionScan(
+            opCtx, nss.ns(), collection, PlanExecutor::YIELD_AUTO);
+
+        BSONObj doc;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&doc, nullptr))) {
+            for (auto&& builder : builders) {
+                builder.addDocument(doc);
+            }
+        }
+
+        if (PlanExecutor::IS_EOF != state) {
+            uasserted(51240,
+                      "Plan executor error while running analyze command: " +
+                          WorkingSetCommon::toStatusString(doc));
+        }
+
+        const auto maxBuckets = static_cast<size_t>(internalQueryStatisticsHistogramBuckets.load());
+        for (auto&& builder : builders) {
+            stats->setFieldStatistics(builder.path(), builder.done(maxBuckets));
+        }
+
+        LOG(1) << "Analyzed " << builders.size() << " fields of " << nss;
+
+        BSONObjBuilder fieldsBuilder(result.subobjStart("fields"));
+        stats->appendToBSON(&fieldsBuilder);
+        return true;
+    }
+
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
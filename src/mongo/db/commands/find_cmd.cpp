@@ -230,8 +230,11 @@ public:
 
             // Get the execution plan for the query.
             bool permitYield = true;
-            auto exec =
-                uassertStatusOK(getExecutorFind(opCtx, collection, std::move(cq), permitYield));
+            auto exec = uassertStatusOK(getExecutorFind(opCtx,
+                                                        collection,
+                                                        std::move(cq),
+                                                        permitYield,
+                                                        QueryPlannerParams::INCLUDE_COLUMN_SCAN));
 
             auto bodyBuilder = result->getBodyBuilder();
             // Got the execution tree. Explain it.
@@ -427,8 +430,11 @@ public:
 
             // Get the execution plan for the query.
             bool permitYield = true;
-            auto exec =
-                uassertStatusOK(getExecutorFind(opCtx, collection, std::move(cq), permitYield));
+            auto exec = uassertStatusOK(getExecutorFind(opCtx,
+                                                        collection,
+                                                        std::move(cq),
+                                                        permitYield,
+                                                        QueryPlannerParams::INCLUDE_COLUMN_SCAN));
 
             {
                 stdx::lock_guard<Client> lk(*opCtx->getClient());
@@ -521,6 +521,11 @@ public:
                     curOp->setOriginatingCommand_inlock(originatingCommand);
                 }
 
+                // Report the getMore against the shape of the query which created the cursor.
+                curOp->debug().queryHash = cursorPin->getQueryHash();
+                curOp->debug().planCacheKey = cursorPin->getPlanCacheKey();
+                curOp->debug().queryShape = cursorPin->getQueryShape().toString();
+
                 // Update the genericCursor stored in curOp with the new cursor stats.
                 curOp->setGenericCursor_inlock(cursorPin->toGenericCursor());
             }
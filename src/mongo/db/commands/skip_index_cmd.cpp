@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/skip_index.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Manages the skip index of a collection, which lets collection scans pass over blocks of records
+ * which cannot match their filter.
+ *
+ * { skipIndex: <collection>, keys: [<path>, ...] }
+ *     Scans the collection once, and replaces its skip index with one over the given field paths.
+ *     The new skip index is installed before the scan under a brief exclusive lock, so that every
+ *     later write maintains it, and the scan then yields like any other read. Scans do not use the
+ *     skip index until it has seen every record.
+ *
+ * { skipIndex: <collection>, drop: true }
+ *     Drops the skip index of the collection.
+ *
+ * Skip indexes are held in memory on the node the command runs on, like index filters.
+ */
+class SkipIndexCmd : public BasicCommand {
+public:
+    SkipIndexCmd() : BasicCommand("skipIndex") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    std::string help() const override {
+        return "Builds or drops the per-block value summaries collection scans use to skip "
+               "records.\n"
+               "{ skipIndex: <collection>, keys: [<path>, ...] } or { skipIndex: <collection>, "
+               "drop: true }";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(cmdObj["drop"].trueValue() ? ActionType::dropIndex
+                                                     : ActionType::createIndex);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        if (cmdObj["drop"].trueValue()) {
+            AutoGetCollection autoColl(opCtx, nss, MODE_X);
+            Collection* collection = autoColl.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound, "ns not found", collection);
+            collection->infoCache()->setSkipIndex(nullptr);
+            return true;
+        }
+
+        const auto keysElem = cmdObj["keys"];
+        uassert(ErrorCodes::TypeMismatch,
+                "'keys' must be a non-empty array of field paths",
+                keysElem.type() == Array && !keysElem.Obj().isEmpty());
+
+        std::vector<std::string> paths;
+        for (auto&& keyElem : keysElem.Obj()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'keys' must be a non-empty array of field paths",
+                    keyElem.type() == String && !keyElem.valueStringData().empty());
+            if (std::find(paths.begin(), paths.end(), keyElem.str()) == paths.end()) {
+                paths.push_back(keyElem.str());
+            }
+        }
+
+        auto skipIndex =
+            std::make_shared<SkipIndex>(std::move(paths),
+                                        internalQuerySkipIndexRecordsPerBlock.load(),
+                                        internalQuerySkipIndexBloomFilterBits.load());
+
+        // Install the skip index first. No write is in progress while the collection is
+        // exclusively locked, so every write either committed before the scan below starts, and is
+        // seen by it, or maintains the skip index itself.
+        UUID uuid = [&] {
+            AutoGetCollection autoColl(opCtx, nss, MODE_X);
+            Collection* collection = autoColl.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound, "ns not found", collection);
+            uassert(ErrorCodes::IllegalOperation,
+                    "Skip indexes are not supported on capped collections",
+                    !collection->isCapped());
+
+            collection->infoCache()->setSkipIndex(skipIndex);
+            return *collection->uuid();
+        }();
+
+        long long numRecords = 0;
+        try {
+            numRecords = _addAllRecords(opCtx, {dbname, uuid}, skipIndex.get());
+        } catch (const DBException&) {
+            // Drop the incomplete skip index, unless it has already been replaced or dropped.
+            UninterruptibleLockGuard noInterrupt(opCtx->lockState());
+            AutoGetCollection autoColl(opCtx, {dbname, uuid}, MODE_X);
+            Collection* collection = autoColl.getCollection();
+            if (collection && collection->infoCache()->getSkipIndex() == skipIndex) {
+                collection->infoCache()->setSkipIndex(nullptr);
+            }
+            throw;
+        }
+
+        skipIndex->markReady();
+
+        LOG(1) << "Built skip index over " << numRecords << " records of " << nss;
+
+        BSONObjBuilder skipIndexBuilder(result.subobjStart("skipIndex"));
+        skipIndex->appendToBSON(&skipIndexBuilder);
+        return true;
+    }
+
+private:
+    /**
+     * Adds every record of the collection 'nsOrUUID' to 'skipIndex' and returns how many there
+     * were. The scan yields, and fails if the collection is dropped meanwhile.
+     */
+    static long long _addAllRecords(OperationContext* opCtx,
+                                    const NamespaceStringOrUUID& nsOrUUID,
+                                    SkipIndex* skipIndex) {
+        AutoGetCollection autoColl(opCtx, nsOrUUID, MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound, "collection dropped while building", collection);
+
+        auto exec = InternalPlanner::collectionScan(
+            opCtx, collection->ns().ns(), collection, PlanExecutor::YIELD_AUTO);
+
+        long long numRecords = 0;
+        BSONObj obj;
+        RecordId id;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &id))) {
+            skipIndex->addDocument(id, obj);
+            ++numRecords;
+        }
+
+        if (PlanExecutor::FAILURE == state) {
+            uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(obj).withContext(
+                "Executor error while building skip index"));
+        }
+
+        return numRecords;
+    }
+
+} skipIndexCmd;
+
+}  // namespace
+}  // namespace mongo
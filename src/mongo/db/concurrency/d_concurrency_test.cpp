@@ -1486,6 +1486,36 @@ TEST_F(DConcurrencyTestFixture, NoThrottlingWhenNotAcquiringTickets) {
     ASSERT(R2.isLocked());
 }
 
+TEST_F(DConcurrencyTestFixture, TicketWaitTimeIsRecorded) {
+    auto clientOpctxPairs = makeKClientsWithLockers(2);
+    auto opctx1 = clientOpctxPairs[0].second.get();
+    auto opctx2 = clientOpctxPairs[1].second.get();
+    // Limit the locker to 1 ticket at a time.
+    UseGlobalThrottling throttle(opctx1, 1);
+
+    Microseconds waitTime;
+    {
+        // A ticket which is immediately available is not waited for.
+        Lock::GlobalRead R1(opctx1, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(R1.isLocked());
+        ASSERT_EQ(Microseconds(0), opctx1->lockState()->getTicketWaitTime());
+
+        // The wait of a second Locker counts even if it times out.
+        ASSERT_THROWS_CODE(Lock::GlobalRead(opctx2,
+                                            Date_t::now() + Milliseconds(50),
+                                            Lock::InterruptBehavior::kThrow),
+                           AssertionException,
+                           ErrorCodes::LockTimeout);
+        waitTime = opctx2->lockState()->getTicketWaitTime();
+        ASSERT_GTE(waitTime, Milliseconds(40));
+    }
+
+    // Once the ticket is released, it is acquired without adding to the wait time.
+    Lock::GlobalRead R2(opctx2, Date_t::now(), Lock::InterruptBehavior::kThrow);
+    ASSERT(R2.isLocked());
+    ASSERT_EQ(waitTime, opctx2->lockState()->getTicketWaitTime());
+}
+
 TEST_F(DConcurrencyTestFixture, ReleaseAndReacquireTicket) {
     auto clientOpctxPairs = makeKClientsWithLockers(2);
     auto opctx1 = clientOpctxPairs[0].second.get();
@@ -33,6 +33,12 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -41,6 +47,7 @@
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
@@ -317,8 +324,8 @@ struct LockHead {
  * The PartitionedLockHead allows optimizing the case where requests overwhelmingly use
  * the intent lock modes MODE_IS and MODE_IX, which are compatible with each other.
  * Having to use a single LockHead causes contention where none would be needed.
- * So, each Locker is associated with a specific partition containing a mapping
- * of resourceId to PartitionedLockHead.
+ * So, each intent request is associated with a specific partition, chosen by the CPU the
+ * request was made on, containing a mapping of resourceId to PartitionedLockHead.
  *
  * As long as all lock requests for a resource have an intent mode, as opposed to a conflicting
  * mode, its LockHead may reference PartitionedLockHeads. A partitioned LockHead will not have
@@ -393,13 +400,20 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+namespace {
+
+// Balance scalability of intent locks against potential added cost of conflicting locks, which
+// have to visit every partition. Have at least one partition per CPU, so that intent lockers
+// running on different cores never share a partition.
+unsigned numPartitions() {
+    return std::max(32u, stdx::thread::hardware_concurrency());
+}
+
+}  // namespace
 
-LockManager::LockManager() {
+LockManager::LockManager() : _numPartitions(numPartitions()) {
     _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
+    _partitions = new CacheAligned<Partition>[_numPartitions];
 }
 
 LockManager::~LockManager() {
@@ -424,6 +438,9 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        // The partition is chosen once, so that the request is found in the same partition when it
+        // is unlocked or migrated, even if the thread has since moved to another CPU.
+        request->partitionIndex = _choosePartitionIndex(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -792,8 +809,18 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
+unsigned LockManager::_choosePartitionIndex(LockRequest* request) const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) % _numPartitions;
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
+}
+
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->partitionIndex];
 }
 
 void LockManager::dump() const {
@@ -996,6 +1023,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
     next = nullptr;
     status = STATUS_NEW;
     partitioned = false;
+    partitionIndex = 0;
     mode = MODE_NONE;
     convertMode = MODE_NONE;
     unlockPending = 0;
@@ -44,6 +44,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -146,9 +147,11 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
+    // Each intent lock request maps to a partition that is used for resources acquired in intent
     // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
+    // contention on the regular LockHead in the lock manager. Requests are spread over the
+    // partitions by the CPU they are made on, so that concurrent intent lockers on different cores
+    // neither share a partition mutex nor a cache line.
     struct Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
@@ -165,7 +168,15 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Chooses the partition a new intent LockRequest should use, preferring the partition of the
+     * CPU the calling thread is running on. Falls back to the id of the request's locker where the
+     * current CPU cannot be determined.
+     */
+    unsigned _choosePartitionIndex(LockRequest* request) const;
+
+    /**
+     * Retrieves the Partition that a particular LockRequest uses for intent locking. Only valid
+     * once the partition has been chosen by lock().
      */
     Partition* _getPartition(LockRequest* request) const;
 
@@ -213,7 +224,7 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    const unsigned _numPartitions;
+    CacheAligned<Partition>* _partitions;
 };
 }  // namespace mongo
@@ -398,6 +398,14 @@ struct LockRequest {
     // No synchronization
     bool partitioned;
 
+    // Index of the LockManager partition this request uses while it is partitioned. Chosen from
+    // the CPU the request was made on, and kept so that unlocking from another CPU finds it.
+    //
+    // Written by LockManager on the thread that issues the request
+    // Read by LockManager on any thread
+    // No synchronization
+    unsigned partitionIndex;
+
     // How many times has LockManager::lock been called for this request. Locks are released when
     // their recursive count drops to zero.
     //
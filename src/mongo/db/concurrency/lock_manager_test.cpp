@@ -27,8 +27,12 @@
  *    it in the license file.
  */
 
+#include <memory>
+#include <vector>
+
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -952,4 +956,50 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, IntentLocksFromManyThreadsAreMigratedForConflictingLock) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    // Take the intent locks from several threads, so that they may land in different partitions.
+    const int kNumThreads = 8;
+    std::vector<std::unique_ptr<LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (int i = 0; i < kNumThreads; i++) {
+        lockers.push_back(std::make_unique<LockerImpl>());
+        requests.push_back(std::make_unique<LockRequestCombo>(lockers.back().get()));
+    }
+
+    std::vector<LockResult> results(kNumThreads, LOCK_INVALID);
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, i] {
+            results[i] = lockMgr.lock(resId, requests[i].get(), i % 2 ? MODE_IX : MODE_IS);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto result : results) {
+        ASSERT_EQ(LOCK_OK, result);
+    }
+
+    // The conflicting request has to wait for every intent lock, whichever partition it is in
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // Unlocking from a different thread than the one which locked must find each request
+    for (int i = 0; i < kNumThreads; i++) {
+        ASSERT_EQ(0, requestX.numNotifies);
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+
+    // Unlock all locks so we don't assert for leaked locks
+    ASSERT(lockMgr.unlock(&requestX));
+}
+
 }  // namespace mongo
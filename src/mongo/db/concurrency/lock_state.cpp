@@ -48,6 +48,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -344,11 +345,20 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = makeGuard([&] { _clientState.store(kInactive); });
 
-        OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
-            return false;
+        // Only read the clock when no ticket is immediately available, which keeps the time
+        // spent queued for a ticket off the uncontended path.
+        if (!holder->tryAcquire()) {
+            Timer waitTimer;
+            auto recordWaitTime = makeGuard([&] {
+                _ticketWaitMicros.fetchAndAdd(durationCount<Microseconds>(waitTimer.elapsed()));
+            });
+
+            OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(interruptible);
+            } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+                return false;
+            }
         }
         restoreStateOnErrorGuard.dismiss();
     }
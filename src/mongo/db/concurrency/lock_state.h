@@ -266,6 +266,10 @@ public:
         return _flowControlStats;
     }
 
+    Microseconds getTicketWaitTime() const override {
+        return Microseconds{_ticketWaitMicros.load()};
+    }
+
     /**
      * This function is for unit testing only.
      */
@@ -368,6 +372,10 @@ private:
     // A structure for accumulating time spent getting flow control tickets.
     FlowControlTicketholder::CurOp _flowControlStats;
 
+    // Time spent waiting for a ticket into the storage engine. Read by $currentOp from other
+    // threads, hence atomic.
+    AtomicWord<long long> _ticketWaitMicros{0};
+
     // Tracks the global lock modes ever acquired in this Locker's life. This value should only ever
     // be accessed from the thread that owns the Locker.
     unsigned char _globalLockMode = (1 << MODE_NONE);
@@ -117,6 +117,28 @@ void LockStats<CounterType>::_report(BSONObjBuilder* builder,
     }
 }
 
+template <typename CounterType>
+void LockStats<CounterType>::reportWaitTime(BSONObjBuilder* builder) const {
+    for (int i = 1; i < ResourceTypesCount; i++) {
+        if (auto micros = _combinedWaitTimeMicros(_stats[i]); micros > 0) {
+            builder->append(resourceTypeName(static_cast<ResourceType>(i)), micros);
+        }
+    }
+
+    if (auto micros = _combinedWaitTimeMicros(_oplogStats); micros > 0) {
+        builder->append("oplog", micros);
+    }
+}
+
+template <typename CounterType>
+long long LockStats<CounterType>::_combinedWaitTimeMicros(const PerModeLockStatCounters& stat) {
+    long long micros = 0;
+    for (int mode = 1; mode < LockModesCount; mode++) {
+        micros += CounterOps::get(stat.modeStats[mode].combinedWaitTimeMicros);
+    }
+    return micros;
+}
+
 template <typename CounterType>
 void LockStats<CounterType>::reset() {
     for (int i = 0; i < ResourceTypesCount; i++) {
@@ -185,6 +185,13 @@ public:
     }
 
     void report(BSONObjBuilder* builder) const;
+
+    /**
+     * Appends the time spent waiting for the locks of each resource type, in microseconds and
+     * summed over all modes. Resource types which were never waited for are left out.
+     */
+    void reportWaitTime(BSONObjBuilder* builder) const;
+
     void reset();
 
 private:
@@ -205,6 +212,8 @@ private:
                  const char* resourceTypeName,
                  const PerModeLockStatCounters& stat) const;
 
+    static long long _combinedWaitTimeMicros(const PerModeLockStatCounters& stat);
+
 
     // Split the lock stats per resource type. Special-case the oplog so we can collect more
     // detailed stats for it.
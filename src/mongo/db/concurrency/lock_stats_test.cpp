@@ -108,6 +108,22 @@ TEST_F(LockStatsTest, Reporting) {
     stats.report(&builder);
 }
 
+TEST_F(LockStatsTest, ReportingWaitTime) {
+    const ResourceId collId(RESOURCE_COLLECTION, std::string("LockStats.ReportingWaitTime"));
+    const ResourceId dbId(RESOURCE_DATABASE, std::string("LockStats"));
+
+    SingleThreadedLockStats stats;
+    stats.recordWaitTime(collId, MODE_S, 100);
+    stats.recordWaitTime(collId, MODE_X, 20);
+    stats.recordWaitTime(resourceIdOplog, MODE_IX, 3);
+    stats.recordAcquisition(dbId, MODE_IS);
+
+    // Wait times are summed over the modes, and resources which were not waited for are omitted.
+    BSONObjBuilder builder;
+    stats.reportWaitTime(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("Collection" << 120LL << "oplog" << 3LL), builder.obj());
+}
+
 TEST_F(LockStatsTest, Subtraction) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Subtraction"));
 
@@ -524,6 +524,14 @@ public:
         return FlowControlTicketholder::CurOp();
     }
 
+    /**
+     * If tracked by an implementation, returns the time spent waiting for a ticket into the
+     * storage engine. May be called from a thread other than the one owning the locker.
+     */
+    virtual Microseconds getTicketWaitTime() const {
+        return Microseconds(0);
+    }
+
     /**
      * This function is for unit testing only.
      */
@@ -47,12 +47,15 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_stats.h"
+#include "mongo/db/stats/remote_wait_time.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -319,6 +322,18 @@ CurOp::~CurOp() {
     if (parent() != nullptr)
         parent()->yielded(_numYields);
     invariant(this == _stack->pop());
+
+    if (parent() != nullptr) {
+        parent()->_updateProfilerTag();
+    } else {
+        SamplingProfiler::clearThreadTag();
+    }
+}
+
+void CurOp::_updateProfilerTag() const {
+    SamplingProfiler::setThreadTag(
+        _command ? StringData(_command->getName()) : StringData(logicalOpToString(_logicalOp)),
+        _ns);
 }
 
 void CurOp::setGenericOpRequestDetails(OperationContext* opCtx,
@@ -339,6 +354,7 @@ void CurOp::setGenericOpRequestDetails(OperationContext* opCtx,
     _opDescription = cmdObj;
     _command = command;
     _ns = nss.ns();
+    _updateProfilerTag();
 }
 
 void CurOp::setMessage_inlock(StringData message) {
@@ -360,17 +376,20 @@ ProgressMeter& CurOp::setProgress_inlock(StringData message,
 
 void CurOp::setNS_inlock(StringData ns) {
     _ns = ns.toString();
+    _updateProfilerTag();
 }
 
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+        _cpuTimer.start();
     }
 }
 
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
+    _updateProfilerTag();
     if (dbProfileLevel) {
         raiseDbProfileLevel(*dbProfileLevel);
     }
@@ -396,9 +415,28 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
         _debug.responseLength = *responseLength;
     }
 
-    // Obtain the total execution time of this operation.
+    // Obtain the total execution time of this operation, and where it went.
     _end = curTimeMicros64();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
+    _cpuTimer.stop();
+    _debug.timeBreakdown = getTimeBreakdown(opCtx);
+
+    // Add the cost of the operation to the statistics of its query shape.
+    if (_debug.queryHash) {
+        QueryStats::OperationMetrics metrics;
+        metrics.isGetMore = _logicalOp == LogicalOp::opGetMore;
+        metrics.executionMicros = _debug.executionTimeMicros;
+        metrics.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        metrics.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        metrics.nreturned = std::max(_debug.nreturned, 0LL);
+        metrics.bytesReturned = std::max(_debug.responseLength, 0);
+        QueryStats::get(opCtx->getServiceContext())
+            .record(NamespaceString(_ns),
+                    *_debug.queryHash,
+                    _debug.queryShape,
+                    metrics,
+                    Date_t::now());
+    }
 
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
@@ -440,6 +478,14 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     return shouldDBProfile(shouldSample);
 }
 
+OpDebug::TimeBreakdown CurOp::getTimeBreakdown(OperationContext* opCtx) const {
+    OpDebug::TimeBreakdown timeBreakdown;
+    timeBreakdown.cpuTime = _cpuTimer.elapsed();
+    timeBreakdown.ticketWaitTime = opCtx->lockState()->getTicketWaitTime();
+    timeBreakdown.remoteWaitTime = RemoteWaitTime::get(opCtx).total();
+    return timeBreakdown;
+}
+
 Command::ReadWriteType CurOp::getReadWriteType() const {
     if (_command) {
         return _command->getReadWriteType();
@@ -721,6 +767,12 @@ string OpDebug::report(Client* client,
         s << " storage:" << storageStats->toBSON().toString();
     }
 
+    BSONObj timeBreakdownObj =
+        makeTimeBreakdownObject(timeBreakdown, lockStats, flowControlStats, storageStats.get());
+    if (timeBreakdownObj.nFields() > 0) {
+        s << " timeBreakdown:" << timeBreakdownObj.toString();
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -810,6 +862,12 @@ void OpDebug::append(const CurOp& curop,
         b.append("storage", storageStats->toBSON());
     }
 
+    BSONObj timeBreakdownObj =
+        makeTimeBreakdownObject(timeBreakdown, &lockStats, flowControlStats, storageStats.get());
+    if (timeBreakdownObj.nFields() > 0) {
+        b.append("timeBreakdown", timeBreakdownObj);
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -860,6 +918,50 @@ BSONObj OpDebug::makeFlowControlObject(FlowControlTicketholder::CurOp stats) con
     return builder.obj();
 }
 
+BSONObj OpDebug::makeTimeBreakdownObject(const TimeBreakdown& timeBreakdown,
+                                         const SingleThreadedLockStats* lockStats,
+                                         FlowControlTicketholder::CurOp flowControlStats,
+                                         const StorageStats* storageStats) {
+    BSONObjBuilder builder;
+    if (timeBreakdown.cpuTime && *timeBreakdown.cpuTime > Microseconds(0)) {
+        builder.append("cpuMicros", durationCount<Microseconds>(*timeBreakdown.cpuTime));
+    }
+
+    if (lockStats) {
+        BSONObjBuilder lockWaitBuilder;
+        lockStats->reportWaitTime(&lockWaitBuilder);
+        BSONObj lockWait = lockWaitBuilder.obj();
+        if (lockWait.nFields() > 0) {
+            builder.append("lockWaitMicros", lockWait);
+        }
+    }
+
+    if (timeBreakdown.ticketWaitTime > Microseconds(0)) {
+        builder.append("ticketWaitMicros",
+                       durationCount<Microseconds>(timeBreakdown.ticketWaitTime));
+    }
+
+    if (flowControlStats.timeAcquiringMicros > 0) {
+        builder.append("flowControlWaitMicros", flowControlStats.timeAcquiringMicros);
+    }
+
+    if (storageStats) {
+        if (auto reading = storageStats->timeReading(); reading > Microseconds(0)) {
+            builder.append("storageReadMicros", durationCount<Microseconds>(reading));
+        }
+        if (auto cacheWait = storageStats->timeWaitingForCache(); cacheWait > Microseconds(0)) {
+            builder.append("storageCacheWaitMicros", durationCount<Microseconds>(cacheWait));
+        }
+    }
+
+    if (timeBreakdown.remoteWaitTime > Microseconds(0)) {
+        builder.append("remoteWaitMicros",
+                       durationCount<Microseconds>(timeBreakdown.remoteWaitTime));
+    }
+
+    return builder.obj();
+}
+
 BSONObj OpDebug::makeSearchBetaObject() const {
     BSONObjBuilder cursorBuilder;
     invariant(mongotCursorId);
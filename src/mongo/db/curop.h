@@ -37,6 +37,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/thread_cpu_timer.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -140,6 +141,19 @@ public:
         AtomicWord<long long> writeConflicts{0};
     };
 
+    /**
+     * Where the wall time of an operation went, beyond the waits that the lock, flow control and
+     * storage statistics already record.
+     */
+    struct TimeBreakdown {
+        // Time spent running on a CPU, or boost::none where the platform cannot measure it.
+        boost::optional<Microseconds> cpuTime;
+        // Time spent queued for a ticket into the storage engine.
+        Microseconds ticketWaitTime{0};
+        // Time spent blocked on the responses of remote commands.
+        Microseconds remoteWaitTime{0};
+    };
+
     OpDebug() = default;
 
     std::string report(Client* client,
@@ -168,6 +182,16 @@ public:
      */
     BSONObj makeFlowControlObject(FlowControlTicketholder::CurOp flowControlStats) const;
 
+    /**
+     * Makes the "timeBreakdown" object out of 'timeBreakdown' and the wait times recorded by the
+     * lock, flow control and storage statistics, any of which may be missing. All times are in
+     * microseconds, and zeros are omitted.
+     */
+    static BSONObj makeTimeBreakdownObject(const TimeBreakdown& timeBreakdown,
+                                           const SingleThreadedLockStats* lockStats,
+                                           FlowControlTicketholder::CurOp flowControlStats,
+                                           const StorageStats* storageStats);
+
     /**
      * Make object from $searchBeta stats with non-populated values omitted.
      */
@@ -216,6 +240,8 @@ public:
     boost::optional<uint32_t> planCacheKey;
     // The hash of the query's "stable" key. This represents the query's shape.
     boost::optional<uint32_t> queryHash;
+    // The "stable" key itself, reported alongside the queryHash by $queryStats.
+    std::string queryShape;
 
     // Details of any error (whether from an exception or a command returning failure).
     Status errInfo = Status::OK();
@@ -234,6 +260,9 @@ public:
     // Stores storage statistics.
     std::shared_ptr<StorageStats> storageStats;
 
+    // Filled in when the operation completes, by CurOp::completeAndLogOperation().
+    TimeBreakdown timeBreakdown;
+
     bool waitingForFlowControl{false};
 };
 
@@ -445,6 +474,7 @@ public:
     }
     void done() {
         _end = curTimeMicros64();
+        _cpuTimer.stop();
     }
     bool isDone() const {
         return _end > 0;
@@ -618,6 +648,12 @@ public:
         return _lockStatsBase;
     }
 
+    /**
+     * Returns where the time of this operation has gone so far, or up to its completion if it is
+     * done. 'opCtx' must be the operation this CurOp belongs to.
+     */
+    OpDebug::TimeBreakdown getTimeBreakdown(OperationContext* opCtx) const;
+
 private:
     class CurOpStack;
 
@@ -625,6 +661,12 @@ private:
 
     CurOp(OperationContext*, CurOpStack*);
 
+    /**
+     * Tags the samples the sampling profiler takes of this thread with the command and namespace
+     * of this operation.
+     */
+    void _updateProfilerTag() const;
+
     CurOpStack* _stack;
     CurOp* _parent{nullptr};
     const Command* _command{nullptr};
@@ -635,6 +677,9 @@ private:
     // The time at which this CurOp instance was marked as done.
     long long _end{0};
 
+    // The CPU time of the thread running the operation, from when it was started until it is done.
+    ThreadCPUTimer _cpuTimer;
+
     // The time at which this CurOp instance had its timer paused, or 0 if the timer is not
     // currently paused.
     long long _lastPauseTime{0};
@@ -102,6 +102,7 @@
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_cache_replanner.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/oplog.h"
@@ -966,6 +967,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     // Depends on setKillAllOperations() above to interrupt the index build operations.
     IndexBuildsCoordinator::get(serviceContext)->shutdown();
 
+    // Depends on setKillAllOperations() above to interrupt any background replan in progress.
+    PlanCacheReplanner::get(serviceContext)->shutdown();
+
     ReplicaSetMonitor::shutdown();
 
     if (auto sr = Grid::get(serviceContext)->shardRegistry()) {
@@ -42,6 +42,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_replanner.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_knobs_gen.h"
@@ -62,12 +63,14 @@ CachedPlanStage::CachedPlanStage(OperationContext* opCtx,
                                  CanonicalQuery* cq,
                                  const QueryPlannerParams& params,
                                  size_t decisionWorks,
-                                 PlanStage* root)
+                                 PlanStage* root,
+                                 boost::optional<PlanCacheKey> planCacheKey)
     : RequiresAllIndicesStage(kStageType, opCtx, collection),
       _ws(ws),
       _canonicalQuery(cq),
       _plannerParams(params),
-      _decisionWorks(decisionWorks) {
+      _decisionWorks(decisionWorks),
+      _planCacheKey(std::move(planCacheKey)) {
     _children.emplace_back(root);
 }
 
@@ -154,7 +157,24 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     }
 
     // If we're here, the trial period took more than 'maxWorksBeforeReplan' work cycles. This
-    // plan is taking too long, so we replan from scratch.
+    // plan is taking too long. When background replanning is enabled, keep running the cached plan
+    // and leave it to the background replanner to pick a new plan for later queries of this shape.
+    if (internalQueryCacheBackgroundReplanning.load()) {
+        PlanCache* cache = collection()->infoCache()->getPlanCache();
+        const bool scheduled = PlanCacheReplanner::get(getOpCtx())->scheduleReplan(
+            *_canonicalQuery,
+            (_planCacheKey ? *_planCacheKey : cache->computeKey(*_canonicalQuery)).toString());
+
+        LOG(1) << "Execution of cached plan required " << maxWorksBeforeReplan
+               << " works, but was originally cached with only " << _decisionWorks
+               << " works. Continuing with the cached plan; background replanning "
+               << (scheduled ? "scheduled" : "already pending")
+               << " for query: " << redact(_canonicalQuery->toStringShort())
+               << " plan summary: " << Explain::getPlanSummary(child().get());
+        return Status::OK();
+    }
+
+    // Otherwise we replan from scratch.
     LOG(1) << "Execution of cached plan required " << maxWorksBeforeReplan
            << " works, but was originally cached with only " << _decisionWorks
            << " works. Evicting cache entry and replanning query: "
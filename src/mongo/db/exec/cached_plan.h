@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <queue>
 
@@ -36,6 +37,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/record_id.h"
@@ -62,7 +64,8 @@ public:
                     CanonicalQuery* cq,
                     const QueryPlannerParams& params,
                     size_t decisionWorks,
-                    PlanStage* root);
+                    PlanStage* root,
+                    boost::optional<PlanCacheKey> planCacheKey = boost::none);
 
     bool isEOF() final;
 
@@ -88,6 +91,13 @@ public:
      */
     Status pickBestPlan(PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Returns the key the cached plan was looked up with, if the caller provided it.
+     */
+    const boost::optional<PlanCacheKey>& planCacheKey() const {
+        return _planCacheKey;
+    }
+
 private:
     /**
      * Passes stats from the trial period run of the cached plan to the plan cache.
@@ -129,6 +139,10 @@ private:
     // cached.
     size_t _decisionWorks;
 
+    // The key of the plan cache entry the plan came from, kept so that the entry can be found
+    // again without encoding the query's shape again.
+    boost::optional<PlanCacheKey> _planCacheKey;
+
     // If we fall back to re-planning the query, and there is just one resulting query solution,
     // that solution is owned here.
     std::unique_ptr<QuerySolution> _replannedQs;
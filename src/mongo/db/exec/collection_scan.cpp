@@ -34,6 +34,7 @@
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/collection_scan_common.h"
@@ -74,6 +75,12 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
         _endCondition = std::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
                                                              _endConditionBSON.firstElement());
     }
+
+    // Skip indexes are only built on collections which are not capped, and so never on the oplog.
+    if (!params.tailable && !params.stopApplyingFilterAfterFirstMatch) {
+        _skipIndexFilter = SkipIndex::makeFilter(collection->infoCache()->getSkipIndex(), _filter);
+        _specificStats.usedSkipIndex = static_cast<bool>(_skipIndexFilter);
+    }
 }
 
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
@@ -128,6 +135,10 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
+        if (_needToSeekToLastSeenId) {
+            return seekToLastSeenId(out);
+        }
+
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
         } else {
@@ -163,6 +174,38 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
     }
 
+    if (_skipIndexFilter && !_skipIndexFilter->mayMatch(record->id)) {
+        ++_specificStats.docsSkipped;
+        if (_params.direction != CollectionScanParams::FORWARD) {
+            return PlanStage::NEED_TIME;
+        }
+
+        // Seek to the first record of the next block which may match, instead of reading every
+        // record of the blocks in between.
+        const RecordId next =
+            _skipIndexFilter->nextCandidate(record->id, &_specificStats.blocksSkipped);
+        if (next.isNull()) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        try {
+            record = _cursor->seekExact(next);
+        } catch (const WriteConflictException&) {
+            // The cursor restores to the record just read.
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!record) {
+            // The record has been deleted, and the failed seek left the cursor unpositioned. Go
+            // back to the record just read and read on from there.
+            _needToSeekToLastSeenId = true;
+            return seekToLastSeenId(out);
+        }
+        _lastSeenId = record->id;
+    }
+
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
@@ -172,6 +215,27 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+PlanStage::StageState CollectionScan::seekToLastSeenId(WorkingSetID* out) {
+    try {
+        if (!_cursor->seekExact(_lastSeenId)) {
+            // Only possible if the scan yielded since reading the record, which was then deleted.
+            Status status(ErrorCodes::QueryPlanKilled,
+                          str::stream() << "CollectionScan died due to failure to restore its "
+                                        << "position after skipping blocks of records. "
+                                        << "Last seen record id: "
+                                        << _lastSeenId);
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            return PlanStage::FAILURE;
+        }
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    _needToSeekToLastSeenId = false;
+    return PlanStage::NEED_TIME;
+}
+
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
@@ -226,6 +290,19 @@ void CollectionScan::doRestoreStateRequiresCollection() {
                     << _lastSeenId,
                 couldRestore);
     }
+
+    // The skip index may have been dropped or rebuilt while yielding, after which the one in use
+    // is no longer kept up to date with writes.
+    if (_skipIndexFilter &&
+        _skipIndexFilter->skipIndex() != collection()->infoCache()->getSkipIndex().get()) {
+        _skipIndexFilter.reset();
+    }
+
+    // Writers may have added values to the block the scan stopped in, so the answer remembered for
+    // it could wrongly skip the records written while yielding.
+    if (_skipIndexFilter) {
+        _skipIndexFilter->reset();
+    }
 }
 
 void CollectionScan::doDetachFromOperationContext() {
@@ -34,6 +34,7 @@
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/skip_index.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -96,6 +97,12 @@ private:
      */
     Status setLatestOplogEntryTimestamp(const Record& record);
 
+    /**
+     * Positions the cursor back on '_lastSeenId', after a seek past blocks of records which the
+     * skip index ruled out found the record it was seeking deleted.
+     */
+    StageState seekToLastSeenId(WorkingSetID* out);
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
@@ -109,6 +116,13 @@ private:
 
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
+    // Set if the collection has a skip index which can tell that some records cannot pass
+    // '_filter'. Those records are passed over without being tested.
+    std::unique_ptr<SkipIndex::Filter> _skipIndexFilter;
+
+    // Set while the cursor needs to be positioned back on '_lastSeenId'.
+    bool _needToSeekToLastSeenId = false;
+
     CollectionScanParams _params;
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
@@ -0,0 +1,323 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/column_scan.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/column_store_key_generator.h"
+#include "mongo/db/index/index_access_method.h"
+
+namespace mongo {
+
+namespace {
+
+using Cell = ColumnStoreKeyGenerator::Cell;
+using CellKind = ColumnStoreKeyGenerator::CellKind;
+
+struct ColumnValue {
+    // The path of the column, less the components already opened as subdocuments.
+    StringData path;
+    BSONElement value;
+};
+
+/**
+ * Appends the values in [begin, end) to 'bob', creating a subdocument for each path component
+ * they share. The paths must be sorted, and none may be a prefix of another, so that the values
+ * which share a first component are next to each other.
+ */
+void appendColumnValues(BSONObjBuilder* bob,
+                        std::vector<ColumnValue>::iterator begin,
+                        std::vector<ColumnValue>::iterator end) {
+    while (begin != end) {
+        const auto dot = begin->path.find('.');
+        if (dot == std::string::npos) {
+            bob->appendAs(begin->value, begin->path);
+            ++begin;
+            continue;
+        }
+
+        const auto field = begin->path.substr(0, dot);
+        auto groupEnd = begin;
+        while (groupEnd != end && groupEnd->path.size() > field.size() &&
+               groupEnd->path.startsWith(field) && groupEnd->path[field.size()] == '.') {
+            groupEnd->path = groupEnd->path.substr(field.size() + 1);
+            ++groupEnd;
+        }
+
+        BSONObjBuilder subBob(bob->subobjStart(field));
+        appendColumnValues(&subBob, begin, groupEnd);
+        begin = groupEnd;
+    }
+}
+
+}  // namespace
+
+// static
+const char* ColumnScan::kStageType = "COLUMN_SCAN";
+
+ColumnScan::ColumnScan(OperationContext* opCtx,
+                       const IndexDescriptor* descriptor,
+                       std::vector<std::string> columns,
+                       WorkingSet* workingSet,
+                       const MatchExpression* filter)
+    : RequiresIndexStage(kStageType, opCtx, descriptor),
+      _workingSet(workingSet),
+      _filter(filter),
+      _rowColumn(ColumnStoreKeyGenerator::kRowColumnPath.toString()) {
+    invariant(std::is_sorted(columns.begin(), columns.end()));
+    for (auto&& path : columns) {
+        _columns.emplace_back(path);
+    }
+
+    _specificStats.indexName = descriptor->indexName();
+    _specificStats.keyPattern = descriptor->keyPattern();
+    _specificStats.columns = std::move(columns);
+}
+
+std::vector<ColumnScan::Column*> ColumnScan::_allColumns() {
+    std::vector<Column*> all{&_rowColumn};
+    for (auto&& column : _columns) {
+        all.push_back(&column);
+    }
+    return all;
+}
+
+void ColumnScan::_openColumn(Column* column) {
+    column->cursor = indexAccessMethod()->newCursor(getOpCtx());
+    _seekColumn(column, RecordId::min());
+}
+
+void ColumnScan::_seekColumn(Column* column, const RecordId& id) {
+    column->entry =
+        column->cursor->seek(ColumnStoreKeyGenerator::makeSeekKey(column->path, id), true);
+    ++_specificStats.keysExamined;
+    if (column->entry &&
+        ColumnStoreKeyGenerator::parseKey(column->entry->key).path != column->path) {
+        column->entry = boost::none;
+    }
+}
+
+void ColumnScan::_advanceColumn(Column* column) {
+    column->entry = column->cursor->next();
+    ++_specificStats.keysExamined;
+    if (column->entry &&
+        ColumnStoreKeyGenerator::parseKey(column->entry->key).path != column->path) {
+        column->entry = boost::none;
+    }
+}
+
+void ColumnScan::_advanceColumnTo(Column* column, const RecordId& id) {
+    while (column->entry && ColumnStoreKeyGenerator::parseKey(column->entry->key).id < id) {
+        _advanceColumn(column);
+    }
+}
+
+PlanStage::StageState ColumnScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF)
+        return PlanStage::IS_EOF;
+
+    // Each step below can be repeated after a write conflict without skipping a document, since
+    // the current row is only marked consumed once it has been fully read.
+    BSONObj obj;
+    RecordId recordId;
+    try {
+        if (!_rowColumn.cursor) {
+            _openColumn(&_rowColumn);
+            for (auto&& column : _columns) {
+                _openColumn(&column);
+            }
+            _rowConsumed = false;
+        } else if (_rowConsumed) {
+            _advanceColumn(&_rowColumn);
+            _rowConsumed = false;
+        }
+
+        if (!_rowColumn.entry) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+
+        const Cell rowCell = ColumnStoreKeyGenerator::parseKey(_rowColumn.entry->key);
+        recordId = rowCell.id;
+        bool mustFetch = rowCell.kind == CellKind::kFetchDocument;
+
+        std::vector<ColumnValue> values;
+        values.reserve(_columns.size());
+        for (auto&& column : _columns) {
+            _advanceColumnTo(&column, recordId);
+            if (!column.entry) {
+                continue;
+            }
+
+            const Cell cell = ColumnStoreKeyGenerator::parseKey(column.entry->key);
+            if (cell.id != recordId) {
+                // The document has no value at the path of the column.
+                continue;
+            }
+            if (cell.kind == CellKind::kFetchDocument) {
+                mustFetch = true;
+                break;
+            }
+            values.push_back({column.path, cell.value});
+        }
+
+        if (mustFetch) {
+            if (!_fetchCursor) {
+                _fetchCursor = collection()->getCursor(getOpCtx());
+            }
+            auto record = _fetchCursor->seekExact(recordId);
+            ++_specificStats.docsFetched;
+            if (!record) {
+                // The document was deleted since the index was read.
+                _rowConsumed = true;
+                return PlanStage::NEED_TIME;
+            }
+            obj = record->data.releaseToBson();
+        } else {
+            BSONObjBuilder bob;
+            if (!rowCell.value.eoo()) {
+                bob.appendAs(rowCell.value, "_id");
+            }
+            appendColumnValues(&bob, values.begin(), values.end());
+            obj = bob.obj();
+        }
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    _rowConsumed = true;
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = recordId;
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), obj.getOwned()};
+    _workingSet->transitionToRecordIdAndObj(id);
+
+    if (!Filter::passes(member, _filter)) {
+        _workingSet->free(id);
+        return PlanStage::NEED_TIME;
+    }
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+bool ColumnScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ColumnScan::doSaveStateRequiresIndex() {
+    // The current row must outlive the position of the cursor it was read from, so that restoring
+    // can find it again. The cells of the other columns are read afresh on restore.
+    if (_rowColumn.entry) {
+        _rowColumn.entry->key = _rowColumn.entry->key.getOwned();
+    }
+    for (auto&& column : _columns) {
+        column.entry = boost::none;
+    }
+    for (auto column : _allColumns()) {
+        if (column->cursor) {
+            column->cursor->save();
+        }
+    }
+    if (_fetchCursor) {
+        _fetchCursor->saveUnpositioned();
+    }
+}
+
+void ColumnScan::doRestoreStateRequiresIndex() {
+    for (auto column : _allColumns()) {
+        if (column->cursor) {
+            column->cursor->restore();
+        }
+    }
+
+    // The cells read before yielding may since have been changed or deleted, so every column is
+    // positioned afresh on the current row rather than trusting the cell it held.
+    if (_rowColumn.entry) {
+        const RecordId rowId = ColumnStoreKeyGenerator::parseKey(_rowColumn.entry->key).id;
+        _seekColumn(&_rowColumn, rowId);
+        if (!_rowColumn.entry ||
+            ColumnStoreKeyGenerator::parseKey(_rowColumn.entry->key).id != rowId) {
+            // The current row was deleted, so the row column now sits on a row not yet read.
+            _rowConsumed = false;
+        }
+        for (auto&& column : _columns) {
+            _seekColumn(&column, rowId);
+        }
+    }
+    if (_fetchCursor) {
+        const bool couldRestore = _fetchCursor->restore();
+        uassert(51241, "could not restore cursor for COLUMN_SCAN stage", couldRestore);
+    }
+}
+
+void ColumnScan::doDetachFromOperationContext() {
+    for (auto column : _allColumns()) {
+        if (column->cursor) {
+            column->cursor->detachFromOperationContext();
+        }
+    }
+    if (_fetchCursor) {
+        _fetchCursor->detachFromOperationContext();
+    }
+}
+
+void ColumnScan::doReattachToOperationContext() {
+    for (auto column : _allColumns()) {
+        if (column->cursor) {
+            column->cursor->reattachToOperationContext(getOpCtx());
+        }
+    }
+    if (_fetchCursor) {
+        _fetchCursor->reattachToOperationContext(getOpCtx());
+    }
+}
+
+std::unique_ptr<PlanStageStats> ColumnScan::getStats() {
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_COLUMN_SCAN);
+    ret->specific = std::make_unique<ColumnScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ColumnScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
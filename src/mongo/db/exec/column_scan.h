@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/exec/requires_index_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+
+class WorkingSet;
+
+/**
+ * Reads the documents of a collection from the columns of a columnstore index, rather than from the
+ * collection itself. Walks the row column of the index, which lists every document, and reads each
+ * of 'columns' in step with it, so that each column is read once, in RecordId order.
+ *
+ * Creates a WorkingSetMember in RID_AND_OBJ state for each document passing 'filter'. The object
+ * holds the _id and the values of 'columns' only, with nested paths rebuilt as subdocuments. When a
+ * column cannot describe the value at its path, because an array lies along it, the whole document
+ * is fetched from the collection instead.
+ */
+class ColumnScan final : public RequiresIndexStage {
+public:
+    ColumnScan(OperationContext* opCtx,
+               const IndexDescriptor* descriptor,
+               std::vector<std::string> columns,
+               WorkingSet* workingSet,
+               const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
+    StageType stageType() const final {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+protected:
+    void doSaveStateRequiresIndex() final;
+
+    void doRestoreStateRequiresIndex() final;
+
+private:
+    struct Column {
+        explicit Column(std::string path) : path(std::move(path)) {}
+
+        std::string path;
+        std::unique_ptr<SortedDataInterface::Cursor> cursor;
+
+        // The next cell of the column which has not been skipped over, or none once the cursor
+        // has moved past the last cell of the column.
+        boost::optional<IndexKeyEntry> entry;
+    };
+
+    /**
+     * Returns the row column followed by the columns of the needed paths.
+     */
+    std::vector<Column*> _allColumns();
+
+    /**
+     * Opens a cursor on 'column' and positions it on its first cell.
+     */
+    void _openColumn(Column* column);
+
+    /**
+     * Positions 'column' on its first cell for a document at or after 'id'.
+     */
+    void _seekColumn(Column* column, const RecordId& id);
+
+    /**
+     * Moves 'column' to its next cell.
+     */
+    void _advanceColumn(Column* column);
+
+    /**
+     * Moves 'column' past all of its cells for documents before 'id'.
+     */
+    void _advanceColumnTo(Column* column, const RecordId& id);
+
+    // The WorkingSet we annotate with results.  Not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    // The row column has a cell for every document, holding its _id.
+    Column _rowColumn;
+
+    // Whether the current cell of '_rowColumn' has already been returned, or filtered out.
+    bool _rowConsumed = true;
+
+    std::vector<Column> _columns;
+
+    // Used to fetch documents which the columns cannot describe.
+    std::unique_ptr<SeekableRecordCursor> _fetchCursor;
+
+    ColumnScanStats _specificStats;
+};
+
+}  // namespace mongo
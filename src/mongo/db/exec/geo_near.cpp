@@ -45,6 +45,7 @@
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
 #include "mongo/db/geo/hash.h"
+#include "mongo/db/geo/shapes.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/expression_index.h"
@@ -136,6 +137,57 @@ static void extractGeometries(const BSONObj& doc,
     }
 }
 
+/**
+ * If 'element' is a point, either legacy or GeoJSON without a "crs", sets 'out' to its coordinates
+ * and returns true. Unlike parsing the element into a GeometryContainer, this allocates nothing and
+ * does not compute the S2 cell of the point, which a distance computation has no use for.
+ */
+static bool parseStoredPointCoordinates(const BSONElement& element, Point* out) {
+    if (!element.isABSONObj()) {
+        return false;
+    }
+
+    const BSONObj obj = element.Obj();
+    PointWithCRS point;
+    if (Array == element.type() || obj.firstElement().isNumber()) {
+        if (!GeoParser::parseLegacyPoint(element, &point, true).isOK()) {
+            return false;
+        }
+    } else {
+        // A GeoJSON point is parsed from its coordinates in the same way as a legacy point, but
+        // must also be a valid longitude and latitude.
+        if (GeoParser::parseGeoJSONType(obj) != GeoParser::GEOJSON_POINT || obj.hasField("crs") ||
+            !GeoParser::parseLegacyPoint(obj["coordinates"], &point, true).isOK() ||
+            !isValidLngLat(point.oldPoint.x, point.oldPoint.y)) {
+            return false;
+        }
+    }
+
+    *out = point.oldPoint;
+    return true;
+}
+
+/**
+ * Computes the distance from the centroid of 'nearQuery' to the point 'stored', exactly as
+ * GeometryContainer::minDistance() would after projecting the point into the query CRS. Returns -1
+ * if the point cannot be projected into that CRS.
+ */
+static double pointDistance(const GeoNearExpression& nearQuery, const Point& stored) {
+    const PointWithCRS& centroid = *nearQuery.centroid;
+    if (FLAT == centroid.crs) {
+        return distance(stored, centroid.oldPoint);
+    }
+
+    invariant(SPHERE == centroid.crs);
+    if (!isValidLngLat(stored.x, stored.y)) {
+        return -1;
+    }
+
+    // Note that it's (lat, lng) for S2 but (lng, lat) for MongoDB.
+    const S2Point storedPoint = S2LatLng::FromDegrees(stored.y, stored.x).Normalized().ToPoint();
+    return S2Distance::distanceRad(centroid.point, storedPoint) * kRadiusOfEarthInMeters;
+}
+
 static StatusWith<double> computeGeoNearDistance(const GeoNearParams& nearParams,
                                                  WorkingSetMember* member) {
     //
@@ -149,33 +201,44 @@ static StatusWith<double> computeGeoNearDistance(const GeoNearParams& nearParams
 
     CRS queryCRS = nearParams.nearQuery->centroid->crs;
 
-    // Extract all the geometries out of this document for the near query
-    std::vector<std::unique_ptr<StoredGeometry>> geometries;
-    extractGeometries(member->obj.value(), nearParams.nearQuery->field, &geometries);
-
-    // Compute the minimum distance of all the geometries in the document
     double minDistance = -1;
     BSONObj minDistanceObj;
-    for (auto it = geometries.begin(); it != geometries.end(); ++it) {
-        StoredGeometry& stored = **it;
-
-        // NOTE: A stored document with STRICT_SPHERE CRS is treated as a malformed document
-        // and ignored. Since GeoNear requires an index, there's no stored STRICT_SPHERE shape.
-        // So we don't check it here.
-
-        // NOTE: For now, we're sure that if we get this far in the query we'll have an
-        // appropriate index which validates the type of geometry we're pulling back here.
-        // TODO: It may make sense to change our semantics and, by default, only return
-        // shapes in the same CRS from $geoNear.
-        if (!stored.geometry.supportsProject(queryCRS))
-            continue;
-        stored.geometry.projectInto(queryCRS);
-
-        double nextDistance = stored.geometry.minDistance(*nearParams.nearQuery->centroid);
-
-        if (minDistance < 0 || nextDistance < minDistance) {
-            minDistance = nextDistance;
-            minDistanceObj = stored.element.Obj();
+
+    // Most documents hold a single point along the path, whose distance can be computed without
+    // extracting and parsing every geometry along the path.
+    const BSONElement pathElement =
+        dps::extractElementAtPath(member->obj.value(), nearParams.nearQuery->field);
+    Point storedPoint;
+    if (queryCRS != STRICT_SPHERE && parseStoredPointCoordinates(pathElement, &storedPoint)) {
+        minDistance = pointDistance(*nearParams.nearQuery, storedPoint);
+        minDistanceObj = pathElement.Obj();
+    } else {
+        // Extract all the geometries out of this document for the near query
+        std::vector<std::unique_ptr<StoredGeometry>> geometries;
+        extractGeometries(member->obj.value(), nearParams.nearQuery->field, &geometries);
+
+        // Compute the minimum distance of all the geometries in the document
+        for (auto it = geometries.begin(); it != geometries.end(); ++it) {
+            StoredGeometry& stored = **it;
+
+            // NOTE: A stored document with STRICT_SPHERE CRS is treated as a malformed document
+            // and ignored. Since GeoNear requires an index, there's no stored STRICT_SPHERE shape.
+            // So we don't check it here.
+
+            // NOTE: For now, we're sure that if we get this far in the query we'll have an
+            // appropriate index which validates the type of geometry we're pulling back here.
+            // TODO: It may make sense to change our semantics and, by default, only return
+            // shapes in the same CRS from $geoNear.
+            if (!stored.geometry.supportsProject(queryCRS))
+                continue;
+            stored.geometry.projectInto(queryCRS);
+
+            double nextDistance = stored.geometry.minDistance(*nearParams.nearQuery->centroid);
+
+            if (minDistance < 0 || nextDistance < minDistance) {
+                minDistance = nextDistance;
+                minDistanceObj = stored.element.Obj();
+            }
         }
     }
 
@@ -1018,19 +1081,33 @@ StatusWith<NearStage::CoveredInterval*>  //
         return StatusWith<CoveredInterval*>(nullptr);
     }
 
+    if (!_bufferedAnnulusOuterBounds.empty()) {
+        // The last index scan also covered this annulus, so it needs no covering of its own.
+        R2Annulus nextBounds(
+            _currBounds.center(), _currBounds.getOuter(), _bufferedAnnulusOuterBounds.front());
+        _bufferedAnnulusOuterBounds.pop_front();
+
+        bool isLastInterval = (nextBounds.getOuter() == _fullBounds.getOuter());
+        _currBounds = nextBounds;
+        return StatusWith<CoveredInterval*>(new CoveredInterval(
+            nullptr, nextBounds.getInner(), nextBounds.getOuter(), isLastInterval));
+    }
+
     //
     // Setup the next interval
     //
 
+    double incrementFactor = 1;
     if (!_specificStats.intervalStats.empty()) {
         const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
 
         // TODO: Generally we want small numbers of results fast, then larger numbers later
         if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
+            incrementFactor = 2;
         else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+            incrementFactor = 0.5;
     }
+    _boundsIncrement *= incrementFactor;
 
     invariant(_boundsIncrement > 0.0);
 
@@ -1041,6 +1118,18 @@ StatusWith<NearStage::CoveredInterval*>  //
     bool isLastInterval = (nextBounds.getOuter() == _fullBounds.getOuter());
     _currBounds = nextBounds;
 
+    // The index scan for this interval may also cover the annuli after it, whose results are then
+    // returned from the buffer in later intervals. Their widths change as if each returned as many
+    // results as the last interval did.
+    R2Annulus scanBounds = nextBounds;
+    const int annuliPerScan = gInternalQueryS2GeoNearAnnuliPerScan.load();
+    for (int i = 1; i < annuliPerScan && scanBounds.getOuter() < _fullBounds.getOuter(); ++i) {
+        _boundsIncrement *= incrementFactor;
+        const double outer = min(scanBounds.getOuter() + _boundsIncrement, _fullBounds.getOuter());
+        _bufferedAnnulusOuterBounds.push_back(outer);
+        scanBounds = R2Annulus(nextBounds.center(), nextBounds.getInner(), outer);
+    }
+
     //
     // Setup the covering region and stages for this interval
     //
@@ -1055,7 +1144,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     const int s2FieldPosition = getFieldPosition(indexDescriptor(), s2Field);
     fassert(28678, s2FieldPosition >= 0);
     scanParams.bounds.fields[s2FieldPosition].intervals.clear();
-    std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
+    std::unique_ptr<S2Region> region(buildS2Region(scanBounds));
 
     std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
 
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/exec/near.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
@@ -142,6 +144,10 @@ private:
     // Keeps track of the region that has already been scanned
     S2CellUnion _scannedCells;
 
+    // The outer radii of the annuli after the current one which the last index scan covered, and so
+    // whose results are already buffered.
+    std::deque<double> _bufferedAnnulusOuterBounds;
+
     class DensityEstimator;
     std::unique_ptr<DensityEstimator> _densityEstimator;
 };
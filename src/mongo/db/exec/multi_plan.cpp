@@ -204,11 +204,18 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
+    const double cutoffZScore = internalQueryPlanEvaluationEarlyCutoffZScore.load();
     for (size_t ix = 0; ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
         }
+
+        if (cutoffZScore > 0 && winnerIsClear(cutoffZScore)) {
+            LOG(2) << "Ending plan trial period after " << (ix + 1) << " of " << numWorks
+                   << " works, since the most productive plan is clearly ahead";
+            break;
+        }
     }
 
     if (_failure) {
@@ -399,6 +406,56 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::winnerIsClear(double cutoffZScore) const {
+    // The productivity of a candidate is the fraction of its works which produced a result. Find
+    // the most productive candidate which has not failed.
+    const CandidatePlan* leader = nullptr;
+    double leaderProductivity = 0;
+    for (auto&& candidate : _candidates) {
+        const size_t works = candidate.root->getCommonStats()->works;
+        if (candidate.failed || works == 0) {
+            continue;
+        }
+
+        const double productivity = static_cast<double>(candidate.results.size()) / works;
+        if (!leader || productivity > leaderProductivity) {
+            leader = &candidate;
+            leaderProductivity = productivity;
+        }
+    }
+
+    const auto minResults =
+        static_cast<size_t>(internalQueryPlanEvaluationEarlyCutoffMinResults.load());
+    if (!leader || leader->results.size() < minResults) {
+        return false;
+    }
+
+    // Compare the leader against every other candidate with a two-proportion z-test. The ranking
+    // bonuses PlanRanker adds on top of productivity are far smaller than any difference which
+    // passes this test, so the leader is also the plan the ranker will pick.
+    const double leaderWorks = leader->root->getCommonStats()->works;
+    for (auto&& candidate : _candidates) {
+        if (&candidate == leader || candidate.failed) {
+            continue;
+        }
+
+        const double works = candidate.root->getCommonStats()->works;
+        if (works == 0) {
+            return false;
+        }
+
+        const double productivity = candidate.results.size() / works;
+        const double pooled = (leader->results.size() + candidate.results.size()) /
+            (leaderWorks + works);
+        const double stdErr = std::sqrt(pooled * (1 - pooled) * (1 / leaderWorks + 1 / works));
+        if (stdErr == 0 || (leaderProductivity - productivity) / stdErr < cutoffZScore) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
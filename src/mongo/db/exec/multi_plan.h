@@ -172,6 +172,13 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Returns true if the most productive candidate plan so far has returned enough results, and
+     * is ahead of every other candidate by a margin with a z-score of at least 'cutoffZScore'.
+     * The trial period then ends early instead of running the remaining works.
+     */
+    bool winnerIsClear(double cutoffZScore) const;
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
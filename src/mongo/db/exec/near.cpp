@@ -160,6 +160,12 @@ PlanStage::StageState NearStage::bufferNext(WorkingSetID* toReturn, Status* erro
         _nextIntervalStats->minDistanceAllowed = _nextInterval->minDistance;
         _nextIntervalStats->maxDistanceAllowed = _nextInterval->maxDistance;
         _nextIntervalStats->inclusiveMaxDistanceAllowed = _nextInterval->inclusiveMax;
+
+        if (!_nextInterval->covering) {
+            // Everything in this interval has already been buffered.
+            _searchState = SearchState_Advancing;
+            return PlanStage::NEED_TIME;
+        }
     }
 
     WorkingSetID nextMemberID;
@@ -287,7 +293,9 @@ unique_ptr<PlanStageStats> NearStage::getStats() {
     unique_ptr<PlanStageStats> ret = std::make_unique<PlanStageStats>(_commonStats, _stageType);
     ret->specific.reset(_specificStats.clone());
     for (size_t i = 0; i < _childrenIntervals.size(); ++i) {
-        ret->children.emplace_back(_childrenIntervals[i]->covering->getStats());
+        if (_childrenIntervals[i]->covering) {
+            ret->children.emplace_back(_childrenIntervals[i]->covering->getStats());
+        }
     }
     return ret;
 }
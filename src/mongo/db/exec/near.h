@@ -80,6 +80,10 @@ namespace mongo {
  * Also for efficient search, the intervals should not be too large or too small - though again
  * correctness does not depend on interval size.
  *
+ * An interval may have no covering stage when the covering of an earlier interval already returned
+ * every result in it. This lets a subclass scan several intervals at once while still returning
+ * their results one interval at a time.
+ *
  * The child stage may return duplicate documents, so it is the responsibility of NearStage to
  * deduplicate. Every document in _resultBuffer is kept track of in _seenDocuments. When a document
  * is returned, it is removed from _seenDocuments.
@@ -205,7 +209,9 @@ private:
 struct NearStage::CoveredInterval {
     CoveredInterval(PlanStage* covering, double minDistance, double maxDistance, bool inclusiveMax);
 
-    PlanStage* const covering;  // Owned in PlanStage::_children.
+    // Owned in PlanStage::_children. Null if the results of this interval were all buffered by the
+    // covering of an earlier interval.
+    PlanStage* const covering;
 
     const double minDistance;
     const double maxDistance;
@@ -125,7 +125,7 @@ boost::optional<BSONObj> PipelineProxyStage::getNextBson() {
         if (_includeMetaData) {
             return next->toBsonWithMetaData();
         } else {
-            return next->toBson();
+            return next->toBson(_sizeTracker);
         }
     }
 
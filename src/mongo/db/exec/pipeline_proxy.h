@@ -32,6 +32,7 @@
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional/optional.hpp>
 
+#include "mongo/bson/bsonmisc.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -101,6 +102,9 @@ protected:
 private:
     std::vector<BSONObj> _stash;
     WorkingSet* _ws;
+
+    // Sizes the BSON of each result after the results before it, which share its shape.
+    BSONSizeTracker _sizeTracker;
 };
 
 }  // namespace mongo
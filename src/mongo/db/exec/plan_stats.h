@@ -192,6 +192,13 @@ struct CollectionScanStats : public SpecificStats {
     // How many documents did we check against our filter?
     size_t docsTested;
 
+    // Whether the scan used the skip index of the collection, how many documents it read but did
+    // not test because the skip index showed they could not match, and how many blocks of records
+    // a forward scan seeked past.
+    bool usedSkipIndex = false;
+    size_t docsSkipped = 0;
+    size_t blocksSkipped = 0;
+
     // >0 if we're traversing the collection forwards. <0 if we're traversing it
     // backwards.
     int direction;
@@ -202,6 +209,27 @@ struct CollectionScanStats : public SpecificStats {
     boost::optional<Timestamp> maxTs;
 };
 
+struct ColumnScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        ColumnScanStats* specific = new ColumnScanStats(*this);
+        return specific;
+    }
+
+    std::string indexName;
+
+    BSONObj keyPattern;
+
+    // The paths of the columns read by the scan.
+    std::vector<std::string> columns;
+
+    // Number of column cells read, including those of the row column.
+    size_t keysExamined = 0;
+
+    // Number of documents fetched from the collection because a column could not describe the
+    // value of one of the needed fields, such as when an array lies along its path.
+    size_t docsFetched = 0;
+};
+
 struct CountStats : public SpecificStats {
     CountStats() : nCounted(0), nSkipped(0) {}
 
@@ -620,6 +648,13 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // Nonzero if only the 'topKLimit' documents with the highest text scores were returned.
+    size_t topKLimit = 0;
+
+    // Whether the score bounds of the unread index keys showed that none of them could reach the
+    // top k before every key was read.
+    bool stoppedEarly = false;
 };
 
 struct TrialStats : public SpecificStats {
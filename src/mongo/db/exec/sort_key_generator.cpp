@@ -43,6 +43,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/util/log.h"
@@ -82,7 +83,8 @@ PlanStage::StageState SortKeyGeneratorStage::doWork(WorkingSetID* out) {
                     member->getComputed(WSM_COMPUTED_TEXT_SCORE));
                 metadata.textScore = scoreData->getScore();
             }
-            sortKey = _sortKeyGen->getSortKey(member->obj.value(), &metadata);
+            sortKey = _sortKeyGen->getSortKey(
+                member->obj.value(), &metadata, OperationArena::get(getOpCtx()));
         } else {
             sortKey = getSortKeyFromIndexKey(*member);
         }
@@ -121,7 +123,7 @@ StatusWith<BSONObj> SortKeyGeneratorStage::getSortKeyFromIndexKey(
     invariant(member.getState() == WorkingSetMember::RID_AND_IDX);
     invariant(!_sortKeyGen->sortHasMeta());
 
-    BSONObjBuilder objBuilder;
+    BSONObjBuilder objBuilder(OperationArena::get(getOpCtx()));
     for (BSONElement specElt : _sortSpec) {
         invariant(specElt.isNumber());
         BSONElement sortKeyElt;
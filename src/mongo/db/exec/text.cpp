@@ -125,6 +125,9 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
             std::make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, collection);
 
         textScorer->addChildren(std::move(indexScanList));
+        if (_params.topKLimit) {
+            textScorer->setTopKLimit(_params.topKLimit, _params.query);
+        }
 
         textMatchStage = std::make_unique<TextMatchStage>(
             opCtx, std::move(textScorer), _params.query, _params.spec, ws);
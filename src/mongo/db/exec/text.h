@@ -64,6 +64,10 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If nonzero, only the 'topKLimit' documents with the highest text scores are needed. Only used
+    // when 'wantTextScore' is true.
+    size_t topKLimit = 0;
 };
 
 /**
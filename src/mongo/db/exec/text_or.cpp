@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
@@ -40,6 +42,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
+#include "mongo/db/fts/fts_index_format.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
 
@@ -49,7 +52,9 @@ using std::unique_ptr;
 using std::vector;
 using std::string;
 
+using fts::FTSIndexFormat;
 using fts::FTSSpec;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -75,6 +80,16 @@ void TextOrStage::addChildren(Children childrenToAdd) {
                      std::make_move_iterator(childrenToAdd.end()));
 }
 
+void TextOrStage::setTopKLimit(size_t limit, const FTSQueryImpl& query) {
+    invariant(limit > 0);
+    invariant(_internalState == State::kInit);
+
+    _specificStats.topKLimit = limit;
+    _topKMatcher = std::make_unique<FTSMatcher>(query, _ftsSpec);
+    _topKTerms = query.getTermsForBounds();
+    _childScoreBounds.assign(_children.size(), std::numeric_limits<double>::infinity());
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -175,6 +190,13 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     WorkingSetID id;
     StageState childState;
     if (_idRetrying == WorkingSet::INVALID_ID) {
+        if (_specificStats.topKLimit) {
+            if (topKComplete()) {
+                finishReadingTopK();
+                return PlanStage::NEED_TIME;
+            }
+            _currentChild = pickTopKChild();
+        }
         childState = _children[_currentChild]->work(&id);
     } else {
         childState = ADVANCED;
@@ -183,8 +205,14 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        return _specificStats.topKLimit ? addTopKCandidate(id, out) : addTerm(id, out);
     } else if (PlanStage::IS_EOF == childState) {
+        if (_specificStats.topKLimit) {
+            // None of the remaining documents contain this child's term.
+            _childScoreBounds[_currentChild] = boost::none;
+            return PlanStage::NEED_TIME;
+        }
+
         // Done with this child.
         ++_currentChild;
 
@@ -296,20 +324,139 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
+    double documentTermScore = FTSIndexFormat::getScoreFromIndexKey(_ftsSpec, newKeyData.keyData);
+
+    // Aggregate relevance score, term keys.
+    textRecordData->score += documentTermScore;
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addTopKCandidate(WorkingSetID wsid, WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    const IndexKeyDatum& keyDatum = wsm->keyData.back();
+    const RecordId recordId = wsm->recordId;
+
+    // Keys are read from each child in decreasing order of score.
+    _childScoreBounds[_currentChild] =
+        FTSIndexFormat::getScoreFromIndexKey(_ftsSpec, keyDatum.keyData);
+
+    if (_seenRecordIds.count(recordId)) {
+        // The document was scored in full the first time one of its keys was read.
+        _ws->free(wsid);
+        return NEED_TIME;
     }
 
-    keyIt.next();  // Skip past 'term'.
+    if (!Filter::passes(keyDatum.keyData, keyDatum.indexKeyPattern, _filter)) {
+        _seenRecordIds.insert(recordId);
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
 
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
+            _seenRecordIds.insert(recordId);
+            _ws->free(wsid);
+            return NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        wsm->makeObjOwnedIfNeeded();
+        _idRetrying = wsid;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
 
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
+    _seenRecordIds.insert(recordId);
+
+    // Documents which fail the phrases or negations of the query must not take a place in the top
+    // k, since the TEXT_MATCH stage above would discard them.
+    const BSONObj& obj = wsm->obj.value();
+    if (!_topKMatcher->matches(obj)) {
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    // The score of a document is the sum of the scores in its keys for the query terms, which are
+    // the scores the index computed from the document.
+    TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(obj, &termScores);
+    double score = 0;
+    for (auto&& term : _topKTerms) {
+        auto it = termScores.find(term);
+        if (it != termScores.end()) {
+            score += it->second;
+        }
+    }
+
+    const auto byScoreDescending = [](const TopKEntry& lhs, const TopKEntry& rhs) {
+        return lhs.score > rhs.score;
+    };
+    if (_topK.size() == _specificStats.topKLimit) {
+        if (score <= _topK.front().score) {
+            _ws->free(wsid);
+            return NEED_TIME;
+        }
+
+        std::pop_heap(_topK.begin(), _topK.end(), byScoreDescending);
+        _ws->free(_topK.back().wsid);
+        _topK.pop_back();
+    }
+
+    // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+    wsm->makeObjOwnedIfNeeded();
+    _topK.push_back({score, wsid});
+    std::push_heap(_topK.begin(), _topK.end(), byScoreDescending);
     return NEED_TIME;
 }
 
+size_t TextOrStage::pickTopKChild() const {
+    boost::optional<size_t> best;
+    for (size_t i = 0; i < _childScoreBounds.size(); ++i) {
+        if (_childScoreBounds[i] && (!best || *_childScoreBounds[i] > *_childScoreBounds[*best])) {
+            best = i;
+        }
+    }
+
+    invariant(best);
+    return *best;
+}
+
+bool TextOrStage::topKComplete() const {
+    bool childrenRemaining = false;
+    double remainingScoreBound = 0;
+    for (auto&& bound : _childScoreBounds) {
+        if (bound) {
+            childrenRemaining = true;
+            remainingScoreBound += *bound;
+        }
+    }
+
+    if (!childrenRemaining) {
+        return true;
+    }
+
+    // A document not seen yet can only score as high as the sum of the bounds of the children.
+    return _topK.size() == _specificStats.topKLimit && _topK.front().score >= remainingScoreBound;
+}
+
+void TextOrStage::finishReadingTopK() {
+    _specificStats.stoppedEarly =
+        std::any_of(_childScoreBounds.begin(),
+                    _childScoreBounds.end(),
+                    [](const boost::optional<double>& bound) { return bool(bound); });
+
+    for (auto&& entry : _topK) {
+        TextRecordData* textRecordData = &_scores[_ws->get(entry.wsid)->recordId];
+        textRecordData->wsid = entry.wsid;
+        textRecordData->score = entry.score;
+    }
+    _topK.clear();
+    _seenRecordIds.clear();
+
+    _scoreIterator = _scores.begin();
+    _internalState = State::kReturningResults;
+}
+
 }  // namespace mongo
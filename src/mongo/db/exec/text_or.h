@@ -29,15 +29,24 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/fts/fts_matcher.h"
+#include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
+using fts::FTSMatcher;
+using fts::FTSQueryImpl;
 using fts::FTSSpec;
 
 class OperationContext;
@@ -46,6 +55,12 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * If a top-k limit is set, only the documents with the k highest scores which match the text query
+ * are returned. Each child scans the keys of one term in decreasing order of score, so the score of
+ * the last key read from a child bounds the score that term adds to any document not yet seen. The
+ * stage reads from the child with the highest bound, scores each new document in full, and stops
+ * reading once the sum of the bounds can no longer beat the lowest of the k best scores so far.
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public RequiresCollectionStage {
@@ -77,6 +92,13 @@ public:
 
     void addChildren(Children childrenToAdd);
 
+    /**
+     * Makes this stage return only the 'limit' documents matching 'query' with the highest text
+     * scores. 'query' must be the query whose terms the children scan. Must be called after the
+     * children have been added and before the first call to work().
+     */
+    void setTopKLimit(size_t limit, const FTSQueryImpl& query);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -118,6 +140,28 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Helper called from readFromChildren in place of addTerm when there is a top-k limit. Scores
+     * the document of 'wsid' the first time it is seen, and keeps it if it is among the k highest
+     * scoring documents so far.
+     */
+    StageState addTopKCandidate(WorkingSetID wsid, WorkingSetID* out);
+
+    /**
+     * Returns the index of the child with the highest score bound which has not reached EOF.
+     */
+    size_t pickTopKChild() const;
+
+    /**
+     * Returns true if none of the index keys not yet read can add a document to the top k.
+     */
+    bool topKComplete() const;
+
+    /**
+     * Moves the top k documents into the score map so that they can be returned.
+     */
+    void finishReadingTopK();
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -152,6 +196,24 @@ private:
 
     TextOrStats _specificStats;
 
+    // State used only when there is a top-k limit. The matcher is set by setTopKLimit().
+    std::unique_ptr<FTSMatcher> _topKMatcher;
+    std::set<std::string> _topKTerms;
+
+    // The score of the last key read from each child, or +inf for a child which has not returned
+    // any keys yet. A child which has reached EOF has no bound.
+    std::vector<boost::optional<double>> _childScoreBounds;
+
+    // Every RecordId for which a key has been read, whether or not its document was kept.
+    stdx::unordered_set<RecordId, RecordId::Hasher> _seenRecordIds;
+
+    // A min-heap, by score, of the k highest scoring documents so far.
+    struct TopKEntry {
+        double score;
+        WorkingSetID wsid;
+    };
+    std::vector<TopKEntry> _topK;
+
     // Members needed only for using the TextMatchableDocument.
     const MatchExpression* _filter;
     WorkingSetID _idRetrying;
@@ -70,4 +70,35 @@ private:
     std::vector<std::uint8_t> _buffer;
 };
 
+/**
+ * Compresses and uncompresses a block of buffer using zstd. Used by the columnar metric chunks,
+ * where zstd both compresses better and decompresses faster than zlib.
+ */
+class ZstdBlockCompressor {
+    ZstdBlockCompressor(const ZstdBlockCompressor&) = delete;
+    ZstdBlockCompressor& operator=(const ZstdBlockCompressor&) = delete;
+
+public:
+    ZstdBlockCompressor() = default;
+
+    /**
+     * Compress a buffer of data.
+     *
+     * Returns a pointer to a buffer that ZstdBlockCompressor owns.
+     * The returned buffer is valid until the next call to compress or uncompress.
+     */
+    StatusWith<ConstDataRange> compress(ConstDataRange source);
+
+    /**
+     * Uncompress a buffer of data into exactly uncompressedLength bytes.
+     *
+     * Returns a pointer to a buffer that ZstdBlockCompressor owns.
+     * The returned buffer is valid until the next call to compress or uncompress.
+     */
+    StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t uncompressedLength);
+
+private:
+    std::vector<std::uint8_t> _buffer;
+};
+
 }  // namespace mongo
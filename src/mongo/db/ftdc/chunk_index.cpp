@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/chunk_index.h"
+
+#include <algorithm>
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_validated.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/ftdc/block_compressor.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+Status FTDCChunkIndex::addChunk(const BSONObj& referenceDoc,
+                                Date_t start,
+                                Date_t end,
+                                std::int64_t offset) {
+    std::vector<std::string> names;
+    Status status = FTDCBSONUtil::extractMetricNames(referenceDoc, &names);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Consecutive chunks usually share a schema, so search from the most recent one
+    auto it = std::find(_schemas.rbegin(), _schemas.rend(), names);
+    std::uint32_t schema = std::distance(_schemas.begin(), it.base()) - 1;
+    if (it == _schemas.rend()) {
+        schema = _schemas.size();
+        _schemas.emplace_back(std::move(names));
+    }
+
+    _chunks.push_back({start, end, offset, schema});
+
+    return Status::OK();
+}
+
+std::vector<FTDCChunkIndex::Chunk> FTDCChunkIndex::findChunks(StringData metric,
+                                                              Date_t start,
+                                                              Date_t end) const {
+    std::vector<bool> hasMetric;
+    hasMetric.reserve(_schemas.size());
+    for (const auto& names : _schemas) {
+        hasMetric.push_back(std::find(names.begin(), names.end(), metric) != names.end());
+    }
+
+    std::vector<Chunk> chunks;
+    for (const auto& chunk : _chunks) {
+        if (chunk.start <= end && chunk.end >= start && hasMetric[chunk.schema]) {
+            chunks.push_back(chunk);
+        }
+    }
+
+    return chunks;
+}
+
+void FTDCChunkIndex::clear() {
+    _chunks.clear();
+    _schemas.clear();
+}
+
+StatusWith<BSONObj> FTDCChunkIndex::toBSON(Date_t date) const {
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCIdField, date);
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCBSONUtil::FTDCType::kChunkIndex));
+
+    {
+        BSONArrayBuilder chunks(builder.subarrayStart(kFTDCChunksField));
+        for (const auto& chunk : _chunks) {
+            BSONObjBuilder chunkBuilder(chunks.subobjStart());
+            chunkBuilder.appendDate(kFTDCCollectStartField, chunk.start);
+            chunkBuilder.appendDate(kFTDCCollectEndField, chunk.end);
+            chunkBuilder.append(kFTDCOffsetField, static_cast<long long>(chunk.offset));
+            chunkBuilder.append(kFTDCSchemaField, static_cast<int>(chunk.schema));
+        }
+    }
+
+    // The metric names are long dotted paths that share prefixes, and compress well
+    BSONArrayBuilder schemas;
+    for (const auto& names : _schemas) {
+        BSONArrayBuilder namesBuilder(schemas.subarrayStart());
+        for (const auto& name : names) {
+            namesBuilder.append(name);
+        }
+    }
+    BSONArray schemasArray = schemas.arr();
+
+    ZstdBlockCompressor compressor;
+    auto swCompressed = compressor.compress(
+        ConstDataRange(schemasArray.objdata(), static_cast<size_t>(schemasArray.objsize())));
+    if (!swCompressed.isOK()) {
+        return swCompressed.getStatus();
+    }
+
+    BufBuilder schemasBuffer;
+    schemasBuffer.appendNum(static_cast<std::uint32_t>(schemasArray.objsize()));
+    schemasBuffer.appendBuf(swCompressed.getValue().data(), swCompressed.getValue().length());
+
+    builder.appendBinData(
+        kFTDCSchemasField, schemasBuffer.len(), BinDataType::BinDataGeneral, schemasBuffer.buf());
+
+    return builder.obj();
+}
+
+Status FTDCChunkIndex::parse(const BSONObj& doc) {
+    clear();
+
+    BSONElement schemasElement;
+    Status status =
+        bsonExtractTypedField(doc, kFTDCSchemasField, BSONType::BinData, &schemasElement);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    int length;
+    const char* buffer = schemasElement.binData(length);
+    ConstDataRangeCursor cdrc(buffer, buffer + length);
+
+    auto swUncompressedLength = cdrc.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+    if (!swUncompressedLength.isOK()) {
+        return swUncompressedLength.getStatus();
+    }
+
+    if (swUncompressedLength.getValue() > BSONObjMaxInternalSize) {
+        return {ErrorCodes::InvalidLength, "Chunk index schemas have exceeded the allowable size."};
+    }
+
+    ZstdBlockCompressor compressor;
+    auto swSchemasBuffer = compressor.uncompress(cdrc, swUncompressedLength.getValue());
+    if (!swSchemasBuffer.isOK()) {
+        return swSchemasBuffer.getStatus();
+    }
+
+    // The document is not part of any checksum so we must validate it is correct
+    auto swSchemas = swSchemasBuffer.getValue().readNoThrow<Validated<BSONObj>>();
+    if (!swSchemas.isOK()) {
+        return swSchemas.getStatus();
+    }
+
+    for (const auto& schema : swSchemas.getValue().val) {
+        if (schema.type() != Array) {
+            return {ErrorCodes::TypeMismatch, "Chunk index schema is not an array"};
+        }
+
+        std::vector<std::string> names;
+        for (const auto& name : schema.Obj()) {
+            if (name.type() != String) {
+                return {ErrorCodes::TypeMismatch, "Chunk index metric name is not a string"};
+            }
+
+            names.push_back(name.str());
+        }
+
+        _schemas.emplace_back(std::move(names));
+    }
+
+    BSONElement chunksElement;
+    status = bsonExtractTypedField(doc, kFTDCChunksField, BSONType::Array, &chunksElement);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    for (const auto& chunkElement : chunksElement.Obj()) {
+        if (chunkElement.type() != Object) {
+            return {ErrorCodes::TypeMismatch, "Chunk index entry is not an object"};
+        }
+
+        BSONObj chunkObj = chunkElement.Obj();
+        BSONElement start;
+        BSONElement end;
+        long long offset;
+        long long schema;
+
+        for (auto s : {bsonExtractTypedField(chunkObj, kFTDCCollectStartField, Date, &start),
+                       bsonExtractTypedField(chunkObj, kFTDCCollectEndField, Date, &end),
+                       bsonExtractIntegerField(chunkObj, kFTDCOffsetField, &offset),
+                       bsonExtractIntegerField(chunkObj, kFTDCSchemaField, &schema)}) {
+            if (!s.isOK()) {
+                return s;
+            }
+        }
+
+        if (offset < 0 || schema < 0 || static_cast<std::size_t>(schema) >= _schemas.size()) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Chunk index entry is not valid: " << chunkObj};
+        }
+
+        _chunks.push_back({start.Date(), end.Date(), offset, static_cast<std::uint32_t>(schema)});
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
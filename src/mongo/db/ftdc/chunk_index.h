@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * An index of the columnar metric chunks of a file by time range and metric name.
+ *
+ * FTDCFileWriter adds each columnar chunk it writes to the index, and when it closes the file
+ * appends the index as a BSON document followed by a fixed size locator document which holds the
+ * offset of the index. FTDCFileReader reads the locator from the end of the file to find the
+ * index, and then reads only the chunks which overlap a time range and hold a metric.
+ *
+ * The chunks of a file share a handful of schemas, so the index stores the metric names of each
+ * schema once, compressed, and each chunk refers to its schema by position.
+ *
+ * Example:
+ * {
+ *  "_id" : Date_t
+ *  "type" : 3
+ *  "chunks" : [ { "start" : Date_t, "end" : Date_t, "offset" : NumberLong, "schema" : 0 }, ... ]
+ *  "schemas" : BinData(...)
+ * }
+ */
+class FTDCChunkIndex {
+public:
+    struct Chunk {
+        // Dates of the first and last samples of the chunk
+        Date_t start;
+        Date_t end;
+
+        // Offset of the chunk document in the file
+        std::int64_t offset;
+
+        // Position of the metric names of the chunk in the schemas of the index
+        std::uint32_t schema;
+    };
+
+    /**
+     * Add a chunk whose samples have the schema of the reference document.
+     */
+    Status addChunk(const BSONObj& referenceDoc, Date_t start, Date_t end, std::int64_t offset);
+
+    /**
+     * Find the chunks which overlap the time range [start, end] and have the metric, in the order
+     * they were added. See FTDCBSONUtil::extractMetricNames for the names of metrics.
+     */
+    std::vector<Chunk> findChunks(StringData metric, Date_t start, Date_t end) const;
+
+    const std::vector<Chunk>& getChunks() const {
+        return _chunks;
+    }
+
+    bool empty() const {
+        return _chunks.empty();
+    }
+
+    void clear();
+
+    /**
+     * Create the index document for storage. For the _id field, the date is specified by the
+     * caller.
+     */
+    StatusWith<BSONObj> toBSON(Date_t date) const;
+
+    /**
+     * Replace the contents of the index with an index document read from storage.
+     */
+    Status parse(const BSONObj& doc);
+
+private:
+    std::vector<Chunk> _chunks;
+
+    // Metric names of each distinct schema
+    std::vector<std::vector<std::string>> _schemas;
+};
+
+}  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/ftdc/compressor.h"
 
 #include "mongo/base/data_builder.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -43,6 +44,22 @@ namespace mongo {
 
 using std::swap;
 
+namespace {
+
+/**
+ * Write a run of zeroes as the pair (0, count - 1).
+ */
+Status writeZeroesRun(DataBuilder* db, std::uint32_t zeroesCount) {
+    auto s1 = db->writeAndAdvance(FTDCVarInt(0));
+    if (!s1.isOK()) {
+        return s1;
+    }
+
+    return db->writeAndAdvance(FTDCVarInt(zeroesCount - 1));
+}
+
+}  // namespace
+
 StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
 FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     if (_referenceDoc.isEmpty()) {
@@ -117,6 +134,10 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
 }
 
 StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamples() {
+    if (_config->formatVersion == FTDCConfig::kFormatVersionColumnar) {
+        return _getCompressedColumnarSamples();
+    }
+
     _uncompressedChunkBuffer.setlen(0);
 
     // Append reference document - BSON Object
@@ -218,6 +239,104 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         _referenceDocDate);
 }
 
+StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::_getCompressedColumnarSamples() {
+    _compressedChunkBuffer.setlen(0);
+
+    // Append reference document - uint32 uncompressed length, uint32 compressed length, and the
+    // BSON Object compressed on its own so readers can learn the schema without inflating blocks
+    auto swRef = _zstdCompressor.compress(
+        ConstDataRange(_referenceDoc.objdata(), static_cast<size_t>(_referenceDoc.objsize())));
+    if (!swRef.isOK()) {
+        return swRef.getStatus();
+    }
+
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_referenceDoc.objsize()));
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(swRef.getValue().length()));
+    _compressedChunkBuffer.appendBuf(swRef.getValue().data(), swRef.getValue().length());
+
+    std::uint32_t blockCount = (_deltaCount == 0)
+        ? 0
+        : (_metricsCount + kMetricsPerColumnBlock - 1) / kMetricsPerColumnBlock;
+
+    // Append counts of metrics, samples, metrics per block and blocks - uint32 little endian
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_metricsCount));
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(kMetricsPerColumnBlock));
+    _compressedChunkBuffer.appendNum(blockCount);
+
+    // Reserve the table of uncompressed and compressed lengths of the blocks, filled in as each
+    // block is compressed.
+    const int blockTableOffset = _compressedChunkBuffer.len();
+    _compressedChunkBuffer.skip(blockCount * 2 * sizeof(std::uint32_t));
+
+    for (std::uint32_t block = 0; block < blockCount; ++block) {
+        const std::uint32_t firstMetric = block * kMetricsPerColumnBlock;
+        const std::uint32_t lastMetric =
+            std::min(firstMetric + kMetricsPerColumnBlock, _metricsCount);
+
+        DataBuilder db((lastMetric - firstMetric) * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
+
+        for (std::uint32_t i = firstMetric; i < lastMetric; i++) {
+            std::uint32_t zeroesCount = 0;
+            std::uint64_t prevDelta = 0;
+
+            for (std::uint32_t j = 0; j < _deltaCount; j++) {
+                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+                std::uint64_t value = zigZagEncode(static_cast<std::int64_t>(delta - prevDelta));
+                prevDelta = delta;
+
+                if (value == 0) {
+                    ++zeroesCount;
+                    continue;
+                }
+
+                if (zeroesCount > 0) {
+                    auto s = writeZeroesRun(&db, zeroesCount);
+                    if (!s.isOK()) {
+                        return s;
+                    }
+
+                    zeroesCount = 0;
+                }
+
+                auto s = db.writeAndAdvance(FTDCVarInt(value));
+                if (!s.isOK()) {
+                    return s;
+                }
+            }
+
+            // Unlike the row format, a run of zeroes never spans two metrics so that each metric
+            // can be decoded without the metrics before it.
+            if (zeroesCount > 0) {
+                auto s = writeZeroesRun(&db, zeroesCount);
+                if (!s.isOK()) {
+                    return s;
+                }
+            }
+        }
+
+        ConstDataRange cdr = db.getCursor();
+
+        auto swBlock = _zstdCompressor.compress(cdr);
+        if (!swBlock.isOK()) {
+            return swBlock.getStatus();
+        }
+
+        char* lengths = _compressedChunkBuffer.buf() + blockTableOffset +
+            block * 2 * sizeof(std::uint32_t);
+        DataView(lengths).write<LittleEndian<std::uint32_t>>(cdr.length());
+        DataView(lengths).write<LittleEndian<std::uint32_t>>(swBlock.getValue().length(),
+                                                             sizeof(std::uint32_t));
+
+        _compressedChunkBuffer.appendBuf(swBlock.getValue().data(), swBlock.getValue().length());
+    }
+
+    return std::tuple<ConstDataRange, Date_t>(
+        ConstDataRange(_compressedChunkBuffer.buf(),
+                       static_cast<size_t>(_compressedChunkBuffer.len())),
+        _referenceDocDate);
+}
+
 void FTDCCompressor::reset() {
     _metrics.clear();
     _reset(BSONObj(), Date_t());
@@ -58,6 +58,15 @@ namespace mongo {
  *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
+ *
+ * Columnar Compression Method (FTDCConfig::formatVersion 2)
+ * 1. Deltas are computed as above, and each metric stores the difference between consecutive
+ *    deltas (delta-of-delta), which is zero for counters that grow at a steady rate.
+ * 2. Each delta-of-delta is ZigZag encoded so small negative numbers stay small, then VarInt
+ *    compressed, with zeros Run Length Encoded per metric.
+ * 3. The metrics are split into blocks of kMetricsPerColumnBlock consecutive metrics, and each
+ *    block is compressed with zstd on its own, so a reader can inflate only the blocks holding the
+ *    metrics it wants.
  */
 class FTDCCompressor {
     FTDCCompressor(const FTDCCompressor&) = delete;
@@ -120,6 +129,14 @@ public:
         return !_referenceDoc.isEmpty();
     }
 
+    /**
+     * Get the reference document of the samples in the compressor, the schema of the chunk
+     * getCompressedSamples returns.
+     */
+    const BSONObj& getReferenceDocument() const {
+        return _referenceDoc;
+    }
+
     /**
      * Gets buffer of compressed data contained in the FTDCCompressor.
      *
@@ -144,16 +161,40 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * ZigZag encode a signed integer so that integers of small magnitude have small encodings.
+     */
+    static std::uint64_t zigZagEncode(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    static std::int64_t zigZagDecode(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    /**
+     * Number of metrics compressed together in a block of a columnar chunk.
+     */
+    static constexpr std::uint32_t kMetricsPerColumnBlock = 64;
+
 private:
     /**
      * Reset the state
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Gets buffer of compressed data in the columnar format.
+     */
+    StatusWith<std::tuple<ConstDataRange, Date_t>> _getCompressedColumnarSamples();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
 
+    // Block Compressor for columnar chunks
+    ZstdBlockCompressor _zstdCompressor;
+
     // Config
     const FTDCConfig* const _config;
 
@@ -32,6 +32,7 @@
 #include <limits>
 #include <random>
 
+#include "mongo/base/data_view.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -128,8 +129,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            std::uint32_t formatVersion = FTDCConfig::kFormatVersionDefault)
+        : _compressor(&_config), _mode(mode) {
+        _config.formatVersion = formatVersion;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -161,13 +165,13 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = uncompress(cdr.get());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = uncompress(std::get<0>(swBuf.getValue()));
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -176,6 +180,15 @@ public:
         ValidateDocumentList(list, _docs, _mode);
     }
 
+private:
+    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange cdr) {
+        if (_config.formatVersion == FTDCConfig::kFormatVersionColumnar) {
+            return _decompressor.uncompressColumnar(cdr);
+        }
+
+        return _decompressor.uncompress(cdr);
+    }
+
 private:
     std::vector<BSONObj> _docs;
     FTDCConfig _config;
@@ -650,4 +663,166 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test zigzag encoding of delta-of-deltas
+TEST_F(FTDCCompressorTest, TestZigZag) {
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(0), 0ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(-1), 1ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(1), 2ULL);
+    ASSERT_EQUALS(FTDCCompressor::zigZagEncode(-2), 3ULL);
+
+    for (std::int64_t value : {std::numeric_limits<std::int64_t>::min(),
+                               std::numeric_limits<std::int64_t>::min() + 1,
+                               std::int64_t{-1000},
+                               std::int64_t{1000},
+                               std::numeric_limits<std::int64_t>::max()}) {
+        ASSERT_EQUALS(FTDCCompressor::zigZagDecode(FTDCCompressor::zigZagEncode(value)), value);
+    }
+}
+
+// Test the columnar format with schema changes, counters, gauges and timestamps
+TEST_F(FTDCCompressorTest, TestColumnarSchemaChanges) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCConfig::kFormatVersionColumnar);
+
+    for (int i = 0; i < 20; i++) {
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "counter"
+                                   << 1000 + i * 7
+                                   << "gauge"
+                                   << (i % 3) - 1
+                                   << "nested"
+                                   << BSON("ts" << Timestamp(100 + i, i % 2) << "d"
+                                                << Date_t::fromMillisSinceEpoch(i * 1000))));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    // Add Value
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "counter"
+                               << 1140
+                               << "gauge"
+                               << -5
+                               << "key3"
+                               << 47));
+    ASSERT_SCHEMA_CHANGED(st);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "counter"
+                          << std::numeric_limits<int>::min()
+                          << "gauge"
+                          << std::numeric_limits<int>::max()
+                          << "key3"
+                          << 47));
+    ASSERT_HAS_SPACE(st);
+}
+
+// Test the columnar format with many metrics, which span several blocks
+TEST_F(FTDCCompressorTest, TestColumnarManyMetrics) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::uniform_int_distribution<long long> genValues(1, std::numeric_limits<long long>::max());
+    const size_t metrics = 1000;
+
+    TestTie c(FTDCValidationMode::kStrict, FTDCConfig::kFormatVersionColumnar);
+
+    auto st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(generateSample(rd, genValues, metrics));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_FULL(st);
+
+    // Add Value
+    st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_HAS_SPACE(st);
+}
+
+// Test inflating only some metrics of a columnar chunk
+TEST_F(FTDCCompressorTest, TestColumnarSelectedMetrics) {
+    FTDCConfig config;
+    config.formatVersion = FTDCConfig::kFormatVersionColumnar;
+    FTDCCompressor c(&config);
+
+    const int samples = 50;
+    for (int i = 0; i < samples; i++) {
+        BSONObjBuilder builder;
+        builder.append("name", "joe");
+        builder.append("ts", Timestamp(1000 + i, 5));
+        {
+            BSONObjBuilder sub(builder.subobjStart("sub"));
+            for (int k = 0; k < 200; k++) {
+                sub.append(std::to_string(k), static_cast<long long>(k * i));
+            }
+        }
+
+        auto st = c.addSample(builder.obj(), Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+
+    FTDCDecompressor d;
+    auto sw = d.uncompressColumnarMetrics(std::get<0>(swBuf.getValue()),
+                                          {"sub.150", "missing", "ts.t", "sub.3", "sub.150"});
+    ASSERT_OK(sw.getStatus());
+
+    const auto& columns = sw.getValue();
+    ASSERT_EQUALS(columns.size(), 5UL);
+    ASSERT_TRUE(columns[1].empty());
+
+    for (auto column : {0, 2, 3, 4}) {
+        ASSERT_EQUALS(columns[column].size(), static_cast<size_t>(samples));
+    }
+
+    for (int i = 0; i < samples; i++) {
+        ASSERT_EQUALS(columns[0][i], static_cast<std::uint64_t>(150 * i));
+        ASSERT_EQUALS(columns[2][i], static_cast<std::uint64_t>(1000 + i));
+        ASSERT_EQUALS(columns[3][i], static_cast<std::uint64_t>(3 * i));
+        ASSERT_EQUALS(columns[4][i], columns[0][i]);
+    }
+}
+
+// Test a columnar chunk whose block claims an oversized uncompressed length is rejected
+TEST_F(FTDCCompressorTest, TestColumnarOversizedBlock) {
+    FTDCConfig config;
+    config.formatVersion = FTDCConfig::kFormatVersionColumnar;
+    FTDCCompressor c(&config);
+
+    for (int i = 0; i < 10; i++) {
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "key1" << i << "key2" << 2 * i),
+                              Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+
+    const ConstDataRange& cdr = std::get<0>(swBuf.getValue());
+    std::vector<char> buf(cdr.data(), cdr.data() + cdr.length());
+
+    // The reference document lengths and the four counts precede the table of block lengths
+    const auto refCompressedLength =
+        ConstDataView(buf.data() + sizeof(std::uint32_t)).read<LittleEndian<std::uint32_t>>();
+    const std::size_t firstBlockOffset =
+        2 * sizeof(std::uint32_t) + refCompressedLength + 4 * sizeof(std::uint32_t);
+    ASSERT_LT(firstBlockOffset, buf.size());
+
+    DataView(buf.data() + firstBlockOffset)
+        .write<LittleEndian<std::uint32_t>>(std::numeric_limits<std::uint32_t>::max());
+
+    FTDCDecompressor d;
+    ASSERT_EQUALS(d.uncompressColumnar(ConstDataRange(buf.data(), buf.size())).getStatus(),
+                  ErrorCodes::InvalidLength);
+}
+
 }  // namespace mongo
@@ -47,7 +47,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          formatVersion(kFormatVersionDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +85,14 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Format of the metric chunks written to new files.
+     *  1. Row oriented chunks, delta encoded and compressed with zlib.
+     *  2. Columnar chunks, delta-of-delta encoded and compressed with zstd in blocks of metrics,
+     *     with an index of the chunks at the end of each archive file.
+     */
+    std::uint32_t formatVersion;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -94,6 +103,9 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const std::uint32_t kFormatVersionDefault = 1;
+    static const std::uint32_t kFormatVersionColumnar = 2;
 };
 
 }  // namespace mongo
@@ -47,6 +47,11 @@ extern const char kFTDCDocsField[];
 extern const char kFTDCCollectStartField[];
 extern const char kFTDCCollectEndField[];
 
+extern const char kFTDCChunksField[];
+extern const char kFTDCSchemasField[];
+extern const char kFTDCSchemaField[];
+extern const char kFTDCOffsetField[];
+
 constexpr StringData kFTDCDefaultDirectory = "diagnostic.data"_sd;
 
 }  // namespace mongo
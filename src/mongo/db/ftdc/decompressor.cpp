@@ -31,6 +31,8 @@
 
 #include "mongo/db/ftdc/decompressor.h"
 
+#include <algorithm>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_validated.h"
 #include "mongo/db/ftdc/compressor.h"
@@ -42,6 +44,251 @@
 
 namespace mongo {
 
+namespace {
+
+/**
+ * The header of a columnar chunk of metrics, and the ranges of its compressed blocks.
+ */
+struct ColumnarChunk {
+    // Owned reference document
+    BSONObj ref;
+
+    // Metrics of the reference document, the first value of each metric
+    std::vector<std::uint64_t> refMetrics;
+
+    std::uint32_t sampleCount{0};
+
+    std::uint32_t metricsPerBlock{0};
+
+    // Uncompressed length and compressed range of each block
+    std::vector<std::pair<std::uint32_t, ConstDataRange>> blocks;
+};
+
+Status readUInt32(ConstDataRangeCursor* cdrc, std::uint32_t* value) {
+    auto swValue = cdrc->readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+    if (!swValue.isOK()) {
+        return swValue.getStatus();
+    }
+
+    *value = swValue.getValue();
+    return Status::OK();
+}
+
+StatusWith<ColumnarChunk> readColumnarChunk(ConstDataRange buf, ZstdBlockCompressor* compressor) {
+    ConstDataRangeCursor cdrc(buf);
+    ColumnarChunk chunk;
+
+    // Read the lengths of the uncompressed and compressed reference document
+    std::uint32_t refLength;
+    std::uint32_t refCompressedLength;
+    for (auto length : {&refLength, &refCompressedLength}) {
+        Status status = readUInt32(&cdrc, length);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (refLength > 10000000) {
+        return Status(ErrorCodes::InvalidLength, "Metrics chunk has exceeded the allowable size.");
+    }
+
+    if (refCompressedLength > cdrc.length()) {
+        return Status(ErrorCodes::InvalidLength, "Metrics chunk is too short.");
+    }
+
+    auto swRefBuffer =
+        compressor->uncompress(ConstDataRange(cdrc.data(), refCompressedLength), refLength);
+    if (!swRefBuffer.isOK()) {
+        return swRefBuffer.getStatus();
+    }
+
+    // The document is not part of any checksum so we must validate it is correct
+    auto swRef = ConstDataRangeCursor(swRefBuffer.getValue()).readNoThrow<Validated<BSONObj>>();
+    if (!swRef.isOK()) {
+        return swRef.getStatus();
+    }
+
+    // The compressor owns the buffer, and will reuse it for the blocks
+    chunk.ref = swRef.getValue().val.getOwned();
+
+    Status advanced = cdrc.advanceNoThrow(refCompressedLength);
+    if (!advanced.isOK()) {
+        return advanced;
+    }
+
+    // Read counts of metrics, samples, metrics per block and blocks
+    std::uint32_t metricsCount;
+    std::uint32_t blockCount;
+    for (auto count : {&metricsCount, &chunk.sampleCount, &chunk.metricsPerBlock, &blockCount}) {
+        Status status = readUInt32(&cdrc, count);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    // Limit size of the buffer we need for metrics and samples
+    if (static_cast<std::uint64_t>(metricsCount) * chunk.sampleCount > 1000000) {
+        return Status(ErrorCodes::InvalidLength,
+                      "Metrics Count and Sample Count have exceeded the allowable range.");
+    }
+
+    if (chunk.metricsPerBlock == 0 ||
+        blockCount != (chunk.sampleCount == 0
+                           ? 0
+                           : (metricsCount + chunk.metricsPerBlock - 1) / chunk.metricsPerBlock)) {
+        return {ErrorCodes::BadValue,
+                "The block count of the columnar chunk does not match its metrics count"};
+    }
+
+    chunk.refMetrics.reserve(metricsCount);
+
+    // We pass the reference document as both the reference document and current document as we only
+    // want the array of metrics.
+    (void)FTDCBSONUtil::extractMetricsFromDocument(chunk.ref, chunk.ref, &chunk.refMetrics);
+
+    if (chunk.refMetrics.size() != metricsCount) {
+        return {ErrorCodes::BadValue,
+                "The metrics in the reference document and metrics count do not match"};
+    }
+
+    // Read the table of block lengths, the blocks follow it
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> lengths(blockCount);
+    for (auto& length : lengths) {
+        for (auto value : {&length.first, &length.second}) {
+            Status status = readUInt32(&cdrc, value);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    chunk.blocks.reserve(blockCount);
+    for (const auto& length : lengths) {
+        if (length.first > 10000000) {
+            return Status(ErrorCodes::InvalidLength,
+                          "Metrics chunk has exceeded the allowable size.");
+        }
+
+        if (length.second > cdrc.length()) {
+            return Status(ErrorCodes::InvalidLength, "Metrics chunk is too short.");
+        }
+
+        chunk.blocks.emplace_back(length.first, ConstDataRange(cdrc.data(), length.second));
+        cdrc.advance(length.second);
+    }
+
+    return {std::move(chunk)};
+}
+
+/**
+ * Inflates the metrics at the given indexes of a columnar chunk, decompressing only the blocks
+ * which hold them.
+ */
+StatusWith<std::vector<std::vector<std::uint64_t>>> inflateColumns(
+    const ColumnarChunk& chunk,
+    const std::vector<std::size_t>& indexes,
+    ZstdBlockCompressor* compressor) {
+    const std::size_t metricsCount = chunk.refMetrics.size();
+
+    std::vector<std::vector<std::uint64_t>> columns(indexes.size());
+
+    // The column each metric is inflated into, or -1 if it is not wanted
+    std::vector<std::int64_t> columnOf(metricsCount, -1);
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+        if (columnOf[indexes[k]] == -1) {
+            columnOf[indexes[k]] = k;
+        }
+    }
+
+    for (std::size_t block = 0; block < chunk.blocks.size(); ++block) {
+        const std::size_t firstMetric = block * chunk.metricsPerBlock;
+        const std::size_t lastMetric = std::min(firstMetric + chunk.metricsPerBlock, metricsCount);
+
+        if (std::all_of(columnOf.begin() + firstMetric,
+                        columnOf.begin() + lastMetric,
+                        [](std::int64_t column) { return column == -1; })) {
+            continue;
+        }
+
+        const auto& compressedBlock = chunk.blocks[block];
+        auto swBlock = compressor->uncompress(compressedBlock.second, compressedBlock.first);
+        if (!swBlock.isOK()) {
+            return swBlock.getStatus();
+        }
+
+        auto cdrc = ConstDataRangeCursor(swBlock.getValue());
+
+        // Each metric is a run of delta-of-deltas which ends with the metric, so every metric of
+        // the block is read to reach the next one.
+        for (std::size_t i = firstMetric; i < lastMetric; i++) {
+            std::vector<std::uint64_t>* column =
+                (columnOf[i] == -1) ? nullptr : &columns[columnOf[i]];
+            if (column) {
+                column->reserve(1 + chunk.sampleCount);
+                column->push_back(chunk.refMetrics[i]);
+            }
+
+            std::uint64_t value = chunk.refMetrics[i];
+            std::uint64_t delta = 0;
+            std::uint64_t zeroesCount = 0;
+
+            for (std::uint32_t j = 0; j < chunk.sampleCount; j++) {
+                std::uint64_t encoded = 0;
+
+                if (zeroesCount) {
+                    zeroesCount--;
+                } else {
+                    auto swEncoded = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                    if (!swEncoded.isOK()) {
+                        return swEncoded.getStatus();
+                    }
+
+                    encoded = swEncoded.getValue();
+
+                    if (encoded == 0) {
+                        auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                        if (!swZero.isOK()) {
+                            return swZero.getStatus();
+                        }
+
+                        zeroesCount = swZero.getValue();
+                    }
+                }
+
+                delta += static_cast<std::uint64_t>(FTDCCompressor::zigZagDecode(encoded));
+                value += delta;
+
+                if (column) {
+                    column->push_back(value);
+                }
+            }
+
+            if (zeroesCount) {
+                return {ErrorCodes::BadValue,
+                        "A run of zeroes spans two metrics of a columnar metrics chunk"};
+            }
+        }
+    }
+
+    // Metrics which were asked for more than once
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+        if (columnOf[indexes[k]] != static_cast<std::int64_t>(k)) {
+            columns[k] = columns[columnOf[indexes[k]]];
+        }
+    }
+
+    // Chunks without samples have no blocks
+    if (chunk.sampleCount == 0) {
+        for (std::size_t k = 0; k < indexes.size(); ++k) {
+            columns[k] = {chunk.refMetrics[indexes[k]]};
+        }
+    }
+
+    return {std::move(columns)};
+}
+
+}  // namespace
+
 StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
     ConstDataRangeCursor compressedDataRange(buf);
 
@@ -182,4 +429,84 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     return {docs};
 }
 
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompressColumnar(ConstDataRange buf) {
+    auto swChunk = readColumnarChunk(buf, &_zstdCompressor);
+    if (!swChunk.isOK()) {
+        return swChunk.getStatus();
+    }
+
+    const ColumnarChunk& chunk = swChunk.getValue();
+
+    std::vector<std::size_t> indexes(chunk.refMetrics.size());
+    for (std::size_t i = 0; i < indexes.size(); ++i) {
+        indexes[i] = i;
+    }
+
+    auto swColumns = inflateColumns(chunk, indexes, &_zstdCompressor);
+    if (!swColumns.isOK()) {
+        return swColumns.getStatus();
+    }
+
+    const auto& columns = swColumns.getValue();
+
+    std::vector<BSONObj> docs;
+
+    // Allocate space for the reference document + samples
+    docs.reserve(1 + chunk.sampleCount);
+
+    docs.emplace_back(chunk.ref);
+
+    std::vector<std::uint64_t> metrics(columns.size());
+
+    for (std::uint32_t j = 1; j <= chunk.sampleCount; ++j) {
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            metrics[i] = columns[i][j];
+        }
+
+        docs.emplace_back(
+            FTDCBSONUtil::constructDocumentFromMetrics(chunk.ref, metrics).getValue());
+    }
+
+    return {docs};
+}
+
+StatusWith<std::vector<std::vector<std::uint64_t>>> FTDCDecompressor::uncompressColumnarMetrics(
+    ConstDataRange buf, const std::vector<std::string>& names) {
+    auto swChunk = readColumnarChunk(buf, &_zstdCompressor);
+    if (!swChunk.isOK()) {
+        return swChunk.getStatus();
+    }
+
+    const ColumnarChunk& chunk = swChunk.getValue();
+
+    std::vector<std::string> metricNames;
+    Status status = FTDCBSONUtil::extractMetricNames(chunk.ref, &metricNames);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Inflate the metrics which are in the chunk, and leave the others empty
+    std::vector<std::size_t> indexes;
+    std::vector<std::size_t> positions;
+    for (std::size_t k = 0; k < names.size(); ++k) {
+        auto it = std::find(metricNames.begin(), metricNames.end(), names[k]);
+        if (it != metricNames.end()) {
+            indexes.push_back(it - metricNames.begin());
+            positions.push_back(k);
+        }
+    }
+
+    auto swColumns = inflateColumns(chunk, indexes, &_zstdCompressor);
+    if (!swColumns.isOK()) {
+        return swColumns.getStatus();
+    }
+
+    std::vector<std::vector<std::uint64_t>> columns(names.size());
+    for (std::size_t k = 0; k < positions.size(); ++k) {
+        columns[positions[k]] = std::move(swColumns.getValue()[k]);
+    }
+
+    return {std::move(columns)};
+}
+
 }  // namespace mongo
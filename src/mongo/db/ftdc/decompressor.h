@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "mongo/base/data_range.h"
@@ -57,8 +58,28 @@ public:
      */
     StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
 
+    /**
+     * Inflates a compressed columnar chunk of metrics into a vector of owned BSON documents.
+     *
+     * Returns N samples where N = sample count + 1. The 1 is the reference document.
+     */
+    StatusWith<std::vector<BSONObj>> uncompressColumnar(ConstDataRange buf);
+
+    /**
+     * Inflates only the named metrics of a compressed columnar chunk of metrics. Only the blocks
+     * holding the named metrics are decompressed.
+     *
+     * Returns a vector of sample count + 1 values for each name, in the order of the names, or an
+     * empty vector for names that are not metrics of the chunk. See
+     * FTDCBSONUtil::extractMetricNames for the names of the metrics of a document.
+     */
+    StatusWith<std::vector<std::vector<std::uint64_t>>> uncompressColumnarMetrics(
+        ConstDataRange buf, const std::vector<std::string>& names);
+
 private:
     BlockCompressor _compressor;
+
+    ZstdBlockCompressor _zstdCompressor;
 };
 
 }  // namespace mongo
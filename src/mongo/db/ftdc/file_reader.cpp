@@ -31,6 +31,7 @@
 
 #include "mongo/db/ftdc/file_reader.h"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <fstream>
 
@@ -38,6 +39,7 @@
 #include "mongo/base/data_type_validated.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/rpc/object_check.h"
@@ -82,6 +84,12 @@ StatusWith<bool> FTDCFileReader::hasNext() {
 
             FTDCBSONUtil::FTDCType type = swType.getValue();
 
+            // The chunk index and its locator only describe the metric chunks
+            if (type == FTDCBSONUtil::FTDCType::kChunkIndex ||
+                type == FTDCBSONUtil::FTDCType::kChunkIndexLocator) {
+                continue;
+            }
+
             if (type == FTDCBSONUtil::FTDCType::kMetadata) {
                 _state = State::kMetadataDoc;
 
@@ -91,7 +99,8 @@ StatusWith<bool> FTDCFileReader::hasNext() {
                 }
 
                 _metadata = swMetadata.getValue();
-            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk) {
+            } else if (type == FTDCBSONUtil::FTDCType::kMetricChunk ||
+                       type == FTDCBSONUtil::FTDCType::kColumnarMetricChunk) {
                 _state = State::kMetricChunk;
 
                 auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(_parent, &_decompressor);
@@ -210,6 +219,282 @@ StatusWith<BSONObj> FTDCFileReader::readDocument() {
     return {swl.getValue().val};
 }
 
+Status FTDCFileReader::seek(std::size_t offset) {
+    // Reading up to the end of the file sets eofbit, which must be cleared to seek
+    _stream.clear();
+    _stream.seekg(offset);
+
+    if (_stream.fail()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to seek to offset " << offset << " in file \""
+                              << _file.generic_string()
+                              << "\""};
+    }
+
+    return Status::OK();
+}
+
+StatusWith<bool> FTDCFileReader::readChunkIndex(FTDCChunkIndex* index) {
+    if (_fileSize < FTDCBSONUtil::kChunkIndexLocatorSize) {
+        return {false};
+    }
+
+    Status s = seek(_fileSize - FTDCBSONUtil::kChunkIndexLocatorSize);
+    if (!s.isOK()) {
+        return s;
+    }
+
+    char buf[FTDCBSONUtil::kChunkIndexLocatorSize];
+
+    _stream.read(buf, sizeof(buf));
+
+    if (sizeof(buf) != _stream.gcount()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read " << sizeof(buf) << " bytes from file \""
+                              << _file.generic_string()
+                              << "\""};
+    }
+
+    // Files without a chunk index end with the tail of some other document instead
+    if (ConstDataView(buf).read<LittleEndian<std::int32_t>>() != sizeof(buf)) {
+        return {false};
+    }
+
+    auto swLocator = ConstDataRange(buf, buf + sizeof(buf)).readNoThrow<Validated<BSONObj>>();
+    if (!swLocator.isOK()) {
+        return {false};
+    }
+
+    const BSONObj& locator = swLocator.getValue().val;
+
+    auto swType = FTDCBSONUtil::getBSONDocumentType(locator);
+    if (!swType.isOK() || swType.getValue() != FTDCBSONUtil::FTDCType::kChunkIndexLocator) {
+        return {false};
+    }
+
+    auto swOffset = FTDCBSONUtil::getChunkIndexOffsetFromLocatorDoc(locator);
+    if (!swOffset.isOK()) {
+        return swOffset.getStatus();
+    }
+
+    if (static_cast<std::size_t>(swOffset.getValue()) >= _fileSize) {
+        return {ErrorCodes::InvalidLength,
+                str::stream() << "Invalid chunk index offset found in file \""
+                              << _file.generic_string()
+                              << "\""};
+    }
+
+    s = seek(swOffset.getValue());
+    if (!s.isOK()) {
+        return s;
+    }
+
+    auto swDoc = readDocument();
+    if (!swDoc.isOK()) {
+        return swDoc.getStatus();
+    }
+
+    swType = FTDCBSONUtil::getBSONDocumentType(swDoc.getValue());
+    if (!swType.isOK()) {
+        return swType.getStatus();
+    }
+
+    if (swType.getValue() != FTDCBSONUtil::FTDCType::kChunkIndex) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Chunk index locator does not point to a chunk index in file \""
+                              << _file.generic_string()
+                              << "\""};
+    }
+
+    s = index->parse(swDoc.getValue());
+    if (!s.isOK()) {
+        return s;
+    }
+
+    return {true};
+}
+
+Status FTDCFileReader::readMetricFromChunk(const BSONObj& chunk,
+                                           StringData metric,
+                                           Date_t start,
+                                           Date_t end,
+                                           std::vector<std::pair<Date_t, std::uint64_t>>* values) {
+    auto swType = FTDCBSONUtil::getBSONDocumentType(chunk);
+    if (!swType.isOK()) {
+        return swType.getStatus();
+    }
+
+    // The "start" dates and the values of the metric in each sample of the chunk
+    std::vector<std::uint64_t> dates;
+    std::vector<std::uint64_t> metricValues;
+
+    if (swType.getValue() == FTDCBSONUtil::FTDCType::kColumnarMetricChunk) {
+        auto swStart = FTDCBSONUtil::getBSONDocumentId(chunk);
+        if (!swStart.isOK()) {
+            return swStart.getStatus();
+        }
+
+        auto swEnd = FTDCBSONUtil::getBSONDocumentEnd(chunk);
+        if (!swEnd.isOK()) {
+            return swEnd.getStatus();
+        }
+
+        // Skip chunks outside of the time range without decompressing them
+        if (swStart.getValue() > end || swEnd.getValue() < start) {
+            return Status::OK();
+        }
+
+        auto swChunk = FTDCBSONUtil::getMetricChunkFromMetricDoc(chunk);
+        if (!swChunk.isOK()) {
+            return swChunk.getStatus();
+        }
+
+        auto swColumns = _decompressor.uncompressColumnarMetrics(
+            swChunk.getValue(), {kFTDCCollectStartField, metric.toString()});
+        if (!swColumns.isOK()) {
+            return swColumns.getStatus();
+        }
+
+        dates = std::move(swColumns.getValue()[0]);
+        metricValues = std::move(swColumns.getValue()[1]);
+    } else {
+        auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(chunk, &_decompressor);
+        if (!swDocs.isOK()) {
+            return swDocs.getStatus();
+        }
+
+        const auto& docs = swDocs.getValue();
+
+        std::vector<std::string> names;
+        Status s = FTDCBSONUtil::extractMetricNames(docs.front(), &names);
+        if (!s.isOK()) {
+            return s;
+        }
+
+        auto metricIt = std::find(names.begin(), names.end(), metric);
+        if (metricIt == names.end()) {
+            return Status::OK();
+        }
+
+        auto startIt = std::find(names.begin(), names.end(), kFTDCCollectStartField);
+
+        std::vector<std::uint64_t> metrics;
+        for (const auto& doc : docs) {
+            metrics.clear();
+            (void)FTDCBSONUtil::extractMetricsFromDocument(doc, doc, &metrics);
+
+            metricValues.push_back(metrics[metricIt - names.begin()]);
+            if (startIt != names.end()) {
+                dates.push_back(metrics[startIt - names.begin()]);
+            }
+        }
+    }
+
+    if (metricValues.empty()) {
+        return Status::OK();
+    }
+
+    if (dates.size() != metricValues.size()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Samples without a '" << kFTDCCollectStartField
+                              << "' date found in file \""
+                              << _file.generic_string()
+                              << "\""};
+    }
+
+    for (std::size_t i = 0; i < dates.size(); ++i) {
+        Date_t date = Date_t::fromMillisSinceEpoch(static_cast<long long>(dates[i]));
+        if (date >= start && date <= end) {
+            values->emplace_back(date, metricValues[i]);
+        }
+    }
+
+    return Status::OK();
+}
+
+StatusWith<std::vector<std::pair<Date_t, std::uint64_t>>> FTDCFileReader::_readMetric(
+    StringData metric, Date_t start, Date_t end) {
+    std::vector<std::pair<Date_t, std::uint64_t>> values;
+
+    FTDCChunkIndex index;
+    auto swHasIndex = readChunkIndex(&index);
+    if (!swHasIndex.isOK()) {
+        return swHasIndex.getStatus();
+    }
+
+    if (swHasIndex.getValue()) {
+        for (const auto& chunk : index.findChunks(metric, start, end)) {
+            Status s = seek(chunk.offset);
+            if (!s.isOK()) {
+                return s;
+            }
+
+            auto swDoc = readDocument();
+            if (!swDoc.isOK()) {
+                return swDoc.getStatus();
+            }
+
+            s = readMetricFromChunk(swDoc.getValue(), metric, start, end, &values);
+            if (!s.isOK()) {
+                return s;
+            }
+        }
+
+        return {std::move(values)};
+    }
+
+    // Without a chunk index, read every metric chunk in the file
+    Status s = seek(0);
+    if (!s.isOK()) {
+        return s;
+    }
+
+    while (true) {
+        auto swDoc = readDocument();
+        if (!swDoc.isOK()) {
+            return swDoc.getStatus();
+        }
+
+        if (swDoc.getValue().isEmpty()) {
+            break;
+        }
+
+        auto swType = FTDCBSONUtil::getBSONDocumentType(swDoc.getValue());
+        if (!swType.isOK()) {
+            return swType.getStatus();
+        }
+
+        if (swType.getValue() == FTDCBSONUtil::FTDCType::kMetricChunk ||
+            swType.getValue() == FTDCBSONUtil::FTDCType::kColumnarMetricChunk) {
+            s = readMetricFromChunk(swDoc.getValue(), metric, start, end, &values);
+            if (!s.isOK()) {
+                return s;
+            }
+        }
+    }
+
+    return {std::move(values)};
+}
+
+StatusWith<std::vector<std::pair<Date_t, std::uint64_t>>> FTDCFileReader::readMetric(
+    StringData metric, Date_t start, Date_t end) {
+    auto swValues = _readMetric(metric, start, end);
+
+    // Start reading documents from the beginning again. The metadata document the reader returned
+    // is unowned, and was overwritten while reading the metric.
+    _state = State::kNeedsDoc;
+    _docs.clear();
+    _metadata = BSONObj();
+    _parent = BSONObj();
+
+    Status s = seek(0);
+    if (!s.isOK()) {
+        return s;
+    }
+
+    return swValues;
+}
+
 Status FTDCFileReader::open(const boost::filesystem::path& file) {
     _stream.open(file.c_str(), std::ios_base::in | std::ios_base::binary);
     if (!_stream.is_open()) {
@@ -33,10 +33,13 @@
 #include <boost/optional.hpp>
 #include <fstream>
 #include <stddef.h>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/ftdc/chunk_index.h"
 #include "mongo/db/ftdc/decompressor.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
@@ -75,12 +78,51 @@ public:
      */
     std::tuple<FTDCBSONUtil::FTDCType, const BSONObj&, Date_t> next();
 
+    /**
+     * Read the values of a metric in the samples taken in the time range [start, end], in the
+     * order they were taken. The time of a sample is its "start" date. See
+     * FTDCBSONUtil::extractMetricNames for the names of metrics.
+     *
+     * If the file ends with a chunk index, only the chunks which overlap the time range and hold
+     * the metric are read, and only the blocks of those chunks which hold the metric are
+     * decompressed. Otherwise every chunk of the file is read.
+     *
+     * Rewinds the file, so that hasNext starts again from the first document.
+     */
+    StatusWith<std::vector<std::pair<Date_t, std::uint64_t>>> readMetric(StringData metric,
+                                                                         Date_t start,
+                                                                         Date_t end);
+
 private:
     /**
      * Read a document from the file. If the file is corrupt, returns an appropriate status.
      */
     StatusWith<BSONObj> readDocument();
 
+    /**
+     * Move to an offset in the file.
+     */
+    Status seek(std::size_t offset);
+
+    /**
+     * Read the chunk index at the end of the file. Returns false if the file has no chunk index.
+     */
+    StatusWith<bool> readChunkIndex(FTDCChunkIndex* index);
+
+    /**
+     * Append the values of a metric in the samples of a metric chunk document taken in the time
+     * range [start, end] to values.
+     */
+    Status readMetricFromChunk(const BSONObj& chunk,
+                               StringData metric,
+                               Date_t start,
+                               Date_t end,
+                               std::vector<std::pair<Date_t, std::uint64_t>>* values);
+
+    StatusWith<std::vector<std::pair<Date_t, std::uint64_t>>> _readMetric(StringData metric,
+                                                                          Date_t start,
+                                                                          Date_t end);
+
 private:
     FTDCDecompressor _decompressor;
 
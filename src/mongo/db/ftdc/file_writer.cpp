@@ -78,6 +78,11 @@ Status FTDCFileWriter::open(const boost::filesystem::path& file) {
 
     _compressor.reset();
 
+    _lastSampleDate = Date_t();
+    _chunkIndex.clear();
+    _writeChunkIndex =
+        _size == 0 && _config->formatVersion == FTDCConfig::kFormatVersionColumnar;
+
     return Status::OK();
 }
 
@@ -152,15 +157,37 @@ Status FTDCFileWriter::writeMetadata(const BSONObj& metadata, Date_t date) {
     return writeArchiveFileBuffer({wrapped.objdata(), static_cast<size_t>(wrapped.objsize())});
 }
 
+BSONObj FTDCFileWriter::createMetricChunkDocument(ConstDataRange buf,
+                                                  Date_t start,
+                                                  Date_t end) const {
+    if (_config->formatVersion == FTDCConfig::kFormatVersionColumnar) {
+        return FTDCBSONUtil::createBSONColumnarMetricChunkDocument(buf, start, end);
+    }
+
+    return FTDCBSONUtil::createBSONMetricChunkDocument(buf, start);
+}
+
 Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
+    // The compressor starts a new chunk with this sample when the schema changes, so the returned
+    // chunk has the reference document and ends with the sample before this one.
+    BSONObj referenceDoc = _compressor.getReferenceDocument();
+    Date_t previousSampleDate = _lastSampleDate;
+
     auto ret = _compressor.addSample(sample, date);
 
     if (!ret.isOK()) {
         return ret.getStatus();
     }
 
+    _lastSampleDate = date;
+
     if (ret.getValue().is_initialized()) {
-        return flush(std::get<0>(ret.getValue().get()), std::get<2>(ret.getValue().get()));
+        auto state = std::get<1>(ret.getValue().get());
+        return flush(std::get<0>(ret.getValue().get()),
+                     std::get<2>(ret.getValue().get()),
+                     state == FTDCCompressor::CompressorState::kSchemaChanged ? previousSampleDate
+                                                                                : date,
+                     referenceDoc);
     }
 
     if (_compressor.getSampleCount() != 0 &&
@@ -171,15 +198,34 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
             return swBuf.getStatus();
         }
 
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                std::get<1>(swBuf.getValue()));
+        BSONObj o = createMetricChunkDocument(
+            std::get<0>(swBuf.getValue()), std::get<1>(swBuf.getValue()), date);
         return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
     }
 
     return Status::OK();
 }
 
-Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
+Status FTDCFileWriter::writeArchiveMetricChunk(ConstDataRange buf,
+                                               Date_t start,
+                                               Date_t end,
+                                               const BSONObj& referenceDoc) {
+    const std::size_t offset = _size;
+
+    BSONObj o = createMetricChunkDocument(buf, start, end);
+    Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+
+    if (!s.isOK() || !_writeChunkIndex) {
+        return s;
+    }
+
+    return _chunkIndex.addChunk(referenceDoc, start, end, offset);
+}
+
+Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range,
+                             Date_t start,
+                             Date_t end,
+                             const BSONObj& referenceDoc) {
     if (!range.is_initialized()) {
         if (_compressor.hasDataToFlush()) {
             auto swBuf = _compressor.getCompressedSamples();
@@ -188,17 +234,17 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
                 return swBuf.getStatus();
             }
 
-            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                    std::get<1>(swBuf.getValue()));
-            Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+            Status s = writeArchiveMetricChunk(std::get<0>(swBuf.getValue()),
+                                               std::get<1>(swBuf.getValue()),
+                                               _lastSampleDate,
+                                               _compressor.getReferenceDocument());
 
             if (!s.isOK()) {
                 return s;
             }
         }
     } else {
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date);
-        Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
+        Status s = writeArchiveMetricChunk(range.get(), start, end, referenceDoc);
 
         if (!s.isOK()) {
             return s;
@@ -217,9 +263,38 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
     return Status::OK();
 }
 
+Status FTDCFileWriter::writeChunkIndex() {
+    if (_chunkIndex.empty()) {
+        return Status::OK();
+    }
+
+    const std::size_t offset = _size;
+
+    auto swIndex = _chunkIndex.toBSON(_chunkIndex.getChunks().front().start);
+    if (!swIndex.isOK()) {
+        return swIndex.getStatus();
+    }
+
+    const BSONObj& index = swIndex.getValue();
+    Status s = writeArchiveFileBuffer({index.objdata(), static_cast<size_t>(index.objsize())});
+    if (!s.isOK()) {
+        return s;
+    }
+
+    BSONObj locator = FTDCBSONUtil::createBSONChunkIndexLocatorDocument(
+        offset, _chunkIndex.getChunks().front().start);
+    return writeArchiveFileBuffer({locator.objdata(), static_cast<size_t>(locator.objsize())});
+}
+
 Status FTDCFileWriter::close() {
     if (_archiveStream.is_open()) {
-        Status s = flush(boost::none, Date_t());
+        Status s = flush(boost::none, Date_t(), Date_t(), BSONObj());
+
+        if (s.isOK() && _writeChunkIndex) {
+            s = writeChunkIndex();
+        }
+
+        _chunkIndex.clear();
 
         _archiveStream.close();
 
@@ -230,6 +305,7 @@ Status FTDCFileWriter::close() {
 }
 
 void FTDCFileWriter::closeWithoutFlushForTest() {
+    _chunkIndex.clear();
     _archiveStream.close();
 }
 
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/ftdc/chunk_index.h"
 #include "mongo/db/ftdc/compressor.h"
 #include "mongo/db/jsobj.h"
 
@@ -56,6 +57,9 @@ namespace mongo {
  *
  * File format is compatible with mongodump as it is just a sequential series of bson documents
  *
+ * When the config asks for columnar metric chunks, the writer also keeps an index of the chunks it
+ * writes to the archive file, and appends it to the file when it is closed. See FTDCChunkIndex.
+ *
  * File rotation and cleanup is not handled by this class.
  */
 class FTDCFileWriter {
@@ -104,8 +108,33 @@ public:
 private:
     /**
      * Flush all changes to disk.
+     *
+     * The range is a chunk the compressor returned from addSample, whose samples were taken from
+     * the start date to the end date and have the schema of the reference document. If there is no
+     * range, the samples in the compressor are flushed.
+     */
+    Status flush(const boost::optional<ConstDataRange>&,
+                 Date_t start,
+                 Date_t end,
+                 const BSONObj& referenceDoc);
+
+    /**
+     * Create the document for a metric chunk in the format of the config.
+     */
+    BSONObj createMetricChunkDocument(ConstDataRange buf, Date_t start, Date_t end) const;
+
+    /**
+     * Append a metric chunk to the archive file, and add it to the chunk index.
      */
-    Status flush(const boost::optional<ConstDataRange>&, Date_t date);
+    Status writeArchiveMetricChunk(ConstDataRange buf,
+                                   Date_t start,
+                                   Date_t end,
+                                   const BSONObj& referenceDoc);
+
+    /**
+     * Append the chunk index and its locator to the archive file.
+     */
+    Status writeChunkIndex();
 
     /**
      * Write a buffer to the beginning of the interim file.
@@ -141,6 +170,16 @@ private:
 
     // Size of interim file
     std::size_t _sizeInterim{0};
+
+    // Date of the last sample written
+    Date_t _lastSampleDate;
+
+    // Index of the columnar metric chunks in the archive file
+    FTDCChunkIndex _chunkIndex;
+
+    // Whether to append the chunk index when the archive file is closed. The index only covers
+    // the chunks of this writer, so it is not written to a file which was not empty when opened.
+    bool _writeChunkIndex{false};
 };
 
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/filesystem.hpp>
+#include <functional>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -157,12 +158,14 @@ TEST_F(FTDCFileTest, TestFileBasicCompress) {
  */
 class FileTestTie {
 public:
-    FileTestTie()
+    FileTestTie(std::uint32_t formatVersion = FTDCConfig::kFormatVersionDefault)
         : _tempdir("metrics_testpath"),
           _path(boost::filesystem::path(_tempdir.path()) / kTestFile),
           _writer(&_config) {
         deleteFileIfNeeded(_path);
 
+        _config.formatVersion = formatVersion;
+
         ASSERT_OK(_writer.open(_path));
     }
 
@@ -359,4 +362,162 @@ TEST_F(FTDCFileTest, TestBadFile) {
     ASSERT_NOT_OK(sw);
 }
 
+// Test schema changes and full chunks in the columnar format
+TEST_F(FTDCFileTest, TestColumnarFull) {
+    FileTestTie c(FTDCConfig::kFormatVersionColumnar);
+
+    for (size_t i = 0; i <= FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault * 2; i++) {
+        c.addSample(BSON("name"
+                         << "joe"
+                         << "key1"
+                         << static_cast<long long int>(i * i)
+                         << "key2"
+                         << 45));
+    }
+
+    // Rename field
+    c.addSample(BSON("name"
+                     << "joe"
+                     << "key1"
+                     << 34
+                     << "key5"
+                     << 45));
+    c.addSample(BSON("name"
+                     << "joe"
+                     << "key1"
+                     << 35
+                     << "key5"
+                     << 40));
+}
+
+namespace {
+BSONObj makeSample(int i, bool withKey3) {
+    BSONObjBuilder builder;
+    builder.appendDate("start", Date_t::fromMillisSinceEpoch(i * 1000));
+    builder.append("name", "joe");
+    builder.append("key1", static_cast<long long>(i * 3));
+    builder.append("nested", BSON("key2" << 7));
+    if (withKey3) {
+        builder.append("key3", static_cast<long long>(-i));
+    }
+
+    return builder.obj();
+}
+
+void writeSamples(FTDCFileWriter* writer, int first, int last, bool withKey3) {
+    for (int i = first; i < last; i++) {
+        ASSERT_OK(writer->writeSample(makeSample(i, withKey3),
+                                      Date_t::fromMillisSinceEpoch(i * 1000)));
+    }
+}
+
+void assertMetricValues(FTDCFileReader* reader,
+                        StringData metric,
+                        int first,
+                        int last,
+                        std::function<long long(int)> value) {
+    auto sw = reader->readMetric(metric,
+                                 Date_t::fromMillisSinceEpoch(first * 1000),
+                                 Date_t::fromMillisSinceEpoch((last - 1) * 1000));
+    ASSERT_OK(sw.getStatus());
+
+    const auto& values = sw.getValue();
+    ASSERT_EQUALS(values.size(), static_cast<size_t>(last - first));
+    for (int i = first; i < last; i++) {
+        ASSERT_EQUALS(values[i - first].first, Date_t::fromMillisSinceEpoch(i * 1000));
+        ASSERT_EQUALS(static_cast<long long>(values[i - first].second), value(i));
+    }
+}
+}  // namespace
+
+// Test reading a metric by time range from a file with a chunk index
+TEST_F(FTDCFileTest, TestColumnarReadMetric) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    FTDCConfig config;
+    config.formatVersion = FTDCConfig::kFormatVersionColumnar;
+    FTDCFileWriter writer(&config);
+
+    BSONObj metadata = BSON("version"
+                            << "4.3");
+
+    ASSERT_OK(writer.open(p));
+    ASSERT_OK(writer.writeMetadata(metadata, Date_t()));
+
+    // Add key3 half way through the second chunk
+    writeSamples(&writer, 0, 450, false);
+    writeSamples(&writer, 450, 1000, true);
+
+    ASSERT_OK(writer.close());
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(p));
+
+    assertMetricValues(&reader, "key1", 0, 1000, [](int i) { return i * 3; });
+    assertMetricValues(&reader, "key1", 290, 310, [](int i) { return i * 3; });
+    assertMetricValues(&reader, "nested.key2", 440, 460, [](int) { return 7; });
+    assertMetricValues(&reader, "key3", 450, 1000, [](int i) { return -i; });
+    assertMetricValues(&reader, "start", 999, 1000, [](int i) { return i * 1000; });
+
+    auto sw = reader.readMetric("key3", Date_t(), Date_t::fromMillisSinceEpoch(449 * 1000));
+    ASSERT_OK(sw.getStatus());
+    ASSERT_TRUE(sw.getValue().empty());
+
+    sw = reader.readMetric("missing", Date_t(), Date_t::max());
+    ASSERT_OK(sw.getStatus());
+    ASSERT_TRUE(sw.getValue().empty());
+
+    // The reader starts again from the beginning of the file, and skips the chunk index
+    std::vector<BSONObj> docs{metadata};
+    for (int i = 0; i < 1000; i++) {
+        docs.push_back(makeSample(i, i >= 450));
+    }
+
+    auto swNext = reader.hasNext();
+    ASSERT_OK(swNext.getStatus());
+    ASSERT_TRUE(swNext.getValue());
+    ASSERT_TRUE(std::get<0>(reader.next()) == FTDCBSONUtil::FTDCType::kMetadata);
+
+    ValidateDocumentList(p, docs, FTDCValidationMode::kStrict);
+}
+
+// Test reading a metric from a file without a chunk index, with both chunk formats
+TEST_F(FTDCFileTest, TestColumnarReadMetricWithoutIndex) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path p(tempdir.path());
+    p /= kTestFile;
+
+    deleteFileIfNeeded(p);
+
+    {
+        FTDCConfig config;
+        FTDCFileWriter writer(&config);
+
+        ASSERT_OK(writer.open(p));
+        writeSamples(&writer, 0, 500, true);
+        ASSERT_OK(writer.close());
+    }
+
+    // The chunk index is not written to a file which already has other chunks
+    {
+        FTDCConfig config;
+        config.formatVersion = FTDCConfig::kFormatVersionColumnar;
+        FTDCFileWriter writer(&config);
+
+        ASSERT_OK(writer.open(p));
+        writeSamples(&writer, 500, 1000, true);
+        ASSERT_OK(writer.close());
+    }
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(p));
+
+    assertMetricValues(&reader, "key1", 0, 1000, [](int i) { return i * 3; });
+    assertMetricValues(&reader, "key3", 450, 550, [](int i) { return -i; });
+}
+
 }  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ftdc_sampling_profiler.h"
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include "mongo/util/hex.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Name of FTDC collector to create.
+ */
+constexpr auto kSamplingProfilerCollector = "samplingProfiler";
+
+void appendFrame(void* address, StringBuilder* folded) {
+#ifndef _WIN32
+    Dl_info info;
+    if (dladdr(address, &info) != 0 && info.dli_fname) {
+        StringData path(info.dli_fname);
+        *folded << path.substr(path.rfind('/') + 1) << "+0x"
+                << integerToHex(static_cast<unsigned long long>(
+                       static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+        return;
+    }
+#endif
+    *folded << "0x" << integerToHex(reinterpret_cast<unsigned long long>(address));
+}
+
+}  // namespace
+
+void FoldedStackTable::add(const SamplingProfiler::Sample& sample) {
+    _samples++;
+
+    std::string key(sample.tag);
+    key.push_back('\0');
+    key.append(reinterpret_cast<const char*>(sample.frames), sample.numFrames * sizeof(void*));
+
+    auto it = _positions.find(key);
+    if (it == _positions.end()) {
+        if (full()) {
+            _untracked++;
+            return;
+        }
+
+        it = _positions.emplace(std::move(key), _stacks.size()).first;
+        _stacks.emplace_back(_fold(sample), 0);
+    }
+
+    _stacks[it->second].second++;
+}
+
+void FoldedStackTable::clear(Date_t since) {
+    _positions.clear();
+    _stacks.clear();
+    _since = since;
+    _samples = 0;
+    _dropped = 0;
+    _untracked = 0;
+}
+
+void FoldedStackTable::append(BSONObjBuilder* builder) const {
+    builder->append("since", _since);
+    builder->append("samples", _samples);
+    builder->append("dropped", _dropped);
+    builder->append("untracked", _untracked);
+
+    BSONArrayBuilder stacks(builder->subarrayStart("stacks"));
+    for (size_t i = 0; i < kMaxStacks; i++) {
+        stacks.append(i < _stacks.size() ? StringData(_stacks[i].first) : StringData());
+    }
+    stacks.doneFast();
+
+    BSONArrayBuilder counts(builder->subarrayStart("counts"));
+    for (size_t i = 0; i < kMaxStacks; i++) {
+        counts.append(i < _stacks.size() ? _stacks[i].second : 0LL);
+    }
+    counts.doneFast();
+
+    if (full()) {
+        builder->append("full", true);
+    }
+}
+
+std::string FoldedStackTable::_fold(const SamplingProfiler::Sample& sample) {
+    StringBuilder folded;
+    folded << (sample.tag[0] ? sample.tag : "[untagged]");
+    for (int i = sample.numFrames - 1; i >= 0; i--) {
+        folded << ';';
+        appendFrame(sample.frames[i], &folded);
+    }
+    return folded.str();
+}
+
+std::string SamplingProfilerCollector::name() const {
+    return kSamplingProfilerCollector;
+}
+
+void SamplingProfilerCollector::collect(OperationContext* opCtx, BSONObjBuilder& builder) {
+    _table.addDropped(SamplingProfiler::drain(
+        [this](const SamplingProfiler::Sample& sample) { _table.add(sample); }));
+
+    builder.append("running", SamplingProfiler::isRunning());
+    _table.append(&builder);
+
+    if (_table.full()) {
+        _table.clear(Date_t::now());
+    }
+}
+
+}  // namespace mongo
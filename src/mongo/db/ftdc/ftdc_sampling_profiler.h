@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Counts the samples of the SamplingProfiler by folded stack, the input format of flame graph
+ * tools: the tag of the sampled thread, then the frames of its stack from the outermost to the
+ * innermost, separated by semicolons.
+ *
+ * A frame is written as "<module>+0x<offset>", the offset of its address into the executable or
+ * shared library which contains it, to be symbolized offline by buildscripts/ftdc_flamegraph.py.
+ *
+ * The counts are cumulative. At most kMaxStacks stacks are counted; the samples of any other stack
+ * are only counted as untracked, until the owner clears the table.
+ *
+ * FTDC stores the numbers of each sample as metrics, but keeps strings only from the first sample
+ * of each chunk, and starts a chunk whenever the names or types of the fields change. The stacks
+ * are therefore reported in fixed-size arrays rather than as field names, so that seeing a stack
+ * does not change the schema, and a stack keeps its position until the table is cleared. Once the
+ * table is full, it is reported with an extra field, so that FTDC starts a chunk holding all its
+ * stacks before the table is cleared.
+ */
+class FoldedStackTable {
+public:
+    static constexpr size_t kMaxStacks = 128;
+
+    /**
+     * Creates an empty table, which tells the samples it counts from those of other tables by
+     * 'since'.
+     */
+    explicit FoldedStackTable(Date_t since) : _since(since) {}
+
+    void add(const SamplingProfiler::Sample& sample);
+
+    void addDropped(long long dropped) {
+        _dropped += dropped;
+    }
+
+    bool full() const {
+        return _stacks.size() >= kMaxStacks;
+    }
+
+    /**
+     * Empties the table, as if it had been created at 'since'.
+     */
+    void clear(Date_t since);
+
+    /**
+     * Appends {since: <date>, samples: <count>, dropped: <count>, untracked: <count>, stacks:
+     * [<folded stack>, ...], counts: [<count>, ...]}, with the stacks in the order they were first
+     * seen. Both arrays have kMaxStacks elements, the unused ones "" and 0. Also appends full: true
+     * once the table is full.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    static std::string _fold(const SamplingProfiler::Sample& sample);
+
+    // Maps the tag and frames of a sample, as raw bytes, to the position of its stack in _stacks.
+    stdx::unordered_map<std::string, size_t> _positions;
+    std::vector<std::pair<std::string, long long>> _stacks;
+
+    Date_t _since;
+    long long _samples = 0;
+    long long _dropped = 0;
+    long long _untracked = 0;
+};
+
+/**
+ * Periodically drains the samples of the SamplingProfiler into a FoldedStackTable, and reports it.
+ * The table is cleared once it is full, after it has been reported.
+ */
+class SamplingProfilerCollector : public FTDCCollectorInterface {
+public:
+    std::string name() const override;
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+
+private:
+    FoldedStackTable _table{Date_t::now()};
+};
+
+}  // namespace mongo
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/ftdc/ftdc_sampling_profiler.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Makes a sample whose frames, innermost first, are at addresses no module contains, so that they
+ * are folded as plain hexadecimal addresses.
+ */
+SamplingProfiler::Sample makeSample(StringData tag, std::vector<uintptr_t> frames) {
+    SamplingProfiler::Sample sample;
+    tag.copyTo(sample.tag, true);
+    for (size_t i = 0; i < frames.size(); i++) {
+        sample.frames[i] = reinterpret_cast<void*>(frames[i]);
+    }
+    sample.numFrames = frames.size();
+    return sample;
+}
+
+BSONObj toBSON(const FoldedStackTable& table) {
+    BSONObjBuilder builder;
+    table.append(&builder);
+    return builder.obj();
+}
+
+using Stacks = std::vector<std::pair<std::string, long long>>;
+
+/**
+ * Returns the stacks and counts 'table' reports, without the unused positions of the arrays.
+ */
+Stacks getStacks(const FoldedStackTable& table) {
+    auto obj = toBSON(table);
+    auto stacks = obj["stacks"].Array();
+    auto counts = obj["counts"].Array();
+    ASSERT_EQ(FoldedStackTable::kMaxStacks, stacks.size());
+    ASSERT_EQ(FoldedStackTable::kMaxStacks, counts.size());
+
+    Stacks result;
+    for (size_t i = 0; i < stacks.size(); i++) {
+        if (!stacks[i].str().empty()) {
+            result.emplace_back(stacks[i].str(), counts[i].numberLong());
+        } else {
+            ASSERT_EQ(0LL, counts[i].numberLong());
+        }
+    }
+    return result;
+}
+
+TEST(FoldedStackTableTest, CountsSamplesByTagAndStack) {
+    FoldedStackTable table(Date_t::fromMillisSinceEpoch(1000));
+    table.add(makeSample("find test.a", {0x30, 0x20, 0x10}));
+    table.add(makeSample("find test.a", {0x30, 0x20, 0x10}));
+    table.add(makeSample("find test.b", {0x30, 0x20, 0x10}));
+    table.add(makeSample("find test.a", {0x40, 0x10}));
+    table.add(makeSample("", {0xab}));
+
+    auto obj = toBSON(table);
+    ASSERT_EQ(Date_t::fromMillisSinceEpoch(1000), obj["since"].Date());
+    ASSERT_EQ(5LL, obj["samples"].numberLong());
+    ASSERT_EQ(0LL, obj["dropped"].numberLong());
+    ASSERT_EQ(0LL, obj["untracked"].numberLong());
+    ASSERT_FALSE(obj.hasField("full"));
+    ASSERT(getStacks(table) == Stacks({{"find test.a;0x10;0x20;0x30", 2},
+                                       {"find test.b;0x10;0x20;0x30", 1},
+                                       {"find test.a;0x10;0x40", 1},
+                                       {"[untagged];0xAB", 1}}));
+}
+
+TEST(FoldedStackTableTest, CountsAreCumulativeUntilCleared) {
+    FoldedStackTable table(Date_t::fromMillisSinceEpoch(1000));
+    table.add(makeSample("insert test.a", {0x10}));
+    table.addDropped(3);
+    auto first = toBSON(table);
+
+    table.add(makeSample("insert test.a", {0x10}));
+    table.addDropped(2);
+    auto second = toBSON(table);
+    ASSERT_EQ(2LL, second["samples"].numberLong());
+    ASSERT_EQ(5LL, second["dropped"].numberLong());
+    ASSERT(getStacks(table) == Stacks({{"insert test.a;0x10", 2}}));
+
+    table.clear(Date_t::fromMillisSinceEpoch(2000));
+    auto cleared = toBSON(table);
+    ASSERT_EQ(Date_t::fromMillisSinceEpoch(2000), cleared["since"].Date());
+    ASSERT_EQ(0LL, cleared["samples"].numberLong());
+    ASSERT_EQ(0LL, cleared["dropped"].numberLong());
+    ASSERT(getStacks(table).empty());
+    ASSERT_EQ(1LL, first["samples"].numberLong());
+}
+
+TEST(FoldedStackTableTest, SchemaOnlyChangesOnceTheTableIsFull) {
+    FoldedStackTable table(Date_t::fromMillisSinceEpoch(1000));
+    auto empty = toBSON(table);
+    for (uintptr_t i = 0; i < FoldedStackTable::kMaxStacks - 1; i++) {
+        table.add(makeSample("find test.a", {0x1000 + i}));
+    }
+
+    // The same fields, of the same types, in the same order.
+    BSONObjIterator emptyIt(empty);
+    for (auto&& element : toBSON(table)) {
+        ASSERT_TRUE(emptyIt.more());
+        auto emptyElement = emptyIt.next();
+        ASSERT_EQ(emptyElement.fieldNameStringData(), element.fieldNameStringData());
+        ASSERT_EQ(emptyElement.type(), element.type());
+        if (element.type() == Array) {
+            ASSERT_EQ(emptyElement.Obj().nFields(), element.Obj().nFields());
+        }
+    }
+    ASSERT_FALSE(emptyIt.more());
+
+    table.add(makeSample("find test.a", {0x10}));
+    ASSERT_TRUE(toBSON(table)["full"].trueValue());
+}
+
+TEST(FoldedStackTableTest, SamplesOfStacksBeyondTheBoundAreUntracked) {
+    FoldedStackTable table(Date_t::fromMillisSinceEpoch(1000));
+    for (uintptr_t i = 0; i < FoldedStackTable::kMaxStacks; i++) {
+        ASSERT_FALSE(table.full());
+        table.add(makeSample("update test.a", {0x1000 + i}));
+    }
+    ASSERT_TRUE(table.full());
+
+    // Stacks already in the table are still counted.
+    table.add(makeSample("update test.a", {0x1000}));
+    table.add(makeSample("update test.a", {0x10}));
+    table.add(makeSample("update test.b", {0x1000}));
+
+    const long long kMaxStacks = FoldedStackTable::kMaxStacks;
+    auto obj = toBSON(table);
+    ASSERT_EQ(kMaxStacks + 3, obj["samples"].numberLong());
+    ASSERT_EQ(2LL, obj["untracked"].numberLong());
+    auto stacks = getStacks(table);
+    ASSERT_EQ(FoldedStackTable::kMaxStacks, stacks.size());
+    ASSERT_EQ("update test.a;0x1000", stacks[0].first);
+    ASSERT_EQ(2LL, stacks[0].second);
+}
+
+}  // namespace
+}  // namespace mongo
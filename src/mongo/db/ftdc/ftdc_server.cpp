@@ -27,6 +27,8 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/ftdc_server.h"
@@ -42,10 +44,13 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/ftdc_sampling_profiler.h"
 #include "mongo/db/ftdc/ftdc_server_gen.h"
 #include "mongo/db/ftdc/ftdc_system_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
@@ -170,6 +175,20 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCSamplingProfilerRate(const std::int32_t potentialNewValue) {
+    // Until FTDC starts, nothing would drain the samples. startFTDC applies the value then.
+    if (!getGlobalFTDCController()) {
+        return Status::OK();
+    }
+
+    if (potentialNewValue == 0) {
+        SamplingProfiler::stop();
+        return Status::OK();
+    }
+
+    return SamplingProfiler::start(potentialNewValue);
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -208,6 +227,7 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.formatVersion = ftdcStartupParams.formatVersion.load();
 
     ftdcDirectoryPathParameter = path;
 
@@ -237,6 +257,17 @@ void startFTDC(boost::filesystem::path& path,
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // Install the sampling profiler collector as a periodic collector, and start the profiler if
+    // it was enabled at startup
+    controller->addPeriodicCollector(std::make_unique<SamplingProfilerCollector>());
+    const auto samplingProfilerRate = ftdcStartupParams.samplingProfilerRate.load();
+    if (samplingProfilerRate > 0) {
+        Status status = SamplingProfiler::start(samplingProfilerRate);
+        if (!status.isOK()) {
+            warning() << "Failed to start the sampling profiler: " << status;
+        }
+    }
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -266,6 +297,8 @@ void stopFTDC() {
     if (controller) {
         controller->stop();
     }
+
+    SamplingProfiler::stop();
 }
 
 FTDCController* FTDCController::get(ServiceContext* serviceContext) {
@@ -64,6 +64,11 @@ const char kFTDCDocsField[] = "docs";
 const char kFTDCCollectStartField[] = "start";
 const char kFTDCCollectEndField[] = "end";
 
+const char kFTDCChunksField[] = "chunks";
+const char kFTDCSchemasField[] = "schemas";
+const char kFTDCSchemaField[] = "schema";
+const char kFTDCOffsetField[] = "offset";
+
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
 
 const std::size_t kMaxRecursion = 10;
@@ -269,6 +274,52 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
     return {matches};
 }
 
+Status extractMetricNames(const BSONObj& doc,
+                          const std::string& prefix,
+                          std::vector<std::string>* names,
+                          size_t recursion) {
+    if (recursion > kMaxRecursion) {
+        return {ErrorCodes::BadValue, "Recursion limit reached."};
+    }
+
+    FTDCBSONObjIterator it(doc);
+
+    while (it.more()) {
+        BSONElement element = it.next();
+        std::string name = prefix + element.fieldNameStringData().toString();
+
+        // Mirrors the metrics extractMetricsFromDocument extracts for each type
+        switch (element.type()) {
+            case NumberDouble:
+            case NumberInt:
+            case NumberLong:
+            case NumberDecimal:
+            case Bool:
+            case Date:
+                names->emplace_back(std::move(name));
+                break;
+
+            case bsonTimestamp:
+                names->emplace_back(name + ".t");
+                names->emplace_back(name + ".i");
+                break;
+
+            case Object:
+            case Array: {
+                Status status = extractMetricNames(element.Obj(), name + ".", names, recursion + 1);
+                if (!status.isOK()) {
+                    return status;
+                }
+            } break;
+
+            default:
+                break;
+        }
+    }
+
+    return Status::OK();
+}
+
 }  // namespace
 
 bool isFTDCType(BSONType type) {
@@ -295,6 +346,10 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
     return extractMetricsFromDocument(referenceDoc, currentDoc, metrics, true, 0);
 }
 
+Status extractMetricNames(const BSONObj& doc, std::vector<std::string>* names) {
+    return extractMetricNames(doc, std::string(), names, 0);
+}
+
 namespace {
 Status constructDocumentFromMetrics(const BSONObj& referenceDocument,
                                     BSONObjBuilder& builder,
@@ -421,6 +476,29 @@ BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
     return builder.obj();
 }
 
+BSONObj createBSONColumnarMetricChunkDocument(ConstDataRange buf, Date_t start, Date_t end) {
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCIdField, start);
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kColumnarMetricChunk));
+    builder.appendDate(kFTDCCollectEndField, end);
+    builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
+
+    return builder.obj();
+}
+
+BSONObj createBSONChunkIndexLocatorDocument(std::int64_t offset, Date_t date) {
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCIdField, date);
+    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kChunkIndexLocator));
+    builder.append(kFTDCOffsetField, static_cast<long long>(offset));
+
+    BSONObj obj = builder.obj();
+    dassert(static_cast<std::size_t>(obj.objsize()) == kChunkIndexLocatorSize);
+    return obj;
+}
+
 StatusWith<Date_t> getBSONDocumentId(const BSONObj& obj) {
     BSONElement element;
 
@@ -440,8 +518,8 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
         return {status};
     }
 
-    if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
-        static_cast<FTDCType>(value) != FTDCType::kMetadata) {
+    if (value < static_cast<int>(FTDCType::kMetadata) ||
+        value > static_cast<int>(FTDCType::kChunkIndexLocator)) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
                               << "' is not an expected value, found '"
@@ -468,13 +546,41 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
     return {element.Obj()};
 }
 
-StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
-                                                         FTDCDecompressor* decompressor) {
+StatusWith<std::int64_t> getChunkIndexOffsetFromLocatorDoc(const BSONObj& obj) {
     if (kDebugBuild) {
         auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+        dassert(swType.isOK() && swType.getValue() == FTDCType::kChunkIndexLocator);
+    }
+
+    long long offset;
+    Status status = bsonExtractIntegerField(obj, kFTDCOffsetField, &offset);
+    if (!status.isOK()) {
+        return {status};
+    }
+
+    if (offset < 0) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Field '" << std::string(kFTDCOffsetField)
+                              << "' is negative, found '"
+                              << offset
+                              << "'"};
     }
 
+    return {offset};
+}
+
+StatusWith<Date_t> getBSONDocumentEnd(const BSONObj& obj) {
+    BSONElement element;
+
+    Status status = bsonExtractTypedField(obj, kFTDCCollectEndField, BSONType::Date, &element);
+    if (!status.isOK()) {
+        return {status};
+    }
+
+    return {element.Date()};
+}
+
+StatusWith<ConstDataRange> getMetricChunkFromMetricDoc(const BSONObj& obj) {
     BSONElement element;
 
     Status status = bsonExtractTypedField(obj, kFTDCDataField, BSONType::BinData, &element);
@@ -489,7 +595,29 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
-    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
+    return ConstDataRange(buffer, static_cast<std::size_t>(length));
+}
+
+StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
+                                                         FTDCDecompressor* decompressor) {
+    auto swType = getBSONDocumentType(obj);
+    if (!swType.isOK()) {
+        return swType.getStatus();
+    }
+
+    dassert(swType.getValue() == FTDCType::kMetricChunk ||
+            swType.getValue() == FTDCType::kColumnarMetricChunk);
+
+    auto swChunk = getMetricChunkFromMetricDoc(obj);
+    if (!swChunk.isOK()) {
+        return swChunk.getStatus();
+    }
+
+    if (swType.getValue() == FTDCType::kColumnarMetricChunk) {
+        return decompressor->uncompressColumnar(swChunk.getValue());
+    }
+
+    return decompressor->uncompress(swChunk.getValue());
 }
 
 }  // namespace FTDCBSONUtil
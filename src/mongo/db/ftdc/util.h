@@ -63,6 +63,27 @@ enum class FTDCType : std::int32_t {
     * See createBSONMetricChunkDocument
     */
     kMetricChunk = 1,
+
+    /**
+    * A columnar metrics chunk is composed of a header + a chunk compressed in blocks of metrics.
+    *
+    * See createBSONColumnarMetricChunkDocument
+    */
+    kColumnarMetricChunk = 2,
+
+    /**
+    * An index of the columnar metric chunks of a file, written when the file is closed.
+    *
+    * See FTDCChunkIndex
+    */
+    kChunkIndex = 3,
+
+    /**
+    * A fixed size document at the very end of a file with the offset of its chunk index.
+    *
+    * See createBSONChunkIndexLocatorDocument
+    */
+    kChunkIndexLocator = 4,
 };
 
 
@@ -98,6 +119,13 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
                                             const BSONObj& doc,
                                             std::vector<std::uint64_t>* metrics);
 
+/**
+ * Extract the names of the metrics of a document, in the order extractMetricsFromDocument
+ * extracts their values. Names are the dotted paths of the fields, and the two metrics of a
+ * timestamp are named after its field with the suffixes ".t" and ".i".
+ */
+Status extractMetricNames(const BSONObj& doc, std::vector<std::string>* names);
+
 /**
  * Construct a document from a reference document and array of metrics.
  *
@@ -149,6 +177,41 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  */
 BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
 
+/**
+ * Create a BSON columnar metric chunk document for storage. The start and end dates are the dates
+ * of the first and last samples of the chunk, so readers can skip chunks by time without
+ * decompressing them.
+ *
+ * Example:
+ * {
+ *  "_id" : Date_t
+ *  "type" : 2
+ *  "end" : Date_t
+ *  "data" : BinData(...)
+ * }
+ */
+BSONObj createBSONColumnarMetricChunkDocument(ConstDataRange buf, Date_t start, Date_t end);
+
+/**
+ * Create the BSON document which locates the chunk index of a file. It always has the size
+ * kChunkIndexLocatorSize, so it can be read from the end of the file.
+ *
+ * Example:
+ * {
+ *  "_id" : Date_t
+ *  "type" : 4
+ *  "offset" : NumberLong(...)
+ * }
+ */
+BSONObj createBSONChunkIndexLocatorDocument(std::int64_t offset, Date_t date);
+
+constexpr std::size_t kChunkIndexLocatorSize = 44;
+
+/**
+ * Get the offset of the chunk index from a chunk index locator document.
+ */
+StatusWith<std::int64_t> getChunkIndexOffsetFromLocatorDoc(const BSONObj& obj);
+
 /**
  * Get the _id field of a BSON document
  */
@@ -165,7 +228,18 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj);
 StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj);
 
 /**
- * Get the set of metric documents from the compressed chunk of a metric document
+ * Get the end date of a columnar metric chunk document
+ */
+StatusWith<Date_t> getBSONDocumentEnd(const BSONObj& obj);
+
+/**
+ * Get the compressed chunk of a metric or columnar metric chunk document
+ */
+StatusWith<ConstDataRange> getMetricChunkFromMetricDoc(const BSONObj& obj);
+
+/**
+ * Get the set of metric documents from the compressed chunk of a metric or columnar metric
+ * chunk document
  */
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor);
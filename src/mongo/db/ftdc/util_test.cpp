@@ -30,6 +30,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/util.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -70,4 +72,28 @@ TEST(FTDCUtilTest, TestMongoSPath) {
     }
 }
 
+// Validate metric names follow the order of the extracted metrics
+TEST(FTDCUtilTest, TestExtractMetricNames) {
+    BSONObj doc = BSON("start" << Date_t::fromMillisSinceEpoch(1000) << "name"
+                               << "joe"
+                               << "a"
+                               << BSON("b" << 1 << "ts" << Timestamp(5, 6) << "c"
+                                           << BSON_ARRAY(true << 2.5))
+                               << "d"
+                               << 7LL);
+
+    std::vector<std::string> names;
+    ASSERT_OK(FTDCBSONUtil::extractMetricNames(doc, &names));
+
+    std::vector<std::string> expected{
+        "start", "a.b", "a.ts.t", "a.ts.i", "a.c.0", "a.c.1", "d"};
+    ASSERT_TRUE(names == expected);
+
+    std::vector<std::uint64_t> metrics;
+    ASSERT_OK(FTDCBSONUtil::extractMetricsFromDocument(doc, doc, &metrics).getStatus());
+    ASSERT_EQUALS(metrics.size(), names.size());
+    ASSERT_EQUALS(metrics[2], 5U);
+    ASSERT_EQUALS(metrics[3], 6U);
+}
+
 }  // namespace mongo
@@ -202,6 +202,18 @@ BSONObj FTSIndexFormat::getIndexKey(double weight,
     return b.obj();
 }
 
+double FTSIndexFormat::getScoreFromIndexKey(const FTSSpec& spec, const BSONObj& key) {
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(key);
+    for (unsigned i = 0; i < spec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    return keyIt.next().number();
+}
+
 void FTSIndexFormat::_appendIndexKey(BSONObjBuilder& b,
                                      double weight,
                                      const string& term,
@@ -57,6 +57,15 @@ public:
                                const BSONObj& indexPrefix,
                                TextIndexVersion textIndexVersion);
 
+    /**
+     * Returns the score stored in 'key', an entry of a text index with spec 'spec'.
+     *
+     * The keys of a term sort by score, so a reverse scan over the keys of a term visits its
+     * highest scoring documents first, and the score of each key bounds the scores of the keys
+     * after it.
+     */
+    static double getScoreFromIndexKey(const FTSSpec& spec, const BSONObj& key);
+
 private:
     /**
      * Helper method to get return entry from the FTSIndex as a BSONObj
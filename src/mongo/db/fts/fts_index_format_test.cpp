@@ -107,6 +107,24 @@ TEST(FTSIndexFormat, ExtraFront1) {
     ASSERT(i.next().numberDouble() > 0);
 }
 
+TEST(FTSIndexFormat, GetScoreFromIndexKey) {
+    FTSSpec spec(assertGet(FTSSpec::fixSpec(fromjson("{key: {x: 1, data: 'text', y: 1}}"))));
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    FTSIndexFormat::getKeys(spec, fromjson("{data: 'cat cat dog', x: 5, y: 6}"), &keys);
+
+    TermFrequencyMap scores;
+    spec.scoreDocument(fromjson("{data: 'cat cat dog'}"), &scores);
+
+    ASSERT_EQUALS(2U, keys.size());
+    for (auto&& key : keys) {
+        BSONObjIterator i(key);
+        i.next();
+        const std::string term = i.next().str();
+        ASSERT_EQUALS(scores[term], FTSIndexFormat::getScoreFromIndexKey(spec, key));
+    }
+    ASSERT_GREATER_THAN(scores["cat"], scores["dog"]);
+}
+
 TEST(FTSIndexFormat, StopWords1) {
     FTSSpec spec(assertGet(FTSSpec::fixSpec(BSON("key" << BSON("data"
                                                                << "text")))));
@@ -53,7 +53,8 @@ TwoDAccessMethod::TwoDAccessMethod(IndexCatalogEntry* btreeState,
 void TwoDAccessMethod::doGetKeys(const BSONObj& obj,
                                  BSONObjSet* keys,
                                  BSONObjSet* multikeyMetadataKeys,
-                                 MultikeyPaths* multikeyPaths) const {
+                                 MultikeyPaths* multikeyPaths,
+                                 boost::optional<RecordId> id) const {
     ExpressionKeysPrivate::get2DKeys(obj, _params, keys);
 }
 
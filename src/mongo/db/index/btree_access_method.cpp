@@ -63,7 +63,8 @@ BtreeAccessMethod::BtreeAccessMethod(IndexCatalogEntry* btreeState,
 void BtreeAccessMethod::doGetKeys(const BSONObj& obj,
                                   BSONObjSet* keys,
                                   BSONObjSet* multikeyMetadataKeys,
-                                  MultikeyPaths* multikeyPaths) const {
+                                  MultikeyPaths* multikeyPaths,
+                                  boost::optional<RecordId> id) const {
     _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
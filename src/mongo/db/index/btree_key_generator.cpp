@@ -29,6 +29,7 @@
 
 #include "mongo/db/index/btree_key_generator.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <memory>
 
@@ -76,6 +77,34 @@ BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
         invariant(pathLength > 0);
         _pathLengths.push_back(pathLength);
     }
+
+    // Build the trie of the indexed paths, sharing the nodes of common prefixes.
+    _pathTrie.emplace_back();
+    for (size_t i = 0; i < fieldNames.size(); ++i) {
+        FieldRef path{fieldNames[i]};
+        size_t nodeIndex = 0;
+        for (size_t part = 0; part < path.numParts(); ++part) {
+            const StringData component = path.getPart(part);
+            const auto& children = _pathTrie[nodeIndex].children;
+            auto child = std::find_if(children.begin(), children.end(), [&](size_t childIndex) {
+                return _pathTrie[childIndex].fieldName == component;
+            });
+            if (child != children.end()) {
+                nodeIndex = *child;
+                continue;
+            }
+
+            PathTrieNode newNode;
+            newNode.fieldName = component.toString();
+            _pathTrie.push_back(std::move(newNode));
+            _pathTrie[nodeIndex].children.push_back(_pathTrie.size() - 1);
+            if (_pathTrie[nodeIndex].children.size() > 64) {
+                _useSinglePassExtraction = false;
+            }
+            nodeIndex = _pathTrie.size() - 1;
+        }
+        _pathTrie[nodeIndex].keyPatternPositions.push_back(i);
+    }
 }
 
 static void assertParallelArrays(const char* first, const char* second) {
@@ -175,15 +204,83 @@ void BtreeKeyGenerator::getKeys(const BSONObj& obj,
             invariant(multikeyPaths->empty());
             multikeyPaths->resize(_fieldNames.size());
         }
-        // '_fieldNames' and '_fixed' are passed by value so that their copies can be mutated as
-        // part of the _getKeysWithArray method.
-        _getKeysWithArray(_fieldNames, _fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+
+        // Most documents have no arrays along the indexed paths and generate exactly one key. Find
+        // all of its values in one traversal of the document, and only fall back to the recursive
+        // expansion below if an array turns up.
+        std::vector<BSONElement> fixed(_fieldNames.size(), nullElt);
+        size_t numFound = 0;
+        if (_useSinglePassExtraction && _extractFieldsWithoutArrays(obj, 0, &fixed, &numFound)) {
+            if (!_isSparse || numFound > 0) {
+                BSONObjBuilder b(_sizeTracker);
+                for (const auto& elt : fixed) {
+                    CollationIndexKey::collationAwareIndexKeyAppend(elt, _collator, &b);
+                }
+                keys->insert(b.obj());
+            }
+        } else {
+            // '_fieldNames' and '_fixed' are passed by value so that their copies can be mutated
+            // as part of the _getKeysWithArray method.
+            _getKeysWithArray(
+                _fieldNames, _fixed, obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+        }
     }
     if (keys->empty() && !_isSparse) {
         keys->insert(_nullKey);
     }
 }
 
+bool BtreeKeyGenerator::_extractFieldsWithoutArrays(const BSONObj& obj,
+                                                    size_t nodeIndex,
+                                                    std::vector<BSONElement>* fixed,
+                                                    size_t* numFound) const {
+    const PathTrieNode& node = _pathTrie[nodeIndex];
+    const size_t numChildren = node.children.size();
+
+    // Like BSONObj::getField(), only the first occurrence of a field name is used, so remember
+    // which children have already been found.
+    uint64_t foundChildren = 0;
+    size_t numFoundChildren = 0;
+
+    for (auto&& elem : obj) {
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < numChildren; ++i) {
+            const uint64_t childBit = uint64_t{1} << i;
+            const size_t childIndex = node.children[i];
+            const PathTrieNode& child = _pathTrie[childIndex];
+            if ((foundChildren & childBit) || child.fieldName != fieldName) {
+                continue;
+            }
+
+            foundChildren |= childBit;
+            ++numFoundChildren;
+
+            if (elem.type() == Array) {
+                return false;
+            }
+
+            for (auto position : child.keyPatternPositions) {
+                (*fixed)[position] = elem;
+                ++*numFound;
+            }
+
+            // Paths continuing through a value which is neither an object nor an array do not
+            // exist, so their fields stay null.
+            if (!child.children.empty() && elem.type() == Object &&
+                !_extractFieldsWithoutArrays(elem.embeddedObject(), childIndex, fixed, numFound)) {
+                return false;
+            }
+            break;
+        }
+
+        if (numFoundChildren == numChildren) {
+            break;
+        }
+    }
+
+    return true;
+}
+
 void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
                                           std::vector<BSONElement> fixed,
                                           const BSONObj& obj,
@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
@@ -69,6 +70,36 @@ public:
     void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const;
 
 private:
+    /**
+     * A node of the trie formed by the dotted paths of the key pattern. Fields sharing a prefix,
+     * such as "a.b" and "a.c", share the nodes of that prefix, so the prefix is only looked up once
+     * per document.
+     */
+    struct PathTrieNode {
+        // The path component leading from the parent to this node. Empty for the root.
+        std::string fieldName;
+
+        // The positions in the key pattern of the indexed fields whose path ends at this node.
+        std::vector<size_t> keyPatternPositions;
+
+        // Indexes into '_pathTrie' of the children of this node.
+        std::vector<size_t> children;
+    };
+
+    /**
+     * Extracts the value of every indexed field of the document 'obj' in a single traversal of the
+     * document guided by '_pathTrie', starting at the trie node 'nodeIndex'. Stores the value of
+     * the field at position i of the key pattern in 'fixed[i]' and counts the fields found in
+     * 'numFound'. Fields which are not present are left untouched.
+     *
+     * Returns false as soon as an array is found along any indexed path, in which case the
+     * contents of 'fixed' must be ignored and the keys generated by _getKeysWithArray() instead.
+     */
+    bool _extractFieldsWithoutArrays(const BSONObj& obj,
+                                     size_t nodeIndex,
+                                     std::vector<BSONElement>* fixed,
+                                     size_t* numFound) const;
+
     // These are used by getKeys below.
     std::vector<const char*> _fieldNames;
     bool _isIdIndex;
@@ -201,6 +232,15 @@ private:
     // the vector is the number of path components in the indexed field.
     std::vector<size_t> _pathLengths;
 
+    // The trie of the paths of the indexed fields, with the root at index 0. Only used when
+    // '_useSinglePassExtraction' is true.
+    std::vector<PathTrieNode> _pathTrie;
+
+    // Whether documents without arrays along the indexed paths have their keys generated by
+    // _extractFieldsWithoutArrays(). False when a trie node has too many children to track which
+    // of them have been found in a single word.
+    bool _useSinglePassExtraction = true;
+
     // Null if this key generator orders strings according to the simple binary compare. If
     // non-null, represents the collator used to generate index keys for indexed strings.
     const CollatorInterface* _collator;
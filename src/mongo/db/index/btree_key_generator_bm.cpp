@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/btree_key_generator.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<BtreeKeyGenerator> makeKeyGenerator(const BSONObj& keyPattern) {
+    std::vector<const char*> fieldNames;
+    std::vector<BSONElement> fixed;
+    for (auto&& elem : keyPattern) {
+        fieldNames.push_back(elem.fieldName());
+        fixed.push_back(BSONElement());
+    }
+    return std::make_unique<BtreeKeyGenerator>(fieldNames, fixed, false, nullptr);
+}
+
+// A document shaped like a typical record, with the indexed fields spread among others.
+BSONObj makeDocument() {
+    return fromjson(
+        "{_id: 1, name: 'widget', status: 'active', created: 1234567890, owner: {id: 42, "
+        "name: 'someone', address: {city: 'Dublin', zip: '12345'}}, price: 19.99, qty: 7, "
+        "tags: ['a', 'b', 'c'], notes: 'a longer string value which is not indexed'}");
+}
+
+void runGetKeys(benchmark::State& state, const BSONObj& keyPattern, const BSONObj& doc) {
+    auto keyGen = makeKeyGenerator(keyPattern);
+    for (auto _ : state) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        keyGen->getKeys(doc, &keys, &multikeyPaths);
+        benchmark::DoNotOptimize(keys);
+    }
+}
+
+void BM_GetKeysSingleField(benchmark::State& state) {
+    runGetKeys(state, BSON("status" << 1), makeDocument());
+}
+
+void BM_GetKeysCompound(benchmark::State& state) {
+    runGetKeys(state, BSON("status" << 1 << "created" << -1 << "qty" << 1), makeDocument());
+}
+
+void BM_GetKeysDottedSharedPrefix(benchmark::State& state) {
+    runGetKeys(state,
+               BSON("owner.id" << 1 << "owner.address.city" << 1 << "owner.address.zip" << 1),
+               makeDocument());
+}
+
+void BM_GetKeysMultikey(benchmark::State& state) {
+    runGetKeys(state, BSON("tags" << 1 << "status" << 1), makeDocument());
+}
+
+// Generates the keys of several indexes over the same document, as an insert into a collection
+// with that many indexes would.
+void BM_GetKeysManyIndexes(benchmark::State& state) {
+    const std::vector<BSONObj> keyPatterns{BSON("name" << 1),
+                                           BSON("status" << 1 << "created" << -1),
+                                           BSON("owner.id" << 1),
+                                           BSON("owner.address.city" << 1 << "price" << 1),
+                                           BSON("qty" << 1),
+                                           BSON("created" << 1),
+                                           BSON("owner.name" << 1 << "status" << 1),
+                                           BSON("price" << -1),
+                                           BSON("owner.address.zip" << 1),
+                                           BSON("notes" << 1)};
+    std::vector<std::unique_ptr<BtreeKeyGenerator>> keyGens;
+    for (auto&& keyPattern : keyPatterns) {
+        keyGens.push_back(makeKeyGenerator(keyPattern));
+    }
+
+    const BSONObj doc = makeDocument();
+    for (auto _ : state) {
+        for (auto&& keyGen : keyGens) {
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            MultikeyPaths multikeyPaths;
+            keyGen->getKeys(doc, &keys, &multikeyPaths);
+            benchmark::DoNotOptimize(keys);
+        }
+    }
+}
+
+BENCHMARK(BM_GetKeysSingleField);
+BENCHMARK(BM_GetKeysCompound);
+BENCHMARK(BM_GetKeysDottedSharedPrefix);
+BENCHMARK(BM_GetKeysMultikey);
+BENCHMARK(BM_GetKeysManyIndexes);
+
+}  // namespace
+}  // namespace mongo
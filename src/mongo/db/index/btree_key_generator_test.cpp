@@ -1160,4 +1160,40 @@ TEST(BtreeKeyGeneratorTest, GetCollationAwareKeysFromNestedArray) {
         testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, false, &collator));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromObjectWithSharedPathPrefixes) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, 'a.c.d': 1, a: 1, 'a.c.e': 1}");
+    BSONObj genKeysFrom = fromjson("{x: 1, a: {c: {e: 3, d: 2}, b: 1}}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 1, '': 2, '': {c: {e: 3, d: 2}, b: 1}, '': 3}"));
+    MultikeyPaths expectedMultikeyPaths(4);
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromObjectUsesFirstOfDuplicateFieldNames) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, c: 1}");
+    BSONObj genKeysFrom = BSON("a" << 1 << "c" << 2 << "a" << BSON("b" << 3) << "c" << 4);
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': null, '': 2}"));
+    MultikeyPaths expectedMultikeyPaths(2);
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromArrayBelowSharedPathPrefix) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, 'a.c': 1}");
+    BSONObj genKeysFrom = fromjson("{a: {b: 1, c: [2, 3]}}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 1, '': 2}"));
+    expectedKeys.insert(fromjson("{'': 1, '': 3}"));
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, {1U}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromObjectWithScalarAlongPathSparse) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, 'a.c': 1}");
+    BSONObj genKeysFrom = fromjson("{a: 5}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths expectedMultikeyPaths(2);
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, true));
+}
+
 }  // namespace
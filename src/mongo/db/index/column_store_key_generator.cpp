@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_store_key_generator.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/field_ref.h"
+
+namespace mongo {
+
+constexpr StringData ColumnStoreKeyGenerator::kRowColumnPath;
+
+// static
+BSONObj ColumnStoreKeyGenerator::makeKey(StringData path,
+                                         const RecordId& id,
+                                         CellKind kind,
+                                         BSONElement value) {
+    BSONObjBuilder bob;
+    bob.append("", path);
+    bob.append("", static_cast<long long>(id.repr()));
+    bob.append("", static_cast<int>(kind));
+    if (value.eoo()) {
+        bob.appendNull("");
+    } else {
+        bob.appendAs(value, "");
+    }
+    return bob.obj();
+}
+
+// static
+BSONObj ColumnStoreKeyGenerator::makeSeekKey(StringData path, const RecordId& id) {
+    BSONObjBuilder bob;
+    bob.append("", path);
+    bob.append("", static_cast<long long>(id.repr()));
+    return bob.obj();
+}
+
+// static
+ColumnStoreKeyGenerator::Cell ColumnStoreKeyGenerator::parseKey(const BSONObj& key) {
+    BSONObjIterator it(key);
+    Cell cell;
+    cell.path = it.next().valueStringData();
+    cell.id = RecordId(it.next().numberLong());
+    cell.kind = static_cast<CellKind>(it.next().numberInt());
+    const auto value = it.next();
+    if (cell.kind == CellKind::kValue) {
+        cell.value = value;
+    }
+    return cell;
+}
+
+ColumnStoreKeyGenerator::ColumnStoreKeyGenerator(const BSONObj& keyPattern) {
+    for (auto&& elem : keyPattern) {
+        if (elem.fieldNameStringData() == "$**") {
+            invariant(keyPattern.nFields() == 1);
+            break;
+        }
+        _paths.push_back(elem.fieldName());
+    }
+}
+
+void ColumnStoreKeyGenerator::generateKeys(const BSONObj& obj,
+                                           const RecordId& id,
+                                           BSONObjSet* keys) const {
+    const auto idElem = obj["_id"];
+    keys->insert(makeKey(kRowColumnPath,
+                         id,
+                         idElem.eoo() ? CellKind::kFetchDocument : CellKind::kValue,
+                         idElem));
+
+    if (_paths.empty()) {
+        for (auto&& elem : obj) {
+            if (elem.fieldNameStringData() == "_id") {
+                continue;
+            }
+            keys->insert(makeKey(elem.fieldNameStringData(), id, CellKind::kValue, elem));
+        }
+        return;
+    }
+
+    for (auto&& path : _paths) {
+        const FieldRef fieldRef(path);
+        BSONObj current = obj;
+        for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+            const auto elem = current[fieldRef.getPart(i)];
+            if (i == fieldRef.numParts() - 1) {
+                if (!elem.eoo()) {
+                    keys->insert(makeKey(path, id, CellKind::kValue, elem));
+                }
+            } else if (elem.type() == BSONType::Object) {
+                current = elem.embeddedObject();
+                continue;
+            } else if (elem.type() == BSONType::Array) {
+                keys->insert(makeKey(path, id, CellKind::kFetchDocument, BSONElement()));
+            }
+
+            // The path ends here, either at its last component, at an array, or because it is
+            // missing from the document.
+            break;
+        }
+    }
+}
+
+}  // namespace mongo
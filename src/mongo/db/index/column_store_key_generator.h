@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * Generates the keys of a columnstore index. A columnstore index stores the value of each of its
+ * paths in every document as a column, so that queries which need only a few fields can read just
+ * those fields. Every key has the form
+ *      { '': <column path>, '': <RecordId>, '': <cell kind>, '': <value> }
+ * which keeps the cells of each column together, in RecordId order, so that several columns can be
+ * read in step. Each document also has a cell in the row column, whose path is empty, so that
+ * documents with none of the indexed paths are still listed. The row column holds the _id of the
+ * document, so every columnstore index can provide the _id field; the rare document without an _id
+ * has a row cell which requires it to be fetched.
+ *
+ * A column holds the value found at its path without traversing arrays. If an array is found before
+ * the last component of the path, the cell only records that the document has to be fetched. An
+ * index with the key pattern { '$**': 'columnstore' } has a column for every top-level field other
+ * than _id.
+ */
+class ColumnStoreKeyGenerator {
+public:
+    // The path of the row column.
+    static constexpr StringData kRowColumnPath = ""_sd;
+
+    enum class CellKind {
+        // The cell holds the value at the path of the column.
+        kValue = 0,
+        // An array was found along the path of the column, or the document has no _id, so the
+        // document must be fetched.
+        kFetchDocument = 1,
+    };
+
+    /**
+     * A key of a columnstore index, unpacked. 'value' is EOO unless 'kind' is kValue.
+     */
+    struct Cell {
+        StringData path;
+        RecordId id;
+        CellKind kind;
+        BSONElement value;
+    };
+
+    /**
+     * Builds the key for a cell in the column 'path' of the document 'id'.
+     */
+    static BSONObj makeKey(StringData path, const RecordId& id, CellKind kind, BSONElement value);
+
+    /**
+     * Builds a key which sorts immediately before every key of the document 'id' in the column
+     * 'path'.
+     */
+    static BSONObj makeSeekKey(StringData path, const RecordId& id);
+
+    /**
+     * Unpacks a key made by makeKey(). The returned cell points into 'key'.
+     */
+    static Cell parseKey(const BSONObj& key);
+
+    explicit ColumnStoreKeyGenerator(const BSONObj& keyPattern);
+
+    /**
+     * Adds the keys of the document 'obj', stored with the RecordId 'id', to 'keys'.
+     */
+    void generateKeys(const BSONObj& obj, const RecordId& id, BSONObjSet* keys) const;
+
+private:
+    // The paths of the columns. Empty if every top-level field has a column.
+    std::vector<std::string> _paths;
+};
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/column_store_key_generator.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using CellKind = ColumnStoreKeyGenerator::CellKind;
+
+const RecordId kId(42);
+
+BSONObjSet generateKeys(const char* keyPattern, const char* doc) {
+    ColumnStoreKeyGenerator keyGen(fromjson(keyPattern));
+    auto keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    keyGen.generateKeys(fromjson(doc), kId, &keys);
+    return keys;
+}
+
+BSONObj valueKey(StringData path, const char* valueObj) {
+    return ColumnStoreKeyGenerator::makeKey(
+        path, kId, CellKind::kValue, fromjson(valueObj).firstElement());
+}
+
+BSONObj rowKey() {
+    return ColumnStoreKeyGenerator::makeKey(
+        ColumnStoreKeyGenerator::kRowColumnPath, kId, CellKind::kValue, BSON("_id" << 1)["_id"]);
+}
+
+void assertKeys(std::vector<BSONObj> expected, const BSONObjSet& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (auto&& key : expected) {
+        ASSERT_EQ(1U, actual.count(key)) << key;
+    }
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ParseKeyRoundTrips) {
+    const auto key = valueKey("a.b", "{v: 'str'}");
+    const auto cell = ColumnStoreKeyGenerator::parseKey(key);
+    ASSERT_EQ("a.b", cell.path);
+    ASSERT_EQ(kId, cell.id);
+    ASSERT(cell.kind == CellKind::kValue);
+    ASSERT_EQ("str", cell.value.String());
+
+    const auto rowCell = ColumnStoreKeyGenerator::parseKey(rowKey());
+    ASSERT_EQ(ColumnStoreKeyGenerator::kRowColumnPath, rowCell.path);
+    ASSERT_EQ(1, rowCell.value.numberInt());
+
+}
+
+TEST(ColumnStoreKeyGeneratorTest, SeekKeySortsBeforeCellsOfDocument) {
+    const auto seekKey = ColumnStoreKeyGenerator::makeSeekKey("a", kId);
+    ASSERT_LT(seekKey.woCompare(valueKey("a", "{v: {$minKey: 1}}"), BSONObj(), false), 0);
+    ASSERT_GT(seekKey.woCompare(ColumnStoreKeyGenerator::makeKey(
+                                    "a", RecordId(41), CellKind::kValue, BSONElement()),
+                                BSONObj(),
+                                false),
+              0);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, GeneratesOneCellPerPath) {
+    auto keys = generateKeys("{a: 'columnstore', 'b.c': 'columnstore'}",
+                             "{_id: 1, a: [1, 2], b: {c: {d: 1}}, e: 1}");
+    assertKeys({rowKey(), valueKey("a", "{v: [1, 2]}"), valueKey("b.c", "{v: {d: 1}}")}, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, MissingPathsHaveNoCell) {
+    auto keys = generateKeys("{a: 'columnstore', 'b.c': 'columnstore'}", "{_id: 1, b: 1}");
+    assertKeys({rowKey()}, keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, ArrayAlongPathRequiresFetch) {
+    auto keys = generateKeys("{'b.c': 'columnstore'}", "{_id: 1, b: [{c: 1}, {c: 2}]}");
+    assertKeys({rowKey(),
+                ColumnStoreKeyGenerator::makeKey("b.c", kId, CellKind::kFetchDocument, {})},
+               keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, DocumentWithoutIdRequiresFetch) {
+    auto keys = generateKeys("{a: 'columnstore'}", "{a: 1}");
+    assertKeys({ColumnStoreKeyGenerator::makeKey(
+                    ColumnStoreKeyGenerator::kRowColumnPath, kId, CellKind::kFetchDocument, {}),
+                valueKey("a", "{v: 1}")},
+               keys);
+}
+
+TEST(ColumnStoreKeyGeneratorTest, AllFieldsPatternHasColumnPerTopLevelField) {
+    auto keys = generateKeys("{'$**': 'columnstore'}", "{_id: 1, a: {b: [1]}, c: null}");
+    assertKeys({rowKey(),
+                valueKey("a", "{v: {b: [1]}}"),
+                valueKey("c", "{v: null}")},
+               keys);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -178,7 +178,7 @@ Status AbstractIndexAccessMethod::insert(OperationContext* opCtx,
     MultikeyPaths multikeyPaths;
 
     // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+    getKeys(obj, options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths, loc);
 
     return insertKeys(opCtx,
                       {keys.begin(), keys.end()},
@@ -297,7 +297,12 @@ Status AbstractIndexAccessMethod::touch(OperationContext* opCtx, const BSONObj&
     // multikey when paging a document's index entries into memory.
     BSONObjSet* multikeyMetadataKeys = nullptr;
     MultikeyPaths* multikeyPaths = nullptr;
-    getKeys(obj, GetKeysMode::kEnforceConstraints, &keys, multikeyMetadataKeys, multikeyPaths);
+    getKeys(obj,
+            GetKeysMode::kEnforceConstraints,
+            &keys,
+            multikeyMetadataKeys,
+            multikeyPaths,
+            boost::none);
 
     std::unique_ptr<SortedDataInterface::Cursor> cursor(_newInterface->newCursor(opCtx));
     for (const auto& key : keys) {
@@ -325,7 +330,8 @@ RecordId AbstractIndexAccessMethod::findSingle(OperationContext* opCtx,
                 GetKeysMode::kEnforceConstraints,
                 &keys,
                 multikeyMetadataKeys,
-                multikeyPaths);
+                multikeyPaths,
+                boost::none);
         invariant(keys.size() == 1);
         actualKey = *keys.begin();
     } else {
@@ -419,7 +425,7 @@ void AbstractIndexAccessMethod::prepareUpdate(OperationContext* opCtx,
         // There's no need to compute the prefixes of the indexed fields that possibly caused the
         // index to be multikey when the old version of the document was written since the index
         // metadata isn't updated when keys are deleted.
-        getKeys(from, getKeysMode, &ticket->oldKeys, nullptr, nullptr);
+        getKeys(from, getKeysMode, &ticket->oldKeys, nullptr, nullptr, record);
     }
 
     if (!indexFilter || indexFilter->matchesBSON(to)) {
@@ -427,7 +433,8 @@ void AbstractIndexAccessMethod::prepareUpdate(OperationContext* opCtx,
                 options.getKeysMode,
                 &ticket->newKeys,
                 &ticket->newMultikeyMetadataKeys,
-                &ticket->newMultikeyPaths);
+                &ticket->newMultikeyPaths,
+                record);
     }
 
     ticket->loc = record;
@@ -565,7 +572,8 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
     MultikeyPaths multikeyPaths;
 
     try {
-        _real->getKeys(obj, options.getKeysMode, &keys, &_multikeyMetadataKeys, &multikeyPaths);
+        _real->getKeys(
+            obj, options.getKeysMode, &keys, &_multikeyMetadataKeys, &multikeyPaths, loc);
     } catch (...) {
         return exceptionToStatus();
     }
@@ -727,7 +735,8 @@ void AbstractIndexAccessMethod::getKeys(const BSONObj& obj,
                                         GetKeysMode mode,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyMetadataKeys,
-                                        MultikeyPaths* multikeyPaths) const {
+                                        MultikeyPaths* multikeyPaths,
+                                        boost::optional<RecordId> id) const {
     // TODO SERVER-36385: Remove ErrorCodes::KeyTooLong.
     static stdx::unordered_set<int> whiteList{ErrorCodes::CannotBuildIndexKeys,
                                               // Btree
@@ -754,7 +763,7 @@ void AbstractIndexAccessMethod::getKeys(const BSONObj& obj,
                                               13026,
                                               13027};
     try {
-        doGetKeys(obj, keys, multikeyMetadataKeys, multikeyPaths);
+        doGetKeys(obj, keys, multikeyMetadataKeys, multikeyPaths, id);
     } catch (const AssertionException& ex) {
         // Suppress all indexing errors when mode is kRelaxConstraints.
         if (mode == GetKeysMode::kEnforceConstraints) {
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <atomic>
+#include <boost/optional.hpp>
 #include <memory>
 #include <set>
 
@@ -304,12 +305,16 @@ public:
      * BSONObjSet with any multikey metadata keys generated while processing the document. These
      * keys are not associated with the document itself, but instead represent multi-key path
      * information that must be stored in a reserved keyspace within the index.
+     *
+     * 'id' is the RecordId of 'obj', when it is known. Index types whose keys embed the RecordId
+     * generate no keys without it.
      */
     virtual void getKeys(const BSONObj& obj,
                          GetKeysMode mode,
                          BSONObjSet* keys,
                          BSONObjSet* multikeyMetadataKeys,
-                         MultikeyPaths* multikeyPaths) const = 0;
+                         MultikeyPaths* multikeyPaths,
+                         boost::optional<RecordId> id) const = 0;
 
     /**
      * Given the set of keys, multikeyMetadataKeys and multikeyPaths generated by a particular
@@ -521,7 +526,8 @@ public:
                  GetKeysMode mode,
                  BSONObjSet* keys,
                  BSONObjSet* multikeyMetadataKeys,
-                 MultikeyPaths* multikeyPaths) const final;
+                 MultikeyPaths* multikeyPaths,
+                 boost::optional<RecordId> id) const final;
 
     bool shouldMarkIndexAsMultikey(const std::vector<BSONObj>& keys,
                                    const std::vector<BSONObj>& multikeyMetadataKeys,
@@ -543,11 +549,14 @@ protected:
      * BSONObjSet with any multikey metadata keys generated while processing the document. These
      * keys are not associated with the document itself, but instead represent multi-key path
      * information that must be stored in a reserved keyspace within the index.
+     *
+     * 'id' is the RecordId of 'obj', or boost::none if it is not known.
      */
     virtual void doGetKeys(const BSONObj& obj,
                            BSONObjSet* keys,
                            BSONObjSet* multikeyMetadataKeys,
-                           MultikeyPaths* multikeyPaths) const = 0;
+                           MultikeyPaths* multikeyPaths,
+                           boost::optional<RecordId> id) const = 0;
 
     IndexCatalogEntry* const _btreeState;  // owned by IndexCatalogEntry
     const IndexDescriptor* const _descriptor;
@@ -83,7 +83,8 @@ SortKeyGenerator::SortKeyGenerator(const BSONObj& sortSpec, const CollatorInterf
 }
 
 StatusWith<BSONObj> SortKeyGenerator::getSortKey(const BSONObj& obj,
-                                                 const Metadata* metadata) const {
+                                                 const Metadata* metadata,
+                                                 BufferArena* arena) const {
     if (_sortHasMeta) {
         invariant(metadata);
     }
@@ -98,7 +99,7 @@ StatusWith<BSONObj> SortKeyGenerator::getSortKey(const BSONObj& obj,
         return indexKey;
     }
 
-    BSONObjBuilder mergedKeyBob;
+    BSONObjBuilder mergedKeyBob(arena);
 
     // Merge metadata into the key.
     BSONObjIterator sortKeyIt(indexKey.getValue());
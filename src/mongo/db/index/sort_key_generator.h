@@ -33,6 +33,7 @@
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/buffer_arena.h"
 
 namespace mongo {
 
@@ -62,8 +63,13 @@ public:
      * The caller must supply the appropriate 'metadata' in the case that the sort pattern includes
      * a $meta sort (i.e. if sortHasMeta() is true). These values are filled in at the corresponding
      * positions in the sort key.
+     *
+     * If an 'arena' is given, the sort key is assembled in it and only the finished key is copied
+     * to the heap.
      */
-    StatusWith<BSONObj> getSortKey(const BSONObj& obj, const Metadata*) const;
+    StatusWith<BSONObj> getSortKey(const BSONObj& obj,
+                                   const Metadata*,
+                                   BufferArena* arena = nullptr) const;
 
     /**
      * Returns true if the sort pattern for this sort key generator includes a $meta sort.
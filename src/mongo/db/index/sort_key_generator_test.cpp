@@ -223,5 +223,20 @@ TEST(SortKeyGeneratorTest, CanGenerateKeysForCompoundMetaSort) {
                       BSON("" << 4 << "" << 0.3 << "" << 1.5 << "" << 5 << "" << 1.5));
 }
 
+TEST(SortKeyGeneratorTest, KeyAssembledInArenaOutlivesIt) {
+    BSONObj pattern = fromjson("{a: 1, b: {$meta: 'textScore'}}");
+    auto sortKeyGen = std::make_unique<SortKeyGenerator>(pattern, nullptr);
+    SortKeyGenerator::Metadata metadata;
+    metadata.textScore = 2.5;
+
+    StatusWith<BSONObj> sortKey = BSONObj();
+    {
+        BufferArena arena;
+        sortKey = sortKeyGen->getSortKey(BSON("a" << 4), &metadata, &arena);
+    }
+    ASSERT_OK(sortKey.getStatus());
+    ASSERT_BSONOBJ_EQ(sortKey.getValue(), BSON("" << 4 << "" << 2.5));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -48,6 +48,7 @@
 #include "mongo/base/init.h"
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -58,6 +59,7 @@
 #include "mongo/logger/rotatable_file_writer.h"
 #include "mongo/logger/syslog_appender.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
@@ -205,6 +207,25 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+/**
+ * Returns 'appender', for the global log domain, wrapped so that a background thread writes the
+ * messages if logAsyncBufferSizeKB is set.
+ */
+std::unique_ptr<logger::MessageLogDomain::EventAppender> makeGlobalAppender(
+    std::unique_ptr<logger::MessageLogDomain::EventAppender> appender) {
+    if (gLogAsyncBufferSizeKB == 0)
+        return appender;
+
+    const size_t bufferSizeBytes = size_t(gLogAsyncBufferSizeKB) * 1024;
+    const size_t totalBufferSizeBytes = size_t(gLogAsyncBufferTotalSizeMB) * 1024 * 1024;
+    return std::make_unique<logger::AsyncAppender>(
+        std::move(appender), bufferSizeBytes, totalBufferSizeBytes);
+}
+
+}  // namespace
+
 // On POSIX platforms we need to set our umask before opening any log files, so this
 // should depend on MungeUmask above, but not on Windows.
 MONGO_INITIALIZER_GENERAL(
@@ -236,8 +257,8 @@ MONGO_INITIALIZER_GENERAL(
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
         manager->getGlobalDomain()->attachAppender(
-            std::make_unique<SyslogAppender<MessageEventEphemeral>>(
-                std::make_unique<logger::MessageEventDetailsEncoder>()));
+            makeGlobalAppender(std::make_unique<SyslogAppender<MessageEventEphemeral>>(
+                std::make_unique<logger::MessageEventDetailsEncoder>())));
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(std::make_unique<SyslogAppender<MessageEventEphemeral>>(
                 std::make_unique<logger::MessageEventDetailsEncoder>()));
@@ -294,8 +315,8 @@ MONGO_INITIALIZER_GENERAL(
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
         manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+            makeGlobalAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue())));
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
                 std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
@@ -316,6 +337,9 @@ MONGO_INITIALIZER_GENERAL(
     logger::globalLogDomain()->attachAppender(
         std::make_unique<RamLogAppender>(RamLog::get("global")));
 
+    // Write the log messages still queued at shutdown, and those logged afterwards synchronously.
+    registerShutdownTask([] { logger::AsyncAppender::shutdownAll(); });
+
     return Status::OK();
 }
 
@@ -0,0 +1,61 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/buffer_arena.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * A BufferArena stored as a decoration on the OperationContext, in which query execution builds
+ * the small objects it makes for each document, such as sort keys.
+ *
+ * Nothing that can outlive the operation may be allocated here. In particular WorkingSet members,
+ * pipeline Values and anything cached by a cursor stay on the heap, since a cursor survives from
+ * one getMore, and thus one OperationContext, to the next. Builders using the arena copy the
+ * finished object out of it, at its exact size, when obj() is called, so the result may be kept.
+ * The buffer of such a builder is then the most recent allocation in the arena, so the next one
+ * reuses its memory and the arena does not grow with the number of objects built.
+ */
+class OperationArena {
+public:
+    static BufferArena* get(OperationContext* opCtx);
+
+    // Most operations allocate nothing, or only a few small objects, so the first chunk is kept
+    // small. Busier operations get larger chunks as the arena grows.
+    static constexpr size_t kFirstChunkSize = 4 * 1024;
+
+private:
+    BufferArena _arena{kFirstChunkSize};
+};
+
+}  // namespace mongo
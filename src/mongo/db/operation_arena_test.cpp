@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_arena.h"
+
+#include <vector>
+
+#include "mongo/db/client.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(OperationArenaTest, EachOperationHasItsOwnArena) {
+    auto serviceCtx = ServiceContext::make();
+    auto client = serviceCtx->makeClient("OperationArenaTest");
+    auto opCtx = client->makeOperationContext();
+
+    auto arena = OperationArena::get(opCtx.get());
+    ASSERT_EQ(arena, OperationArena::get(opCtx.get()));
+    ASSERT_EQ(arena->bytesReserved(), 0U);
+
+    auto otherClient = serviceCtx->makeClient("OperationArenaTestOther");
+    auto otherOpCtx = otherClient->makeOperationContext();
+    ASSERT_NE(arena, OperationArena::get(otherOpCtx.get()));
+}
+
+TEST(OperationArenaTest, BuiltObjectsAreCopiedOutOfTheArena) {
+    auto serviceCtx = ServiceContext::make();
+    auto client = serviceCtx->makeClient("OperationArenaTest");
+    auto opCtx = client->makeOperationContext();
+    auto arena = OperationArena::get(opCtx.get());
+
+    std::vector<BSONObj> objs;
+    for (int i = 0; i < 1000; i++) {
+        BSONObjBuilder bob(arena);
+        bob.append("a", i);
+        bob.append("b", "two");
+        objs.push_back(bob.obj());
+    }
+
+    // Each builder reused the memory of the one before, and the objects are intact.
+    ASSERT_EQ(arena->bytesReserved(), OperationArena::kFirstChunkSize);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_BSONOBJ_EQ(objs[i],
+                          BSON("a" << i << "b"
+                                   << "two"));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
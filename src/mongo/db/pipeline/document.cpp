@@ -36,6 +36,8 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -54,7 +56,7 @@ const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldSortKey,
     Document::metaFieldTextScore};
 
-Position DocumentStorage::findField(StringData requested) const {
+Position DocumentStorage::findFieldInBuffer(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -82,7 +84,7 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
-Value& DocumentStorage::appendField(StringData name) {
+Value& DocumentStorage::appendFieldToBuffer(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -109,7 +111,7 @@ Value& DocumentStorage::appendField(StringData name) {
 #undef append
 
     // Make sure next field starts where we expect it
-    fassert(16486, getField(pos).next()->ptr() == _buffer + _usedBytes);
+    fassert(16486, elementAt(pos).next()->ptr() == _buffer + _usedBytes);
 
     _numFields++;
 
@@ -120,12 +122,52 @@ Value& DocumentStorage::appendField(StringData name) {
         rehash();
     }
 
-    return getField(pos).val;
+    return elementAt(pos).val;
+}
+
+Position DocumentStorage::loadNextField() {
+    if (kDebugBuild) {
+        invariant(!_loadingField.swap(true),
+                  "Document fields loaded by several threads at once; call loadAllFields() first");
+    }
+    ON_BLOCK_EXIT([&] {
+        if (kDebugBuild) {
+            _loadingField.store(false);
+        }
+    });
+
+    const BSONElement elem(_bson.objdata() + _bsonOffset);
+    _bsonOffset += elem.size();
+    if (_bsonOffset == static_cast<unsigned>(_bson.objsize()) - 1) {
+        _bsonOffset = 0;  // only the EOO byte is left
+    }
+
+    // Embedded objects share the buffer of _bson, and are loaded lazily in turn.
+    Value value = elem.type() == BSONType::Object && !elem.embeddedObject().isEmpty()
+        ? Value(Document(make_intrusive<DocumentStorage>(
+              elem.embeddedObject().shareOwnershipWith(_bson.sharedBuffer()), _bsonBufferSize)))
+        : Value(elem);
+
+    const Position pos = getNextPosition();
+    appendFieldToBuffer(elem.fieldNameStringData()) = std::move(value);
+    return pos;
+}
+
+Position DocumentStorage::loadFieldsUntil(StringData name) {
+    while (_bsonOffset) {
+        const bool isRequested =
+            BSONElement(_bson.objdata() + _bsonOffset).fieldNameStringData() == name;
+        const Position pos = loadNextField();
+        if (isRequested) {
+            return pos;
+        }
+    }
+    return Position();
 }
 
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
+    ValueElement& elem = elementAt(pos);
     elem.nextCollision = Position();
 
     const unsigned bucket = bucketForKey(elem.nameSD());
@@ -133,7 +175,7 @@ void DocumentStorage::addFieldToHashTable(Position pos) {
     Position* posPtr = &_hashTab[bucket];
     while (posPtr->found()) {
         // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+        posPtr = &elementAt(*posPtr).nextCollision;
     }
     *posPtr = Position(pos.index);
 }
@@ -219,6 +261,11 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         dassert(out->_numFields == _numFields);
     }
 
+    out->_bson = _bson;
+    out->_bsonBufferSize = _bsonBufferSize;
+    out->_bsonOffset = _bsonOffset;
+    out->_modified = _modified;
+
     // Copy metadata
     if (_metaFields.any()) {
         out->_metaFields = _metaFields;
@@ -257,15 +304,9 @@ DocumentStorage::~DocumentStorage() {
 }
 
 Document::Document(const BSONObj& bson) {
-    MutableDocument md(bson.nFields());
-
-    BSONObjIterator it(bson);
-    while (it.more()) {
-        BSONElement bsonElement(it.next());
-        md.addField(bsonElement.fieldNameStringData(), Value(bsonElement));
+    if (!bson.isEmpty()) {
+        _storage = make_intrusive<DocumentStorage>(bson.getOwned());
     }
-
-    *this = md.freeze();
 }
 
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
@@ -285,6 +326,34 @@ BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d
     return builder.builder();
 }
 
+namespace {
+/**
+ * Returns true if 'obj' has values nested more than 'maxDepth' levels below its own fields. The
+ * contents of an empty array are not counted as a level, as Value::addToBsonObj() does not count
+ * them.
+ */
+bool isNestedDeeperThan(const BSONObj& obj, size_t maxDepth) {
+    for (auto&& elem : obj) {
+        if (elem.type() == BSONType::Object ||
+            (elem.type() == BSONType::Array && !elem.embeddedObject().isEmpty())) {
+            if (maxDepth == 0 || isNestedDeeperThan(elem.embeddedObject(), maxDepth - 1)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * True if the BSON backing 'storage' can be copied as is to serialize it at depth
+ * 'recursionLevel'.
+ */
+bool canCopyBson(const DocumentStorage& storage, size_t recursionLevel) {
+    return storage.isUnmodifiedBson() &&
+        !isNestedDeeperThan(storage.bson(), BSONDepth::getMaxAllowableDepth() - recursionLevel);
+}
+}  // namespace
+
 void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
     uassert(ErrorCodes::Overflow,
             str::stream() << "cannot convert document to BSON because it exceeds the limit of "
@@ -292,17 +361,36 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (canCopyBson(storage(), recursionLevel)) {
+        builder->appendElements(storage().bson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    if (canCopyBson(storage(), 1)) {
+        return storage().bson();
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
 }
 
+BSONObj Document::toBson(const BSONSizeTracker& sizeTracker) const {
+    if (canCopyBson(storage(), 1)) {
+        return storage().bson();
+    }
+
+    BSONObjBuilder bb(sizeTracker);
+    toBson(&bb);
+    return bb.obj();
+}
+
 constexpr StringData Document::metaFieldTextScore;
 constexpr StringData Document::metaFieldRandVal;
 constexpr StringData Document::metaFieldSortKey;
@@ -442,16 +530,48 @@ const Value Document::getNestedField(const FieldPath& path, vector<Position>* po
     return getNestedFieldHelper(*this, path, positions, 0);
 }
 
+namespace {
+void loadAllFieldsOf(const Value& value) {
+    if (value.getType() == BSONType::Object) {
+        value.getDocument().loadAllFields();
+    } else if (value.getType() == BSONType::Array) {
+        for (auto&& elem : value.getArray()) {
+            loadAllFieldsOf(elem);
+        }
+    }
+}
+}  // namespace
+
+void Document::loadAllFields() const {
+    if (!_storage)
+        return;
+
+    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        loadAllFieldsOf(it->val);
+    }
+}
+
 size_t Document::getApproximateSize() const {
     if (!_storage)
         return 0;  // we've allocated no memory
 
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
+    size += storage().bsonBufferSize();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Only count the fields loaded so far, rather than loading them all. The rest are counted as
+    // part of the BSON above. Missing values add nothing.
+    for (DocumentStorageIterator it = storage().iteratorAll(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
+
+        // An embedded document loaded from our BSON counts the buffer we have already counted.
+        if (it->val.getType() == BSONType::Object) {
+            const Document embedded = it->val.getDocument();
+            if (embedded._storage && embedded.storage().sharesBsonBufferWith(storage())) {
+                size -= embedded.storage().bsonBufferSize();
+            }
+        }
     }
 
     // The metadata also occupies space in the document storage that's pre-allocated.
@@ -40,6 +40,7 @@
 
 namespace mongo {
 class BSONObj;
+class BSONSizeTracker;
 class FieldIterator;
 class FieldPath;
 class Value;
@@ -65,6 +66,11 @@ class Position;
  *  pass and return by Value. Note that the data in a Document is
  *  immutable, but you can replace a Document instance with assignment.
  *
+ *  A Document constructed from BSON converts its fields to Values as they are looked up, so even
+ *  const member functions may modify the storage it shares with its copies. A Document may
+ *  therefore only be read by several threads at once after loadAllFields() has been called on
+ *  it. Debug builds check that no two threads load fields of the same storage at the same time.
+ *
  *  See Also: Value class in Value.h
  */
 class Document {
@@ -104,7 +110,11 @@ public:
     /// Empty Document (does no allocation)
     Document() {}
 
-    /// Create a new Document deep-converted from the given BSONObj.
+    /**
+     * Create a new Document from the given BSONObj. The Document keeps an owned copy of the
+     * BSONObj, and converts its fields to Values only as they are accessed. Until a field is
+     * modified, serializing the Document copies the BSONObj.
+     */
     explicit Document(const BSONObj& bson);
 
     /**
@@ -149,18 +159,26 @@ public:
 
     /// True if this document has no fields.
     bool empty() const {
-        return !_storage || storage().iterator().atEnd();
+        return !_storage || storage().empty();
     }
 
     /// Create a new FieldIterator that can be used to examine the Document's fields in order.
     FieldIterator fieldIterator() const;
 
+    /**
+     * Converts every field still held as BSON to a Value, here and in all embedded Documents.
+     * Looking up a field of a Document constructed from BSON may load it into the shared storage,
+     * so a Document must be fully loaded before several threads read it at once.
+     */
+    void loadAllFields() const;
+
     /// Convenience type for dealing with fields. Used by FieldIterator.
     typedef std::pair<StringData, Value> FieldPair;
 
     /** Get the approximate storage size of the document and sub-values in bytes.
      *  Note: Some memory may be shared with other Documents or between fields within
-     *        a single Document so this can overestimate usage.
+     *        a single Document so this can overestimate usage. In particular, a Document
+     *        embedded in one constructed from BSON counts all of that BSON, which it keeps alive.
      *
      *  Note: the value returned by this function includes the size of the metadata associated with
      *  the document.
@@ -220,6 +238,13 @@ public:
     void toBson(BSONObjBuilder* builder, size_t recursionLevel = 1) const;
     BSONObj toBson() const;
 
+    /**
+     * Like toBson(), but sizes the buffer for the BSONObj after the objects previously built with
+     * 'sizeTracker'. Documents of a similar shape then do not have to grow the buffer as they are
+     * serialized.
+     */
+    BSONObj toBson(const BSONSizeTracker& sizeTracker) const;
+
     /**
      * Like toBson, but includes metadata at the top-level.
      * Output is parseable by fromBsonWithMetaData
@@ -327,6 +352,7 @@ public:
     }
 
 private:
+    friend class DocumentStorage;
     friend class FieldIterator;
     friend class ValueStorage;
     friend class MutableDocument;
@@ -35,7 +35,9 @@
 #include <boost/intrusive_ptr.hpp>
 
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -180,7 +182,14 @@ private:
     bool _includeMissing;
 };
 
-/// Storage class used by both Document and MutableDocument
+/**
+ * Storage class used by both Document and MutableDocument
+ *
+ * Storage constructed from BSON keeps the BSON and loads its fields into the buffer only as they
+ * are looked up, in the order they appear in the BSON. Loading fields is not a logical change to
+ * the storage, and so is done by const methods too. As loading may reallocate the buffer, storage
+ * with fields left to load must not be read by several threads at once.
+ */
 class DocumentStorage : public RefCountable {
 public:
     DocumentStorage()
@@ -189,12 +198,29 @@ public:
           _usedBytes(0),
           _numFields(0),
           _hashTabMask(0),
+          _bsonBufferSize(0),
+          _bsonOffset(0),
+          _modified(false),
           _metaFields(),
           _textScore(0),
           _randVal(0),
           _geoNearDistance(0),
           _searchScore(0) {}
 
+    /// Storage backed by 'bson', which must be owned.
+    explicit DocumentStorage(BSONObj bson) : DocumentStorage() {
+        invariant(bson.isOwned());
+        _bson = std::move(bson);
+        _bsonBufferSize = _bson.isEmpty() ? 0 : _bson.objsize();
+        _bsonOffset = _bson.isEmpty() ? 0 : sizeof(int32_t);
+    }
+
+    /// Storage backed by 'bson', which is embedded in the BSON of an enclosing document, whose
+    /// 'bsonBufferSize' bytes it keeps alive.
+    DocumentStorage(BSONObj bson, unsigned bsonBufferSize) : DocumentStorage(std::move(bson)) {
+        _bsonBufferSize = bsonBufferSize;
+    }
+
     ~DocumentStorage();
 
     enum MetaType : char {
@@ -222,13 +248,45 @@ public:
         return count;
     }
 
+    bool empty() const {
+        // Fields not loaded yet cannot have been removed.
+        return !_bsonOffset && DocumentStorageIterator(_firstElement, end(), false).atEnd();
+    }
+
+    /**
+     * True if this storage was constructed from BSON and none of its fields have been modified
+     * since, in which case bson() holds exactly its fields.
+     */
+    bool isUnmodifiedBson() const {
+        return !_modified && !_bson.isEmpty();
+    }
+    const BSONObj& bson() const {
+        return _bson;
+    }
+
+    /**
+     * The size of the BSON kept alive by this storage. The storage of an embedded document shares
+     * the buffer of the outermost document constructed from BSON, and keeps all of it alive.
+     */
+    size_t bsonBufferSize() const {
+        return _bsonBufferSize;
+    }
+    bool sharesBsonBufferWith(const DocumentStorage& other) const {
+        return !_bson.isEmpty() && _bson.sharedBuffer().get() == other._bson.sharedBuffer().get();
+    }
+
     /// Returns the position of the next field to be inserted
     Position getNextPosition() const {
         return Position(_usedBytes);
     }
 
     /// Returns the position of the named field (may be missing) or Position()
-    Position findField(StringData name) const;
+    Position findField(StringData name) const {
+        Position pos = findFieldInBuffer(name);
+        if (pos.found() || !_bsonOffset)
+            return pos;
+        return const_cast<DocumentStorage*>(this)->loadFieldsUntil(name);
+    }
 
     // Document uses these
     const ValueElement& getField(Position pos) const {
@@ -244,8 +302,8 @@ public:
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
-        verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        _modified = true;
+        return elementAt(pos);
     }
     Value& getField(StringData name) {
         Position pos = findField(name);
@@ -255,7 +313,11 @@ public:
     }
 
     /// Adds a new field with missing Value at the end of the document
-    Value& appendField(StringData name);
+    Value& appendField(StringData name) {
+        loadAllFields();
+        _modified = true;
+        return appendFieldToBuffer(name);
+    }
 
     /** Preallocates space for fields. Use this to attempt to prevent buffer growth.
      *  This is only valid to call before anything is added to the document.
@@ -264,10 +326,11 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
-    /// This includes missing values
+    /// This includes missing values, and only covers the fields loaded so far
     DocumentStorageIterator iteratorAll() const {
         return DocumentStorageIterator(_firstElement, end(), true);
     }
@@ -391,6 +454,29 @@ public:
     }
 
 private:
+    Position findFieldInBuffer(StringData name) const;
+
+    /// Like getField(), but for bookkeeping which does not change the field's value.
+    ValueElement& elementAt(Position pos) {
+        verify(pos.found());
+        return *(_firstElement->plusBytes(pos.index));
+    }
+
+    /// Adds a new field with missing Value at the end of the buffer
+    Value& appendFieldToBuffer(StringData name);
+
+    /// Loads the next field of _bson into the buffer and returns its position.
+    Position loadNextField();
+
+    /// Loads fields of _bson up to and including the first named 'name', returning its position.
+    Position loadFieldsUntil(StringData name);
+
+    void loadAllFields() const {
+        while (_bsonOffset) {
+            const_cast<DocumentStorage*>(this)->loadNextField();
+        }
+    }
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
@@ -468,6 +554,15 @@ private:
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
 
+    BSONObj _bson;             // fields not yet in _buffer are loaded from here
+    unsigned _bsonBufferSize;  // size of the outermost BSON in the buffer of _bson, or 0
+    unsigned _bsonOffset;      // offset in _bson of the next field to load, or 0 once all loaded
+    bool _modified;            // set once any field is modified or added
+
+    // Set while a field is being loaded from _bson, in debug builds only. Loading is not
+    // thread-safe, so finding it already set means that another thread is loading concurrently.
+    AtomicWord<bool> _loadingField{false};
+
     std::bitset<MetaType::NUM_FIELDS> _metaFields;
     double _textScore;
     double _randVal;
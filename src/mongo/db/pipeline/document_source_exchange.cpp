@@ -359,7 +359,9 @@ size_t Exchange::loadNextBatch() {
         switch (_policy) {
             case ExchangePolicyEnum::kBroadcast: {
                 bool full = false;
-                // The document is sent to all consumers.
+                // The document is sent to all consumers, whose threads read it concurrently, so
+                // none of its fields may be left to load on first access.
+                input.getDocument().loadAllFields();
                 for (auto& c : _consumers) {
                     full = c->appendDocument(input, _maxBufferSize);
                 }
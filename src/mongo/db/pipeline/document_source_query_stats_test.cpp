@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_query_stats.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/stats/query_stats.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceQueryStatsTest = AggregationContextFixture;
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfSpecIsNotObject) {
+    const auto specObj = fromjson("{$queryStats: 1}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ShouldFailToParseIfSpecIsANonEmptyObject) {
+    const auto specObj = fromjson("{$queryStats: {unknownOption: 1}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::FailedToParse);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, CannotRunOnMongos) {
+    const auto specObj = fromjson("{$queryStats: {}}");
+    getExpCtx()->inMongos = true;
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        51242);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, CollectionlessMustRunOnAdmin) {
+    const auto specObj = fromjson("{$queryStats: {}}");
+    getExpCtx()->ns = NamespaceString::makeCollectionlessAggregateNSS("test");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::InvalidNamespace);
+}
+
+TEST_F(DocumentSourceQueryStatsTest, ReturnsStatsOfTheNamespaceOrOfEveryNamespace) {
+    auto& queryStats = QueryStats::get(getServiceContext());
+    QueryStats::OperationMetrics metrics;
+    metrics.executionMicros = 10;
+    queryStats.record(getExpCtx()->ns, 1, "a", metrics, Date_t());
+    queryStats.record(getExpCtx()->ns, 2, "b", metrics, Date_t());
+    queryStats.record(NamespaceString("unittests.other"), 1, "a", metrics, Date_t());
+
+    const auto specObj = fromjson("{$queryStats: {}}");
+    auto stage = DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx());
+    for (int i = 0; i < 2; i++) {
+        auto next = stage->getNext();
+        ASSERT(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(getExpCtx()->ns.ns()), next.getDocument()["ns"]);
+        ASSERT_VALUE_EQ(Value(1LL), next.getDocument()["execCount"]);
+    }
+    ASSERT(stage->getNext().isEOF());
+
+    getExpCtx()->ns = NamespaceString::makeCollectionlessAggregateNSS(NamespaceString::kAdminDb);
+    stage = DocumentSourceQueryStats::createFromBson(specObj.firstElement(), getExpCtx());
+    int count = 0;
+    while (stage->getNext().isAdvanced()) {
+        count++;
+    }
+    ASSERT_EQ(3, count);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source_skip.h"
@@ -460,7 +461,8 @@ BSONObj DocumentSourceSort::extractKeyWithArray(const Document& doc) const {
     // Convert the Document to a BSONObj, but only do the conversion for the paths we actually need.
     // Then run the result through the SortKeyGenerator to obtain the final sort key.
     auto bsonDoc = document_path_support::documentToBsonWithPaths(doc, _paths);
-    return uassertStatusOK(_sortKeyGen->getSortKey(std::move(bsonDoc), &metadata));
+    auto arena = OperationArena::get(pExpCtx->opCtx);
+    return uassertStatusOK(_sortKeyGen->getSortKey(std::move(bsonDoc), &metadata, arena));
 }
 
 std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) const {
@@ -122,6 +122,94 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone3);
 }
 
+TEST(DocumentConstruction, FromBsonLooksUpFieldsInAnyOrder) {
+    Document document = fromBson(fromjson("{a: 1, b: 'q', c: {d: 2, e: [3]}, f: 4}"));
+    ASSERT_FALSE(document.empty());
+    ASSERT_VALUE_EQ(Value(4), document["f"]);
+    ASSERT_VALUE_EQ(Value(2), document.getNestedField(FieldPath("c.d")));
+    ASSERT_VALUE_EQ(Value(), document["g"]);
+    ASSERT_VALUE_EQ(Value(1), document["a"]);
+
+    // Fields are iterated over in their BSON order, whatever order they were looked up in.
+    ASSERT_EQUALS(4U, document.size());
+    ASSERT_EQUALS("a", getNthField(document, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(document, 1).first.toString());
+    ASSERT_EQUALS("c", getNthField(document, 2).first.toString());
+    ASSERT_EQUALS("f", getNthField(document, 3).first.toString());
+}
+
+TEST(DocumentConstruction, FromBsonKeepsPositionsAsMoreFieldsAreLookedUp) {
+    Document document = fromBson(fromjson("{a: 1, b: 2, c: 3, d: 4, e: 5, f: 6}"));
+    const Position bPos = document.positionOf("b");
+    const Position fPos = document.positionOf("f");
+    ASSERT_VALUE_EQ(Value(2), document[bPos]);
+    ASSERT_VALUE_EQ(Value(6), document[fPos]);
+    ASSERT_EQUALS(bPos, document.positionOf("b"));
+}
+
+TEST(DocumentConstruction, FromBsonWithDuplicateFieldNames) {
+    Document document = fromBson(BSON("a" << 1 << "a" << 2));
+    ASSERT_VALUE_EQ(Value(1), document["a"]);
+    ASSERT_EQUALS(2U, document.size());
+}
+
+TEST(DocumentSerialization, UnmodifiedDocumentSharesItsBson) {
+    const BSONObj bson = fromjson("{a: 1, b: {c: 2, d: [{e: 3}]}, f: 'x'}");
+    Document document = fromBson(bson);
+    ASSERT_VALUE_EQ(Value(2), document.getNestedField(FieldPath("b.c")));
+
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+    ASSERT_EQUALS(bson["b"].Obj().objdata(), document["b"].getDocument().toBson().objdata());
+
+    BSONObjBuilder builder;
+    document.toBson(&builder);
+    ASSERT_BSONOBJ_EQ(bson, builder.obj());
+}
+
+TEST(DocumentSerialization, ModifiedDocumentFromBsonSerializesItsChanges) {
+    const BSONObj bson = fromjson("{a: 1, b: {c: 2, d: 3}, e: 'x'}");
+    const Document document = fromBson(bson);
+
+    MutableDocument md(document);
+    md.setField("a", Value(5));
+    md.addField("f", Value(6));
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 5, b: {c: 2, d: 3}, e: 'x', f: 6}"), md.peek().toBson());
+
+    md.reset(document);
+    md.setNestedField(FieldPath("b.d"), Value(4));
+    md.remove("e");
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1, b: {c: 2, d: 4}}"), md.freeze().toBson());
+
+    // The original document is unchanged.
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+}
+
+TEST(DocumentLoading, LoadAllFieldsLoadsEmbeddedDocuments) {
+    Document document = fromBson(fromjson("{a: {b: {c: 1}}, d: [{e: 2}], f: 3}"));
+    document.loadAllFields();
+    const size_t loadedSize = document.getApproximateSize();
+
+    // Nothing is left to load.
+    ASSERT_VALUE_EQ(Value(1), document.getNestedField(FieldPath("a.b.c")));
+    ASSERT_VALUE_EQ(Value(2), document["d"][0]["e"]);
+    ASSERT_VALUE_EQ(Value(3), document["f"]);
+    ASSERT_EQUALS(loadedSize, document.getApproximateSize());
+}
+
+TEST(DocumentSize, EmbeddedDocumentSharingBsonIsCountedOnce) {
+    const BSONObj bson = BSON("a" << BSON("b" << std::string(1000, 'x')));
+    Document document = fromBson(bson);
+    ASSERT_EQUALS(BSONType::Object, document["a"].getType());
+    ASSERT_LT(document.getApproximateSize(), 2U * bson.objsize());
+}
+
+TEST(DocumentSize, EmbeddedDocumentCountsTheBsonItKeepsAlive) {
+    const BSONObj bson = BSON("a" << BSON("b" << 1) << "c" << std::string(1000, 'x'));
+    const Document embedded = fromBson(bson)["a"].getDocument();
+    ASSERT_GTE(embedded.getApproximateSize(), static_cast<size_t>(bson.objsize()));
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
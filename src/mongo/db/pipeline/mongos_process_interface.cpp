@@ -249,6 +249,14 @@ BSONObj MongoSInterface::_reportCurrentOpForClient(OperationContext* opCtx,
     CurOp::reportCurrentOpForClient(
         opCtx, client, (truncateOps == CurrentOpTruncateMode::kTruncateOps), &builder);
 
+    if (auto clientOpCtx = client->getOperationContext()) {
+        auto timeBreakdown = OpDebug::makeTimeBreakdownObject(
+            CurOp::get(*clientOpCtx)->getTimeBreakdown(clientOpCtx), nullptr, {}, nullptr);
+        if (timeBreakdown.nFields() > 0) {
+            builder.append("timeBreakdown", timeBreakdown);
+        }
+    }
+
     return builder.obj();
 }
 
@@ -639,6 +639,9 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
     if (pipeline->peekFront() && pipeline->peekFront()->constraints().isChangeStreamStage()) {
         invariant(expCtx->tailableMode == TailableModeEnum::kTailableAndAwaitData);
         plannerOpts |= QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
+    } else {
+        // The pipeline only sees the fields it depends on, so it may read them from columns.
+        plannerOpts |= QueryPlannerParams::INCLUDE_COLUMN_SCAN;
     }
 
     if (rewrittenGroupStage) {
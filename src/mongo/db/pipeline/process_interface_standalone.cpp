@@ -553,13 +553,25 @@ BSONObj MongoInterfaceStandalone::_reportCurrentOpForClient(
         }
 
         // Append lock stats before returning.
-        if (auto lockerInfo = clientOpCtx->lockState()->getLockerInfo(
-                CurOp::get(*clientOpCtx)->getLockStatsBase())) {
+        auto lockerInfo = clientOpCtx->lockState()->getLockerInfo(
+            CurOp::get(*clientOpCtx)->getLockStatsBase());
+        if (lockerInfo) {
             fillLockerInfo(*lockerInfo, builder);
         }
 
         auto flowControlStats = clientOpCtx->lockState()->getFlowControlStats();
         flowControlStats.writeToBuilder(builder);
+
+        // Storage statistics are only gathered once an operation completes, so the time it spent
+        // in the storage engine is missing here.
+        auto timeBreakdown = OpDebug::makeTimeBreakdownObject(
+            CurOp::get(*clientOpCtx)->getTimeBreakdown(clientOpCtx),
+            lockerInfo ? &lockerInfo->stats : nullptr,
+            flowControlStats,
+            nullptr);
+        if (timeBreakdown.nFields() > 0) {
+            builder.append("timeBreakdown", timeBreakdown);
+        }
     }
 
     return builder.obj();
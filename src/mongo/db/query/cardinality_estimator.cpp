@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cardinality_estimator.h"
+
+#include <algorithm>
+
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+CardinalityEstimator::CardinalityEstimator(const CollectionStatistics& stats, double numRecords)
+    : _stats(stats), _numRecords(numRecords) {}
+
+boost::optional<double> CardinalityEstimator::estimateExamined(
+    const QuerySolutionNode* node) const {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return _numRecords;
+
+        case STAGE_IXSCAN: {
+            const auto* ixn = static_cast<const IndexScanNode*>(node);
+
+            // Keys of indexes with a collation, or of special index types, cannot be compared to
+            // the raw values in the histograms.
+            if (ixn->index.type != INDEX_BTREE || ixn->index.collator ||
+                ixn->bounds.isSimpleRange || ixn->bounds.fields.empty()) {
+                return boost::none;
+            }
+
+            const auto fieldStats =
+                _stats.getFieldStatistics(ixn->index.keyPattern.firstElementFieldName());
+            if (!fieldStats) {
+                return boost::none;
+            }
+
+            // Only the bounds on the leading field are used, which overestimates the keys examined
+            // by scans of compound indexes with bounds on later fields as well.
+            double fraction = 0;
+            for (auto&& interval : ixn->bounds.fields[0].intervals) {
+                fraction += fieldStats->histogram.estimateFraction(interval);
+            }
+
+            return std::min(fraction, 1.0) * _numRecords * fieldStats->valuesPerDocument;
+        }
+
+        default:
+            break;
+    }
+
+    // Other stages examine nothing themselves, but every one of their children is run.
+    if (node->children.empty()) {
+        return boost::none;
+    }
+
+    double examined = 0;
+    for (auto&& child : node->children) {
+        const auto childExamined = estimateExamined(child);
+        if (!childExamined) {
+            return boost::none;
+        }
+        examined += *childExamined;
+    }
+
+    return examined;
+}
+
+boost::optional<size_t> CardinalityEstimator::pickSolution(
+    const std::vector<std::unique_ptr<QuerySolution>>& solutions, double confidenceRatio) const {
+    std::vector<double> estimates;
+    for (auto&& solution : solutions) {
+        const auto estimate = estimateExamined(solution->root.get());
+        if (!estimate) {
+            return boost::none;
+        }
+        estimates.push_back(*estimate);
+    }
+
+    if (estimates.empty()) {
+        return boost::none;
+    }
+
+    const size_t best = std::min_element(estimates.begin(), estimates.end()) - estimates.begin();
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        if (i == best) {
+            continue;
+        }
+
+        // Adding one keeps plans which are expected to examine nothing comparable.
+        if ((estimates[best] + 1) * confidenceRatio > estimates[i] + 1) {
+            return boost::none;
+        }
+
+        if (solutions[best]->hasBlockingStage && !solutions[i]->hasBlockingStage) {
+            return boost::none;
+        }
+    }
+
+    return best;
+}
+
+}  // namespace mongo
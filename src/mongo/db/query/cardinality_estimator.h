@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+namespace mongo {
+
+class CollectionStatistics;
+class QuerySolution;
+struct QuerySolutionNode;
+
+/**
+ * Estimates how many index keys and documents the candidate plans of a query examine, using the
+ * histograms held in the collection's statistics.
+ *
+ * An estimate is only made when every leaf of a plan is a collection scan or a scan of a btree
+ * index whose leading field has been analyzed. Any other plan is treated as unknown, and the
+ * caller falls back to ranking the candidates by a trial run.
+ */
+class CardinalityEstimator {
+public:
+    CardinalityEstimator(const CollectionStatistics& stats, double numRecords);
+
+    /**
+     * Returns the estimated number of keys and documents examined by the scans below 'node', or
+     * boost::none if it cannot be estimated.
+     */
+    boost::optional<double> estimateExamined(const QuerySolutionNode* node) const;
+
+    /**
+     * Returns the index of the solution in 'solutions' which is expected to examine at least
+     * 'confidenceRatio' times fewer keys and documents than every other solution. Returns
+     * boost::none when no solution is clearly cheapest, or when the winner would need a blocking
+     * sort that some other solution avoids.
+     */
+    boost::optional<size_t> pickSolution(
+        const std::vector<std::unique_ptr<QuerySolution>>& solutions,
+        double confidenceRatio) const;
+
+private:
+    const CollectionStatistics& _stats;
+    const double _numRecords;
+};
+
+}  // namespace mongo
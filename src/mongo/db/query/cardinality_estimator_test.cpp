@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cardinality_estimator.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const double kNumRecords = 1000;
+
+IndexEntry buildSimpleIndexEntry(const BSONObj& kp) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier("test_foo"),
+            nullptr,
+            {},
+            nullptr,
+            nullptr};
+}
+
+/**
+ * Statistics for a collection of 1000 documents where 'a' is unique and 'b' is always 1.
+ */
+class CardinalityEstimatorTest : public unittest::Test {
+protected:
+    CardinalityEstimatorTest() {
+        FieldStatisticsBuilder aBuilder("a", 10000, 1);
+        FieldStatisticsBuilder bBuilder("b", 10000, 1);
+        for (int i = 0; i < kNumRecords; ++i) {
+            const auto doc = BSON("a" << i << "b" << 1);
+            aBuilder.addDocument(doc);
+            bBuilder.addDocument(doc);
+        }
+        _stats.setFieldStatistics("a", aBuilder.done(100));
+        _stats.setFieldStatistics("b", bBuilder.done(100));
+    }
+
+    /**
+     * Makes a solution which fetches the documents with 'field' equal to 'value' from an index on
+     * 'field'.
+     */
+    static std::unique_ptr<QuerySolution> makeIndexSolution(StringData field, int value) {
+        auto ixn = std::make_unique<IndexScanNode>(buildSimpleIndexEntry(BSON(field << 1)));
+        OrderedIntervalList oil(field.toString());
+        oil.intervals.push_back(Interval(BSON("" << value << "" << value), true, true));
+        ixn->bounds.fields.push_back(oil);
+
+        auto fetch = std::make_unique<FetchNode>();
+        fetch->children.push_back(ixn.release());
+
+        auto solution = std::make_unique<QuerySolution>();
+        solution->root = std::move(fetch);
+        return solution;
+    }
+
+    static std::unique_ptr<QuerySolution> makeCollScanSolution() {
+        auto solution = std::make_unique<QuerySolution>();
+        solution->root = std::make_unique<CollectionScanNode>();
+        return solution;
+    }
+
+    CollectionStatistics _stats;
+};
+
+TEST_F(CardinalityEstimatorTest, EstimatesIndexAndCollectionScans) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+
+    ASSERT_APPROX_EQUAL(*estimator.estimateExamined(makeIndexSolution("a", 10)->root.get()),
+                        1.0,
+                        0.5);
+    ASSERT_APPROX_EQUAL(*estimator.estimateExamined(makeIndexSolution("b", 1)->root.get()),
+                        kNumRecords,
+                        1.0);
+    ASSERT_EQ(*estimator.estimateExamined(makeCollScanSolution()->root.get()), kNumRecords);
+}
+
+TEST_F(CardinalityEstimatorTest, UnanalyzedFieldCannotBeEstimated) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+    ASSERT_FALSE(estimator.estimateExamined(makeIndexSolution("c", 1)->root.get()));
+}
+
+TEST_F(CardinalityEstimatorTest, PicksClearlyCheapestSolution) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexSolution("b", 1));
+    solutions.push_back(makeIndexSolution("a", 10));
+    solutions.push_back(makeCollScanSolution());
+
+    const auto chosen = estimator.pickSolution(solutions, 10.0);
+    ASSERT(chosen);
+    ASSERT_EQ(*chosen, 1U);
+}
+
+TEST_F(CardinalityEstimatorTest, DoesNotPickWhenSolutionsAreClose) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexSolution("b", 1));
+    solutions.push_back(makeCollScanSolution());
+
+    ASSERT_FALSE(estimator.pickSolution(solutions, 10.0));
+}
+
+TEST_F(CardinalityEstimatorTest, DoesNotPickWhenAnySolutionIsUnknown) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexSolution("a", 10));
+    solutions.push_back(makeIndexSolution("c", 1));
+
+    ASSERT_FALSE(estimator.pickSolution(solutions, 10.0));
+}
+
+TEST_F(CardinalityEstimatorTest, DoesNotPickBlockingSortOverNonBlockingPlan) {
+    CardinalityEstimator estimator(_stats, kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexSolution("a", 10));
+    solutions.push_back(makeCollScanSolution());
+    solutions[0]->hasBlockingStage = true;
+
+    ASSERT_FALSE(estimator.pickSolution(solutions, 10.0));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,314 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/hasher.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+const BSONObj kNullValue = BSON("" << BSONNULL);
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Returns the fraction of the values strictly between 'lower' and 'upper' which fall within the
+ * interval from 'start' to 'end', where 'start' is not greater than 'end'. All of the values in
+ * the range have the canonical type of 'upper'.
+ */
+double rangeOverlap(const BSONElement& lower,
+                    const BSONElement& upper,
+                    double numDistinct,
+                    const BSONElement& start,
+                    const BSONElement& end) {
+    const int type = upper.canonicalType();
+    if (end.canonicalType() < type || start.canonicalType() > type ||
+        compareValues(start, upper) >= 0 || compareValues(end, lower) <= 0) {
+        return 0;
+    }
+
+    const bool coversLower = start.canonicalType() < type || compareValues(start, lower) <= 0;
+    const bool coversUpper = end.canonicalType() > type || compareValues(end, upper) >= 0;
+    if (coversLower && coversUpper) {
+        return 1;
+    }
+
+    // A point inside the range is assumed to be as common as any other distinct value there.
+    if (compareValues(start, end) == 0) {
+        return 1 / std::max(numDistinct, 1.0);
+    }
+
+    const BSONElement clampedStart = coversLower ? lower : start;
+    const BSONElement clampedEnd = coversUpper ? upper : end;
+    if (lower.isNumber() && upper.isNumber() && clampedStart.isNumber() &&
+        clampedEnd.isNumber()) {
+        const double width = upper.numberDouble() - lower.numberDouble();
+        if (width > 0 && std::isfinite(width)) {
+            const double overlap = clampedEnd.numberDouble() - clampedStart.numberDouble();
+            return std::min(std::max(overlap / width, 0.0), 1.0);
+        }
+    }
+
+    // Without a way to interpolate, assume the interval covers half of the range.
+    return 0.5;
+}
+
+}  // namespace
+
+//
+// FieldHistogram
+//
+
+FieldHistogram FieldHistogram::make(std::vector<BSONObj> values, size_t maxBuckets) {
+    invariant(maxBuckets > 0);
+
+    FieldHistogram histogram;
+    if (values.empty()) {
+        return histogram;
+    }
+
+    std::sort(values.begin(), values.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return compareValues(lhs.firstElement(), rhs.firstElement()) < 0;
+    });
+
+    const double total = values.size();
+    const double depth = total / maxBuckets;
+
+    double rangeCount = 0;
+    double rangeDistinct = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t next = i + 1;
+        while (next < values.size() &&
+               compareValues(values[next].firstElement(), values[i].firstElement()) == 0) {
+            ++next;
+        }
+
+        // Buckets also end at the last value of each canonical type, so that the values within a
+        // bucket are all comparable to each other.
+        const bool lastOfType = next == values.size() ||
+            values[next].firstElement().canonicalType() !=
+                values[i].firstElement().canonicalType();
+
+        const double count = next - i;
+        if (histogram._buckets.empty() || lastOfType || rangeCount + count >= depth) {
+            Bucket bucket;
+            bucket.upperBoundObj = values[i];
+            bucket.equalFraction = count / total;
+            bucket.rangeFraction = rangeCount / total;
+            bucket.rangeDistinct = rangeDistinct;
+            histogram._buckets.push_back(std::move(bucket));
+
+            rangeCount = 0;
+            rangeDistinct = 0;
+        } else {
+            rangeCount += count;
+            ++rangeDistinct;
+        }
+
+        i = next;
+    }
+
+    return histogram;
+}
+
+double FieldHistogram::estimateFraction(const Interval& interval) const {
+    // Descending intervals are handled as their ascending equivalent.
+    const bool ascending = compareValues(interval.start, interval.end) <= 0;
+    const BSONElement start = ascending ? interval.start : interval.end;
+    const BSONElement end = ascending ? interval.end : interval.start;
+    const bool startInclusive = ascending ? interval.startInclusive : interval.endInclusive;
+    const bool endInclusive = ascending ? interval.endInclusive : interval.startInclusive;
+
+    const auto contains = [&](const BSONElement& value) {
+        const int startCmp = compareValues(value, start);
+        const int endCmp = compareValues(value, end);
+        return (startCmp > 0 || (startCmp == 0 && startInclusive)) &&
+            (endCmp < 0 || (endCmp == 0 && endInclusive));
+    };
+
+    double fraction = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        const auto& bucket = _buckets[i];
+        if (contains(bucket.upperBound())) {
+            fraction += bucket.equalFraction;
+        }
+
+        if (i > 0 && bucket.rangeFraction > 0) {
+            fraction += bucket.rangeFraction *
+                rangeOverlap(_buckets[i - 1].upperBound(),
+                             bucket.upperBound(),
+                             bucket.rangeDistinct,
+                             start,
+                             end);
+        }
+    }
+
+    return std::min(fraction, 1.0);
+}
+
+void FieldHistogram::appendToBSON(BSONObjBuilder* builder) const {
+    BSONArrayBuilder bucketsBuilder(builder->subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upperBound(), "upperBound");
+        bucketBuilder.append("equalFraction", bucket.equalFraction);
+        bucketBuilder.append("rangeFraction", bucket.rangeFraction);
+        bucketBuilder.append("rangeDistinct", bucket.rangeDistinct);
+    }
+}
+
+//
+// FieldStatisticsBuilder
+//
+
+FieldStatisticsBuilder::FieldStatisticsBuilder(std::string path, size_t sampleSize, int64_t seed)
+    : _path(std::move(path)), _sampleSize(sampleSize), _random(seed) {
+    invariant(sampleSize > 0);
+}
+
+void FieldStatisticsBuilder::addDocument(const BSONObj& doc) {
+    ++_numDocuments;
+
+    BSONElementSet values;
+    dps::extractAllElementsAlongPath(doc, _path, values);
+    if (values.empty()) {
+        _addValue(kNullValue.firstElement());
+        return;
+    }
+
+    for (auto&& value : values) {
+        _addValue(value);
+    }
+}
+
+void FieldStatisticsBuilder::_addValue(const BSONElement& value) {
+    ++_numValues;
+    _distinctValues.add(static_cast<uint64_t>(
+        BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED)));
+
+    // Reservoir sampling keeps each of the values seen so far with equal probability.
+    size_t slot = _sample.size();
+    if (_sample.size() >= _sampleSize) {
+        slot = static_cast<size_t>(_random.nextInt64(_numValues));
+        if (slot >= _sampleSize) {
+            return;
+        }
+    }
+
+    BSONObjBuilder valueBuilder;
+    valueBuilder.appendAs(value, "");
+    if (slot == _sample.size()) {
+        _sample.push_back(valueBuilder.obj());
+    } else {
+        _sample[slot] = valueBuilder.obj();
+    }
+}
+
+FieldStatistics FieldStatisticsBuilder::done(size_t maxBuckets) {
+    FieldStatistics stats;
+    stats.histogram = FieldHistogram::make(std::move(_sample), maxBuckets);
+    stats.distinctValues = _distinctValues.estimate();
+    stats.valuesPerDocument =
+        _numDocuments > 0 ? static_cast<double>(_numValues) / _numDocuments : 1;
+    stats.numDocuments = _numDocuments;
+    return stats;
+}
+
+//
+// CollectionStatistics
+//
+
+std::shared_ptr<const FieldStatistics> CollectionStatistics::getFieldStatistics(
+    StringData path) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _fields.find(path);
+    if (it == _fields.end()) {
+        return nullptr;
+    }
+
+    const auto& entry = it->second;
+    const long long numWrites = _numWrites.load() - entry.numWritesAtAnalyze;
+    if (numWrites > internalQueryStatisticsMaxWriteRatio.load() *
+            std::max(entry.stats->numDocuments, 1LL)) {
+        return nullptr;
+    }
+    return entry.stats;
+}
+
+void CollectionStatistics::setFieldStatistics(const std::string& path, FieldStatistics stats) {
+    auto fieldStats = std::make_shared<const FieldStatistics>(std::move(stats));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields[path] = {std::move(fieldStats), _numWrites.load()};
+    _hasFields.store(true);
+}
+
+bool CollectionStatistics::empty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _fields.empty();
+}
+
+void CollectionStatistics::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields.clear();
+    _hasFields.store(false);
+}
+
+void CollectionStatistics::appendToBSON(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& field : _fields) {
+        const auto& stats = *field.second.stats;
+        BSONObjBuilder fieldBuilder(builder->subobjStart(field.first));
+        fieldBuilder.appendNumber("numDocuments", stats.numDocuments);
+        fieldBuilder.appendNumber("writesSinceAnalyze",
+                                  _numWrites.load() - field.second.numWritesAtAnalyze);
+        fieldBuilder.append("distinctValues", stats.distinctValues);
+        fieldBuilder.append("valuesPerDocument", stats.valuesPerDocument);
+        BSONObjBuilder histogramBuilder(fieldBuilder.subobjStart("histogram"));
+        stats.histogram.appendToBSON(&histogramBuilder);
+    }
+}
+
+}  // namespace mongo
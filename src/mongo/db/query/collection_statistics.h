@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/hyperloglog.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+struct Interval;
+
+/**
+ * An equi-depth histogram over the values of one field, in BSON order.
+ *
+ * Each bucket ends at a value seen in the sample, and records both the fraction of values equal
+ * to that bound and the fraction strictly between it and the bound of the previous bucket. A value
+ * common enough to fill a bucket on its own always ends up as a bound, so the frequency of heavy
+ * hitters in skewed data is known exactly instead of being averaged over a bucket. The first
+ * bucket ends at the smallest value sampled and has no range part, and a bucket always ends at the
+ * largest value of each canonical type, so that no bucket mixes values of different types.
+ */
+class FieldHistogram {
+public:
+    struct Bucket {
+        BSONElement upperBound() const {
+            return upperBoundObj.firstElement();
+        }
+
+        // A single-field object holding the bound.
+        BSONObj upperBoundObj;
+
+        // The fraction of all values equal to the bound.
+        double equalFraction = 0;
+
+        // The fraction of all values strictly between the previous bound and this one, and the
+        // number of distinct such values in the sample.
+        double rangeFraction = 0;
+        double rangeDistinct = 0;
+    };
+
+    FieldHistogram() = default;
+
+    /**
+     * Builds a histogram of about 'maxBuckets' buckets from 'values', which are single-field
+     * objects whose only element is the value.
+     */
+    static FieldHistogram make(std::vector<BSONObj> values, size_t maxBuckets);
+
+    /**
+     * Returns the estimated fraction of values which fall within 'interval'. Values within a
+     * bucket are assumed to be spread evenly over its distinct values, or over the numeric range
+     * of the bucket when both the bucket and the interval are numeric.
+     */
+    double estimateFraction(const Interval& interval) const;
+
+    const std::vector<Bucket>& buckets() const {
+        return _buckets;
+    }
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+private:
+    std::vector<Bucket> _buckets;
+};
+
+/**
+ * Statistics about the values of one field of a collection, as they would appear as keys of an
+ * index on the field: array values contribute each of their elements, and missing values count as
+ * null.
+ */
+struct FieldStatistics {
+    FieldHistogram histogram;
+
+    // The estimated number of distinct values over the whole collection.
+    double distinctValues = 0;
+
+    // The average number of values per document, which is greater than 1 for array fields.
+    double valuesPerDocument = 1;
+
+    // The number of documents the statistics were gathered from.
+    long long numDocuments = 0;
+};
+
+/**
+ * Accumulates the statistics of the field 'path' over a stream of documents. The number of
+ * distinct values is estimated over every value added, while the histogram is built from a
+ * uniform reservoir sample of at most 'sampleSize' values.
+ */
+class FieldStatisticsBuilder {
+public:
+    FieldStatisticsBuilder(std::string path, size_t sampleSize, int64_t seed);
+
+    void addDocument(const BSONObj& doc);
+
+    FieldStatistics done(size_t maxBuckets);
+
+    const std::string& path() const {
+        return _path;
+    }
+
+private:
+    void _addValue(const BSONElement& value);
+
+    const std::string _path;
+    const size_t _sampleSize;
+
+    PseudoRandom _random;
+    HyperLogLog _distinctValues;
+    std::vector<BSONObj> _sample;
+
+    long long _numDocuments = 0;
+    long long _numValues = 0;
+};
+
+/**
+ * Holds the field statistics of a collection, which the planner may use to estimate the cost of
+ * candidate plans. Statistics are gathered by the analyze command and are kept in memory only,
+ * like index filters.
+ *
+ * The collection counts the documents it inserts, updates and deletes. Once more documents have
+ * been written since a field was analyzed than internalQueryStatisticsMaxWriteRatio times the
+ * number of documents it was analyzed over, its statistics are considered stale and are no longer
+ * returned to the planner.
+ *
+ * This class is thread-safe.
+ */
+class CollectionStatistics {
+    CollectionStatistics(const CollectionStatistics&) = delete;
+    CollectionStatistics& operator=(const CollectionStatistics&) = delete;
+
+public:
+    CollectionStatistics() = default;
+
+    /**
+     * Returns the statistics of the field 'path', or nullptr if it has not been analyzed or its
+     * statistics are stale.
+     */
+    std::shared_ptr<const FieldStatistics> getFieldStatistics(StringData path) const;
+
+    /**
+     * Replaces the statistics of the field 'path'.
+     */
+    void setFieldStatistics(const std::string& path, FieldStatistics stats);
+
+    bool empty() const;
+
+    void clear();
+
+    /**
+     * Called by the collection for every 'numDocuments' documents it writes. Cheap when no field
+     * has been analyzed.
+     */
+    void notifyOfWrites(long long numDocuments) {
+        if (_hasFields.loadRelaxed()) {
+            _numWrites.fetchAndAddRelaxed(numDocuments);
+        }
+    }
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const FieldStatistics> stats;
+
+        // The value of '_numWrites' when the field was analyzed.
+        long long numWritesAtAnalyze = 0;
+    };
+
+    mutable stdx::mutex _mutex;
+
+    StringMap<Entry> _fields;
+
+    // Mirrors !_fields.empty() so that writes can skip counting without taking '_mutex'.
+    AtomicWord<bool> _hasFields{false};
+
+    // The number of documents written to the collection while it had statistics.
+    AtomicWord<long long> _numWrites{0};
+};
+
+}  // namespace mongo
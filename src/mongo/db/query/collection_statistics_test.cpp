@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kSampleSize = 10000;
+const int64_t kSeed = 12345;
+
+FieldStatistics buildStats(const std::vector<BSONObj>& docs, size_t maxBuckets) {
+    FieldStatisticsBuilder builder("a", kSampleSize, kSeed);
+    for (auto&& doc : docs) {
+        builder.addDocument(doc);
+    }
+    return builder.done(maxBuckets);
+}
+
+Interval makeInterval(const BSONObj& bounds, bool startInclusive, bool endInclusive) {
+    return Interval(bounds, startInclusive, endInclusive);
+}
+
+TEST(CollectionStatisticsTest, HeavyHitterFrequencyIsExact) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 900; ++i) {
+        docs.push_back(BSON("a" << 5));
+    }
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("a" << 100 + i));
+    }
+
+    const auto stats = buildStats(docs, 10);
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 5 << "" << 5), true, true)),
+        0.9,
+        1e-9);
+
+    // A rare value is estimated from its bucket, never as frequent as the heavy hitter.
+    ASSERT_LT(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 150 << "" << 150), true, true)),
+        0.1);
+}
+
+TEST(CollectionStatisticsTest, NumericRangeIsInterpolated) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(BSON("a" << i));
+    }
+
+    const auto stats = buildStats(docs, 10);
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 0 << "" << 499), true, true)),
+        0.5,
+        0.02);
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 250 << "" << 260), true, false)),
+        0.01,
+        0.005);
+
+    // A descending interval covers the same values as its ascending equivalent.
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 499 << "" << 0), true, true)),
+        0.5,
+        0.02);
+
+    // Nothing lies outside of the sampled values.
+    ASSERT_EQ(
+        stats.histogram.estimateFraction(makeInterval(BSON("" << 2000 << "" << 3000), true, true)),
+        0.0);
+}
+
+TEST(CollectionStatisticsTest, IntervalOnlyCoversValuesOfItsType) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("a" << i));
+        docs.push_back(BSON("a" << std::to_string(i)));
+    }
+
+    const auto stats = buildStats(docs, 20);
+    const auto allNumbers = BSON("" << -std::numeric_limits<double>::infinity() << ""
+                                    << std::numeric_limits<double>::infinity());
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(makeInterval(allNumbers, true, true)), 0.5, 1e-9);
+}
+
+TEST(CollectionStatisticsTest, ArraysAndMissingValuesAreCountedLikeIndexKeys) {
+    const auto stats = buildStats({BSON("a" << BSON_ARRAY(1 << 2)), BSON("a" << 3), BSONObj()}, 10);
+
+    // The array contributes both of its elements, and the missing value counts as null.
+    ASSERT_APPROX_EQUAL(stats.valuesPerDocument, 4.0 / 3, 1e-9);
+    ASSERT_EQ(stats.numDocuments, 3);
+    ASSERT_APPROX_EQUAL(stats.distinctValues, 4.0, 0.5);
+    ASSERT_APPROX_EQUAL(
+        stats.histogram.estimateFraction(
+            makeInterval(BSON("" << BSONNULL << "" << BSONNULL), true, true)),
+        0.25,
+        1e-9);
+}
+
+TEST(CollectionStatisticsTest, ReservoirSampleIsBounded) {
+    FieldStatisticsBuilder builder("a", 100, kSeed);
+    for (int i = 0; i < 10000; ++i) {
+        builder.addDocument(BSON("a" << i));
+    }
+
+    const auto stats = builder.done(10);
+    ASSERT_LTE(stats.histogram.buckets().size(), 11U);
+    ASSERT_EQ(stats.numDocuments, 10000);
+
+    // The distinct value count covers every value, not only the sampled ones.
+    ASSERT_APPROX_EQUAL(stats.distinctValues, 10000.0, 500.0);
+}
+
+TEST(CollectionStatisticsTest, SetGetAndClear) {
+    CollectionStatistics collStats;
+    ASSERT(collStats.empty());
+    ASSERT_FALSE(collStats.getFieldStatistics("a"));
+
+    collStats.setFieldStatistics("a", buildStats({BSON("a" << 1)}, 10));
+    ASSERT_FALSE(collStats.empty());
+    ASSERT(collStats.getFieldStatistics("a"));
+    ASSERT_FALSE(collStats.getFieldStatistics("b"));
+
+    BSONObjBuilder bob;
+    collStats.appendToBSON(&bob);
+    ASSERT(bob.obj()["a"]["histogram"].isABSONObj());
+
+    collStats.clear();
+    ASSERT(collStats.empty());
+}
+
+TEST(CollectionStatisticsTest, WritesMakeStatisticsStale) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("a" << i));
+    }
+
+    CollectionStatistics collStats;
+    collStats.notifyOfWrites(1000);
+    collStats.setFieldStatistics("a", buildStats(docs, 10));
+
+    // Writes made before the field was analyzed do not count against it.
+    const long long maxWrites = internalQueryStatisticsMaxWriteRatio.load() * docs.size();
+    collStats.notifyOfWrites(maxWrites);
+    ASSERT(collStats.getFieldStatistics("a"));
+
+    collStats.notifyOfWrites(1);
+    ASSERT_FALSE(collStats.getFieldStatistics("a"));
+    ASSERT_FALSE(collStats.empty());
+
+    // Analyzing the field again makes its statistics current.
+    collStats.setFieldStatistics("a", buildStats(docs, 10));
+    ASSERT(collStats.getFieldStatistics("a"));
+}
+
+}  // namespace
+}  // namespace mongo
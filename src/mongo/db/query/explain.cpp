@@ -148,6 +148,9 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_IXSCAN == type) {
         const IndexScanStats* spec = static_cast<const IndexScanStats*>(specific);
         return spec->keysExamined;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->keysExamined;
     } else if (STAGE_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->keysExamined;
@@ -175,6 +178,9 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_COLUMN_SCAN == type) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        return spec->docsFetched;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -199,7 +205,11 @@ void addStageSummaryStr(const PlanStage* stage, StringBuilder& sb) {
 
     // Some leaf nodes also provide info about the index they used.
     const SpecificStats* specific = stage->getSpecificStats();
-    if (STAGE_COUNT_SCAN == stage->stageType()) {
+    if (STAGE_COLUMN_SCAN == stage->stageType()) {
+        const ColumnScanStats* spec = static_cast<const ColumnScanStats*>(specific);
+        const KeyPattern keyPattern{spec->keyPattern};
+        sb << " " << keyPattern;
+    } else if (STAGE_COUNT_SCAN == stage->stageType()) {
         const CountScanStats* spec = static_cast<const CountScanStats*>(specific);
         const KeyPattern keyPattern{spec->keyPattern};
         sb << " " << keyPattern;
@@ -361,8 +371,26 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (spec->maxTs) {
             bob->append("maxTs", *(spec->maxTs));
         }
+        if (spec->usedSkipIndex) {
+            bob->append("usedSkipIndex", true);
+        }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->usedSkipIndex) {
+                bob->appendNumber("docsSkipped", spec->docsSkipped);
+                bob->appendNumber("blocksSkipped", spec->blocksSkipped);
+            }
+        }
+    } else if (STAGE_COLUMN_SCAN == stats.stageType) {
+        ColumnScanStats* spec = static_cast<ColumnScanStats*>(stats.specific.get());
+
+        bob->append("keyPattern", spec->keyPattern);
+        bob->append("indexName", spec->indexName);
+        bob->append("columns", spec->columns);
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("docsFetched", spec->docsFetched);
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
@@ -567,8 +595,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->topKLimit) {
+            bob->appendNumber("topKLimit", spec->topKLimit);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->fetches);
+            if (spec->topKLimit) {
+                bob->appendBool("stoppedEarly", spec->stoppedEarly);
+            }
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -978,6 +1013,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IndexScanStats* ixscanStats =
                 static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
             statsOut->indexesUsed.insert(ixscanStats->indexName);
+        } else if (STAGE_COLUMN_SCAN == stages[i]->stageType()) {
+            const ColumnScanStats* columnScanStats =
+                static_cast<const ColumnScanStats*>(stages[i]->getSpecificStats());
+            statsOut->indexesUsed.insert(columnScanStats->indexName);
         } else if (STAGE_COUNT_SCAN == stages[i]->stageType()) {
             const CountScan* countScan = static_cast<const CountScan*>(stages[i]);
             const CountScanStats* countScanStats =
@@ -1054,6 +1093,26 @@ void Explain::planCacheEntryToBSON(const PlanCacheEntry& entry, BSONObjBuilder*
     scoresBuilder.doneFast();
 
     out->append("indexFilterSet", entry.plannerData[0]->indexFilterApplied);
+
+    const auto appendPercentiles = [](StringData fieldName,
+                                      const PlanCacheMetricHistogram& histogram,
+                                      BSONObjBuilder* bob) {
+        BSONObjBuilder percentilesBob(bob->subobjStart(fieldName));
+        percentilesBob.append("p50", static_cast<long long>(histogram.percentile(0.5)));
+        percentilesBob.append("p90", static_cast<long long>(histogram.percentile(0.9)));
+        percentilesBob.append("p99", static_cast<long long>(histogram.percentile(0.99)));
+        percentilesBob.append("max", static_cast<long long>(histogram.max()));
+    };
+
+    // Statistics of the executions of the cached plan since the entry was created.
+    static const PlanCacheEntryExecutionStats kNoExecutions;
+    const auto& executionStats = entry.executionStats ? *entry.executionStats : kNoExecutions;
+    BSONObjBuilder execStatsBob(out->subobjStart("executionStats"));
+    execStatsBob.append("executions", static_cast<long long>(executionStats.works.count()));
+    appendPercentiles("works", executionStats.works, &execStatsBob);
+    appendPercentiles("keysExamined", executionStats.keysExamined, &execStatsBob);
+    appendPercentiles("docsExamined", executionStats.docsExamined, &execStatsBob);
+    execStatsBob.doneFast();
 }
 
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/keypattern.h"
@@ -151,6 +152,22 @@ void endQueryOp(OperationContext* opCtx,
 
     if (collection) {
         collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+
+        // Record the per-shape statistics of queries which ran to completion with a cached plan,
+        // under the key the plan was looked up with.
+        const PlanStage* root = exec.getRootStage();
+        if (0 == cursorId && !summaryStats.replanned && STAGE_CACHED_PLAN == root->stageType()) {
+            const auto& planCacheKey = static_cast<const CachedPlanStage*>(root)->planCacheKey();
+            if (planCacheKey) {
+                collection->infoCache()
+                    ->getPlanCache()
+                    ->recordExecution(*planCacheKey,
+                                      root->getCommonStats()->works,
+                                      summaryStats.totalKeysExamined,
+                                      summaryStats.totalDocsExamined)
+                    .ignore();
+            }
+        }
     }
 
     if (curOp->shouldDBProfile()) {
@@ -448,6 +465,12 @@ Message getMore(OperationContext* opCtx,
         // or upconverted legacy query in the originatingCommand field.
         curOp.setOpDescription_inlock(upconvertGetMoreEntry(nss, cursorid, ntoreturn));
         curOp.setOriginatingCommand_inlock(cursorPin->getOriginatingCommandObj());
+
+        // Report the getMore against the shape of the query which created the cursor.
+        curOp.debug().queryHash = cursorPin->getQueryHash();
+        curOp.debug().planCacheKey = cursorPin->getPlanCacheKey();
+        curOp.debug().queryShape = cursorPin->getQueryShape().toString();
+
         // Update the generic cursor in curOp.
         curOp.setGenericCursor_inlock(cursorPin->toGenericCursor());
     }
@@ -60,7 +60,9 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/canonical_query_encoder.h"
+#include "mongo/db/query/cardinality_estimator.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
@@ -256,6 +258,14 @@ void fillOutPlannerParams(OperationContext* opCtx,
         collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii->more()) {
         const IndexCatalogEntry* ice = ii->next();
+        if (ice->descriptor()->getIndexType() == IndexType::INDEX_COLUMN) {
+            // Columnstore indexes are only read by column scans, never by index scans.
+            if (plannerParams->options & QueryPlannerParams::INCLUDE_COLUMN_SCAN) {
+                plannerParams->columnStoreIndexes.push_back(
+                    indexEntryFromIndexCatalogEntry(opCtx, *ice, canonicalQuery));
+            }
+            continue;
+        }
         plannerParams->indices.push_back(
             indexEntryFromIndexCatalogEntry(opCtx, *ice, canonicalQuery));
     }
@@ -459,6 +469,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             collection->infoCache()->getPlanCache()->computeKey(*canonicalQuery);
         CurOp::get(opCtx)->debug().queryHash =
             canonical_query_encoder::computeHash(planCacheKey.getStableKeyStringData());
+        CurOp::get(opCtx)->debug().queryShape = planCacheKey.getStableKeyStringData().toString();
         CurOp::get(opCtx)->debug().planCacheKey =
             canonical_query_encoder::computeHash(planCacheKey.toString());
 
@@ -489,7 +500,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                          canonicalQuery.get(),
                                                          plannerParams,
                                                          cs->decisionWorks,
-                                                         rawRoot);
+                                                         rawRoot,
+                                                         planCacheKey);
                 return PrepareExecutionResult(
                     std::move(canonicalQuery), std::move(querySolution), std::move(root));
             }
@@ -540,6 +552,30 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // A plan which the collection's field statistics show to be far cheaper than all of the others
+    // is run without a trial period. Like a single plan, it is not cached.
+    if (solutions.size() > 1 && internalQueryPlannerUseCollectionStatistics.load()) {
+        const CollectionStatistics* stats = collection->infoCache()->getCollectionStatistics();
+        if (!stats->empty()) {
+            CardinalityEstimator estimator(*stats, collection->numRecords(opCtx));
+            if (auto chosen = estimator.pickSolution(
+                    solutions, internalQueryPlannerStatisticsConfidenceRatio.load())) {
+                PlanStage* rawRoot;
+                verify(StageBuilder::build(
+                    opCtx, collection, *canonicalQuery, *solutions[*chosen], ws, &rawRoot));
+                root.reset(rawRoot);
+
+                LOG(2) << "Chose plan using collection statistics; it will be run but will not be "
+                          "cached. "
+                       << redact(canonicalQuery->toStringShort())
+                       << ", planSummary: " << Explain::getPlanSummary(root.get());
+
+                return PrepareExecutionResult(
+                    std::move(canonicalQuery), std::move(solutions[*chosen]), std::move(root));
+            }
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -753,6 +789,7 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> _getExecutorFind(
     if (OperationShardingState::isOperationVersioned(opCtx)) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+
     return getExecutor(opCtx, collection, std::move(canonicalQuery), yieldPolicy, plannerOptions);
 }
 
@@ -781,7 +818,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorLega
                             collection,
                             std::move(canonicalQuery),
                             PlanExecutor::YIELD_AUTO,
-                            QueryPlannerParams::DEFAULT);
+                            QueryPlannerParams::INCLUDE_COLUMN_SCAN);
 }
 
 namespace {
@@ -1503,6 +1540,9 @@ QueryPlannerParams fillOutPlannerParamsForDistinct(OperationContext* opCtx,
     while (ii->more()) {
         const IndexCatalogEntry* ice = ii->next();
         const IndexDescriptor* desc = ice->descriptor();
+        if (desc->getIndexType() == IndexType::INDEX_COLUMN) {
+            continue;
+        }
         if (desc->keyPattern().hasField(parsedDistinct.getKey())) {
             if (!mayUnwindArrays && isAnyComponentOfPathMultikey(desc->keyPattern(),
                                                                  desc->isMultikey(opCtx),
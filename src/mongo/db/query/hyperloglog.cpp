@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/hyperloglog.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+HyperLogLog::HyperLogLog(int precision) : _precision(precision) {
+    invariant(precision >= kMinPrecision && precision <= kMaxPrecision);
+    _registers.resize(size_t{1} << precision);
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    const size_t index = hash >> (64 - _precision);
+
+    // The remaining bits, shifted up so that an all-zero remainder ranks one past its width.
+    const uint64_t remainder = hash << _precision;
+    const int maxRank = 64 - _precision + 1;
+    const int rank = remainder == 0 ? maxRank : countLeadingZeros64(remainder) + 1;
+
+    _registers[index] = std::max(_registers[index], static_cast<uint8_t>(rank));
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    invariant(_precision == other._precision);
+    for (size_t i = 0; i < _registers.size(); ++i) {
+        _registers[i] = std::max(_registers[i], other._registers[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    const double numRegisters = _registers.size();
+
+    double sum = 0;
+    size_t numZeroRegisters = 0;
+    for (auto reg : _registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0) {
+            ++numZeroRegisters;
+        }
+    }
+
+    // The bias correction constant for 16 or more registers, from Flajolet et al.
+    const double alpha = 0.7213 / (1 + 1.079 / numRegisters);
+    const double rawEstimate = alpha * numRegisters * numRegisters / sum;
+
+    // Small cardinalities are estimated more accurately by linear counting of the empty registers.
+    if (rawEstimate <= 2.5 * numRegisters && numZeroRegisters != 0) {
+        return numRegisters * std::log(numRegisters / numZeroRegisters);
+    }
+
+    return rawEstimate;
+}
+
+}  // namespace mongo
@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace mongo {
+
+/**
+ * A HyperLogLog sketch, which estimates the number of distinct values in a stream of 64-bit
+ * hashes using 2^precision one-byte registers. The standard error of the estimate is about
+ * 1.04 / sqrt(2^precision), so the default precision of 12 gives roughly 1.6% in 4KB.
+ *
+ * The hashes added must be uniformly distributed over all 64 bits.
+ */
+class HyperLogLog {
+public:
+    static constexpr int kMinPrecision = 4;
+    static constexpr int kMaxPrecision = 16;
+    static constexpr int kDefaultPrecision = 12;
+
+    explicit HyperLogLog(int precision = kDefaultPrecision);
+
+    void add(uint64_t hash);
+
+    /**
+     * Adds the values seen by 'other', which must have the same precision, to this sketch.
+     */
+    void merge(const HyperLogLog& other);
+
+    /**
+     * Returns the estimated number of distinct hashes added so far.
+     */
+    double estimate() const;
+
+    int precision() const {
+        return _precision;
+    }
+
+private:
+    int _precision;
+
+    // Each register holds the largest rank, that is the position of the first set bit after the
+    // register index bits, of the hashes which mapped to it.
+    std::vector<uint8_t> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/hyperloglog.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Spreads consecutive integers uniformly over 64 bits, as the sketch requires.
+uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+TEST(HyperLogLogTest, EmptySketchEstimatesZero) {
+    HyperLogLog hll;
+    ASSERT_EQ(hll.estimate(), 0.0);
+}
+
+TEST(HyperLogLogTest, SmallCardinalityIsNearlyExact) {
+    HyperLogLog hll;
+    for (uint64_t i = 0; i < 100; ++i) {
+        hll.add(mix(i));
+    }
+
+    ASSERT_APPROX_EQUAL(hll.estimate(), 100.0, 2.0);
+}
+
+TEST(HyperLogLogTest, DuplicatesAreNotCounted) {
+    HyperLogLog hll;
+    for (int round = 0; round < 3; ++round) {
+        for (uint64_t i = 0; i < 100000; ++i) {
+            hll.add(mix(i));
+        }
+    }
+
+    // The standard error at the default precision is about 1.6%.
+    ASSERT_APPROX_EQUAL(hll.estimate(), 100000.0, 5000.0);
+}
+
+TEST(HyperLogLogTest, MergeEstimatesUnion) {
+    HyperLogLog lhs;
+    HyperLogLog rhs;
+    for (uint64_t i = 0; i < 60000; ++i) {
+        lhs.add(mix(i));
+    }
+    for (uint64_t i = 40000; i < 100000; ++i) {
+        rhs.add(mix(i));
+    }
+
+    lhs.merge(rhs);
+    ASSERT_APPROX_EQUAL(lhs.estimate(), 100000.0, 5000.0);
+}
+
+TEST(HyperLogLogTest, LowerPrecisionUsesFewerRegisters) {
+    HyperLogLog hll(HyperLogLog::kMinPrecision);
+    ASSERT_EQ(hll.precision(), HyperLogLog::kMinPrecision);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        hll.add(mix(i));
+    }
+
+    // With only 16 registers the error is large, but the estimate stays in the right range.
+    ASSERT_GT(hll.estimate(), 500.0);
+    ASSERT_LT(hll.estimate(), 2000.0);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -29,8 +29,11 @@
 
 #pragma once
 
+#include <array>
 #include <boost/optional/optional.hpp>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
@@ -220,6 +223,10 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The cached plan reads the needed fields from the
+        // columns of the columnstore index in 'tree'.
+        COLUMN_SCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -236,6 +243,50 @@ struct SolutionCacheData {
 
 class PlanCacheEntry;
 
+/**
+ * Tracks the distribution of a per-execution metric of a query shape, such as the number of works
+ * or of documents examined by each execution of its cached plan. Values are counted in
+ * power-of-two buckets, so percentiles are approximate: they report the upper bound of the bucket
+ * which the requested rank falls in. Values of 2^30 and above share the last bucket, whose
+ * percentiles are reported as the largest value recorded.
+ */
+class PlanCacheMetricHistogram {
+public:
+    void record(uint64_t value);
+
+    /**
+     * Returns the approximate 'p'th percentile of the recorded values, where 0 < p <= 1, or 0 if
+     * nothing has been recorded.
+     */
+    uint64_t percentile(double p) const;
+
+    uint64_t count() const {
+        return _count;
+    }
+
+    uint64_t max() const {
+        return _max;
+    }
+
+private:
+    // Bucket 0 counts zeroes and bucket i counts the values in [2^(i-1), 2^i), except for the last
+    // bucket which counts all values from 2^(kNumBuckets-2). A bucket stops counting once full.
+    static constexpr size_t kNumBuckets = 32;
+
+    std::array<uint32_t, kNumBuckets> _buckets{};
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+};
+
+/**
+ * Execution statistics of the queries which ran with the plan of a cache entry.
+ */
+struct PlanCacheEntryExecutionStats {
+    PlanCacheMetricHistogram works;
+    PlanCacheMetricHistogram keysExamined;
+    PlanCacheMetricHistogram docsExamined;
+};
+
 /**
  * Information returned from a get(...) query.
  */
@@ -338,6 +389,10 @@ public:
     // Scores from uses of this cache entry.
     std::vector<double> feedback;
 
+    // Statistics of the executions of this entry's plan which ran to completion. Allocated by the
+    // first such execution, so that entries which are never used again do not pay for them.
+    std::unique_ptr<PlanCacheEntryExecutionStats> executionStats;
+
     // Whether or not the cache entry is active. Inactive cache entries should not be used for
     // planning.
     bool isActive = false;
@@ -353,6 +408,10 @@ public:
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
+ *
+ * Entries are spread over several independently locked partitions by hash of their key, so that
+ * operations on different query shapes of a hot collection do not serialize on a single mutex.
+ * Each partition keeps its own LRU order.
  */
 class PlanCache {
 private:
@@ -471,6 +530,19 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, double score);
 
+    /**
+     * Records the execution statistics of a query which ran to completion with the plan of the
+     * entry for 'key', so that they can be reported per query shape. The key is the one the plan
+     * was looked up with, so that finishing a query does not encode its shape again.
+     *
+     * If the entry corresponding to 'key' isn't in the cache anymore, the statistics are ignored
+     * and an error Status is returned.
+     */
+    Status recordExecution(const PlanCacheKey& key,
+                           size_t works,
+                           size_t keysExamined,
+                           size_t docsExamined);
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -546,10 +618,24 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    /**
+     * A subset of the cache entries, protected by its own mutex.
+     */
+    struct Partition {
+        explicit Partition(size_t size) : cache(size) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+
+        // Protects 'cache'.
+        mutable stdx::mutex mutex;
+    };
+
+    /**
+     * Returns the partition which holds the entry for 'key'.
+     */
+    Partition& _getPartition(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_replanner.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/multi_plan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/explain.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/stage_builder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getPlanCacheReplanner = ServiceContext::declareDecoration<PlanCacheReplanner>();
+
+}  // namespace
+
+PlanCacheReplanner* PlanCacheReplanner::get(ServiceContext* serviceContext) {
+    return &getPlanCacheReplanner(serviceContext);
+}
+
+PlanCacheReplanner* PlanCacheReplanner::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool PlanCacheReplanner::scheduleReplan(const CanonicalQuery& cq, const std::string& planCacheKey) {
+    auto shape = cq.ns() + '\0' + planCacheKey;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_inShutdown || !_pendingShapes.insert(shape).second) {
+        return false;
+    }
+
+    if (!_pool) {
+        ThreadPool::Options options;
+        options.poolName = "PlanCacheReplanner";
+        options.minThreads = 0;
+        options.maxThreads = 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+        };
+        _pool = std::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+
+    _pool->schedule([ this, shape = std::move(shape), qr = cq.getQueryRequest() ](auto status) {
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _pendingShapes.erase(shape);
+        });
+
+        // The pool only refuses work while shutting down, in which case the replan is dropped.
+        if (!status.isOK()) {
+            return;
+        }
+
+        _replan(qr);
+    });
+
+    return true;
+}
+
+void PlanCacheReplanner::waitForIdle() {
+    ThreadPool* pool;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        pool = _pool.get();
+    }
+
+    if (pool) {
+        pool->waitForIdle();
+    }
+}
+
+void PlanCacheReplanner::shutdown() {
+    std::unique_ptr<ThreadPool> pool;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
+        pool = std::move(_pool);
+    }
+
+    // The tasks erase their shapes under '_mutex', so the pool must be joined without holding it.
+    if (pool) {
+        pool->shutdown();
+        pool->join();
+    }
+}
+
+void PlanCacheReplanner::_replan(const QueryRequest& qr) {
+    auto opCtx = cc().makeOperationContext();
+
+    try {
+        const auto nss = qr.nss();
+        AutoGetCollectionForRead autoColl(opCtx.get(), nss);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx;
+        auto cq = uassertStatusOK(
+            CanonicalQuery::canonicalize(opCtx.get(),
+                                         std::make_unique<QueryRequest>(qr),
+                                         expCtx,
+                                         ExtensionsCallbackReal(opCtx.get(), &nss),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures));
+
+        QueryPlannerParams plannerParams;
+        fillOutPlannerParams(opCtx.get(), collection, cq.get(), &plannerParams);
+
+        // Deactivate the degraded entry first, as an inline replan does, so that the winner of the
+        // new trial period can take its place even if it needed more works.
+        PlanCache* planCache = collection->infoCache()->getPlanCache();
+        planCache->deactivate(*cq);
+
+        auto solutions = uassertStatusOK(QueryPlanner::plan(*cq, plannerParams));
+        if (solutions.size() < 2) {
+            // There is nothing to choose between, so there is nothing to cache either.
+            LOG(1) << "Background replanning of " << redact(cq->toStringShort())
+                   << " produced " << solutions.size() << " query solutions; nothing to cache";
+            return;
+        }
+
+        auto ws = std::make_unique<WorkingSet>();
+        auto multiPlanStage = std::make_unique<MultiPlanStage>(
+            opCtx.get(), collection, cq.get(), MultiPlanStage::CachingMode::AlwaysCache);
+
+        for (auto&& solution : solutions) {
+            if (solution->cacheData) {
+                solution->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
+            }
+
+            PlanStage* root;
+            verify(StageBuilder::build(opCtx.get(), collection, *cq, *solution, ws.get(), &root));
+            multiPlanStage->addPlan(std::move(solution), root, ws.get());
+        }
+
+        // Creating the executor runs the trial period of the candidate plans and writes the
+        // winner to the plan cache. Nothing is returned from it.
+        auto exec = uassertStatusOK(PlanExecutor::make(opCtx.get(),
+                                                       std::move(ws),
+                                                       std::move(multiPlanStage),
+                                                       std::move(cq),
+                                                       collection,
+                                                       PlanExecutor::YIELD_AUTO));
+
+        LOG(1) << "Background replanning of " << redact(exec->getCanonicalQuery()->toStringShort())
+               << " resulted in plan with summary: " << Explain::getPlanSummary(exec.get());
+    } catch (const DBException& ex) {
+        LOG(1) << "Background replanning of query on " << qr.nss()
+               << " failed: " << redact(ex.toStatus());
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/db/query/query_request.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Replans query shapes whose cached plan has degraded on a background thread. This lets the
+ * operation which noticed the degradation keep running its cached plan, instead of paying for
+ * multi-planning every candidate plan itself. Used by the CachedPlanStage when
+ * 'internalQueryCacheBackgroundReplanning' is enabled.
+ *
+ * Replanning a shape deactivates its cache entry and runs the multi-planner over all candidate
+ * plans, caching the winner, exactly as an inline replan would.
+ */
+class PlanCacheReplanner {
+    PlanCacheReplanner(const PlanCacheReplanner&) = delete;
+    PlanCacheReplanner& operator=(const PlanCacheReplanner&) = delete;
+
+public:
+    PlanCacheReplanner() = default;
+
+    static PlanCacheReplanner* get(ServiceContext* serviceContext);
+    static PlanCacheReplanner* get(OperationContext* opCtx);
+
+    /**
+     * Schedules a background replan of the shape of 'cq'. Returns false without scheduling anything
+     * if a replan of the same shape is already pending, or if the replanner has been shut down.
+     *
+     * 'planCacheKey' identifies the shape of 'cq' in the plan cache of its collection.
+     */
+    bool scheduleReplan(const CanonicalQuery& cq, const std::string& planCacheKey);
+
+    /**
+     * Waits until all of the replans scheduled so far have completed. Used for testing.
+     */
+    void waitForIdle();
+
+    /**
+     * Stops the background thread, waiting for a replan in progress to finish. Replans scheduled
+     * afterwards are refused. Called at server shutdown.
+     */
+    void shutdown();
+
+private:
+    /**
+     * Replans the shape of 'qr' against the collection it names, using a new operation context on
+     * the current thread's client. Errors are logged and otherwise ignored, since the cache entry
+     * then simply remains as it was.
+     */
+    static void _replan(const QueryRequest& qr);
+
+    // Protects the members below.
+    stdx::mutex _mutex;
+
+    // Created the first time a replan is scheduled.
+    std::unique_ptr<ThreadPool> _pool;
+
+    // Set once shutdown() has been called, after which no more replans are scheduled.
+    bool _inShutdown = false;
+
+    // The namespaces and plan cache keys of the shapes with a pending replan.
+    StringSet _pendingShapes;
+};
+
+}  // namespace mongo
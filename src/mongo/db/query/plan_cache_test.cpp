@@ -567,6 +567,86 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, LargeCacheHoldsEntriesForManyShapes) {
+    // A cache of this size is split into several independently locked partitions.
+    PlanCache planCache(5000);
+    QueryTestServiceContext serviceContext;
+
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (int i = 0; i < 200; ++i) {
+        queries.push_back(canonicalize(BSON(("field" + std::to_string(i)) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+
+    ASSERT_EQ(planCache.size(), 200U);
+    ASSERT_EQ(planCache.getAllEntries().size(), 200U);
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries.front()));
+    ASSERT_EQ(planCache.get(*queries.front()).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.size(), 199U);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
+    }
+}
+
+TEST(PlanCacheTest, MetricHistogramReportsPercentiles) {
+    PlanCacheMetricHistogram histogram;
+    ASSERT_EQ(histogram.percentile(0.5), 0U);
+
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+
+    ASSERT_EQ(histogram.count(), 100U);
+    ASSERT_EQ(histogram.max(), 100U);
+
+    // Percentiles are reported at the upper bound of their power-of-two bucket.
+    ASSERT_EQ(histogram.percentile(0.5), 63U);
+    ASSERT_EQ(histogram.percentile(0.99), 100U);
+    ASSERT_EQ(histogram.percentile(0.01), 1U);
+}
+
+TEST(PlanCacheTest, MetricHistogramReportsLargeValuesAsTheMax) {
+    PlanCacheMetricHistogram histogram;
+    histogram.record(1);
+    histogram.record(1ULL << 40);
+    histogram.record(1ULL << 50);
+
+    ASSERT_EQ(histogram.count(), 3U);
+    ASSERT_EQ(histogram.percentile(0.3), 1U);
+    ASSERT_EQ(histogram.percentile(0.5), 1ULL << 50);
+    ASSERT_EQ(histogram.percentile(1), 1ULL << 50);
+}
+
+TEST(PlanCacheTest, RecordExecutionUpdatesEntryStats) {
+    PlanCache planCache;
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    const auto key = planCache.computeKey(*cq);
+
+    // There is no entry to record the execution against yet.
+    ASSERT_NOT_OK(planCache.recordExecution(key, 10, 5, 5));
+
+    addCacheEntryForShape(*cq, &planCache);
+    ASSERT_FALSE(assertGet(planCache.getEntry(*cq))->executionStats);
+
+    ASSERT_OK(planCache.recordExecution(key, 10, 5, 4));
+    ASSERT_OK(planCache.recordExecution(key, 20, 8, 2));
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT(entry->executionStats);
+    ASSERT_EQ(entry->executionStats->works.count(), 2U);
+    ASSERT_EQ(entry->executionStats->works.max(), 20U);
+    ASSERT_EQ(entry->executionStats->keysExamined.max(), 8U);
+    ASSERT_EQ(entry->executionStats->docsExamined.max(), 4U);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -35,14 +35,17 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -136,6 +139,30 @@ std::vector<bool> canProvideSortWithMergeSort(
     return shouldReverseScan;
 }
 
+/**
+ * Returns true if 'expr' has a node which looks at the whole document without reporting the fields
+ * it reads from MatchExpression::addDependencies(), such as $where.
+ */
+bool hasWholeDocumentPredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::WHERE:
+        case MatchExpression::INTERNAL_SCHEMA_ALLOWED_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_MAX_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_MIN_PROPERTIES:
+        case MatchExpression::INTERNAL_SCHEMA_ROOT_DOC_EQ:
+            return true;
+        default:
+            break;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (hasWholeDocumentPredicate(expr->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -177,6 +204,94 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
     return std::move(csn);
 }
 
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeColumnScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    invariant(index.type == INDEX_COLUMN);
+
+    const auto projection = query.getProj();
+    if (!projection || projection->requiresDocument() || projection->wantIndexKey()) {
+        return nullptr;
+    }
+
+    DepsTracker filterDeps;
+    query.root()->addDependencies(&filterDeps);
+    if (filterDeps.needWholeDocument || hasWholeDocumentPredicate(query.root())) {
+        return nullptr;
+    }
+
+    std::set<std::string> neededFields(filterDeps.fields.begin(), filterDeps.fields.end());
+    std::set<std::string> projectedFields;
+    for (auto&& field : projection->getRequiredFields()) {
+        neededFields.insert(field.toString());
+        projectedFields.insert(field.toString());
+    }
+    for (auto&& sortElem : query.getQueryRequest().getSort()) {
+        if (sortElem.type() != BSONType::Object) {
+            neededFields.insert(sortElem.fieldName());
+        }
+    }
+    if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
+        for (auto&& shardKeyElem : params.shardKey) {
+            neededFields.insert(shardKeyElem.fieldName());
+        }
+    }
+
+    const bool hasColumnPerField =
+        index.keyPattern.firstElementFieldNameStringData() == "$**"_sd;
+
+    std::set<std::string> columns;
+    std::set<std::string> projectedColumns;
+    for (auto&& field : neededFields) {
+        const FieldRef fieldRef(field);
+        if (fieldRef.getPart(0) == "_id"_sd) {
+            // The row column holds the _id of every document.
+            continue;
+        }
+
+        std::string column;
+        if (hasColumnPerField) {
+            column = fieldRef.getPart(0).toString();
+        } else {
+            // Read 'field' from the shortest column path which is 'field' or one of its prefixes.
+            boost::optional<StringData> shortestPath;
+            for (auto&& keyElem : index.keyPattern) {
+                const auto path = keyElem.fieldNameStringData();
+                if (FieldRef(path).isPrefixOfOrEqualTo(fieldRef) &&
+                    (!shortestPath || path.size() < shortestPath->size())) {
+                    shortestPath = path;
+                }
+            }
+            if (!shortestPath) {
+                return nullptr;
+            }
+            column = shortestPath->toString();
+        }
+
+        if (projectedFields.count(field)) {
+            // A column holds nothing for a document missing its path, so a dotted column cannot
+            // tell whether the subdocuments along its path exist. The projection of {a: {c: 1}} on
+            // "a.b" is {a: {}}, which only a column for "a" can produce.
+            if (column.find('.') != std::string::npos) {
+                return nullptr;
+            }
+            projectedColumns.insert(column);
+        }
+        columns.insert(std::move(column));
+    }
+
+    // The scan rebuilds each document with its columns in path order, not in the order the fields
+    // are stored in. A projection keeps the stored order of the fields it returns, so a column scan
+    // is only used when they all come from one column, besides _id.
+    if (projectedColumns.size() > 1) {
+        return nullptr;
+    }
+
+    auto csn = std::make_unique<ColumnScanNode>(index);
+    csn->filter = query.root()->shallowClone();
+    csn->columns.assign(columns.begin(), columns.end());
+    return std::move(csn);
+}
+
 std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeLeafNode(
     const CanonicalQuery& query,
     const IndexEntry& index,
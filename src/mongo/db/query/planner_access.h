@@ -102,6 +102,16 @@ public:
                                                                  bool tailable,
                                                                  const QueryPlannerParams& params);
 
+    /**
+     * Return a ColumnScanNode which reads every document of the collection from the columns of the
+     * columnstore index 'index', in place of a collection scan. Returns null unless the columns of
+     * 'index' hold every field that 'query' needs, which requires a projection that does not need
+     * the whole document.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeColumnScan(const IndexEntry& index,
+                                                             const CanonicalQuery& query,
+                                                             const QueryPlannerParams& params);
+
     /**
      * Return a plan that uses the provided index as a proxy for a collection scan.
      */
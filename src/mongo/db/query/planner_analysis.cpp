@@ -396,6 +396,30 @@ std::unique_ptr<ProjectionNode> analyzeProjection(const CanonicalQuery& query,
         std::move(solnRoot), *query.root(), qr.getProj(), *query.getProj());
 }
 
+/**
+ * If 'solnRoot' is a limited sort by text score alone whose input comes straight from a TEXT node,
+ * tells the TEXT node that only the documents with the highest scores are needed.
+ */
+void pushSortLimitIntoTextNode(QuerySolutionNode* solnRoot) {
+    if (STAGE_SORT != solnRoot->getType()) {
+        return;
+    }
+
+    auto sort = static_cast<SortNode*>(solnRoot);
+    if (!sort->limit || sort->pattern.nFields() != 1 ||
+        !QueryRequest::isTextScoreMeta(sort->pattern.firstElement())) {
+        return;
+    }
+
+    auto sortKeyGen = sort->children[0];
+    if (STAGE_SORT_KEY_GENERATOR != sortKeyGen->getType() ||
+        STAGE_TEXT != sortKeyGen->children[0]->getType()) {
+        return;
+    }
+
+    static_cast<TextNode*>(sortKeyGen->children[0])->topKLimit = sort->limit;
+}
+
 }  // namespace
 
 // static
@@ -781,6 +805,10 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
         return nullptr;
     }
 
+    if (hasSortStage) {
+        pushSortLimitIntoTextNode(solnRoot.get());
+    }
+
     // A solution can be blocking if it has a blocking sort stage or
     // a hashed AND stage.
     bool hasAndHashStage = hasNode(solnRoot.get(), STAGE_AND_HASH);
@@ -281,6 +281,17 @@ std::unique_ptr<QuerySolution> buildCollscanSoln(const CanonicalQuery& query,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildColumnScanSoln(const IndexEntry& index,
+                                                   const CanonicalQuery& query,
+                                                   const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeColumnScan(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
 std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
                                                 const CanonicalQuery& query,
                                                 const QueryPlannerParams& params,
@@ -468,6 +479,17 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::COLUMN_SCAN_SOLN == winnerCacheData.solnType) {
+        // The cached solution is a column scan, which can only be used if the caller allows it.
+        std::unique_ptr<QuerySolution> soln;
+        if (params.options & QueryPlannerParams::INCLUDE_COLUMN_SCAN) {
+            soln = buildColumnScanSoln(*winnerCacheData.tree->entry, query, params);
+        }
+        if (!soln) {
+            return Status(ErrorCodes::BadValue, "plan cache error: column scan soln");
+        } else {
+            return {std::move(soln)};
+        }
     }
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
@@ -999,6 +1021,30 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collscanNeeded = (0 == out.size() && canTableScan);
 
+    // A column scan reads every document just as a collection scan does, but only the fields the
+    // query needs, so it takes the place of a collection scan which is needed because no index
+    // applies. It never competes with indexed plans.
+    if (possibleToCollscan && collscanNeeded &&
+        params.options & QueryPlannerParams::INCLUDE_COLUMN_SCAN) {
+        for (auto&& index : params.columnStoreIndexes) {
+            auto soln = buildColumnScanSoln(index, query, params);
+            if (soln) {
+                LOG(5) << "Planner: outputting a column scan:" << endl << redact(soln->toString());
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::COLUMN_SCAN_SOLN;
+                soln->cacheData.reset(scd);
+
+                out.push_back(std::move(soln));
+                collscanNeeded = false;
+                break;
+            }
+        }
+    }
+
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         auto collscan = buildCollscanSoln(query, isTailable, params);
         if (collscan) {
@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/query_planner_test_fixture.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A specialization of the QueryPlannerTest fixture which presents the planner with columnstore
+ * indexes and allows it to consider column scans.
+ */
+class QueryPlannerColumnStoreTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        params.options |= QueryPlannerParams::INCLUDE_COLUMN_SCAN;
+    }
+
+    void addColumnStoreIndex(BSONObj keyPattern) {
+        params.columnStoreIndexes.push_back({std::move(keyPattern),
+                                             IndexType::INDEX_COLUMN,
+                                             false,  // multikey
+                                             {},
+                                             {},
+                                             false,  // sparse
+                                             false,  // unique
+                                             IndexEntry::Identifier{"columnstore"},
+                                             nullptr,  // filterExpr
+                                             BSONObj(),
+                                             nullptr,
+                                             nullptr});
+    }
+
+    /**
+     * Returns the column scan of the solution which reads one, or nullptr if no solution does.
+     */
+    const ColumnScanNode* findColumnScan() const {
+        for (auto&& soln : solns) {
+            if (auto node = findColumnScan(soln->root.get())) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static const ColumnScanNode* findColumnScan(const QuerySolutionNode* node) {
+        if (STAGE_COLUMN_SCAN == node->getType()) {
+            return static_cast<const ColumnScanNode*>(node);
+        }
+        for (auto&& child : node->children) {
+            if (auto columnScan = findColumnScan(child)) {
+                return columnScan;
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(QueryPlannerColumnStoreTest, ReadsOnlyTheColumnsTheQueryNeeds) {
+    addColumnStoreIndex(BSON("a" << IndexNames::COLUMN << "b" << IndexNames::COLUMN << "c"
+                                 << IndexNames::COLUMN));
+    runQuerySortProj(fromjson("{b: 1}"), BSONObj(), fromjson("{a: 1}"));
+
+    auto columnScan = findColumnScan();
+    ASSERT(columnScan);
+    ASSERT(columnScan->columns == std::vector<std::string>({"a", "b"}));
+}
+
+TEST_F(QueryPlannerColumnStoreTest, ProjectsDottedPathFromTopLevelColumn) {
+    addColumnStoreIndex(BSON("a" << IndexNames::COLUMN));
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{'a.b': 1}"));
+
+    auto columnScan = findColumnScan();
+    ASSERT(columnScan);
+    ASSERT(columnScan->columns == std::vector<std::string>({"a"}));
+}
+
+TEST_F(QueryPlannerColumnStoreTest, ProjectsDottedPathFromColumnPerField) {
+    addColumnStoreIndex(BSON("$**" << IndexNames::COLUMN));
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{'a.b': 1}"));
+
+    auto columnScan = findColumnScan();
+    ASSERT(columnScan);
+    ASSERT(columnScan->columns == std::vector<std::string>({"a"}));
+}
+
+TEST_F(QueryPlannerColumnStoreTest, DoesNotProjectFromDottedColumn) {
+    // The projection of {a: {c: 1}} on "a.b" is {a: {}}, but the column for "a.b" holds nothing
+    // for that document.
+    addColumnStoreIndex(BSON("a.b" << IndexNames::COLUMN));
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{'a.b': 1}"));
+    ASSERT_FALSE(findColumnScan());
+
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{'a.b.c': 1}"));
+    ASSERT_FALSE(findColumnScan());
+}
+
+TEST_F(QueryPlannerColumnStoreTest, FiltersOnDottedColumn) {
+    addColumnStoreIndex(BSON("a.b" << IndexNames::COLUMN << "c" << IndexNames::COLUMN));
+    runQuerySortProj(fromjson("{'a.b': 1}"), BSONObj(), fromjson("{c: 1}"));
+
+    auto columnScan = findColumnScan();
+    ASSERT(columnScan);
+    ASSERT(columnScan->columns == std::vector<std::string>({"a.b", "c"}));
+}
+
+TEST_F(QueryPlannerColumnStoreTest, DoesNotProjectFieldsFromSeveralColumns) {
+    // The scan would return the fields in path order rather than in their stored order.
+    addColumnStoreIndex(BSON("$**" << IndexNames::COLUMN));
+    runQuerySortProj(BSONObj(), BSONObj(), fromjson("{z: 1, a: 1}"));
+    ASSERT_FALSE(findColumnScan());
+
+    runQuerySortProj(fromjson("{z: 1}"), BSONObj(), fromjson("{_id: 1, a: 1}"));
+    ASSERT(findColumnScan());
+}
+
+TEST_F(QueryPlannerColumnStoreTest, DoesNotCompeteWithIndexedPlans) {
+    addIndex(BSON("a" << 1));
+    addColumnStoreIndex(BSON("$**" << IndexNames::COLUMN));
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{b: 1}"));
+    ASSERT_FALSE(findColumnScan());
+
+    runQuerySortProj(fromjson("{c: 1}"), BSONObj(), fromjson("{b: 1}"));
+    ASSERT(findColumnScan());
+}
+
+TEST_F(QueryPlannerColumnStoreTest, DoesNotUseColumnScanWithoutProjection) {
+    addColumnStoreIndex(BSON("$**" << IndexNames::COLUMN));
+    runQuery(fromjson("{a: 1}"));
+    ASSERT_FALSE(findColumnScan());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -98,6 +98,11 @@ struct QueryPlannerParams {
         // return exactly one document per value of the distinct field. See the comments above the
         // declaration of getExecutorDistinct() for more detail.
         STRICT_DISTINCT_ONLY = 1 << 11,
+
+        // Set this to consider scanning the columnstore indexes in 'columnStoreIndexes' instead of
+        // the collection. The results of a column scan hold only the fields the query needs, so
+        // this must not be set for updates, deletes or anything else needing whole documents.
+        INCLUDE_COLUMN_SCAN = 1 << 12,
     };
 
     // See Options enum above.
@@ -106,6 +111,10 @@ struct QueryPlannerParams {
     // What indices are available for planning?
     std::vector<IndexEntry> indices;
 
+    // The columnstore indexes of the collection, if INCLUDE_COLUMN_SCAN is set. They are kept
+    // apart from 'indices' because they cannot answer index scans.
+    std::vector<IndexEntry> columnStoreIndexes;
+
     // What's our shard key?  If INCLUDE_SHARD_FILTER is set we will create a shard filtering
     // stage.  If we know the shard key, we can perform covering analysis instead of always
     // forcing a fetch.
@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/db/query/query_solution.h"
@@ -203,6 +204,10 @@ void TextNode::appendToString(str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topKLimit) {
+        addIndent(ss, indent + 1);
+        *ss << "topKLimit = " << topKLimit << '\n';
+    }
     if (nullptr != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->debugString();
@@ -217,6 +222,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->_sort = this->_sort;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->topKLimit = this->topKLimit;
 
     return copy;
 }
@@ -254,6 +260,49 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     return copy;
 }
 
+//
+// ColumnScanNode
+//
+
+bool ColumnScanNode::hasField(const std::string& field) const {
+    const auto isPrefixOf = [&field](StringData path) {
+        return StringData(field).startsWith(path) &&
+            (field.size() == path.size() || field[path.size()] == '.');
+    };
+
+    return isPrefixOf("_id") || std::any_of(columns.begin(), columns.end(), isPrefixOf);
+}
+
+void ColumnScanNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "COLUMN_SCAN\n";
+    addIndent(ss, indent + 1);
+    *ss << "name = " << index.identifier.catalogName << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "keyPattern = " << index.keyPattern << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "columns = [";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        *ss << (i > 0 ? ", " : "") << columns[i];
+    }
+    *ss << "]\n";
+    if (nullptr != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->debugString();
+    }
+    addCommon(ss, indent);
+}
+
+QuerySolutionNode* ColumnScanNode::clone() const {
+    ColumnScanNode* copy = new ColumnScanNode(this->index);
+    cloneBaseData(copy);
+
+    copy->_sort = this->_sort;
+    copy->columns = this->columns;
+
+    return copy;
+}
+
 //
 // AndHashNode
 //
@@ -287,6 +287,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If nonzero, the node is the input of a sort by text score with this limit, so only the
+    // 'topKLimit' documents with the highest text scores need to be returned.
+    size_t topKLimit = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -333,6 +337,44 @@ struct CollectionScanNode : public QuerySolutionNode {
     bool shouldWaitForOplogVisibility = false;
 };
 
+/**
+ * Reads the fields a query needs from the columns of a columnstore index. Produces one result per
+ * document, holding only those fields, so it is not 'fetched()'.
+ */
+struct ColumnScanNode : public QuerySolutionNode {
+    ColumnScanNode(IndexEntry index)
+        : _sort(SimpleBSONObjComparator::kInstance.makeBSONObjSet()), index(std::move(index)) {}
+
+    virtual ~ColumnScanNode() {}
+
+    virtual StageType getType() const {
+        return STAGE_COLUMN_SCAN;
+    }
+
+    virtual void appendToString(str::stream* ss, int indent) const;
+
+    bool fetched() const {
+        return false;
+    }
+    bool hasField(const std::string& field) const;
+    bool sortedByDiskLoc() const {
+        return false;
+    }
+    const BSONObjSet& getSort() const {
+        return _sort;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet _sort;
+
+    IndexEntry index;
+
+    // The paths of the columns to read, in sorted order. No path is a prefix of another. The _id
+    // field is always available from the row column, which is read in addition to these.
+    std::vector<std::string> columns;
+};
+
 struct AndHashNode : public QuerySolutionNode {
     AndHashNode();
     virtual ~AndHashNode();
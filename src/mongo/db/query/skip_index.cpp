@@ -0,0 +1,353 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/skip_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+namespace {
+
+namespace dps = ::mongo::dotted_path_support;
+
+// Bloom filter positions are derived from two hashes of a value, with the i-th position at
+// h1 + i * h2 modulo the size of the filter.
+const int kNumBloomFilterHashes = 4;
+
+const BSONElementComparator kValueComparator(BSONElementComparator::FieldNamesMode::kIgnore,
+                                             nullptr);
+
+// Spreads the bits of the hash of a value, which are poorly mixed for small numbers.
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename Fn>
+void forEachBloomFilterBit(const BSONElement& value, size_t numWords, const Fn& fn) {
+    const uint64_t h1 = mixHash(kValueComparator.hash(value));
+    const uint64_t h2 = mixHash(h1) | 1;
+    const uint64_t numBits = numWords * 64;
+    for (int i = 0; i < kNumBloomFilterHashes; ++i) {
+        const uint64_t bit = (h1 + i * h2) % numBits;
+        fn(bit / 64, uint64_t{1} << (bit % 64));
+    }
+}
+
+// Whether a predicate against 'value' can be decided from the smallest and largest values and the
+// values hashed into a Bloom filter. Comparisons to null also match missing fields, and arrays are
+// matched against their elements, neither of which the summaries record.
+bool isUsableValue(const BSONElement& value) {
+    switch (value.type()) {
+        case EOO:
+        case jstNULL:
+        case Undefined:
+        case Array:
+        case RegEx:
+        case MinKey:
+        case MaxKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
+}  // namespace
+
+SkipIndex::Filter::Filter(std::shared_ptr<const SkipIndex> skipIndex,
+                          std::vector<Predicate> predicates)
+    : _skipIndex(std::move(skipIndex)), _predicates(std::move(predicates)) {}
+
+bool SkipIndex::Filter::mayMatch(const RecordId& id) {
+    const long long block = _skipIndex->_blockFor(id);
+    if (!_haveLastBlock || block != _lastBlock) {
+        _lastBlock = block;
+        _lastBlockMayMatch = _skipIndex->_mayMatch(block, _predicates);
+        _haveLastBlock = true;
+    }
+    return _lastBlockMayMatch;
+}
+
+RecordId SkipIndex::Filter::nextCandidate(const RecordId& id, size_t* blocksSkipped) {
+    const RecordId next =
+        _skipIndex->_nextCandidate(_skipIndex->_blockFor(id), _predicates, blocksSkipped);
+    if (!next.isNull()) {
+        _lastBlock = _skipIndex->_blockFor(next);
+        _lastBlockMayMatch = true;
+        _haveLastBlock = true;
+    }
+    return next;
+}
+
+SkipIndex::SkipIndex(std::vector<std::string> paths,
+                     long long recordsPerBlock,
+                     size_t bloomFilterBits)
+    : _paths(std::move(paths)),
+      _recordsPerBlock(recordsPerBlock),
+      _bloomFilterWords((bloomFilterBits + 63) / 64) {
+    invariant(_recordsPerBlock > 0);
+    invariant(_bloomFilterWords > 0);
+}
+
+std::unique_ptr<SkipIndex::Filter> SkipIndex::makeFilter(
+    std::shared_ptr<const SkipIndex> skipIndex, const MatchExpression* expr) {
+    if (!skipIndex || !skipIndex->isReady() || !expr) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> conjuncts;
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            conjuncts.push_back(expr->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(expr);
+    }
+
+    std::vector<Filter::Predicate> predicates;
+    for (auto conjunct : conjuncts) {
+        const auto& paths = skipIndex->paths();
+        const auto path = std::find(paths.begin(), paths.end(), conjunct->path());
+        if (path == paths.end()) {
+            continue;
+        }
+
+        Filter::Predicate predicate;
+        predicate.pathIndex = std::distance(paths.begin(), path);
+        predicate.matchType = conjunct->matchType();
+
+        switch (conjunct->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE: {
+                auto comparison = static_cast<const ComparisonMatchExpressionBase*>(conjunct);
+                if (comparison->getCollator() || !isUsableValue(comparison->getData())) {
+                    continue;
+                }
+                predicate.values.push_back(comparison->getData());
+                break;
+            }
+            case MatchExpression::MATCH_IN: {
+                auto in = static_cast<const InMatchExpression*>(conjunct);
+                if (in->getCollator() || !in->getRegexes().empty() ||
+                    !std::all_of(in->getEqualities().begin(),
+                                 in->getEqualities().end(),
+                                 isUsableValue)) {
+                    continue;
+                }
+                predicate.values = in->getEqualities();
+                break;
+            }
+            default:
+                continue;
+        }
+
+        predicates.push_back(std::move(predicate));
+    }
+
+    if (predicates.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<Filter>(std::move(skipIndex), std::move(predicates));
+}
+
+void SkipIndex::addDocument(const RecordId& id, const BSONObj& doc) {
+    // Extract the values before taking the mutex, so that concurrent writers only serialize on
+    // updating the summaries.
+    std::vector<BSONElement> values;
+    values.reserve(_paths.size());
+    for (auto&& path : _paths) {
+        const char* remainingPath = path.c_str();
+        values.push_back(dps::extractElementAtPathOrArrayAlongPath(doc, remainingPath));
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& block = _blocks[_blockFor(id)];
+    if (block.fields.empty()) {
+        block.fields.resize(_paths.size());
+        for (auto&& summary : block.fields) {
+            summary.bloomFilter.resize(_bloomFilterWords);
+        }
+    }
+    if (block.firstRecordId.isNull() || id < block.firstRecordId) {
+        block.firstRecordId = id;
+    }
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        // A missing value, or a path through a scalar, matches none of the predicates used.
+        if (values[i].eoo()) {
+            continue;
+        }
+
+        // The extraction stops at the first array along the path.
+        if (values[i].type() == Array) {
+            block.fields[i].hasArrays = true;
+            continue;
+        }
+
+        _addValue(lk, &block.fields[i], values[i]);
+    }
+}
+
+void SkipIndex::_addValue(WithLock, FieldSummary* summary, const BSONElement& value) {
+    if (summary->min.isEmpty() || kValueComparator.evaluate(value < summary->min.firstElement())) {
+        summary->min = value.wrap("");
+    }
+    if (summary->max.isEmpty() || kValueComparator.evaluate(value > summary->max.firstElement())) {
+        summary->max = value.wrap("");
+    }
+
+    forEachBloomFilterBit(value, _bloomFilterWords, [&](size_t word, uint64_t mask) {
+        summary->bloomFilter[word] |= mask;
+    });
+}
+
+bool SkipIndex::FieldSummary::mayContain(const BSONElement& value) const {
+    if (min.isEmpty() || kValueComparator.evaluate(value < min.firstElement()) ||
+        kValueComparator.evaluate(value > max.firstElement())) {
+        return false;
+    }
+
+    bool allBitsSet = true;
+    forEachBloomFilterBit(value, bloomFilter.size(), [&](size_t word, uint64_t mask) {
+        allBitsSet = allBitsSet && (bloomFilter[word] & mask);
+    });
+    return allBitsSet;
+}
+
+bool SkipIndex::_mayMatch(long long blockNumber,
+                          const std::vector<Filter::Predicate>& predicates) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _blocks.find(blockNumber);
+    if (it == _blocks.end()) {
+        // Every block holding a record has a summary, so there is nothing to skip here.
+        return true;
+    }
+
+    return _blockMayMatch(lk, it->second, predicates);
+}
+
+RecordId SkipIndex::_nextCandidate(long long blockNumber,
+                                   const std::vector<Filter::Predicate>& predicates,
+                                   size_t* blocksSkipped) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++*blocksSkipped;
+
+    // Blocks without a summary hold no records, so only the summarized ones need be considered.
+    for (auto it = _blocks.upper_bound(blockNumber); it != _blocks.end(); ++it) {
+        if (_blockMayMatch(lk, it->second, predicates)) {
+            return it->second.firstRecordId;
+        }
+        ++*blocksSkipped;
+    }
+    return RecordId();
+}
+
+bool SkipIndex::_blockMayMatch(WithLock,
+                               const Block& block,
+                               const std::vector<Filter::Predicate>& predicates) {
+    for (auto&& predicate : predicates) {
+        const FieldSummary& summary = block.fields[predicate.pathIndex];
+        if (summary.hasArrays) {
+            continue;
+        }
+
+        // None of the documents of the block has a value for the path.
+        if (summary.min.isEmpty()) {
+            return false;
+        }
+
+        const BSONElement min = summary.min.firstElement();
+        const BSONElement max = summary.max.firstElement();
+
+        bool mayMatch = true;
+        switch (predicate.matchType) {
+            case MatchExpression::EQ:
+                mayMatch = summary.mayContain(predicate.values.front());
+                break;
+            case MatchExpression::LT:
+                mayMatch = kValueComparator.evaluate(min < predicate.values.front());
+                break;
+            case MatchExpression::LTE:
+                mayMatch = kValueComparator.evaluate(min <= predicate.values.front());
+                break;
+            case MatchExpression::GT:
+                mayMatch = kValueComparator.evaluate(max > predicate.values.front());
+                break;
+            case MatchExpression::GTE:
+                mayMatch = kValueComparator.evaluate(max >= predicate.values.front());
+                break;
+            case MatchExpression::MATCH_IN:
+                mayMatch = std::any_of(predicate.values.begin(),
+                                       predicate.values.end(),
+                                       [&](const BSONElement& v) { return summary.mayContain(v); });
+                break;
+            default:
+                MONGO_UNREACHABLE;
+        }
+
+        if (!mayMatch) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SkipIndex::appendToBSON(BSONObjBuilder* builder) const {
+    BSONArrayBuilder pathsBuilder(builder->subarrayStart("keys"));
+    for (auto&& path : _paths) {
+        pathsBuilder.append(path);
+    }
+    pathsBuilder.doneFast();
+
+    builder->appendNumber("recordsPerBlock", _recordsPerBlock);
+    builder->appendNumber("bloomFilterBits", static_cast<long long>(_bloomFilterWords * 64));
+    builder->append("ready", isReady());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->appendNumber("blocks", static_cast<long long>(_blocks.size()));
+}
+
+}  // namespace mongo
@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A lightweight index which summarizes the values of a few fields of a collection per block of
+ * consecutive RecordIds, instead of indexing every document. For each field and block it keeps
+ * the smallest and largest value, in BSON order, and a Bloom filter of the values. A collection
+ * scan whose filter constrains one of the fields can then pass over the records of every block
+ * which cannot hold a match, without the write amplification of maintaining a btree index. This
+ * suits ad-hoc filters over large collections which are mostly appended to.
+ *
+ * Summaries only ever grow. Deleting a document or changing one of its values leaves the old
+ * value in the summary of its block, so a block may be visited without holding a match, but a
+ * block holding a match is never skipped. Blocks with an array along a summarized path are never
+ * skipped on predicates over that path.
+ *
+ * Skip indexes are not an index type: they are built by the skipIndex command on the node it runs
+ * on and are not replicated. Like index filters, they are kept in memory only, and are lost on
+ * restart.
+ *
+ * This class is thread-safe.
+ */
+class SkipIndex {
+    SkipIndex(const SkipIndex&) = delete;
+    SkipIndex& operator=(const SkipIndex&) = delete;
+
+public:
+    /**
+     * Decides whether the records of a block may match the filter of a collection scan. Created
+     * for a single scan, and not thread-safe.
+     */
+    class Filter {
+    public:
+        struct Predicate {
+            // The position of the constrained path in the paths of the skip index.
+            size_t pathIndex;
+
+            // One of EQ, LT, LTE, GT, GTE or MATCH_IN.
+            MatchExpression::MatchType matchType;
+
+            // The operand of a comparison, or each equality of an $in.
+            std::vector<BSONElement> values;
+        };
+
+        Filter(std::shared_ptr<const SkipIndex> skipIndex, std::vector<Predicate> predicates);
+
+        /**
+         * Returns false if the record 'id' cannot match the filter the predicates were taken from.
+         * The answer is remembered for the block of 'id', so that a scan only consults the skip
+         * index once per block.
+         */
+        bool mayMatch(const RecordId& id);
+
+        /**
+         * Returns the smallest RecordId written to the first block after the block of 'id' which
+         * may match, or a null RecordId if no later block may match. Adds the number of blocks
+         * passed over to 'blocksSkipped'. A forward scan which finds that 'id' cannot match may
+         * seek there instead of reading the records in between, although the record returned may
+         * have been deleted since.
+         */
+        RecordId nextCandidate(const RecordId& id, size_t* blocksSkipped);
+
+        /**
+         * Forgets the answer remembered for the last block. Must be called when the scan resumes
+         * after yielding, since writers may have added values to the summary of that block.
+         */
+        void reset() {
+            _haveLastBlock = false;
+        }
+
+        const SkipIndex* skipIndex() const {
+            return _skipIndex.get();
+        }
+
+    private:
+        std::shared_ptr<const SkipIndex> _skipIndex;
+        std::vector<Predicate> _predicates;
+
+        long long _lastBlock = 0;
+        bool _lastBlockMayMatch = true;
+        bool _haveLastBlock = false;
+    };
+
+    /**
+     * Summarizes the values of each field path in 'paths' over blocks of 'recordsPerBlock'
+     * consecutive RecordIds, with Bloom filters of 'bloomFilterBits' bits.
+     */
+    SkipIndex(std::vector<std::string> paths, long long recordsPerBlock, size_t bloomFilterBits);
+
+    /**
+     * Returns a filter for the records of a scan with the filter 'expr', or nullptr if there is no
+     * skip index or 'expr' does not constrain any of its paths in a way it can use. Only top-level
+     * conjunctions of comparisons and $in against constants are used, and only under the simple
+     * collation. 'expr' must outlive the filter returned.
+     *
+     * Also returns nullptr while the skip index is still being built.
+     */
+    static std::unique_ptr<Filter> makeFilter(std::shared_ptr<const SkipIndex> skipIndex,
+                                               const MatchExpression* expr);
+
+    /**
+     * Adds the values of 'doc', which is stored at 'id', to the summary of its block. Must be
+     * called for every document inserted or updated before the write can become visible.
+     */
+    void addDocument(const RecordId& id, const BSONObj& doc);
+
+    /**
+     * Marks the summaries as complete, after which scans may use them to skip blocks. Until then
+     * writers keep the skip index up to date, but scans ignore it.
+     */
+    void markReady() {
+        _ready.store(true);
+    }
+
+    bool isReady() const {
+        return _ready.load();
+    }
+
+    const std::vector<std::string>& paths() const {
+        return _paths;
+    }
+
+    long long recordsPerBlock() const {
+        return _recordsPerBlock;
+    }
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+private:
+    // The summary of the values of one path over one block.
+    struct FieldSummary {
+        bool mayContain(const BSONElement& value) const;
+
+        // Single-field objects holding the smallest and largest value. Empty while no value has
+        // been seen.
+        BSONObj min;
+        BSONObj max;
+
+        // Set once a document of the block has an array along the path, after which the block is
+        // never skipped on the path.
+        bool hasArrays = false;
+
+        std::vector<uint64_t> bloomFilter;
+    };
+
+    struct Block {
+        // The smallest RecordId written to the block.
+        RecordId firstRecordId;
+
+        // The summary of each path, in the order of the paths.
+        std::vector<FieldSummary> fields;
+    };
+
+    long long _blockFor(const RecordId& id) const {
+        return id.repr() / _recordsPerBlock;
+    }
+
+    bool _mayMatch(long long block, const std::vector<Filter::Predicate>& predicates) const;
+
+    RecordId _nextCandidate(long long block,
+                            const std::vector<Filter::Predicate>& predicates,
+                            size_t* blocksSkipped) const;
+
+    static bool _blockMayMatch(WithLock,
+                               const Block& block,
+                               const std::vector<Filter::Predicate>& predicates);
+
+    void _addValue(WithLock, FieldSummary* summary, const BSONElement& value);
+
+    const std::vector<std::string> _paths;
+    const long long _recordsPerBlock;
+    const size_t _bloomFilterWords;
+
+    // Set once every record which existed when the skip index was installed has been added.
+    AtomicWord<bool> _ready{false};
+
+    mutable stdx::mutex _mutex;
+
+    std::map<long long, Block> _blocks;
+};
+
+}  // namespace mongo
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/skip_index.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const long long kRecordsPerBlock = 10;
+
+std::unique_ptr<MatchExpression> parseMatchExpression(const BSONObj& obj,
+                                                      const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    StatusWithMatchExpression status = MatchExpressionParser::parse(obj, std::move(expCtx));
+    ASSERT_OK(status.getStatus());
+    return std::move(status.getValue());
+}
+
+std::shared_ptr<SkipIndex> makeSkipIndex(std::vector<std::string> paths) {
+    auto skipIndex = std::make_shared<SkipIndex>(std::move(paths), kRecordsPerBlock, 1024);
+    skipIndex->markReady();
+    return skipIndex;
+}
+
+/**
+ * Returns whether a scan with the filter 'query' would test the records of the block 'block' of
+ * 'skipIndex'. The skip index must be able to use 'query'.
+ */
+bool blockMayMatch(std::shared_ptr<SkipIndex> skipIndex, const char* query, long long block) {
+    auto expr = parseMatchExpression(fromjson(query));
+    auto filter = SkipIndex::makeFilter(skipIndex, expr.get());
+    ASSERT(filter);
+    return filter->mayMatch(RecordId(block * kRecordsPerBlock + 1));
+}
+
+TEST(SkipIndexTest, FilterNotMadeWithoutUsablePredicates) {
+    auto skipIndex = makeSkipIndex({"a"});
+
+    for (auto query : {"{b: 1}",
+                       "{a: null}",
+                       "{a: [1, 2]}",
+                       "{a: {$in: [1, null]}}",
+                       "{a: {$in: [1, /x/]}}",
+                       "{a: {$ne: 1}}",
+                       "{$or: [{a: 1}, {a: 2}]}"}) {
+        auto expr = parseMatchExpression(fromjson(query));
+        ASSERT_FALSE(SkipIndex::makeFilter(skipIndex, expr.get())) << query;
+    }
+
+    ASSERT_FALSE(SkipIndex::makeFilter(nullptr, parseMatchExpression(fromjson("{a: 1}")).get()));
+}
+
+TEST(SkipIndexTest, FilterNotMadeWhileBuilding) {
+    auto skipIndex =
+        std::make_shared<SkipIndex>(std::vector<std::string>{"a"}, kRecordsPerBlock, 1024);
+    skipIndex->addDocument(RecordId(1), BSON("a" << 1));
+
+    auto expr = parseMatchExpression(fromjson("{a: 2}"));
+    ASSERT_FALSE(SkipIndex::makeFilter(skipIndex, expr.get()));
+
+    skipIndex->markReady();
+    ASSERT(SkipIndex::makeFilter(skipIndex, expr.get()));
+}
+
+TEST(SkipIndexTest, FilterSeesValuesAddedToTheLastBlockAfterReset) {
+    auto skipIndex = makeSkipIndex({"a"});
+    skipIndex->addDocument(RecordId(1), BSON("a" << 1));
+
+    auto expr = parseMatchExpression(fromjson("{a: 2}"));
+    auto filter = SkipIndex::makeFilter(skipIndex, expr.get());
+    ASSERT(filter);
+    ASSERT_FALSE(filter->mayMatch(RecordId(1)));
+
+    // A write while the scan yields adds a matching value to the block the scan stopped in.
+    skipIndex->addDocument(RecordId(2), BSON("a" << 2));
+    filter->reset();
+    ASSERT_TRUE(filter->mayMatch(RecordId(2)));
+}
+
+TEST(SkipIndexTest, FilterNotMadeForCollatedComparisons) {
+    auto skipIndex = makeSkipIndex({"a"});
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    auto expr = parseMatchExpression(fromjson("{a: 'abc'}"), &collator);
+    ASSERT_FALSE(SkipIndex::makeFilter(skipIndex, expr.get()));
+}
+
+TEST(SkipIndexTest, EqualitySkipsBlocksWithoutValue) {
+    auto skipIndex = makeSkipIndex({"a"});
+    for (int i = 0; i < 30; ++i) {
+        skipIndex->addDocument(RecordId(i + 1), BSON("a" << i));
+    }
+
+    // Each block holds ten consecutive values of 'a'.
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 5}", 0));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 5}", 1));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 5}", 2));
+
+    // Numbers of other types compare equal.
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: NumberLong(15)}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 15.0}", 1));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 15.5}", 1));
+}
+
+TEST(SkipIndexTest, RangeComparisonsUseMinAndMax) {
+    auto skipIndex = makeSkipIndex({"a"});
+    for (int i = 0; i < 30; ++i) {
+        skipIndex->addDocument(RecordId(i + 1), BSON("a" << i));
+    }
+
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: {$gt: 19}}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: {$gte: 19}}", 1));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: {$lt: 10}}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: {$lte: 10}}", 1));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: {$gt: 5, $lt: 8}}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: {$gt: 5, $lt: 12}}", 1));
+}
+
+TEST(SkipIndexTest, InMatchesIfAnyEqualityMayMatch) {
+    auto skipIndex = makeSkipIndex({"a"});
+    for (int i = 0; i < 20; ++i) {
+        skipIndex->addDocument(RecordId(i + 1), BSON("a" << i));
+    }
+
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: {$in: [1, 2, 3]}}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: {$in: [1, 2, 13]}}", 1));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: {$in: []}}", 1));
+}
+
+TEST(SkipIndexTest, ConjunctionSkipsIfAnyPredicateCannotMatch) {
+    auto skipIndex = makeSkipIndex({"a", "b.c"});
+    for (int i = 0; i < 10; ++i) {
+        skipIndex->addDocument(RecordId(i + 1), BSON("a" << i << "b" << fromjson("{c: 'x'}")));
+    }
+
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 1, 'b.c': 'x', d: 5}", 0));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 1, 'b.c': 'y'}", 0));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 11, 'b.c': 'x'}", 0));
+}
+
+TEST(SkipIndexTest, BlocksWithArraysAreNotSkipped) {
+    auto skipIndex = makeSkipIndex({"a.b"});
+    skipIndex->addDocument(RecordId(1), fromjson("{a: {b: 1}}"));
+    skipIndex->addDocument(RecordId(11), fromjson("{a: {b: 1}}"));
+    skipIndex->addDocument(RecordId(12), fromjson("{a: [{b: 2}]}"));
+    skipIndex->addDocument(RecordId(21), fromjson("{a: {b: 1}}"));
+    skipIndex->addDocument(RecordId(22), fromjson("{a: {b: [3]}}"));
+
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{'a.b': 5}", 0));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{'a.b': 5}", 1));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{'a.b': 5}", 2));
+}
+
+TEST(SkipIndexTest, BlocksWithoutValuesAreSkipped) {
+    auto skipIndex = makeSkipIndex({"a"});
+    skipIndex->addDocument(RecordId(1), BSON("b" << 1));
+    skipIndex->addDocument(RecordId(2), BSON("a" << BSON("c" << 1)));
+
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 1}", 0));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: {c: 1}}", 0));
+}
+
+TEST(SkipIndexTest, BlocksWithoutSummaryAreNotSkipped) {
+    auto skipIndex = makeSkipIndex({"a"});
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 1}", 3));
+}
+
+TEST(SkipIndexTest, SummariesKeepValuesOfUpdatedDocuments) {
+    auto skipIndex = makeSkipIndex({"a"});
+    skipIndex->addDocument(RecordId(1), BSON("a" << 1));
+    skipIndex->addDocument(RecordId(1), BSON("a" << 2));
+
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 1}", 0));
+    ASSERT_TRUE(blockMayMatch(skipIndex, "{a: 2}", 0));
+    ASSERT_FALSE(blockMayMatch(skipIndex, "{a: 3}", 0));
+}
+
+TEST(SkipIndexTest, NextCandidateIsFirstRecordOfNextBlockWhichMayMatch) {
+    auto skipIndex = makeSkipIndex({"a"});
+    skipIndex->addDocument(RecordId(3), BSON("a" << 1));
+    skipIndex->addDocument(RecordId(14), BSON("a" << 1));
+    skipIndex->addDocument(RecordId(47), BSON("a" << 2));
+    skipIndex->addDocument(RecordId(45), BSON("a" << 1));
+    skipIndex->addDocument(RecordId(52), BSON("a" << 2));
+
+    auto expr = parseMatchExpression(fromjson("{a: 2}"));
+    auto filter = SkipIndex::makeFilter(skipIndex, expr.get());
+    ASSERT(filter);
+
+    // Blocks 0 and 1 cannot match and blocks 2 and 3 hold no records. The scan resumes at the
+    // smallest RecordId of block 4, although it was not written first.
+    ASSERT_FALSE(filter->mayMatch(RecordId(3)));
+    size_t blocksSkipped = 0;
+    ASSERT_EQ(RecordId(45), filter->nextCandidate(RecordId(3), &blocksSkipped));
+    ASSERT_EQ(2U, blocksSkipped);
+    ASSERT_TRUE(filter->mayMatch(RecordId(45)));
+
+    ASSERT_TRUE(filter->nextCandidate(RecordId(52), &blocksSkipped).isNull());
+    ASSERT_EQ(3U, blocksSkipped);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -72,6 +72,8 @@ struct ServerGlobalParams {
 
     bool objcheck = true;  // --objcheck
 
+    AtomicWord<bool> objcheckUTF8{false};  // wireObjectCheckUTF8 server parameter
+
     int defaultProfile = 0;                // --profile
     int slowMS = 100;                      // --time in ms that is "slow"
     double sampleRate = 1.0;               // --samplerate rate at which to sample slow queries
@@ -66,93 +66,118 @@ void OpCounters::gotOp(int op, bool isCommand) {
     }
 }
 
-void OpCounters::_checkWrap(CacheAligned<AtomicWord<long long>> OpCounters::*counter, int n) {
-    static constexpr auto maxCount = 1LL << 60;
-    auto oldValue = (this->*counter).fetchAndAddRelaxed(n);
+void OpCounters::_checkWrap(AtomicWord<long long> Counts::*counter, int n) {
+    // Each CPU's counter is bounded by its share of 2^60, so that their sum is bounded by 2^60.
+    static const long long maxCount = (1LL << 60) / PerCpuSlots::count();
+    auto oldValue = (_counts.local().*counter).fetchAndAddRelaxed(n);
     if (oldValue > maxCount) {
-        _insert.store(0);
-        _query.store(0);
-        _update.store(0);
-        _delete.store(0);
-        _getmore.store(0);
-        _command.store(0);
+        _counts.forEach([](Counts& counts) {
+            counts.insert.store(0);
+            counts.query.store(0);
+            counts.update.store(0);
+            counts.remove.store(0);
+            counts.getmore.store(0);
+            counts.command.store(0);
+        });
     }
 }
 
+long long OpCounters::_sum(AtomicWord<long long> Counts::*counter) const {
+    long long sum = 0;
+    _counts.forEach([&](const Counts& counts) { sum += (counts.*counter).loadRelaxed(); });
+    return sum;
+}
+
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.append("insert", getInsert());
+    b.append("query", getQuery());
+    b.append("update", getUpdate());
+    b.append("delete", getDelete());
+    b.append("getmore", getGetMore());
+    b.append("command", getCommand());
     return b.obj();
 }
 
+namespace {
+
+// Each CPU's counter is bounded by its share of 2^60, so that their sum is bounded by 2^60.
+long long maxNetworkCount() {
+    static const long long maxCount = (1LL << 60) / PerCpuSlots::count();
+    return maxCount;
+}
+
+}  // namespace
+
 void NetworkCounter::hitPhysicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
+    auto& counts = _counts.local();
 
     // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesIn.loadRelaxed() > MAX;
+    const bool overflow = counts.physicalBytesIn.loadRelaxed() > maxNetworkCount();
 
     if (overflow) {
-        _physicalBytesIn.store(bytes);
+        counts.physicalBytesIn.store(bytes);
     } else {
-        _physicalBytesIn.fetchAndAdd(bytes);
+        counts.physicalBytesIn.fetchAndAddRelaxed(bytes);
     }
 }
 
 void NetworkCounter::hitPhysicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
+    auto& counts = _counts.local();
 
     // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesOut.loadRelaxed() > MAX;
+    const bool overflow = counts.physicalBytesOut.loadRelaxed() > maxNetworkCount();
 
     if (overflow) {
-        _physicalBytesOut.store(bytes);
+        counts.physicalBytesOut.store(bytes);
     } else {
-        _physicalBytesOut.fetchAndAdd(bytes);
+        counts.physicalBytesOut.fetchAndAddRelaxed(bytes);
     }
 }
 
 void NetworkCounter::hitLogicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
+    auto& counts = _counts.local();
 
     // don't care about the race as its just a counter
-    const bool overflow = _together.logicalBytesIn.loadRelaxed() > MAX;
+    const bool overflow = counts.logicalBytesIn.loadRelaxed() > maxNetworkCount();
 
     if (overflow) {
-        _together.logicalBytesIn.store(bytes);
+        counts.logicalBytesIn.store(bytes);
         // The requests field only gets incremented here (and not in hitPhysical) because the
         // hitLogical and hitPhysical are each called for each operation. Incrementing it in both
         // functions would double-count the number of operations.
-        _together.requests.store(1);
+        counts.requests.store(1);
     } else {
-        _together.logicalBytesIn.fetchAndAdd(bytes);
-        _together.requests.fetchAndAdd(1);
+        counts.logicalBytesIn.fetchAndAddRelaxed(bytes);
+        counts.requests.fetchAndAddRelaxed(1);
     }
 }
 
 void NetworkCounter::hitLogicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
+    auto& counts = _counts.local();
 
     // don't care about the race as its just a counter
-    const bool overflow = _logicalBytesOut.loadRelaxed() > MAX;
+    const bool overflow = counts.logicalBytesOut.loadRelaxed() > maxNetworkCount();
 
     if (overflow) {
-        _logicalBytesOut.store(bytes);
+        counts.logicalBytesOut.store(bytes);
     } else {
-        _logicalBytesOut.fetchAndAdd(bytes);
+        counts.logicalBytesOut.fetchAndAddRelaxed(bytes);
     }
 }
 
+long long NetworkCounter::_sum(AtomicWord<long long> Counts::*counter) const {
+    long long sum = 0;
+    _counts.forEach([&](const Counts& counts) { sum += (counts.*counter).loadRelaxed(); });
+    return sum;
+}
+
 void NetworkCounter::append(BSONObjBuilder& b) {
-    b.append("bytesIn", static_cast<long long>(_together.logicalBytesIn.loadRelaxed()));
-    b.append("bytesOut", static_cast<long long>(_logicalBytesOut.loadRelaxed()));
-    b.append("physicalBytesIn", static_cast<long long>(_physicalBytesIn.loadRelaxed()));
-    b.append("physicalBytesOut", static_cast<long long>(_physicalBytesOut.loadRelaxed()));
-    b.append("numRequests", static_cast<long long>(_together.requests.loadRelaxed()));
+    b.append("bytesIn", _sum(&Counts::logicalBytesIn));
+    b.append("bytesOut", _sum(&Counts::logicalBytesOut));
+    b.append("physicalBytesIn", _sum(&Counts::physicalBytesIn));
+    b.append("physicalBytesOut", _sum(&Counts::physicalBytesOut));
+    b.append("numRequests", _sum(&Counts::requests));
 }
 
 
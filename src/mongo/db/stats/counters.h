@@ -33,6 +33,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
 #include "mongo/rpc/message.h"
+#include "mongo/util/concurrency/per_cpu.h"
 #include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/with_alignment.h"
@@ -41,32 +42,34 @@ namespace mongo {
 
 /**
  * for storing operation counters
- * note: not thread safe.  ok with that for speed
+ *
+ * Each CPU has its own set of counters, which are summed when they are read, so that operations
+ * running on different cores do not contend on the same cache lines.
  */
 class OpCounters {
 public:
     OpCounters() = default;
 
     void gotInserts(int n) {
-        _checkWrap(&OpCounters::_insert, n);
+        _checkWrap(&Counts::insert, n);
     }
     void gotInsert() {
-        _checkWrap(&OpCounters::_insert, 1);
+        _checkWrap(&Counts::insert, 1);
     }
     void gotQuery() {
-        _checkWrap(&OpCounters::_query, 1);
+        _checkWrap(&Counts::query, 1);
     }
     void gotUpdate() {
-        _checkWrap(&OpCounters::_update, 1);
+        _checkWrap(&Counts::update, 1);
     }
     void gotDelete() {
-        _checkWrap(&OpCounters::_delete, 1);
+        _checkWrap(&Counts::remove, 1);
     }
     void gotGetMore() {
-        _checkWrap(&OpCounters::_getmore, 1);
+        _checkWrap(&Counts::getmore, 1);
     }
     void gotCommand() {
-        _checkWrap(&OpCounters::_command, 1);
+        _checkWrap(&Counts::command, 1);
     }
 
     void gotOp(int op, bool isCommand);
@@ -74,35 +77,45 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicWord<long long>* getInsert() const {
-        return &_insert;
+    long long getInsert() const {
+        return _sum(&Counts::insert);
     }
-    const AtomicWord<long long>* getQuery() const {
-        return &_query;
+    long long getQuery() const {
+        return _sum(&Counts::query);
     }
-    const AtomicWord<long long>* getUpdate() const {
-        return &_update;
+    long long getUpdate() const {
+        return _sum(&Counts::update);
     }
-    const AtomicWord<long long>* getDelete() const {
-        return &_delete;
+    long long getDelete() const {
+        return _sum(&Counts::remove);
     }
-    const AtomicWord<long long>* getGetMore() const {
-        return &_getmore;
+    long long getGetMore() const {
+        return _sum(&Counts::getmore);
     }
-    const AtomicWord<long long>* getCommand() const {
-        return &_command;
+    long long getCommand() const {
+        return _sum(&Counts::command);
     }
 
 private:
-    // Increment member `counter` by `n`, resetting all counters if it was > 2^60.
-    void _checkWrap(CacheAligned<AtomicWord<long long>> OpCounters::*counter, int n);
-
-    CacheAligned<AtomicWord<long long>> _insert;
-    CacheAligned<AtomicWord<long long>> _query;
-    CacheAligned<AtomicWord<long long>> _update;
-    CacheAligned<AtomicWord<long long>> _delete;
-    CacheAligned<AtomicWord<long long>> _getmore;
-    CacheAligned<AtomicWord<long long>> _command;
+    // The counters of one CPU, which share a cache line since they are updated by the same core.
+    struct Counts {
+        AtomicWord<long long> insert;
+        AtomicWord<long long> query;
+        AtomicWord<long long> update;
+        AtomicWord<long long> remove;
+        AtomicWord<long long> getmore;
+        AtomicWord<long long> command;
+    };
+    static_assert(sizeof(Counts) <= stdx::hardware_constructive_interference_size,
+                  "cache line spill");
+
+    // Increment member `counter` of this CPU's counters by `n`, resetting all counters if the
+    // total might have passed 2^60.
+    void _checkWrap(AtomicWord<long long> Counts::*counter, int n);
+
+    long long _sum(AtomicWord<long long> Counts::*counter) const;
+
+    PerCpu<Counts> _counts;
 };
 
 extern OpCounters globalOpCounters;
@@ -122,20 +135,20 @@ public:
     void append(BSONObjBuilder& b);
 
 private:
-    CacheAligned<AtomicWord<long long>> _physicalBytesIn{0};
-    CacheAligned<AtomicWord<long long>> _physicalBytesOut{0};
-
-    // These two counters are always incremented at the same time, so
-    // we place them on the same cache line.
-    struct Together {
+    // The counters of one CPU. Each core only updates its own, so they can share a cache line.
+    struct Counts {
+        AtomicWord<long long> physicalBytesIn{0};
+        AtomicWord<long long> physicalBytesOut{0};
         AtomicWord<long long> logicalBytesIn{0};
         AtomicWord<long long> requests{0};
+        AtomicWord<long long> logicalBytesOut{0};
     };
-    CacheAligned<Together> _together{};
-    static_assert(sizeof(decltype(_together)) <= stdx::hardware_constructive_interference_size,
+    static_assert(sizeof(Counts) <= stdx::hardware_constructive_interference_size,
                   "cache line spill");
 
-    CacheAligned<AtomicWord<long long>> _logicalBytesOut{0};
+    long long _sum(AtomicWord<long long> Counts::*counter) const;
+
+    PerCpu<Counts> _counts;
 };
 
 extern NetworkCounter networkCounter;
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/per_cpu.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxThreads = 64;
+
+/**
+ * The baseline: every thread increments the same atomic, as OpCounters used to.
+ */
+void BM_SharedAtomicIncrement(benchmark::State& state) {
+    static CacheAligned<AtomicWord<long long>> counter;
+
+    for (auto keepRunning : state) {
+        counter.fetchAndAddRelaxed(1);
+    }
+}
+
+void BM_PerCpuIncrement(benchmark::State& state) {
+    static PerCpu<AtomicWord<long long>> counter;
+
+    for (auto keepRunning : state) {
+        counter.local().fetchAndAddRelaxed(1);
+    }
+}
+
+void BM_OpCountersGotQuery(benchmark::State& state) {
+    static OpCounters opCounters;
+
+    for (auto keepRunning : state) {
+        opCounters.gotQuery();
+    }
+}
+
+void BM_NetworkCounterHitLogicalIn(benchmark::State& state) {
+    static NetworkCounter counter;
+
+    for (auto keepRunning : state) {
+        counter.hitLogicalIn(100);
+    }
+}
+
+void BM_TopGlobalLatencyStats(benchmark::State& state) {
+    static Top top;
+
+    for (auto keepRunning : state) {
+        top.incrementGlobalTransactionLatencyStats(100);
+    }
+}
+
+BENCHMARK(BM_SharedAtomicIncrement)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_PerCpuIncrement)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_OpCountersGotQuery)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_NetworkCounterHitLogicalIn)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_TopGlobalLatencyStats)->ThreadRange(1, kMaxThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -92,4 +92,27 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, AddSumsHistograms) {
+    OperationLatencyHistogram first;
+    OperationLatencyHistogram second;
+    OperationLatencyHistogram both;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        first.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        both.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        if (i % 2 == 0) {
+            second.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+            second.increment(kLowerBounds[i], Command::ReadWriteType::kTransaction);
+            both.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+            both.increment(kLowerBounds[i], Command::ReadWriteType::kTransaction);
+        }
+    }
+    first.add(second);
+
+    BSONObjBuilder firstBuilder;
+    first.append(true, &firstBuilder);
+    BSONObjBuilder bothBuilder;
+    both.append(true, &bothBuilder);
+    ASSERT_BSONOBJ_EQ(bothBuilder.obj(), firstBuilder.obj());
+}
 }  // namespace mongo
@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include <boost/functional/hash.hpp>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_gen.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStats = ServiceContext::declareDecoration<QueryStats>();
+
+}  // namespace
+
+int QueryStats::LatencyHistogram::getBucket(uint64_t micros) {
+    if (micros < kSubBuckets) {
+        return micros;
+    }
+
+    // The buckets below kSubBuckets each hold one value. Above that, the highest set bit selects a
+    // power of two and the kSubBucketBits bits below it select one of its linear sub-buckets.
+    const int log2 = 63 - countLeadingZeros64(micros);
+    const int subBucket = (micros >> (log2 - kSubBucketBits)) & (kSubBuckets - 1);
+    return std::min((log2 - kSubBucketBits + 1) * kSubBuckets + subBucket, kNumBuckets - 1);
+}
+
+uint64_t QueryStats::LatencyHistogram::getBucketLowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    return static_cast<uint64_t>(kSubBuckets + bucket % kSubBuckets)
+        << (bucket / kSubBuckets - 1);
+}
+
+void QueryStats::LatencyHistogram::append(StringData fieldName, BSONObjBuilder* builder) const {
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart(fieldName));
+    for (int i = 0; i < kNumBuckets; i++) {
+        if (_buckets[i] == 0) {
+            continue;
+        }
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(i)));
+        entryBuilder.append("count", static_cast<long long>(_buckets[i]));
+    }
+}
+
+void QueryStats::Aggregate::append(StringData fieldName, BSONObjBuilder* builder) const {
+    BSONObjBuilder aggregateBuilder(builder->subobjStart(fieldName));
+    aggregateBuilder.append("sum", sum);
+    aggregateBuilder.append("max", max);
+}
+
+BSONObj QueryStats::Entry::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("ns", nss.ns());
+    builder.append("queryHash", unsignedIntToFixedLengthHex(queryHash));
+    builder.append("queryShape", queryShape);
+    builder.append("firstSeen", firstSeen);
+    builder.append("lastSeen", lastSeen);
+    builder.append("execCount", execCount);
+    builder.append("getMoreCount", getMoreCount);
+    builder.append("totalExecMicros", totalExecMicros);
+    latency.append("latencyMicros", &builder);
+    docsExamined.append("docsExamined", &builder);
+    keysExamined.append("keysExamined", &builder);
+    nreturned.append("nreturned", &builder);
+    bytesReturned.append("bytesReturned", &builder);
+    return builder.obj();
+}
+
+size_t QueryStats::KeyHasher::operator()(const Key& key) const {
+    size_t seed = std::hash<std::string>()(key.first);
+    boost::hash_combine(seed, key.second);
+    return seed;
+}
+
+QueryStats& QueryStats::get(ServiceContext* service) {
+    return getQueryStats(service);
+}
+
+size_t QueryStats::_partitionFor(const NamespaceString& nss, uint32_t queryHash) {
+    // The queryHash is already well mixed, but shapes shared by several collections should not all
+    // land in the same partition.
+    size_t seed = queryHash;
+    boost::hash_combine(seed, nss.ns());
+    return seed % kNumPartitions;
+}
+
+void QueryStats::_evict(Partition* partition, size_t maxBytes) {
+    while (partition->size > maxBytes && !partition->entries.empty()) {
+        const Entry& victim = partition->entries.back();
+        partition->size -= victim.approximateSize();
+        partition->index.erase({victim.nss.ns(), victim.queryHash});
+        partition->entries.pop_back();
+    }
+}
+
+void QueryStats::record(const NamespaceString& nss,
+                        uint32_t queryHash,
+                        StringData queryShape,
+                        const OperationMetrics& metrics,
+                        Date_t now) {
+    const long long maxBytes = internalQueryStatsMaxMemoryBytes.load();
+    if (maxBytes <= 0) {
+        return;
+    }
+    const size_t maxPartitionBytes = maxBytes / kNumPartitions;
+
+    Partition& partition = _partitions[_partitionFor(nss, queryHash)];
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+    auto it = partition.index.find({nss.ns(), queryHash});
+    if (it == partition.index.end()) {
+        partition.entries.emplace_front(nss, queryHash, queryShape.toString(), now);
+        partition.size += partition.entries.front().approximateSize();
+        it = partition.index.emplace(Key{nss.ns(), queryHash}, partition.entries.begin()).first;
+    } else if (it->second != partition.entries.begin()) {
+        partition.entries.splice(partition.entries.begin(), partition.entries, it->second);
+    }
+
+    Entry& entry = partition.entries.front();
+    entry.lastSeen = now;
+    if (metrics.isGetMore) {
+        ++entry.getMoreCount;
+    } else {
+        ++entry.execCount;
+    }
+    entry.totalExecMicros += metrics.executionMicros;
+    entry.latency.increment(std::max(metrics.executionMicros, 0LL));
+    entry.docsExamined.add(metrics.docsExamined);
+    entry.keysExamined.add(metrics.keysExamined);
+    entry.nreturned.add(metrics.nreturned);
+    entry.bytesReturned.add(metrics.bytesReturned);
+
+    // A limit lowered at runtime is applied to a partition the next time it records anything. The
+    // entry just recorded is only evicted if it alone is larger than the partition's share.
+    _evict(&partition, maxPartitionBytes);
+}
+
+void QueryStats::appendStats(const boost::optional<NamespaceString>& nss,
+                             std::vector<BSONObj>* out) const {
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (auto&& entry : partition.entries) {
+            if (!nss || entry.nss == *nss) {
+                out->push_back(entry.toBSON());
+            }
+        }
+    }
+}
+
+void QueryStats::clear() {
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.entries.clear();
+        partition.index.clear();
+        partition.size = 0;
+    }
+}
+
+size_t QueryStats::approximateSize() const {
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        size += partition.size;
+    }
+    return size;
+}
+
+}  // namespace mongo
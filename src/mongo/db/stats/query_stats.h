@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Always-on statistics about the latency and resource use of each query shape, keyed by the
+ * namespace and the queryHash of the shape. Entries are spread across independently locked
+ * partitions so that concurrent operations on different shapes rarely contend, and the least
+ * recently used entries are evicted once the memory used by a partition passes its share of
+ * 'internalQueryStatsMaxMemoryBytes'.
+ */
+class QueryStats {
+public:
+    static const size_t kNumPartitions = 16;
+
+    /**
+     * A latency histogram whose buckets have a bounded relative error: each power of two is
+     * divided into four linearly spaced buckets, so a value is never more than 25% above the lower
+     * bound of its bucket.
+     */
+    class LatencyHistogram {
+    public:
+        static const int kSubBucketBits = 2;
+        static const int kSubBuckets = 1 << kSubBucketBits;
+        static const int kNumBuckets = 160;
+
+        static int getBucket(uint64_t micros);
+
+        // Inclusive lower bound, in microseconds, of the given bucket.
+        static uint64_t getBucketLowerBound(int bucket);
+
+        void increment(uint64_t micros) {
+            ++_buckets[getBucket(micros)];
+        }
+
+        uint64_t count(int bucket) const {
+            return _buckets[bucket];
+        }
+
+        /**
+         * Appends the non-empty buckets as an array of {micros: <lower bound>, count: <count>}.
+         */
+        void append(StringData fieldName, BSONObjBuilder* builder) const;
+
+    private:
+        std::array<uint64_t, kNumBuckets> _buckets{};
+    };
+
+    /**
+     * The sum and the maximum of a metric over every execution of a shape.
+     */
+    struct Aggregate {
+        void add(long long value) {
+            sum += value;
+            max = std::max(max, value);
+        }
+
+        void append(StringData fieldName, BSONObjBuilder* builder) const;
+
+        long long sum = 0;
+        long long max = 0;
+    };
+
+    /**
+     * What a single find, aggregate or getMore operation cost.
+     */
+    struct OperationMetrics {
+        bool isGetMore = false;
+        long long executionMicros = 0;
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    static QueryStats& get(ServiceContext* service);
+
+    /**
+     * Adds the cost of one operation to the entry of its shape, creating the entry if needed. Does
+     * nothing if the memory limit is zero.
+     */
+    void record(const NamespaceString& nss,
+                uint32_t queryHash,
+                StringData queryShape,
+                const OperationMetrics& metrics,
+                Date_t now);
+
+    /**
+     * Appends a document for each entry, or only those on 'nss' when it is given.
+     */
+    void appendStats(const boost::optional<NamespaceString>& nss,
+                     std::vector<BSONObj>* out) const;
+
+    /**
+     * Removes every entry.
+     */
+    void clear();
+
+    /**
+     * The number of bytes used by the entries of all partitions.
+     */
+    size_t approximateSize() const;
+
+private:
+    struct Entry {
+        Entry(NamespaceString nss, uint32_t queryHash, std::string queryShape, Date_t firstSeen)
+            : nss(std::move(nss)),
+              queryHash(queryHash),
+              queryShape(std::move(queryShape)),
+              firstSeen(firstSeen),
+              lastSeen(firstSeen) {}
+
+        size_t approximateSize() const {
+            return sizeof(Entry) + nss.size() + queryShape.size();
+        }
+
+        BSONObj toBSON() const;
+
+        NamespaceString nss;
+        uint32_t queryHash;
+        std::string queryShape;
+        Date_t firstSeen;
+        Date_t lastSeen;
+
+        long long execCount = 0;
+        long long getMoreCount = 0;
+        long long totalExecMicros = 0;
+        LatencyHistogram latency;
+        Aggregate docsExamined;
+        Aggregate keysExamined;
+        Aggregate nreturned;
+        Aggregate bytesReturned;
+    };
+
+    using EntryList = std::list<Entry>;
+    using Key = std::pair<std::string, uint32_t>;
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        // Ordered from the most to the least recently used.
+        EntryList entries;
+        stdx::unordered_map<Key, EntryList::iterator, KeyHasher> index;
+        size_t size = 0;
+    };
+
+    static size_t _partitionFor(const NamespaceString& nss, uint32_t queryHash);
+
+    // Evicts the least recently used entries of 'partition' until it is within 'maxBytes'.
+    static void _evict(Partition* partition, size_t maxBytes);
+
+    std::array<Partition, kNumPartitions> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include "mongo/db/stats/query_stats_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+const NamespaceString kOtherNss("test.other");
+
+QueryStats::OperationMetrics makeMetrics(long long micros, long long docsExamined) {
+    QueryStats::OperationMetrics metrics;
+    metrics.executionMicros = micros;
+    metrics.docsExamined = docsExamined;
+    metrics.keysExamined = docsExamined * 2;
+    metrics.nreturned = 1;
+    metrics.bytesReturned = 100;
+    return metrics;
+}
+
+TEST(QueryStatsLatencyHistogramTest, BucketsBoundTheirValues) {
+    using Histogram = QueryStats::LatencyHistogram;
+    for (uint64_t micros : {0ULL, 1ULL, 3ULL, 4ULL, 5ULL, 7ULL, 8ULL, 9ULL, 15ULL, 1000ULL,
+                            123456ULL, 1ULL << 35}) {
+        const int bucket = Histogram::getBucket(micros);
+        ASSERT_LTE(Histogram::getBucketLowerBound(bucket), micros);
+        ASSERT_GT(Histogram::getBucketLowerBound(bucket + 1), micros);
+        // A value is at most 25% above the lower bound of its bucket.
+        ASSERT_LTE(micros, Histogram::getBucketLowerBound(bucket) * 5 / 4 + 1);
+    }
+
+    for (int bucket = 1; bucket < Histogram::kNumBuckets; bucket++) {
+        ASSERT_EQ(bucket, Histogram::getBucket(Histogram::getBucketLowerBound(bucket)));
+    }
+
+    ASSERT_EQ(Histogram::kNumBuckets - 1, Histogram::getBucket(~0ULL));
+}
+
+TEST(QueryStatsTest, AggregatesExecutionsOfTheSameShape) {
+    QueryStats stats;
+    const Date_t first = Date_t::fromMillisSinceEpoch(1000);
+    const Date_t last = Date_t::fromMillisSinceEpoch(2000);
+    stats.record(kNss, 0x1234, "shape", makeMetrics(10, 5), first);
+    stats.record(kNss, 0x1234, "shape", makeMetrics(1000, 50), last);
+
+    auto getMore = makeMetrics(20, 7);
+    getMore.isGetMore = true;
+    stats.record(kNss, 0x1234, "shape", getMore, last);
+
+    std::vector<BSONObj> out;
+    stats.appendStats(boost::none, &out);
+    ASSERT_EQ(1U, out.size());
+
+    const BSONObj& entry = out[0];
+    ASSERT_EQ("test.coll", entry["ns"].str());
+    ASSERT_EQ("00001234", entry["queryHash"].str());
+    ASSERT_EQ("shape", entry["queryShape"].str());
+    ASSERT_EQ(first, entry["firstSeen"].Date());
+    ASSERT_EQ(last, entry["lastSeen"].Date());
+    ASSERT_EQ(2, entry["execCount"].numberLong());
+    ASSERT_EQ(1, entry["getMoreCount"].numberLong());
+    ASSERT_EQ(1030, entry["totalExecMicros"].numberLong());
+    ASSERT_EQ(3U, entry["latencyMicros"].Array().size());
+    ASSERT_BSONOBJ_EQ(BSON("sum" << 62LL << "max" << 50LL), entry["docsExamined"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("sum" << 124LL << "max" << 100LL), entry["keysExamined"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("sum" << 300LL << "max" << 100LL), entry["bytesReturned"].Obj());
+}
+
+TEST(QueryStatsTest, SeparatesShapesAndNamespaces) {
+    QueryStats stats;
+    stats.record(kNss, 1, "a", makeMetrics(1, 1), Date_t());
+    stats.record(kNss, 2, "b", makeMetrics(1, 1), Date_t());
+    stats.record(kOtherNss, 1, "a", makeMetrics(1, 1), Date_t());
+
+    std::vector<BSONObj> all;
+    stats.appendStats(boost::none, &all);
+    ASSERT_EQ(3U, all.size());
+
+    std::vector<BSONObj> forNss;
+    stats.appendStats(kNss, &forNss);
+    ASSERT_EQ(2U, forNss.size());
+    for (auto&& entry : forNss) {
+        ASSERT_EQ(kNss.ns(), entry["ns"].str());
+    }
+
+    stats.clear();
+    std::vector<BSONObj> afterClear;
+    stats.appendStats(boost::none, &afterClear);
+    ASSERT(afterClear.empty());
+    ASSERT_EQ(0U, stats.approximateSize());
+}
+
+TEST(QueryStatsTest, EvictsLeastRecentlyUsedShapesOverTheMemoryLimit) {
+    const long long originalLimit = internalQueryStatsMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryStatsMaxMemoryBytes.store(originalLimit); });
+
+    QueryStats stats;
+    const std::string shape(1000, 's');
+    for (uint32_t hash = 0; hash < 200; hash++) {
+        stats.record(kNss, hash, shape, makeMetrics(1, 1), Date_t());
+    }
+    const size_t unboundedSize = stats.approximateSize();
+
+    // Lower the limit to roughly a quarter of what is used. Recording into each partition applies
+    // the new limit to it.
+    internalQueryStatsMaxMemoryBytes.store(unboundedSize / 4);
+    for (uint32_t hash = 0; hash < 200; hash++) {
+        stats.record(kNss, hash, shape, makeMetrics(1, 1), Date_t());
+    }
+    ASSERT_LTE(stats.approximateSize(), unboundedSize / 4);
+
+    std::vector<BSONObj> out;
+    stats.appendStats(boost::none, &out);
+    ASSERT_LT(out.size(), 200U);
+    ASSERT_GT(out.size(), 0U);
+
+    // The shape recorded last is the most recently used in its partition, so it is kept.
+    bool sawLastShape = false;
+    for (auto&& entry : out) {
+        sawLastShape |= entry["queryHash"].str() == unsignedIntToFixedLengthHex(199);
+    }
+    ASSERT(sawLastShape);
+}
+
+TEST(QueryStatsTest, RecordsNothingWithZeroMemoryLimit) {
+    const long long originalLimit = internalQueryStatsMaxMemoryBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryStatsMaxMemoryBytes.store(originalLimit); });
+    internalQueryStatsMaxMemoryBytes.store(0);
+
+    QueryStats stats;
+    stats.record(kNss, 1, "a", makeMetrics(1, 1), Date_t());
+    std::vector<BSONObj> out;
+    stats.appendStats(boost::none, &out);
+    ASSERT(out.empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Accumulates the time an operation spends blocked waiting for the responses of the remote
+ * commands it sends, for instance to the shards targeted by a mongos. Reported as part of the
+ * time breakdown of the operation in the slow query log, the profiler and $currentOp.
+ */
+class RemoteWaitTime {
+public:
+    static RemoteWaitTime& get(OperationContext* opCtx);
+
+    void add(Microseconds waited) {
+        _micros.fetchAndAdd(durationCount<Microseconds>(waited));
+    }
+
+    /**
+     * May be called from a thread other than the one running the operation.
+     */
+    Microseconds total() const {
+        return Microseconds{_micros.load()};
+    }
+
+    /**
+     * Adds the time between its construction and its destruction to the remote wait time of an
+     * operation.
+     */
+    class Scope {
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    public:
+        explicit Scope(OperationContext* opCtx) : _waitTime(get(opCtx)) {}
+
+        ~Scope() {
+            _waitTime.add(_timer.elapsed());
+        }
+
+    private:
+        RemoteWaitTime& _waitTime;
+        Timer _timer;
+    };
+
+private:
+    AtomicWord<long long> _micros{0};
+};
+
+}  // namespace mongo
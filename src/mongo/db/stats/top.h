@@ -33,12 +33,15 @@
  * DB usage monitor.
  */
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/per_cpu.h"
+#include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -151,10 +154,31 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::set<std::string> _collDropNs;
+    static const size_t kNumPartitions = 16;
+
+    /**
+     * The collections are divided among partitions by the hash of their namespace, each with its
+     * own lock, so that operations on different collections rarely contend.
+     */
+    struct Partition {
+        mutable SimpleMutex lock;
+        UsageMap usage;
+        std::set<std::string> collDropNs;
+    };
+
+    /**
+     * The global latency histogram is kept per CPU, each with its own lock, and the histograms of
+     * every CPU are summed when they are read.
+     */
+    struct GlobalHistogram {
+        SpinLock lock;
+        OperationLatencyHistogram histogram;
+    };
+
+    Partition& _getPartition(const StringMapHashedKey& hashedNs);
+
+    std::array<CacheAligned<Partition>, kNumPartitions> _partitions;
+    PerCpu<GlobalHistogram> _globalHistogramStats;
 };
 
 }  // namespace mongo
@@ -30,14 +30,88 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include <vector>
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
 
 using namespace mongo;
 
+using TopRecordTest = ServiceContextTest;
+
 TEST(TopTest, CollectionDropped) {
     Top().collectionDropped(NamespaceString("test.coll"));
 }
 
+TEST_F(TopRecordTest, RecordsEveryCollectionAcrossPartitions) {
+    auto opCtx = makeOperationContext();
+    Top top;
+    const int kCollections = 100;
+    for (int i = 0; i < kCollections; i++) {
+        const std::string ns = str::stream() << "test.coll" << i;
+        for (int j = 0; j <= i % 3; j++) {
+            top.record(opCtx.get(),
+                       ns,
+                       LogicalOp::opQuery,
+                       Top::LockType::ReadLocked,
+                       10,
+                       false,
+                       Command::ReadWriteType::kRead);
+        }
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(static_cast<size_t>(kCollections), usage.size());
+    for (int i = 0; i < kCollections; i++) {
+        const std::string ns = str::stream() << "test.coll" << i;
+        ASSERT_EQ(i % 3 + 1, usage[ns].queries.count);
+        ASSERT_EQ(10 * (i % 3 + 1), usage[ns].readLock.time);
+    }
+
+    // A dropped collection is removed, and the query which dropped it is not recorded.
+    top.collectionDropped(NamespaceString("test.coll0"));
+    top.record(opCtx.get(),
+               "test.coll0",
+               LogicalOp::opQuery,
+               Top::LockType::ReadLocked,
+               10,
+               true,
+               Command::ReadWriteType::kCommand);
+    top.cloneMap(usage);
+    ASSERT_EQ(static_cast<size_t>(kCollections - 1), usage.size());
+    ASSERT(usage.find("test.coll0") == usage.end());
+
+    BSONObjBuilder builder;
+    top.append(builder);
+    ASSERT_EQ(kCollections - 1, builder.obj().nFields());
+}
+
+TEST(TopTest, GlobalLatencyStatsSumEveryThread) {
+    Top top;
+    const int kThreads = 8;
+    const int kOpsPerThread = 1000;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kOpsPerThread; j++) {
+                top.incrementGlobalTransactionLatencyStats(5);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder builder;
+    top.appendGlobalLatencyStats(false, &builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_EQ(kThreads * kOpsPerThread, stats["transactions"]["ops"].numberLong());
+    ASSERT_EQ(5 * kThreads * kOpsPerThread, stats["transactions"]["latency"].numberLong());
+}
+
 }  // namespace
@@ -37,6 +37,7 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/repl/read_concern_level.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -102,6 +103,21 @@ public:
      * layer.
      */
     virtual std::shared_ptr<StorageStats> getCopy() = 0;
+
+    /**
+     * Time spent reading data from disk, if tracked by the storage engine.
+     */
+    virtual Microseconds timeReading() const {
+        return Microseconds(0);
+    }
+
+    /**
+     * Time spent waiting for room in the cache of the storage engine, for instance while eviction
+     * made space, if tracked by the storage engine.
+     */
+    virtual Microseconds timeWaitingForCache() const {
+        return Microseconds(0);
+    }
 };
 
 
@@ -78,6 +78,19 @@ std::shared_ptr<StorageStats> WiredTigerOperationStats::getCopy() {
     return copy;
 }
 
+Microseconds WiredTigerOperationStats::timeReading() const {
+    return Microseconds{_getStat(WT_STAT_SESSION_READ_TIME)};
+}
+
+Microseconds WiredTigerOperationStats::timeWaitingForCache() const {
+    return Microseconds{_getStat(WT_STAT_SESSION_CACHE_TIME)};
+}
+
+long long WiredTigerOperationStats::_getStat(int key) const {
+    auto it = _stats.find(key);
+    return it == _stats.end() ? 0 : it->second;
+}
+
 void WiredTigerOperationStats::fetchStats(WT_SESSION* session,
                                           const std::string& uri,
                                           const std::string& config) {
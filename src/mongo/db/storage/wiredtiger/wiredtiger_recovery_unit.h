@@ -73,7 +73,13 @@ public:
 
     std::shared_ptr<StorageStats> getCopy() final;
 
+    Microseconds timeReading() const final;
+
+    Microseconds timeWaitingForCache() const final;
+
 private:
+    long long _getStat(int key) const;
+
     /**
      * Each statistic in WiredTiger has an integer key, which this map associates with a section
      * (either DATA or WAIT) and user-readable name.
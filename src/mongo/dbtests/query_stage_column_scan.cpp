@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This file tests db/exec/column_scan.cpp.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/column_scan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/json.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/unittest/unittest.h"
+
+namespace query_stage_column_scan {
+
+static const NamespaceString nss{"unittests.QueryStageColumnScan"};
+
+class QueryStageColumnScanTest : public unittest::Test {
+public:
+    QueryStageColumnScanTest() : _client(&_opCtx) {}
+
+    virtual ~QueryStageColumnScanTest() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        _client.dropCollection(nss.ns());
+    }
+
+    void insert(const BSONObj& obj) {
+        _client.insert(nss.ns(), obj);
+    }
+
+    void createIndex(const BSONObj& keyPattern) {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), keyPattern));
+    }
+
+    std::unique_ptr<ColumnScan> makeColumnScan(Collection* coll,
+                                               const BSONObj& keyPattern,
+                                               std::vector<std::string> columns) {
+        std::vector<const IndexDescriptor*> indexes;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(&_opCtx, keyPattern, false, &indexes);
+        ASSERT_EQ(indexes.size(), 1U);
+        return std::make_unique<ColumnScan>(
+            &_opCtx, indexes[0], std::move(columns), &_ws, nullptr);
+    }
+
+    /**
+     * Works 'scan' until it advances, and returns the object it produced.
+     */
+    BSONObj getNext(ColumnScan* scan) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::ADVANCED != state) {
+            state = scan->work(&id);
+            ASSERT_NE(PlanStage::IS_EOF, state);
+            ASSERT_NE(PlanStage::FAILURE, state);
+        }
+        return _ws.get(id)->obj.value();
+    }
+
+    void assertEOF(ColumnScan* scan) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (PlanStage::NEED_TIME == state) {
+            state = scan->work(&id);
+        }
+        ASSERT_EQ(PlanStage::IS_EOF, state);
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _opCtxPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_opCtxPtr;
+    DBDirectClient _client;
+    WorkingSet _ws;
+};
+
+TEST_F(QueryStageColumnScanTest, RebuildsDottedColumnsAsSubdocuments) {
+    const BSONObj keyPattern = BSON("a" << IndexNames::COLUMN << "b.c" << IndexNames::COLUMN);
+    insert(fromjson("{_id: 1, a: 1, b: {c: 2, d: 3}}"));
+    insert(fromjson("{_id: 2, b: {d: 3}}"));
+    createIndex(keyPattern);
+
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto scan = makeColumnScan(ctx.getCollection(), keyPattern, {"a", "b.c"});
+
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1, a: 1, b: {c: 2}}"), getNext(scan.get()));
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), getNext(scan.get()));
+    assertEOF(scan.get());
+}
+
+TEST_F(QueryStageColumnScanTest, RereadsColumnsUpdatedWhileYielded) {
+    const BSONObj keyPattern = BSON("a" << IndexNames::COLUMN);
+    insert(fromjson("{_id: 1}"));
+    insert(fromjson("{_id: 2, a: 2}"));
+    createIndex(keyPattern);
+
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto scan = makeColumnScan(ctx.getCollection(), keyPattern, {"a"});
+
+    // Reading the first document moves the column for "a" on to the cell of the second.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), getNext(scan.get()));
+
+    scan->saveState();
+    _client.update(nss.ns(), BSON("_id" << 2), BSON("$set" << BSON("a" << 20)));
+    scan->restoreState();
+
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2, a: 20}"), getNext(scan.get()));
+    assertEOF(scan.get());
+}
+
+TEST_F(QueryStageColumnScanTest, ContinuesAfterReturnedDocumentDeletedWhileYielded) {
+    const BSONObj keyPattern = BSON("a" << IndexNames::COLUMN);
+    insert(fromjson("{_id: 1, a: 1}"));
+    insert(fromjson("{_id: 2, a: 2}"));
+    insert(fromjson("{_id: 3, a: 3}"));
+    createIndex(keyPattern);
+
+    dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+    auto scan = makeColumnScan(ctx.getCollection(), keyPattern, {"a"});
+
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1, a: 1}"), getNext(scan.get()));
+
+    scan->saveState();
+    _client.remove(nss.ns(), BSON("_id" << 1));
+    scan->restoreState();
+
+    // The next document is neither skipped nor returned twice.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2, a: 2}"), getNext(scan.get()));
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3, a: 3}"), getNext(scan.get()));
+    assertEOF(scan.get());
+}
+
+}  // namespace query_stage_column_scan
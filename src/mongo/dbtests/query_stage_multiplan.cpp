@@ -275,6 +275,34 @@ TEST_F(QueryStageMultiPlanTest, MPSCollectionScanVsHighlySelectiveIXScan) {
     ASSERT_EQUALS(results, N / 10);
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSEndsTrialEarlyWhenWinnerIsClear) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    // Without the early cut-off, the index scan runs until it has returned the maximum number of
+    // results for the trial period.
+    auto mps = runMultiPlanner(_opCtx.get(), nss, coll, 7);
+    const size_t fullTrialWorks = getBestPlanWorks(mps.get());
+    ASSERT_GTE(fullTrialWorks, static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load()));
+
+    // The index scan returns a result on nearly every work while the collection scan returns one
+    // every ten, so the cut-off ends the trial as soon as the index scan has enough results.
+    internalQueryPlanEvaluationEarlyCutoffZScore.store(3.0);
+    ON_BLOCK_EXIT([] { internalQueryPlanEvaluationEarlyCutoffZScore.store(0.0); });
+
+    mps = runMultiPlanner(_opCtx.get(), nss, coll, 7);
+    ASSERT_LT(getBestPlanWorks(mps.get()), fullTrialWorks);
+    ASSERT_GTE(mps->getChildren()[mps->bestPlanIdx()]->getStats()->common.advanced,
+               static_cast<size_t>(internalQueryPlanEvaluationEarlyCutoffMinResults.load()));
+}
+
 TEST_F(QueryStageMultiPlanTest, MPSDoesNotCreateActiveCacheEntryImmediately) {
     const int N = 100;
     for (int i = 0; i < N; ++i) {
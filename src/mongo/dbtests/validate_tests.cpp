@@ -875,7 +875,8 @@ public:
                          IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
                          &keys,
                          nullptr,
-                         nullptr);
+                         nullptr,
+                         id1);
             auto removeStatus =
                 iam->removeKeys(&_opCtx, {keys.begin(), keys.end()}, id1, options, &numDeleted);
             auto insertStatus = iam->insert(&_opCtx, badKey, id1, options, &insertResult);
@@ -1311,7 +1312,8 @@ public:
                          IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered,
                          &keys,
                          nullptr,
-                         nullptr);
+                         nullptr,
+                         rid);
             auto removeStatus =
                 iam->removeKeys(&_opCtx, {keys.begin(), keys.end()}, rid, options, &numDeleted);
 
@@ -0,0 +1,432 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#endif
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+// How long the writer sleeps when there is nothing to write. A thread wakes it when it queues a
+// message in an empty buffer, so this only bounds the delay of a wakeup that raced with the writer
+// going to sleep.
+const Milliseconds kWriterIdleWait{100};
+
+AtomicWord<unsigned long long> nextAppenderId{0};
+
+stdx::mutex registryMutex;
+std::vector<AsyncAppender*> registry;
+
+thread_local bool isWriterThread = false;
+
+// Set once a thread's buffers have been released on its exit, after which anything it logs is
+// written synchronously.
+thread_local bool threadRingsReleased = false;
+
+/**
+ * The fixed size part of a message in a ring, followed by its context name and message text.
+ */
+struct RecordHeader {
+    long long dateMillis;
+    int severity;
+    int component;
+    uint32_t contextNameSize;
+    uint32_t messageSize;
+    bool isTruncatable;
+};
+
+/**
+ * A message copied out of a ring by the writer.
+ */
+struct Record {
+    Date_t date;
+    LogSeverity severity = LogSeverity::Log();
+    LogComponent component = LogComponent::kDefault;
+    std::string contextName;
+    std::string message;
+    bool isTruncatable;
+};
+
+}  // namespace
+
+/**
+ * A ring buffer of records with a single producer, the thread it belongs to, and a single consumer,
+ * the writer. Each side only ever advances its own position, so neither takes a lock.
+ */
+class AsyncAppender::Ring {
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+public:
+    explicit Ring(size_t capacity) : _data(new char[capacity]), _capacity(capacity) {}
+
+    /**
+     * Copies 'event' into the ring, or returns false if there is not enough room for it.
+     * 'wasEmpty' is set to whether the ring held no records before.
+     */
+    bool tryPush(const Event& event, bool* wasEmpty) {
+        const StringData contextName = event.getContextName();
+        const StringData message = event.getMessage();
+        const size_t size = recordSize(event);
+
+        const auto head = _head.loadRelaxed();
+        const auto tail = _tail.load();
+        if (size > _capacity - (head - tail))
+            return false;
+
+        RecordHeader header;
+        header.dateMillis = event.getDate().toMillisSinceEpoch();
+        header.severity = event.getSeverity().toInt();
+        header.component = static_cast<LogComponent::Value>(event.getComponent());
+        header.contextNameSize = contextName.size();
+        header.messageSize = message.size();
+        header.isTruncatable = event.isTruncatable();
+
+        auto position = head;
+        _write(position, &header, sizeof(header));
+        position += sizeof(header);
+        _write(position, contextName.rawData(), contextName.size());
+        position += contextName.size();
+        _write(position, message.rawData(), message.size());
+
+        _head.store(head + size);
+        *wasEmpty = head == tail;
+        return true;
+    }
+
+    /**
+     * Returns the number of bytes 'event' takes up in a ring.
+     */
+    static size_t recordSize(const Event& event) {
+        return sizeof(RecordHeader) + event.getContextName().size() + event.getMessage().size();
+    }
+
+    /**
+     * Moves every record in the ring to the end of 'records'.
+     */
+    void popAll(std::vector<Record>* records) {
+        const auto head = _head.load();
+        auto tail = _tail.loadRelaxed();
+        while (tail != head) {
+            RecordHeader header;
+            _read(tail, &header, sizeof(header));
+            tail += sizeof(header);
+
+            Record record;
+            record.date = Date_t::fromMillisSinceEpoch(header.dateMillis);
+            record.severity = LogSeverity::cast(header.severity);
+            record.component = static_cast<LogComponent::Value>(header.component);
+            record.isTruncatable = header.isTruncatable;
+            record.contextName.resize(header.contextNameSize);
+            _read(tail, &record.contextName[0], header.contextNameSize);
+            tail += header.contextNameSize;
+            record.message.resize(header.messageSize);
+            _read(tail, &record.message[0], header.messageSize);
+            tail += header.messageSize;
+
+            records->push_back(std::move(record));
+        }
+        _tail.store(tail);
+    }
+
+    bool empty() const {
+        return _head.load() == _tail.load();
+    }
+
+    /**
+     * Marks the ring as no longer written to, as its thread has exited.
+     */
+    void abandon() {
+        _abandoned.store(true);
+    }
+
+    bool abandoned() const {
+        return _abandoned.load();
+    }
+
+private:
+    void _write(unsigned long long position, const void* source, size_t bytes) {
+        const size_t offset = position % _capacity;
+        const size_t first = std::min(bytes, _capacity - offset);
+        memcpy(_data.get() + offset, source, first);
+        memcpy(_data.get(), static_cast<const char*>(source) + first, bytes - first);
+    }
+
+    void _read(unsigned long long position, void* dest, size_t bytes) const {
+        const size_t offset = position % _capacity;
+        const size_t first = std::min(bytes, _capacity - offset);
+        memcpy(dest, _data.get() + offset, first);
+        memcpy(static_cast<char*>(dest) + first, _data.get(), bytes - first);
+    }
+
+    const std::unique_ptr<char[]> _data;
+    const size_t _capacity;
+
+    // Total number of bytes ever pushed, written only by the producer, and popped, written only by
+    // the consumer.
+    AtomicWord<unsigned long long> _head{0};
+    AtomicWord<unsigned long long> _tail{0};
+
+    AtomicWord<bool> _abandoned{false};
+};
+
+AsyncAppender::AsyncAppender(std::unique_ptr<Appender<Event>> appender,
+                             size_t bufferSizeBytes,
+                             size_t totalBufferSizeBytes)
+    : _appender(std::move(appender)),
+      _bufferSizeBytes(std::max(bufferSizeBytes, kMinBufferSizeBytes)),
+      _totalBufferSizeBytes(totalBufferSizeBytes),
+      _id(nextAppenderId.fetchAndAdd(1)) {
+#ifndef _WIN32
+    // The writer may be started before the signal processing thread masks the asynchronous signals
+    // in the process. Those must only ever be delivered to that thread, so that they lead to a
+    // clean shutdown or a log rotation rather than the default action, and the writer inherits a
+    // mask which blocks them.
+    sigset_t asyncSignals;
+    sigemptyset(&asyncSignals);
+    sigaddset(&asyncSignals, SIGHUP);
+    sigaddset(&asyncSignals, SIGINT);
+    sigaddset(&asyncSignals, SIGTERM);
+    sigaddset(&asyncSignals, SIGUSR1);
+    sigaddset(&asyncSignals, SIGXCPU);
+    sigset_t previousMask;
+    invariant(pthread_sigmask(SIG_BLOCK, &asyncSignals, &previousMask) == 0);
+    _writer = stdx::thread([this] { _writerThread(); });
+    invariant(pthread_sigmask(SIG_SETMASK, &previousMask, nullptr) == 0);
+#else
+    _writer = stdx::thread([this] { _writerThread(); });
+#endif
+
+    stdx::lock_guard<stdx::mutex> lk(registryMutex);
+    registry.push_back(this);
+}
+
+AsyncAppender::~AsyncAppender() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(registryMutex);
+        registry.erase(std::find(registry.begin(), registry.end(), this));
+    }
+    shutdown();
+}
+
+Status AsyncAppender::append(const Event& event) {
+    // Checked before anything else, since these may be logged from a fatal signal handler, which
+    // must neither allocate, take a lock nor wait for the writer.
+    if (event.getSeverity() >= LogSeverity::Error() || !event.isTruncatable()) {
+        return _appender->append(event);
+    }
+
+    if (_async.load() && !isWriterThread && !threadRingsReleased) {
+        Ring* ring = _ringForThisThread();
+        if (!ring) {
+            // This thread has nothing queued to write first.
+            return _appender->append(event);
+        }
+
+        if (Ring::recordSize(event) <= _bufferSizeBytes) {
+            bool wasEmpty;
+            if (!ring->tryPush(event, &wasEmpty)) {
+                _dropped.fetchAndAdd(1);
+            } else if (wasEmpty) {
+                _wakeWriter.notify_one();
+            }
+            return Status::OK();
+        }
+        flush();
+    }
+    return _appender->append(event);
+}
+
+void AsyncAppender::flush(Milliseconds timeout) {
+    if (!_async.load() || isWriterThread)
+        return;
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const auto flush = ++_flushesRequested;
+    _wakeWriter.notify_one();
+    _flushed.wait_for(lk, timeout.toSystemDuration(), [&] {
+        return _flushesCompleted >= flush || _stopRequested;
+    });
+}
+
+void AsyncAppender::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_stopRequested)
+            return;
+        _stopRequested = true;
+    }
+    _wakeWriter.notify_one();
+    _writer.join();
+
+    // Write what was queued while the writer stopped. A message queued by a thread that has not yet
+    // seen the switch to synchronous writes can still be lost.
+    _async.store(false);
+    _drain();
+    _reportDropped();
+}
+
+void AsyncAppender::flushAll() {
+    stdx::lock_guard<stdx::mutex> lk(registryMutex);
+    for (auto appender : registry) {
+        appender->flush();
+    }
+}
+
+void AsyncAppender::shutdownAll() {
+    stdx::lock_guard<stdx::mutex> lk(registryMutex);
+    for (auto appender : registry) {
+        appender->shutdown();
+    }
+}
+
+AsyncAppender::Ring* AsyncAppender::_ringForThisThread() {
+    // A thread may log to more than one AsyncAppender, for example one per log domain.
+    struct ThreadRings {
+        ~ThreadRings() {
+            for (auto&& entry : rings) {
+                if (entry.second)
+                    entry.second->abandon();
+            }
+            threadRingsReleased = true;
+        }
+
+        std::vector<std::pair<unsigned long long, std::shared_ptr<Ring>>> rings;
+    };
+    thread_local ThreadRings threadRings;
+
+    for (auto&& entry : threadRings.rings) {
+        if (entry.first == _id)
+            return entry.second.get();
+    }
+
+    // A thread which finds no room keeps writing synchronously for as long as it lives, rather
+    // than taking the mutex on every message to look again.
+    std::shared_ptr<Ring> ring;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_ringBytes + _bufferSizeBytes <= _totalBufferSizeBytes) {
+            ring = std::make_shared<Ring>(_bufferSizeBytes);
+            _rings.push_back(ring);
+            _ringBytes += _bufferSizeBytes;
+        }
+    }
+    threadRings.rings.emplace_back(_id, ring);
+    return ring.get();
+}
+
+size_t AsyncAppender::_drain() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        // The ring of a thread that has exited is released once it has been emptied. It is checked
+        // for being abandoned first, as its thread may push to it until then.
+        const auto finished = [](const auto& ring) { return ring->abandoned() && ring->empty(); };
+        const auto end = std::remove_if(_rings.begin(), _rings.end(), finished);
+        _ringBytes -= (_rings.end() - end) * _bufferSizeBytes;
+        _rings.erase(end, _rings.end());
+        rings = _rings;
+    }
+
+    std::vector<Record> records;
+    for (auto&& ring : rings) {
+        ring->popAll(&records);
+    }
+
+    // The records of each thread are in order already. Interleave them by time.
+    std::stable_sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) {
+        return lhs.date < rhs.date;
+    });
+
+    for (auto&& record : records) {
+        Event event(
+            record.date, record.severity, record.component, record.contextName, record.message);
+        event.setIsTruncatable(record.isTruncatable);
+        _appender->append(event).transitional_ignore();
+    }
+    return records.size();
+}
+
+void AsyncAppender::_writerThread() {
+    setThreadName("AsyncLogWriter");
+    isWriterThread = true;
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        const auto flushes = _flushesRequested;
+        const bool stop = _stopRequested;
+        lk.unlock();
+
+        const auto written = _drain();
+        _reportDropped();
+
+        lk.lock();
+        _flushesCompleted = flushes;
+        _flushed.notify_all();
+        if (stop)
+            return;
+
+        if (!written && _flushesRequested == flushes && !_stopRequested) {
+            _wakeWriter.wait_for(lk, kWriterIdleWait.toSystemDuration());
+        }
+    }
+}
+
+void AsyncAppender::_reportDropped() {
+    const auto dropped = _dropped.load();
+    if (dropped == _droppedReported)
+        return;
+
+    const std::string message = str::stream()
+        << "Dropped " << dropped - _droppedReported
+        << " log messages because the log buffer of the thread logging them was full";
+    Event event(
+        Date_t::now(), LogSeverity::Warning(), LogComponent::kControl, getThreadName(), message);
+    _appender->append(event).transitional_ignore();
+    _droppedReported = dropped;
+}
+
+}  // namespace logger
+}  // namespace mongo
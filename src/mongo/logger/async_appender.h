@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender that takes the formatting and writing of log messages off the threads that log them.
+ *
+ * Each thread copies its messages, as compact binary records, into a ring buffer of its own which
+ * only it writes to. A background thread drains the buffers, puts the messages back in time order
+ * and hands them to the wrapped appender, which encodes and writes them. Logging a message thus
+ * never waits on the log file, its mutex or the encoder, and threads never contend with each other.
+ *
+ * When a thread's buffer is full its messages are dropped rather than making it wait. The writer
+ * reports how many were dropped in the log. A message too large for a buffer is written
+ * synchronously instead. The buffers of all threads together are limited in size; a thread which
+ * starts logging once the limit is reached writes its messages synchronously.
+ *
+ * Messages of severity Error and above, and messages which must not be truncated such as stack
+ * traces, are written synchronously and at once, since the process may be about to terminate and
+ * they may be logged from a fatal signal handler. They do not wait for the messages queued before
+ * them, which may therefore be written after them; the date of each message gives their order.
+ * Everything logged once the appender has been shut down is also written synchronously. The
+ * wrapped appender must therefore be safe to call from several threads at once, as the file,
+ * console and syslog appenders are.
+ */
+class AsyncAppender : public Appender<MessageEventEphemeral> {
+    AsyncAppender(const AsyncAppender&) = delete;
+    AsyncAppender& operator=(const AsyncAppender&) = delete;
+
+public:
+    using Event = MessageEventEphemeral;
+
+    /**
+     * Wraps 'appender', giving each thread that logs a buffer of 'bufferSizeBytes' bytes, up to
+     * 'totalBufferSizeBytes' for all threads, and starts the writer thread.
+     */
+    AsyncAppender(std::unique_ptr<Appender<Event>> appender,
+                  size_t bufferSizeBytes,
+                  size_t totalBufferSizeBytes);
+
+    ~AsyncAppender();
+
+    Status append(const Event& event) override;
+
+    /**
+     * Waits until every message queued before the call has been written, or 'timeout' has passed.
+     * Takes a lock, so must not be called from a signal handler.
+     */
+    void flush(Milliseconds timeout = Seconds(10));
+
+    /**
+     * Writes the messages still queued and stops the writer thread. Messages logged afterwards are
+     * written synchronously.
+     */
+    void shutdown();
+
+    /**
+     * Returns the number of messages dropped because the buffer of the thread logging them was
+     * full.
+     */
+    long long droppedCount() const {
+        return _dropped.load();
+    }
+
+    /**
+     * Flushes every AsyncAppender in the process, such as before the log files are rotated.
+     */
+    static void flushAll();
+
+    /**
+     * Shuts down every AsyncAppender in the process, such as when it exits.
+     */
+    static void shutdownAll();
+
+    // Smallest buffer a thread may be given.
+    static constexpr size_t kMinBufferSizeBytes = 4 * 1024;
+
+private:
+    class Ring;
+
+    /**
+     * Returns the buffer of the calling thread, or nullptr if the buffers of other threads already
+     * take up the whole size allowed.
+     */
+    Ring* _ringForThisThread();
+
+    /**
+     * Copies the records out of every ring and writes them in time order. Returns the number of
+     * records written.
+     */
+    size_t _drain();
+
+    void _writerThread();
+
+    void _reportDropped();
+
+    const std::unique_ptr<Appender<Event>> _appender;
+    const size_t _bufferSizeBytes;
+    const size_t _totalBufferSizeBytes;
+    const unsigned long long _id;
+
+    AtomicWord<bool> _async{true};
+    AtomicWord<long long> _dropped{0};
+    long long _droppedReported = 0;
+
+    stdx::mutex _mutex;
+    std::vector<std::shared_ptr<Ring>> _rings;
+    size_t _ringBytes = 0;
+    stdx::condition_variable _wakeWriter;
+    stdx::condition_variable _flushed;
+    unsigned long long _flushesRequested = 0;
+    unsigned long long _flushesCompleted = 0;
+    bool _stopRequested = false;
+
+    stdx::thread _writer;
+};
+
+}  // namespace logger
+}  // namespace mongo
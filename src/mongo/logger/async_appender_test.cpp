@@ -0,0 +1,262 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+using Event = MessageEventEphemeral;
+
+const size_t kTotalBufferSizeBytes = 16 * 1024 * 1024;
+
+/**
+ * Records the messages appended to it. Until unblocked, it blocks the first append of a message
+ * which may be truncated, which holds the writer of an AsyncAppender up while threads fill their
+ * buffers.
+ */
+class CaptureAppender : public Appender<Event> {
+public:
+    explicit CaptureAppender(bool blocked = false) : _blocked(blocked) {}
+
+    Status append(const Event& event) override {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _unblocked.wait(lk, [&] { return !_blocked || !event.isTruncatable(); });
+        _messages.push_back(event.getMessage().toString());
+        _severities.push_back(event.getSeverity());
+        return Status::OK();
+    }
+
+    void unblock() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _blocked = false;
+        _unblocked.notify_all();
+    }
+
+    std::vector<std::string> messages() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _messages;
+    }
+
+    std::vector<LogSeverity> severities() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _severities;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _unblocked;
+    bool _blocked;
+    std::vector<std::string> _messages;
+    std::vector<LogSeverity> _severities;
+};
+
+Status appendMessage(AsyncAppender* appender,
+                     StringData message,
+                     LogSeverity severity = LogSeverity::Log()) {
+    return appender->append(
+        Event(Date_t::now(), severity, LogComponent::kQuery, "AsyncAppenderTest", message));
+}
+
+TEST(AsyncAppenderTest, WritesEveryThreadsMessagesInOrder) {
+    auto capture = new CaptureAppender();
+    AsyncAppender appender(
+        std::unique_ptr<Appender<Event>>(capture), 64 * 1024, kTotalBufferSizeBytes);
+
+    const int kThreads = 4;
+    const int kMessagesPerThread = 200;
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kMessagesPerThread; i++) {
+                const std::string message = str::stream() << t << ":" << i;
+                ASSERT_OK(appendMessage(&appender, message));
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    appender.flush();
+
+    ASSERT_EQ(appender.droppedCount(), 0);
+    const auto messages = capture->messages();
+    ASSERT_EQ(messages.size(), size_t(kThreads * kMessagesPerThread));
+
+    // Each thread's messages are written in the order it logged them.
+    std::vector<int> nextMessage(kThreads, 0);
+    for (auto&& message : messages) {
+        const auto colon = message.find(':');
+        const int thread = std::stoi(message.substr(0, colon));
+        ASSERT_EQ(std::stoi(message.substr(colon + 1)), nextMessage[thread]++);
+    }
+}
+
+TEST(AsyncAppenderTest, DropsMessagesWhenTheBufferIsFull) {
+    auto capture = new CaptureAppender(true);
+    AsyncAppender appender(std::unique_ptr<Appender<Event>>(capture),
+                           AsyncAppender::kMinBufferSizeBytes,
+                           kTotalBufferSizeBytes);
+
+    // Once the writer takes a message it blocks on it, so that the others pile up.
+    const std::string message(100, 'x');
+    long long appended = 0;
+    while (appender.droppedCount() == 0) {
+        ASSERT_OK(appendMessage(&appender, message));
+        appended++;
+    }
+    const auto dropped = appender.droppedCount();
+
+    capture->unblock();
+    appender.flush();
+
+    // Every message not dropped was written, as was a note of how many were dropped.
+    const auto messages = capture->messages();
+    ASSERT_EQ(std::count(messages.begin(), messages.end(), message), appended - dropped);
+
+    const std::string note = str::stream()
+        << "Dropped " << dropped
+        << " log messages because the log buffer of the thread logging them was full";
+    const auto noteIt = std::find(messages.begin(), messages.end(), note);
+    ASSERT(noteIt != messages.end());
+    ASSERT(capture->severities()[noteIt - messages.begin()] == LogSeverity::Warning());
+}
+
+TEST(AsyncAppenderTest, WritesMessagesTooLargeForTheBufferSynchronously) {
+    auto capture = new CaptureAppender();
+    AsyncAppender appender(std::unique_ptr<Appender<Event>>(capture),
+                           AsyncAppender::kMinBufferSizeBytes,
+                           kTotalBufferSizeBytes);
+
+    const std::string large(2 * AsyncAppender::kMinBufferSizeBytes, 'x');
+    ASSERT_OK(appendMessage(&appender, "first"));
+    ASSERT_OK(appendMessage(&appender, large));
+
+    // The large message was written after the one queued before it, and not dropped.
+    const std::vector<std::string> expected{"first", large};
+    ASSERT(capture->messages() == expected);
+    ASSERT_EQ(appender.droppedCount(), 0);
+}
+
+TEST(AsyncAppenderTest, ThreadsBeyondTheTotalBufferSizeWriteSynchronously) {
+    auto capture = new CaptureAppender(true);
+    AsyncAppender appender(std::unique_ptr<Appender<Event>>(capture),
+                           AsyncAppender::kMinBufferSizeBytes,
+                           AsyncAppender::kMinBufferSizeBytes);
+
+    // This thread takes the only buffer there is room for. Its message is queued, and the writer
+    // blocks on it.
+    ASSERT_OK(appendMessage(&appender, "queued"));
+
+    // Another thread finds no room for a buffer, so it writes synchronously, and waits for the
+    // writer to be unblocked.
+    stdx::thread other([&] { ASSERT_OK(appendMessage(&appender, "synchronous")); });
+    capture->unblock();
+    other.join();
+    appender.flush();
+
+    auto messages = capture->messages();
+    std::sort(messages.begin(), messages.end());
+    const std::vector<std::string> expected{"queued", "synchronous"};
+    ASSERT(messages == expected);
+}
+
+TEST(AsyncAppenderTest, ErrorsAreWrittenSynchronously) {
+    auto capture = new CaptureAppender();
+    AsyncAppender appender(
+        std::unique_ptr<Appender<Event>>(capture), 64 * 1024, kTotalBufferSizeBytes);
+
+    ASSERT_OK(appendMessage(&appender, "first"));
+    ASSERT_OK(appendMessage(&appender, "error", LogSeverity::Error()));
+    ASSERT_OK(appendMessage(&appender, "severe", LogSeverity::Severe()));
+
+    // No flush is needed to see the errors, but the message queued before them may not have been
+    // written yet.
+    auto messages = capture->messages();
+    const auto error = std::find(messages.begin(), messages.end(), "error");
+    ASSERT(error != messages.end());
+    ASSERT(std::find(error, messages.end(), "severe") != messages.end());
+
+    appender.flush();
+    messages = capture->messages();
+    std::sort(messages.begin(), messages.end());
+    const std::vector<std::string> expected{"error", "first", "severe"};
+    ASSERT(messages == expected);
+}
+
+TEST(AsyncAppenderTest, MessagesWhichMustNotBeTruncatedDoNotWaitForTheWriter) {
+    auto capture = new CaptureAppender(true);
+    AsyncAppender appender(
+        std::unique_ptr<Appender<Event>>(capture), 64 * 1024, kTotalBufferSizeBytes);
+
+    // The writer blocks on the queued message. A stack trace, as a fatal signal handler logs it,
+    // is written at once rather than after waiting for the writer to catch up.
+    ASSERT_OK(appendMessage(&appender, "queued"));
+    const auto start = Date_t::now();
+    ASSERT_OK(appender.append(
+        Event(Date_t::now(), LogSeverity::Severe(), LogComponent::kDefault, "test", "stack trace")
+            .setIsTruncatable(false)));
+    ASSERT_LT(Date_t::now() - start, Seconds(5));
+    ASSERT(capture->messages() == std::vector<std::string>{"stack trace"});
+
+    capture->unblock();
+    appender.flush();
+    const std::vector<std::string> expected{"stack trace", "queued"};
+    ASSERT(capture->messages() == expected);
+}
+
+TEST(AsyncAppenderTest, WritesSynchronouslyAfterShutdown) {
+    auto capture = new CaptureAppender();
+    AsyncAppender appender(
+        std::unique_ptr<Appender<Event>>(capture), 64 * 1024, kTotalBufferSizeBytes);
+
+    ASSERT_OK(appendMessage(&appender, "queued"));
+    appender.shutdown();
+    ASSERT_EQ(capture->messages().size(), 1U);
+
+    ASSERT_OK(appendMessage(&appender, "synchronous"));
+    const std::vector<std::string> expected{"queued", "synchronous"};
+    ASSERT(capture->messages() == expected);
+}
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
@@ -52,9 +52,15 @@ struct Validator<BSONObj> {
         return BSONVersion::kLatest;
     }
 
+    inline static BSONUTF8Check enabledUTF8Check() {
+        return serverGlobalParams.objcheckUTF8.load() ? BSONUTF8Check::kEnforce
+                                                      : BSONUTF8Check::kSkip;
+    }
+
     inline static Status validateLoad(const char* ptr, size_t length) {
-        return serverGlobalParams.objcheck ? validateBSON(ptr, length, enabledBSONVersion())
-                                           : Status::OK();
+        return serverGlobalParams.objcheck
+            ? validateBSON(ptr, length, enabledBSONVersion(), enabledUTF8Check())
+            : Status::OK();
     }
 
     static Status validateStore(const BSONObj& toStore);
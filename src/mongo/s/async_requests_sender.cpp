@@ -37,6 +37,7 @@
 #include <memory>
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/stats/remote_wait_time.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -76,7 +77,6 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
     // Initialize command metadata to handle the read preference.
     _metadataObj = readPreference.toContainingBSON();
 
-    _remotes.reserve(requests.size());
     for (const auto& request : requests) {
         // Kick off requests immediately.
         _remotes.emplace_back(this, request.shardId, request.cmdObj).executeRequest();
@@ -88,6 +88,9 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() noexcept {
 
     _remotesLeft--;
 
+    // Everything below either returns a response which is already queued or blocks until one is.
+    RemoteWaitTime::Scope waitTimeScope(_opCtx);
+
     // If we've been interrupted, the response queue should be filled with interrupted answers, go
     // ahead and return one of those
     if (!_interruptStatus.isOK()) {
@@ -120,6 +123,18 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() noexcept {
     return _responseQueue.pop(_opCtx);
 }
 
+void AsyncRequestsSender::addRequest(const Request& request) {
+    _remotesLeft++;
+
+    if (!_interruptStatus.isOK()) {
+        // Callbacks are no longer serviced, so fail the request without sending it
+        _responseQueue.push({request.shardId, _interruptStatus, boost::none});
+        return;
+    }
+
+    _remotes.emplace_back(this, request.shardId, request.cmdObj).executeRequest();
+}
+
 void AsyncRequestsSender::stopRetrying() noexcept {
     _stopRetrying = true;
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <vector>
 
 #include "mongo/base/status_with.h"
@@ -154,6 +155,16 @@ public:
      */
     Response next() noexcept;
 
+    /**
+     * Schedules an additional request. Its response is returned by next() like those of the
+     * requests the ARS was constructed with, so a caller can send more work to a remote as soon as
+     * it responds, without waiting for the other remotes.
+     *
+     * If the operation has already been interrupted, the request is not sent and its response
+     * carries the interruption status.
+     */
+    void addRequest(const Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -267,8 +278,9 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
-    // Data tracking the state of our communication with each of the remote nodes.
-    std::vector<RemoteData> _remotes;
+    // Data tracking the state of our communication with each of the remote nodes. A deque, since
+    // callbacks hold pointers to the elements while addRequest() appends to it.
+    std::deque<RemoteData> _remotes;
 
     // Number of remotes we haven't returned final results from.
     size_t _remotesLeft;
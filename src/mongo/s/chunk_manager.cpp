@@ -68,6 +68,93 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+// Bounds on the number of entries in each block of a ChunkInfoMap. Blocks are small enough that
+// copying one on write is cheap, but large enough that the vector of block pointers, which is
+// copied on every refresh, stays small even for collections with millions of chunks.
+const size_t kMaxChunkMapBlockSize = 256;
+const size_t kMinChunkMapBlockSize = kMaxChunkMapBlockSize / 4;
+
+/**
+ * Orders chunk map entries (and plain key strings) by the key string of the chunk's max.
+ */
+struct ChunkMapKeyStringLess {
+    bool operator()(const std::string& keyString, const ChunkInfoMap::value_type& entry) const {
+        return keyString < entry.first;
+    }
+
+    bool operator()(const ChunkInfoMap::value_type& entry, const std::string& keyString) const {
+        return entry.first < keyString;
+    }
+};
+
+/**
+ * Checks that the range of "right" starts exactly where the range of "left" ends.
+ */
+void checkChunksAreContiguous(const ChunkInfo& left, const ChunkInfo& right) {
+    if (SimpleBSONObjComparator::kInstance.evaluate(left.getMax() == right.getMin()))
+        return;
+
+    if (SimpleBSONObjComparator::kInstance.evaluate(left.getMax() < right.getMin()))
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Gap exists in the routing table between chunks "
+                                << left.getRange().toString()
+                                << " and "
+                                << right.getRange().toString());
+    else
+        uasserted(ErrorCodes::ConflictingOperationInProgress,
+                  str::stream() << "Overlap exists in the routing table between chunks "
+                                << left.getRange().toString()
+                                << " and "
+                                << right.getRange().toString());
+}
+
+/**
+ * Checks that "chunkMap" covers the complete space from [MinKey, MaxKey) without gaps or overlaps,
+ * assuming that this was the case before the chunks with max key strings "changedMaxKeyStrings"
+ * were applied to it. Since applying a chunk only removes the chunks it overlaps, any two chunks
+ * which became neighbours because of the change have at least one changed chunk among them, so it
+ * is sufficient to check the neighbours of the changed chunks.
+ */
+void checkChunkMapContinuity(const ChunkInfoMap& chunkMap,
+                             const std::vector<std::string>& changedMaxKeyStrings) {
+    if (chunkMap.empty())
+        return;
+
+    checkAllElementsAreOfType(MinKey, chunkMap.begin()->second->getMin());
+    checkAllElementsAreOfType(MaxKey, std::prev(chunkMap.end())->second->getMax());
+
+    for (const auto& maxKeyString : changedMaxKeyStrings) {
+        const auto it = chunkMap.lowerBound(maxKeyString);
+
+        // The chunk was later overwritten by one with a different max, which is checked instead
+        if (it == chunkMap.end() || it->first != maxKeyString)
+            continue;
+
+        if (it != chunkMap.begin())
+            checkChunksAreContiguous(*std::prev(it)->second, *it->second);
+
+        const auto next = std::next(it);
+        if (next != chunkMap.end())
+            checkChunksAreContiguous(*it->second, *next->second);
+    }
+}
+
+/**
+ * Returns a non-OK status if "shardKey" contains values, which would be compared differently
+ * under a non-simple collation and therefore cannot be used to target a single chunk.
+ */
+Status checkKeyIsTargetableWithCollation(const BSONObj& shardKey) {
+    for (BSONElement elt : shardKey) {
+        if (CollationIndexKey::isCollatableType(elt.type())) {
+            return {ErrorCodes::ShardKeyNotFound,
+                    str::stream() << "Cannot target single shard due to collation of key "
+                                  << elt.fieldNameStringData()};
+        }
+    }
+
+    return Status::OK();
+}
+
 }  // namespace
 
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
@@ -76,7 +163,8 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
                                          ChunkInfoMap chunkMap,
-                                         ChunkVersion collectionVersion)
+                                         ChunkVersion collectionVersion,
+                                         ShardVersionTargetingMap shardVersions)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
       _uuid(uuid),
@@ -86,21 +174,174 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
       _collectionVersion(collectionVersion),
-      _shardVersions(_constructShardVersionMap()) {}
+      _shardVersions(std::move(shardVersions)) {}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upperBound(const_iterator first,
+                                                      const std::string& keyString) const {
+    invariant(first._blocks == &_blocks);
+
+    // Find the first block at or after the one "first" points into, which has an entry greater
+    // than keyString, and then the first such entry inside of it
+    const auto blockIt = std::upper_bound(
+        _blocks.begin() + first._block,
+        _blocks.end(),
+        keyString,
+        [](const std::string& keyString, const std::shared_ptr<Block>& block) {
+            return keyString < block->back().first;
+        });
+    if (blockIt == _blocks.end())
+        return end();
+
+    const size_t block = blockIt - _blocks.begin();
+    const auto& entries = **blockIt;
+    const auto entryIt =
+        std::upper_bound(entries.begin() + (block == first._block ? first._pos : 0),
+                         entries.end(),
+                         keyString,
+                         ChunkMapKeyStringLess());
+
+    return {&_blocks, block, size_t(entryIt - entries.begin())};
+}
 
-Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
-    const bool hasSimpleCollation = (collation.isEmpty() && !_rt->getDefaultCollator()) ||
+ChunkInfoMap::const_iterator ChunkInfoMap::lowerBound(const std::string& keyString) const {
+    const auto blockIt = std::lower_bound(
+        _blocks.begin(),
+        _blocks.end(),
+        keyString,
+        [](const std::shared_ptr<Block>& block, const std::string& keyString) {
+            return block->back().first < keyString;
+        });
+    if (blockIt == _blocks.end())
+        return end();
+
+    const auto& entries = **blockIt;
+    const auto entryIt =
+        std::lower_bound(entries.begin(), entries.end(), keyString, ChunkMapKeyStringLess());
+
+    return {&_blocks, size_t(blockIt - _blocks.begin()), size_t(entryIt - entries.begin())};
+}
+
+void ChunkInfoMap::replace(const_iterator first, const_iterator last, value_type entry) {
+    invariant(first._blocks == &_blocks);
+    invariant(last._blocks == &_blocks);
+
+    if (_blocks.empty()) {
+        _blocks.push_back(std::make_shared<Block>());
+        _blocks.back()->push_back(std::move(entry));
+        _size = 1;
+        return;
+    }
+
+    // Make both positions point inside of a block, so that a position at the start of a block
+    // (including end()) is expressed as the end of the previous block
+    size_t firstBlock = first._block;
+    size_t firstPos = first._pos;
+    if (firstPos == 0 && firstBlock > 0) {
+        --firstBlock;
+        firstPos = _blocks[firstBlock]->size();
+    }
+
+    size_t lastBlock = last._block;
+    size_t lastPos = last._pos;
+    if (lastPos == 0 && lastBlock > firstBlock) {
+        --lastBlock;
+        lastPos = _blocks[lastBlock]->size();
+    }
+
+    if (firstBlock == lastBlock) {
+        auto& entries = _getWritableBlock(firstBlock);
+        _size -= lastPos - firstPos;
+        entries.insert(entries.erase(entries.begin() + firstPos, entries.begin() + lastPos),
+                       std::move(entry));
+        _size += 1;
+
+        _rebalanceBlock(firstBlock);
+        return;
+    }
+
+    // The replaced range spans multiple blocks, so keep the beginning of the first block followed
+    // by the new entry, drop all the blocks in between and keep the end of the last block
+    auto& head = _getWritableBlock(firstBlock);
+    _size -= head.size() - firstPos;
+    head.erase(head.begin() + firstPos, head.end());
+    head.push_back(std::move(entry));
+    _size += 1;
+
+    for (size_t block = firstBlock + 1; block < lastBlock; ++block) {
+        _size -= _blocks[block]->size();
+    }
+
+    auto& tail = _getWritableBlock(lastBlock);
+    _size -= lastPos;
+    tail.erase(tail.begin(), tail.begin() + lastPos);
+
+    _blocks.erase(_blocks.begin() + firstBlock + 1, _blocks.begin() + lastBlock);
+
+    _rebalanceBlock(firstBlock + 1);
+    _rebalanceBlock(std::min(firstBlock, _blocks.size() - 1));
+}
+
+ChunkInfoMap::Block& ChunkInfoMap::_getWritableBlock(size_t block) {
+    // A block which is referenced only from this map cannot be reached by any other thread, so it
+    // is safe to modify it in place
+    if (_blocks[block].use_count() != 1) {
+        _blocks[block] = std::make_shared<Block>(*_blocks[block]);
+    }
+
+    return *_blocks[block];
+}
+
+void ChunkInfoMap::_rebalanceBlock(size_t block) {
+    if (block >= _blocks.size())
+        return;
+
+    const auto& entries = *_blocks[block];
+
+    if (entries.empty()) {
+        _blocks.erase(_blocks.begin() + block);
+        return;
+    }
+
+    if (entries.size() < kMinChunkMapBlockSize && _blocks.size() > 1) {
+        // Merge the block into a new one together with its right (or for the last block, left)
+        // neighbour, and let that be split below if it ends up too large
+        const size_t left = (block + 1 < _blocks.size()) ? block : block - 1;
+
+        auto merged = std::make_shared<Block>();
+        merged->reserve(_blocks[left]->size() + _blocks[left + 1]->size());
+        merged->insert(merged->end(), _blocks[left]->begin(), _blocks[left]->end());
+        merged->insert(merged->end(), _blocks[left + 1]->begin(), _blocks[left + 1]->end());
+
+        _blocks[left] = std::move(merged);
+        _blocks.erase(_blocks.begin() + left + 1);
+
+        _rebalanceBlock(left);
+        return;
+    }
+
+    if (entries.size() > kMaxChunkMapBlockSize) {
+        auto& lowerHalf = _getWritableBlock(block);
+        const auto middle = lowerHalf.begin() + lowerHalf.size() / 2;
+
+        auto upperHalf = std::make_shared<Block>(std::make_move_iterator(middle),
+                                                 std::make_move_iterator(lowerHalf.end()));
+        lowerHalf.erase(middle, lowerHalf.end());
+
+        _blocks.insert(_blocks.begin() + block + 1, std::move(upperHalf));
+    }
+}
+
+bool ChunkManager::_hasSimpleCollation(const BSONObj& collation) const {
+    return (collation.isEmpty() && !_rt->getDefaultCollator()) ||
         SimpleBSONObjComparator::kInstance.evaluate(collation == CollationSpec::kSimpleSpec);
-    if (!hasSimpleCollation) {
-        for (BSONElement elt : shardKey) {
-            uassert(ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "Cannot target single shard due to collation of key "
-                                  << elt.fieldNameStringData(),
-                    !CollationIndexKey::isCollatableType(elt.type()));
-        }
+}
+
+Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
+    if (!_hasSimpleCollation(collation)) {
+        uassertStatusOK(checkKeyIsTargetableWithCollation(shardKey));
     }
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto it = _rt->_upperBound(_rt->_extractKeyString(shardKey));
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
             it != _rt->getChunkMap().end() && it->second->containsKey(shardKey));
@@ -108,11 +349,65 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<StatusWith<Chunk>> ChunkManager::findIntersectingChunks(
+    const std::vector<BSONObj>& shardKeys, const BSONObj& collation) const {
+    const bool hasSimpleCollation = _hasSimpleCollation(collation);
+
+    std::vector<Status> statuses(shardKeys.size(), Status::OK());
+    std::vector<ChunkInfo*> chunks(shardKeys.size(), nullptr);
+
+    // Pairs of (key string, position in shardKeys) for all the keys, which can be targeted
+    std::vector<std::pair<std::string, size_t>> sortedKeys;
+    sortedKeys.reserve(shardKeys.size());
+
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        if (!hasSimpleCollation) {
+            statuses[i] = checkKeyIsTargetableWithCollation(shardKeys[i]);
+            if (!statuses[i].isOK())
+                continue;
+        }
+
+        sortedKeys.emplace_back(_rt->_extractKeyString(shardKeys[i]), i);
+    }
+
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+
+    // Since the keys are sorted, the chunk for each key cannot precede the chunk found for the key
+    // before it, so every search only needs to consider the remainder of the routing table
+    auto it = _rt->getChunkMap().cbegin();
+    for (const auto& sortedKey : sortedKeys) {
+        const auto& shardKey = shardKeys[sortedKey.second];
+
+        it = _rt->_upperBound(it, sortedKey.first);
+        if (it == _rt->getChunkMap().cend() || !it->second->containsKey(shardKey)) {
+            statuses[sortedKey.second] = {ErrorCodes::ShardKeyNotFound,
+                                          str::stream() << "Cannot target single shard using key "
+                                                        << shardKey};
+            continue;
+        }
+
+        chunks[sortedKey.second] = it->second.get();
+    }
+
+    std::vector<StatusWith<Chunk>> results;
+    results.reserve(shardKeys.size());
+
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        if (!statuses[i].isOK()) {
+            results.emplace_back(std::move(statuses[i]));
+        } else {
+            results.emplace_back(Chunk(*chunks[i], _clusterTime));
+        }
+    }
+
+    return results;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto it = _rt->_upperBound(_rt->_extractKeyString(shardKey));
     if (it == _rt->getChunkMap().end())
         return false;
 
@@ -212,7 +507,7 @@ bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& sh
 
 ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj& shardKey,
                                                                    const ShardId& shardId) const {
-    for (auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    for (auto it = _rt->_upperBound(_rt->_extractKeyString(shardKey));
          it != _rt->getChunkMap().end();
          ++it) {
         const auto& chunk = it->second;
@@ -230,7 +525,7 @@ void RoutingTableHistory::getAllShardIds(std::set<ShardId>* all) const {
     std::transform(_shardVersions.begin(),
                    _shardVersions.end(),
                    std::inserter(*all, all->begin()),
-                   [](const ShardVersionMap::value_type& pair) { return pair.first; });
+                   [](const ShardVersionTargetingMap::value_type& pair) { return pair.first; });
 }
 
 std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator>
@@ -238,10 +533,10 @@ RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
 
-    const auto itMin = _chunkMap.upper_bound(_extractKeyString(min));
+    const auto itMin = _upperBound(_extractKeyString(min));
     const auto itMax = [this, &max, isMaxInclusive]() {
-        auto it = isMaxInclusive ? _chunkMap.upper_bound(_extractKeyString(max))
-                                 : _chunkMap.lower_bound(_extractKeyString(max));
+        auto it = isMaxInclusive ? _upperBound(_extractKeyString(max))
+                                 : _lowerBound(_extractKeyString(max));
         return it == _chunkMap.end() ? it : ++it;
     }();
 
@@ -384,7 +679,7 @@ ChunkVersion RoutingTableHistory::getVersion(const ShardId& shardName) const {
         return ChunkVersion(0, 0, _collectionVersion.epoch());
     }
 
-    return it->second;
+    return it->second.shardVersion;
 }
 
 std::string RoutingTableHistory::toString() const {
@@ -398,95 +693,12 @@ std::string RoutingTableHistory::toString() const {
 
     sb << "Shard versions:\n";
     for (const auto& entry : _shardVersions) {
-        sb << "\t" << entry.first << ": " << entry.second.toString() << '\n';
+        sb << "\t" << entry.first << ": " << entry.second.shardVersion.toString() << '\n';
     }
 
     return sb.str();
 }
 
-ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
-    const OID& epoch = _collectionVersion.epoch();
-
-    ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(currentRangeShardId, ChunkVersion(0, 0, epoch)).first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId,
-                          &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                             const auto& currentChunk = chunkMapEntry.second;
-
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
-
-                             if (currentChunk->getLastmod() > maxShardVersion)
-                                 maxShardVersion = currentChunk->getLastmod();
-
-                             return false;
-                         });
-
-        const auto rangeLast = std::prev(current);
-
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->second->getMax();
-
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream()
-                              << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
-                              << " and "
-                              << rangeLast->second->getRange().toString());
-        }
-
-        if (!firstMin)
-            firstMin = rangeMin;
-
-        lastMax = rangeMax;
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!_chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
-
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
-
-    return shardVersions;
-}
-
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -505,7 +717,8 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(defaultCollator),
                                std::move(unique),
                                {},
-                               {0, 0, epoch})
+                               {0, 0, epoch},
+                               {})
         .makeUpdated(chunks);
 }
 
@@ -513,7 +726,22 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
+    const auto& epoch = startingCollectionVersion.epoch();
+
+    // Copying the chunk map only copies pointers to its blocks and applying the changes below only
+    // copies the blocks they modify, so this routing table, which may still be in use by other
+    // operations, shares all of its unchanged chunks with the new one.
     auto chunkMap = _chunkMap;
+    auto shardVersions = _shardVersions;
+
+    // Shards which lost the chunk their shard version came from, but still own other chunks,
+    // along with the version of that chunk
+    std::map<ShardId, ChunkVersion> removedShardVersions;
+
+    // Max key strings of all the applied chunks, around which the continuity of the routing table
+    // needs to be checked
+    std::vector<std::string> changedMaxKeyStrings;
+    changedMaxKeyStrings.reserve(changedChunks.size());
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -534,11 +762,11 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
 
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
         // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
+        const auto low = chunkMap.upperBound(chunkMinKeyString);
 
         // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
         // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
+        const auto high = chunkMap.upperBound(low, chunkMaxKeyString);
 
         // If we are in the middle of splitting a chunk, for the first few
         // chunks inserted, low == high, because both lookups will point to the
@@ -546,13 +774,13 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // for the current chunk being split, low will point to the chunk that
         // we're splitting, and high will point to the next chunk past the one
         // we're splitting (which could be chunkMap.end()). In this case,
-        // std::distance(low, high) == 1. Lastly, this does not apply during
+        // std::next(low) == high. Lastly, this does not apply during
         // the creation of the original routing table, in which case the map is
         // empty and the first chunk that is inserted will find that low ==
         // high, but low == chunkMap.end(), and we aren't doing a split in that
         // case.
         auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
+            (low != chunkMap.end() && (low == high || std::next(low) == high));
 
         auto newChunk = std::make_shared<ChunkInfo>(chunk);
         if (foundSingleChunk) {
@@ -562,11 +790,42 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
             newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
         }
 
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        // Take the chunks, which overlap the chunk we got from the persistent store, away from the
+        // shards which own them
+        for (auto it = low; it != high; ++it) {
+            const auto& replacedChunk = it->second;
+
+            auto shardVersionIt = shardVersions.find(replacedChunk->getShardIdAt(boost::none));
+            invariant(shardVersionIt != shardVersions.end());
+
+            auto& shardVersion = shardVersionIt->second;
+            if (--shardVersion.numChunks == 0) {
+                shardVersions.erase(shardVersionIt);
+            } else if (replacedChunk->getLastmod() == shardVersion.shardVersion) {
+                removedShardVersions[shardVersionIt->first] = shardVersion.shardVersion;
+            }
+        }
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        // Replace all these chunks with only the chunk itself
+        chunkMap.replace(low, high, std::make_pair(chunkMaxKeyString, newChunk));
+        changedMaxKeyStrings.push_back(chunkMaxKeyString);
+
+        const auto& shardId = newChunk->getShardIdAt(boost::none);
+
+        auto& shardVersion =
+            shardVersions
+                .emplace(shardId, ShardVersionTargetingInfo{ChunkVersion(0, 0, epoch), 0})
+                .first->second;
+        ++shardVersion.numChunks;
+        if (chunkVersion > shardVersion.shardVersion)
+            shardVersion.shardVersion = chunkVersion;
+
+        // A chunk at least as new as the one the shard lost determines the shard version again
+        auto removedShardVersionIt = removedShardVersions.find(shardId);
+        if (removedShardVersionIt != removedShardVersions.end() &&
+            chunkVersion >= removedShardVersionIt->second) {
+            removedShardVersions.erase(removedShardVersionIt);
+        }
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -580,6 +839,42 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    checkChunkMapContinuity(chunkMap, changedMaxKeyStrings);
+
+    // A shard which loses the chunk its shard version came from normally also gets a chunk with a
+    // newer version as part of the same change. Only if it did not, its shard version needs to be
+    // recomputed from its remaining chunks, which requires a pass over the entire routing table.
+    std::set<ShardId> shardVersionsToRecompute;
+    for (const auto& removedShardVersion : removedShardVersions) {
+        auto it = shardVersions.find(removedShardVersion.first);
+        if (it != shardVersions.end()) {
+            it->second.shardVersion = ChunkVersion(0, 0, epoch);
+            shardVersionsToRecompute.insert(removedShardVersion.first);
+        }
+    }
+
+    if (!shardVersionsToRecompute.empty()) {
+        for (const auto& entry : chunkMap) {
+            const auto& chunkInfo = entry.second;
+
+            auto it = shardVersions.find(chunkInfo->getShardIdAt(boost::none));
+            invariant(it != shardVersions.end());
+            if (!shardVersionsToRecompute.count(it->first))
+                continue;
+
+            if (chunkInfo->getLastmod() > it->second.shardVersion)
+                it->second.shardVersion = chunkInfo->getLastmod();
+        }
+    }
+
+    // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+    // somewhere, which should have been caught at chunk load time
+    invariant(chunkMap.empty() || !shardVersions.empty());
+    for (const auto& shardVersion : shardVersions) {
+        invariant(shardVersion.second.numChunks > 0);
+        invariant(shardVersion.second.shardVersion.isSet());
+    }
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -587,7 +882,8 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
-                                collectionVersion));
+                                collectionVersion,
+                                std::move(shardVersions)));
 }
 
 }  // namespace mongo
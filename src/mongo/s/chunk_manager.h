@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "mongo/base/status_with.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
@@ -49,12 +52,158 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+/**
+ * Sorted sequence of (max for each chunk, entry describing the chunk) pairs, ordered by the
+ * KeyString encoding of the chunk's max.
+ *
+ * The entries are kept in bounded-size blocks of contiguous memory, so that the binary searches
+ * done for every targeted document touch few cache lines. The blocks are never modified once they
+ * are shared between copies of the map: copying a map only copies the block pointers and replacing
+ * entries copies just the blocks it touches. This lets successive versions of a routing table share
+ * all their unchanged chunks and makes applying a refresh proportional to the size of the change
+ * rather than to the number of chunks in the collection.
+ */
+class ChunkInfoMap {
+    using Block = std::vector<std::pair<std::string, std::shared_ptr<ChunkInfo>>>;
+    using Blocks = std::vector<std::shared_ptr<Block>>;
+
+public:
+    using value_type = Block::value_type;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*(*_blocks)[_block])[_pos];
+        }
+        pointer operator->() const {
+            return &operator*();
+        }
+
+        const_iterator& operator++() {
+            if (++_pos == (*_blocks)[_block]->size()) {
+                ++_block;
+                _pos = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto result = *this;
+            operator++();
+            return result;
+        }
+
+        const_iterator& operator--() {
+            if (_pos == 0) {
+                --_block;
+                _pos = (*_blocks)[_block]->size();
+            }
+            --_pos;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto result = *this;
+            operator--();
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _blocks == other._blocks && _block == other._block && _pos == other._pos;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const Blocks* blocks, size_t block, size_t pos)
+            : _blocks(blocks), _block(block), _pos(pos) {}
+
+        const Blocks* _blocks{nullptr};
+        size_t _block{0};
+        size_t _pos{0};
+    };
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator begin() const {
+        return {&_blocks, 0, 0};
+    }
+    const_iterator end() const {
+        return {&_blocks, _blocks.size(), 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    /**
+     * Returns the first entry whose key string is greater than (respectively, not less than)
+     * "keyString". The search can be restricted to start from "first" when the caller already
+     * knows that no earlier entry can qualify.
+     */
+    const_iterator upperBound(const std::string& keyString) const {
+        return upperBound(begin(), keyString);
+    }
+    const_iterator upperBound(const_iterator first, const std::string& keyString) const;
+    const_iterator lowerBound(const std::string& keyString) const;
+
+    /**
+     * Replaces the entries in the range [first, last) with "entry", whose key string must sort
+     * after all the entries before "first" and before all the entries starting at "last".
+     * Invalidates all iterators into this map, but not into any of its copies.
+     */
+    void replace(const_iterator first, const_iterator last, value_type entry);
+
+private:
+    /**
+     * Returns the block at the specified position, first making a private copy of it if it is
+     * shared with other maps.
+     */
+    Block& _getWritableBlock(size_t block);
+
+    /**
+     * Restores the size bounds of the block at the specified position after it has been modified,
+     * by splitting it or merging it with a neighbour.
+     */
+    void _rebalanceBlock(size_t block);
+
+    Blocks _blocks;
+    size_t _size{0};
+};
+
+/**
+ * The maximum chunk version of a shard which owns chunks of a collection and the number of chunks
+ * it owns. Keeping the count allows the routing table to tell when a shard loses its last chunk
+ * without scanning all the chunks.
+ */
+struct ShardVersionTargetingInfo {
+    ChunkVersion shardVersion;
+    size_t numChunks{0};
+};
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+// Map from a shard to the targeting information kept for it by the routing table
+using ShardVersionTargetingMap = std::map<ShardId, ShardVersionTargetingInfo>;
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -157,15 +306,22 @@ private:
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
                         ChunkInfoMap chunkMap,
-                        ChunkVersion collectionVersion);
-
-    /**
-     * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
-     */
-    ShardVersionMap _constructShardVersionMap() const;
+                        ChunkVersion collectionVersion,
+                        ShardVersionTargetingMap shardVersions);
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
+    ChunkInfoMap::const_iterator _upperBound(const std::string& keyString) const {
+        return _chunkMap.upperBound(keyString);
+    }
+    ChunkInfoMap::const_iterator _upperBound(ChunkInfoMap::const_iterator first,
+                                             const std::string& keyString) const {
+        return _chunkMap.upperBound(first, keyString);
+    }
+    ChunkInfoMap::const_iterator _lowerBound(const std::string& keyString) const {
+        return _chunkMap.lowerBound(keyString);
+    }
+
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
     const unsigned long long _sequenceNumber;
@@ -188,7 +344,8 @@ private:
     const bool _unique;
 
     // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
-    // ranges must cover the complete space from [MinKey, MaxKey).
+    // ranges must cover the complete space from [MinKey, MaxKey). Shares the unchanged parts of its
+    // contents with the routing tables this one was created from.
     const ChunkInfoMap _chunkMap;
 
     // Max version across all chunks
@@ -196,7 +353,7 @@ private:
 
     // Map from shard id to the maximum chunk version for that shard. If a shard contains no
     // chunks, it won't be present in this map.
-    const ShardVersionMap _shardVersions;
+    const ShardVersionTargetingMap _shardVersions;
 
     friend class ChunkManager;
 };
@@ -330,6 +487,18 @@ public:
      */
     Chunk findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const;
 
+    /**
+     * Batched version of findIntersectingChunk, which targets all of "shardKeys" at once. The keys
+     * are encoded and sorted up front, so that the chunks are located in a single forward sweep
+     * over the routing table instead of one independent search per key.
+     *
+     * Returns one entry per shard key, in the same order as "shardKeys". A key which cannot be
+     * targeted to a single chunk gets the error findIntersectingChunk would have thrown for it, so
+     * that one bad key does not fail the rest of the batch.
+     */
+    std::vector<StatusWith<Chunk>> findIntersectingChunks(const std::vector<BSONObj>& shardKeys,
+                                                          const BSONObj& collation) const;
+
     /**
      * Same as findIntersectingChunk, but assumes the simple collation.
      */
@@ -404,6 +573,12 @@ public:
     }
 
 private:
+    /**
+     * Returns whether targeting with "collation" is equivalent to targeting with the simple
+     * collation, taking the collection's default collation into account when it is empty.
+     */
+    bool _hasSimpleCollation(const BSONObj& collation) const;
+
     std::shared_ptr<RoutingTableHistory> _rt;
     boost::optional<Timestamp> _clusterTime;
 };
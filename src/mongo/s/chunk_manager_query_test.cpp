@@ -488,5 +488,53 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksBatched) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a" << -100), BSON("a" << 0), BSON("a" << 100)});
+
+    const std::vector<BSONObj> shardKeys{BSON("a" << 150),
+                                         BSON("a" << -150),
+                                         BSON("a" << 0),
+                                         BSON("a" << 150),
+                                         BSON("a" << -100),
+                                         BSON("a" << 99)};
+    const auto results = chunkManager->findIntersectingChunks(shardKeys, BSONObj());
+    ASSERT_EQ(shardKeys.size(), results.size());
+
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        ASSERT_OK(results[i].getStatus());
+        ASSERT_EQ(chunkManager->findIntersectingChunkWithSimpleCollation(shardKeys[i]).getShardId(),
+                  results[i].getValue().getShardId());
+    }
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksBatchedReportsPerKeyErrors) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss,
+                                         shardKeyPattern,
+                                         nullptr,
+                                         false,
+                                         {BSON("a"
+                                               << "x"),
+                                          BSON("a"
+                                               << "y")});
+
+    // String keys cannot be targeted under a non-simple collation, but that must not prevent the
+    // other keys in the batch from being targeted
+    const auto results = chunkManager->findIntersectingChunks({BSON("a"
+                                                                    << "z"),
+                                                               BSON("a" << 5)},
+                                                              BSON("locale"
+                                                                   << "en_US"));
+    ASSERT_EQ(2UL, results.size());
+    ASSERT_EQ(ErrorCodes::ShardKeyNotFound, results[0].getStatus());
+    ASSERT_OK(results[1].getStatus());
+    ASSERT_EQ(ShardId("0"), results[1].getValue().getShardId());
+}
+
 }  // namespace
 }  // namespace mongo
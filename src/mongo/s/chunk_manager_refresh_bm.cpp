@@ -121,7 +121,41 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+void BM_IncrementalRefreshAfterSplit(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    // Split a chunk in the middle of the routing table into two
+    const auto chunkToSplit = getRangeForChunk(nChunks / 2, nChunks);
+    const auto splitPoint = BSON("_id" << chunkToSplit.getMin()["_id"].numberInt() + 50);
+    const auto chunk =
+        cm->getChunkManager()->findIntersectingChunkWithSimpleCollation(chunkToSplit.getMin());
+    const auto shardId = chunk.getShardId();
+
+    auto postSplitVersion = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    std::vector<ChunkType> newChunks;
+    postSplitVersion.incMinor();
+    newChunks.emplace_back(
+        collName, ChunkRange(chunkToSplit.getMin(), splitPoint), postSplitVersion, shardId);
+    postSplitVersion.incMinor();
+    newChunks.emplace_back(
+        collName, ChunkRange(splitPoint, chunkToSplit.getMax()), postSplitVersion, shardId);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalRefreshAfterSplit)
+    ->Args({2, 50000})
+    ->Args({2, 500000})
+    ->Args({100, 500000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -246,6 +280,55 @@ void BM_FindIntersectingChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_FindIntersectingChunksBatched(benchmark::State& state,
+                                      CollectionMetadataBuilderFn makeCollectionMetadata) {
+    constexpr size_t kBatchSize = 1000;
+
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    auto cm = makeCollectionMetadata(nShards, nChunks);
+    auto keys = makeKeys(nChunks);
+
+    std::vector<std::vector<BSONObj>> batches;
+    for (size_t i = 0; i + kBatchSize <= keys.size(); i += kBatchSize) {
+        batches.emplace_back(keys.begin() + i, keys.begin() + i + kBatchSize);
+    }
+    auto batchesIter = makeCircularIterator(batches);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(cm->getChunkManager()->findIntersectingChunks(
+            *batchesIter, CollationSpec::kSimpleSpec));
+        ++batchesIter;
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+template <typename CollectionMetadataBuilderFn>
+void BM_FindIntersectingChunksOneByOne(benchmark::State& state,
+                                       CollectionMetadataBuilderFn makeCollectionMetadata) {
+    constexpr size_t kBatchSize = 1000;
+
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    auto cm = makeCollectionMetadata(nShards, nChunks);
+    auto keys = makeKeys(nChunks);
+    auto keysIter = makeCircularIterator(keys);
+
+    for (auto keepRunning : state) {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+            benchmark::DoNotOptimize(
+                cm->getChunkManager()->findIntersectingChunkWithSimpleCollation(*keysIter));
+            ++keysIter;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
 template <typename CollectionMetadataBuilderFn>
 void BM_GetShardIdsForRange(benchmark::State& state,
                             CollectionMetadataBuilderFn makeCollectionMetadata) {
@@ -328,6 +411,18 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             BM_FindIntersectingChunk, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
             BM_FindIntersectingChunk, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunksBatched,
+                                   Pessimal,
+                                   makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunksBatched,
+                                   Optimal,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunksOneByOne,
+                                   Pessimal,
+                                   makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunksOneByOne,
+                                   Optimal,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
             BM_GetShardIdsForRange, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
@@ -347,6 +442,7 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({10, 50000})
             ->Args({100, 50000})
             ->Args({1000, 50000})
+            ->Args({10, 500000})
             ->Args({2, 2});
     }
 
@@ -35,7 +35,9 @@
 #include "mongo/db/commands.h"
 #include "mongo/s/cluster_commands_helpers.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/request_types/create_collection_gen.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -73,6 +75,10 @@ public:
              BSONObjBuilder& result) override {
         const NamespaceString nss(parseNs(dbName, cmdObj));
 
+        // Creating a view, or a collection with a default collation, changes the results of reads
+        // of a namespace which did not exist.
+        ON_BLOCK_EXIT([&] { ClusterQueryResultCache::get(opCtx)->invalidate(nss); });
+
         createShardDatabase(opCtx, dbName);
 
         uassert(ErrorCodes::InvalidOptions,
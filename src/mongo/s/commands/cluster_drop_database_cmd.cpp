@@ -37,6 +37,7 @@
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -81,7 +82,10 @@ public:
 
         // Invalidate the database metadata so the next access kicks off a full reload, even if
         // sending the command to the config server fails due to e.g. a NetworkError.
-        ON_BLOCK_EXIT([opCtx, dbname] { Grid::get(opCtx)->catalogCache()->purgeDatabase(dbname); });
+        ON_BLOCK_EXIT([opCtx, dbname] {
+            Grid::get(opCtx)->catalogCache()->purgeDatabase(dbname);
+            ClusterQueryResultCache::get(opCtx)->invalidateDatabase(dbname);
+        });
 
         // Send _configsvrDropDatabase to the config server.
         auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
@@ -53,6 +53,7 @@
 #include "mongo/s/cluster_commands_helpers.h"
 #include "mongo/s/commands/strategy.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/request_types/shard_collection_gen.h"
 #include "mongo/s/write_ops/cluster_write.h"
 #include "mongo/stdx/chrono.h"
@@ -235,6 +236,13 @@ public:
                 "Invalid output namespace",
                 inlineOutput || outputCollNss.isValid());
 
+        // Cached results of reads of the output collection may no longer reflect its contents.
+        ON_BLOCK_EXIT([&] {
+            if (!inlineOutput) {
+                ClusterQueryResultCache::get(opCtx)->invalidate(outputCollNss);
+            }
+        });
+
         auto const catalogCache = Grid::get(opCtx)->catalogCache();
 
         // Ensure the input database exists and set up the input collection
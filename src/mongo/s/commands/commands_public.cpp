@@ -44,8 +44,10 @@
 #include "mongo/s/cluster_commands_helpers.h"
 #include "mongo/s/commands/cluster_explain.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -209,6 +211,11 @@ public:
                 str::stream() << "Invalid target namespace: " << toNss.ns(),
                 toNss.isValid());
 
+        ON_BLOCK_EXIT([&] {
+            ClusterQueryResultCache::get(opCtx)->invalidate(fromNss);
+            ClusterQueryResultCache::get(opCtx)->invalidate(toNss);
+        });
+
         const auto fromRoutingInfo = uassertStatusOK(
             Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(opCtx, fromNss));
         uassert(13138, "You can't rename a sharded collection", !fromRoutingInfo.cm());
@@ -269,6 +276,9 @@ public:
                 "You can't convertToCapped a sharded collection",
                 !routingInfo.cm());
 
+        // Capping the collection may remove documents from it.
+        ON_BLOCK_EXIT([&] { ClusterQueryResultCache::get(opCtx)->invalidate(nss); });
+
         // convertToCapped creates a temp collection and renames it at the end. It will require
         // special handling for create collection.
         return nonShardedCollectionCommandPassthrough(
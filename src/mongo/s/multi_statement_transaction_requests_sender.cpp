@@ -94,6 +94,11 @@ AsyncRequestsSender::Response MultiStatementTransactionRequestsSender::next() {
     return response;
 }
 
+void MultiStatementTransactionRequestsSender::addRequest(
+    const AsyncRequestsSender::Request& request) {
+    _ars.addRequest(attachTxnDetails(_opCtx, {request}).front());
+}
+
 void MultiStatementTransactionRequestsSender::stopRetrying() {
     _ars.stopRetrying();
 }
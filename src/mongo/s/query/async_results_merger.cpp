@@ -39,6 +39,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -79,6 +80,28 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the ordering under which sort keys for 'sortKeyPattern' are normalized, or boost::none if
+ * there is no sort or the pattern has more fields than an Ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const boost::optional<BSONObj>& sortKeyPattern) {
+    if (!sortKeyPattern ||
+        static_cast<size_t>(sortKeyPattern->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*sortKeyPattern);
+}
+
+/**
+ * Encodes 'sortKey' as a KeyString. Two such strings compare bytewise in the same order as
+ * compareSortKeys() orders the sort keys they were built from, so the merge can order remotes with
+ * a memcmp rather than a field-by-field BSON comparison.
+ */
+std::string makeNormalizedSortKey(const BSONObj& sortKey, Ordering ordering) {
+    KeyString ks(KeyString::Version::V1, sortKey, ordering);
+    return std::string(ks.getBuffer(), ks.getSize());
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -91,8 +114,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params.getSort())),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params.getSort().value_or(BSONObj()),
+                                    _params.getCompareWholeSortKey(),
+                                    static_cast<bool>(_sortKeyOrdering))),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -109,6 +135,8 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
         _addBatchToBuffer(WithLock::withoutLock(), remoteIndex, remote.getCursorResponse());
         ++remoteIndex;
     }
+    _killRemotesOutsideLimit(WithLock::withoutLock());
+
     // If this is a change stream, then we expect to have already received PBRTs from every shard.
     invariant(_promisedMinSortKeys.empty() || _promisedMinSortKeys.size() == _remotes.size());
     _highWaterMark = _promisedMinSortKeys.empty() ? BSONObj() : _promisedMinSortKeys.begin()->first;
@@ -306,6 +334,10 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
+    }
+    ++_numReturned;
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -368,6 +400,18 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
         adjustedBatchSize = *_params.getBatchSize() - remote.fetchedCount;
     }
 
+    // Every result already returned from the merged stream sorts before anything this remote has
+    // yet to send, as do the results still buffered from it. Don't ask for more than the remainder
+    // of the limit, since the rest would be thrown away.
+    if (_params.getLimit() && _params.getSort() && _tailableMode == TailableModeEnum::kNormal) {
+        const std::int64_t numBuffered = remote.docBuffer.size();
+        const std::int64_t numUseful =
+            std::max<std::int64_t>(1, *_params.getLimit() - _numReturned - numBuffered);
+        if (!adjustedBatchSize || *adjustedBatchSize > numUseful) {
+            adjustedBatchSize = numUseful;
+        }
+    }
+
     BSONObj cmdObj = GetMoreRequest(remote.cursorNss,
                                     remote.cursorId,
                                     adjustedBatchSize,
@@ -418,6 +462,9 @@ Status AsyncResultsMerger::scheduleGetMores() {
 }
 
 Status AsyncResultsMerger::_scheduleGetMores(WithLock lk) {
+    // Don't ask for more results from remotes which can no longer contribute any.
+    _killRemotesOutsideLimit(lk);
+
     // Schedule remote work on hosts for which we need more results.
     for (size_t i = 0; i < _remotes.size(); ++i) {
         auto& remote = _remotes[i];
@@ -582,6 +629,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.cursorId = 0;
     }
 }
@@ -613,6 +662,9 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
         return;
     }
 
+    // The new results may have made this remote or others unnecessary for the merged stream.
+    _killRemotesOutsideLimit(lk);
+
     // If the cursor is tailable and we just received an empty batch, the next return value should
     // be boost::none in order to indicate the end of the batch. We do not ask for the next batch if
     // the cursor is tailable, as batches received from remote tailable cursors should be passed
@@ -660,6 +712,24 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
+
+        if (_sortKeyOrdering) {
+            remote.sortKeyBuffer.push(makeNormalizedSortKey(
+                extractSortKey(obj, _params.getCompareWholeSortKey()), *_sortKeyOrdering));
+            remote.lastSortKey = remote.sortKeyBuffer.back();
+
+            if (_params.getLimit()) {
+                // Keep only the 'limit' smallest keys; a key larger than all of them can never
+                // become one of them.
+                const auto limit = static_cast<size_t>(*_params.getLimit());
+                if (_smallestSortKeys.size() < limit) {
+                    _smallestSortKeys.push(*remote.lastSortKey);
+                } else if (*remote.lastSortKey < _smallestSortKeys.top()) {
+                    _smallestSortKeys.pop();
+                    _smallestSortKeys.push(*remote.lastSortKey);
+                }
+            }
+        }
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
@@ -705,6 +775,37 @@ void AsyncResultsMerger::_scheduleKillCursors(WithLock, OperationContext* opCtx)
     }
 }
 
+void AsyncResultsMerger::_killRemotesOutsideLimit(WithLock) {
+    // A killCursors command can only be scheduled on behalf of an OperationContext. If there is
+    // none, the remotes will be checked again the next time one is attached.
+    if (!_opCtx || _lifecycleState != kAlive || !_sortKeyOrdering || !_params.getLimit() ||
+        _tailableMode != TailableModeEnum::kNormal ||
+        _smallestSortKeys.size() < static_cast<size_t>(*_params.getLimit())) {
+        return;
+    }
+
+    // At least 'limit' results sort at or before this key, so a remote whose remaining results
+    // all sort strictly after it cannot contribute to the merged stream.
+    const auto& largestUsefulSortKey = _smallestSortKeys.top();
+
+    for (auto& remote : _remotes) {
+        if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+            !remote.lastSortKey || *remote.lastSortKey <= largestUsefulSortKey) {
+            continue;
+        }
+
+        BSONObj cmdObj = KillCursorsRequest(_params.getNss(), {remote.cursorId}).toBSON();
+        executor::RemoteCommandRequest request(
+            remote.getTargetHost(), _params.getNss().db().toString(), cmdObj, _opCtx);
+
+        // Send kill request; discard callback handle, if any, or failure report, if not.
+        _executor->scheduleRemoteCommand(request, [](auto const&) {}).getStatus().ignore();
+
+        // Treat the remote as exhausted so that we neither wait for nor ask it for more results.
+        remote.cursorId = 0;
+    }
+}
+
 executor::TaskExecutor::EventHandle AsyncResultsMerger::kill(OperationContext* opCtx) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -777,6 +878,10 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_useNormalizedSortKeys) {
+        return _remotes[lhs].sortKeyBuffer.front() > _remotes[rhs].sortKeyBuffer.front();
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
@@ -31,10 +31,12 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -292,6 +294,14 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The normalized sort keys of the results in 'docBuffer', in the same order. Used only if
+        // there is a sort which can be normalized.
+        std::queue<std::string> sortKeyBuffer;
+
+        // The normalized sort key of the last result received from this remote. Since the remote
+        // returns its results in sort order, nothing it has yet to return can sort before it.
+        boost::optional<std::string> lastSortKey;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -308,8 +318,12 @@ private:
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool useNormalizedSortKeys)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _useNormalizedSortKeys(useNormalizedSortKeys) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -322,6 +336,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, the remotes are ordered by the bytewise comparison of their buffered
+        // normalized sort keys rather than by re-extracting and comparing the BSON sort keys.
+        const bool _useNormalizedSortKeys;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -445,11 +463,23 @@ private:
      */
     void _updateRemoteMetadata(WithLock, size_t remoteIndex, const CursorResponse& response);
 
+    /**
+     * If there is a sort with a limit and 'limit' results have been received, schedules a
+     * killCursors command on every remote whose remaining results all sort after the 'limit'th
+     * smallest result received so far, and marks such remotes as exhausted. Results which are
+     * already buffered from those remotes are still returned.
+     */
+    void _killRemotesOutsideLimit(WithLock);
+
     OperationContext* _opCtx;
     executor::TaskExecutor* _executor;
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // The ordering used to build normalized sort keys. Set only if there is a sort with few enough
+    // fields to be encoded as a KeyString.
+    boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable stdx::mutex _mutex;
 
@@ -460,6 +490,14 @@ private:
     // next document to return, according to the sort order. Used only if there is a sort.
     std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
 
+    // The 'limit' smallest normalized sort keys received from any remote, with the largest of them
+    // on top. Used only if there is a sort with a limit.
+    std::priority_queue<std::string> _smallestSortKeys;
+
+    // The number of results returned by _nextReadySorted(). Every one of them sorts before any
+    // result that the remotes have yet to send.
+    long long _numReturned = 0;
+
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
@@ -1116,6 +1116,110 @@ TEST_F(AsyncResultsMergerTest, GetMoreBatchSizes) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedWithLimitKillsRemotesWhichCannotContribute) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1, $sortKey: {'': 1}}"),
+                                   fromjson("{_id: 2, $sortKey: {'': 2}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch1)));
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5, $sortKey: {'': 5}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, batch2)));
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 0, $sortKey: {'': 0}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[2], kTestShardHosts[2], CursorResponse(kTestNss, 3, batch3)));
+    auto params = makeARMParamsFromExistingCursors(std::move(cursors), findCmd);
+    params.setLimit(2);
+    auto arm = std::make_unique<AsyncResultsMerger>(
+        operationContext(), executor(), std::move(params));
+
+    // The two smallest keys have already been received, so the first two remotes, whose remaining
+    // results all sort after them, have their cursors killed right away.
+    assertKillCusorsCmdHasCursorId(getNthPendingRequest(0u).cmdObj, 1);
+    assertKillCusorsCmdHasCursorId(getNthPendingRequest(1u).cmdObj, 2);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 0, $sortKey: {'': 0}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->ready());
+
+    // Only the third remote is asked for more results, and for no more than the one result still
+    // needed to satisfy the limit.
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    BSONObj scheduledCmd = getNthPendingRequest(2u).cmdObj;
+    auto request = GetMoreRequest::parseFromBSON("anydbname", scheduledCmd);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().cursorid, 3LL);
+    ASSERT_EQ(*request.getValue().batchSize, 1LL);
+
+    // Respond to the two killCursors commands, then to the getMore.
+    scheduleNetworkResponseObjs({BSON("ok" << 1), BSON("ok" << 1)});
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch4 = {fromjson("{_id: 3, $sortKey: {'': 3}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch4);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The results already buffered from the killed remotes are still merged in order.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1, $sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2, $sortKey: {'': 2}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3, $sortKey: {'': 3}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 5, $sortKey: {'': 5}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, SortedWithLimitKillsRemoteOnceItsBatchSortsPastLimit) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: -1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 9, $sortKey: {'': 9}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, batch1)));
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 8, $sortKey: {'': 8}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, batch2)));
+    auto params = makeARMParamsFromExistingCursors(std::move(cursors), findCmd);
+    params.setLimit(2);
+    auto arm = std::make_unique<AsyncResultsMerger>(
+        operationContext(), executor(), std::move(params));
+
+    // Both remotes may still produce one of the two largest results.
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 9, $sortKey: {'': 9}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->ready());
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch3 = {fromjson("{_id: 4, $sortKey: {'': 4}}")};
+    responses.emplace_back(kTestNss, CursorId(1), batch3);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The first remote's latest result sorts after the two best results seen so far, so its
+    // cursor is killed instead of being asked for another batch.
+    assertKillCusorsCmdHasCursorId(getNthPendingRequest(0u).cmdObj, 1);
+    scheduleNetworkResponseObjs({BSON("ok" << 1)});
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 8, $sortKey: {'': 8}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    auto killedEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killedEvent);
+}
+
 TEST_F(AsyncResultsMergerTest, AllowPartialResults) {
     BSONObj findCmd = fromjson("{find: 'testcoll', allowPartialResults: true}");
     std::vector<RemoteCursor> cursors;
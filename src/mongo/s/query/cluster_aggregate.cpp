@@ -68,6 +68,7 @@
 #include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/owned_remote_cursor.h"
@@ -78,6 +79,8 @@
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -726,6 +729,60 @@ void appendEmptyResultSetWithStatus(OperationContext* opCtx,
     appendEmptyResultSet(opCtx, *result, status, nss.ns());
 }
 
+/**
+ * Returns the key under which the results of the aggregation 'request' are kept in the router
+ * result cache, or boost::none if the aggregation is not eligible for caching.
+ */
+boost::optional<std::string> makeResultCacheKey(OperationContext* opCtx,
+                                                const ClusterAggregate::Namespaces& namespaces,
+                                                const AggregationRequest& request) {
+    if (request.getExplain() || namespaces.executionNss.isCollectionlessAggregateNS() ||
+        !ClusterQueryResultCache::isEnabledForOperation(opCtx)) {
+        return boost::none;
+    }
+
+    // Cached results are only invalidated by writes to the aggregated collection, so pipelines
+    // which read from other collections cannot be cached.
+    LiteParsedPipeline litePipe(request);
+    if (litePipe.hasChangeStream() || !litePipe.getInvolvedNamespaces().empty()) {
+        return boost::none;
+    }
+
+    if (ClusterQueryResultCache::hasStageExcludedFromCache(request.getPipeline())) {
+        return boost::none;
+    }
+
+    const auto cmdObj = request.serializeToCommandObj().toBson();
+    if (ClusterQueryResultCache::refersToTimeOfRead(cmdObj)) {
+        return boost::none;
+    }
+
+    return ClusterQueryResultCache::makeKey(
+        namespaces.executionNss, cmdObj, ReadPreferenceSetting::get(opCtx));
+}
+
+/**
+ * Returns the collection the aggregation 'request' writes to through a final $out or $merge stage,
+ * if any.
+ */
+boost::optional<NamespaceString> getOutputNss(const AggregationRequest& request) {
+    if (request.getExplain() || request.getPipeline().empty()) {
+        return boost::none;
+    }
+
+    const auto& lastStage = request.getPipeline().back();
+    const auto stageName = lastStage.firstElementFieldNameStringData();
+    if (stageName != "$out" && stageName != "$merge") {
+        return boost::none;
+    }
+
+    // The only namespace $out and $merge involve is the one they write to.
+    const auto involvedNamespaces =
+        LiteParsedDocumentSource::parse(request, lastStage)->getInvolvedNamespaces();
+    invariant(involvedNamespaces.size() == 1u);
+    return *involvedNamespaces.begin();
+}
+
 }  // namespace
 
 Status ClusterAggregate::runAggregate(OperationContext* opCtx,
@@ -733,6 +790,65 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
                                       const AggregationRequest& request,
                                       const PrivilegeVector& privileges,
                                       BSONObjBuilder* result) {
+    // Cached results of reads of the collection a pipeline writes to may no longer reflect its
+    // contents, whether or not the pipeline succeeds.
+    if (auto outputNss = getOutputNss(request)) {
+        ON_BLOCK_EXIT([&] { ClusterQueryResultCache::get(opCtx)->invalidate(*outputNss); });
+        return _runAggregate(opCtx, namespaces, request, privileges, result);
+    }
+
+    const auto resultCacheKey = makeResultCacheKey(opCtx, namespaces, request);
+    if (!resultCacheKey) {
+        return _runAggregate(opCtx, namespaces, request, privileges, result);
+    }
+
+    auto routingInfoStatus =
+        sharded_agg_helpers::getExecutionNsRoutingInfo(opCtx, namespaces.executionNss);
+    if (!routingInfoStatus.isOK()) {
+        return _runAggregate(opCtx, namespaces, request, privileges, result);
+    }
+
+    auto const resultCache = ClusterQueryResultCache::get(opCtx);
+    auto const clock = opCtx->getServiceContext()->getFastClockSource();
+    const auto routingVersion =
+        ClusterQueryResultCache::RoutingVersion::make(routingInfoStatus.getValue());
+
+    // If the same aggregation recently completed against the current routing table, return its
+    // results without contacting the shards.
+    if (auto cachedResults = resultCache->lookup(*resultCacheKey, routingVersion, clock->now())) {
+        CurOp::get(opCtx)->debug().nreturned = cachedResults->size();
+        CurOp::get(opCtx)->debug().cursorExhausted = true;
+        CursorResponse(namespaces.requestedNss, CursorId(0), std::move(*cachedResults))
+            .addToBSON(CursorResponse::ResponseType::InitialResponse, result);
+        return Status::OK();
+    }
+
+    const auto generation = resultCache->getGeneration(namespaces.executionNss);
+    auto status = _runAggregate(opCtx, namespaces, request, privileges, result);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Only results which were returned in full can be served from the cache.
+    auto swCursorResponse = CursorResponse::parseFromBSON(result->asTempObj());
+    if (swCursorResponse.isOK() && swCursorResponse.getValue().getCursorId() == 0) {
+        resultCache->insert(
+            *resultCacheKey,
+            namespaces.executionNss,
+            generation,
+            routingVersion,
+            swCursorResponse.getValue().releaseBatch(),
+            clock->now() + Milliseconds(internalQueryRouterResultCacheTTLMillis.load()));
+    }
+
+    return status;
+}
+
+Status ClusterAggregate::_runAggregate(OperationContext* opCtx,
+                                       const Namespaces& namespaces,
+                                       const AggregationRequest& request,
+                                       const PrivilegeVector& privileges,
+                                       BSONObjBuilder* result) {
     uassert(51028, "Cannot specify exchange option to a mongos", !request.getExchangeSpec());
     uassert(51143,
             "Cannot specify runtime constants option to a mongos",
@@ -105,6 +105,16 @@ public:
                                    unsigned numberRetries = 0);
 
 private:
+    /**
+     * Executes the aggregation 'request' against the shards. Called by runAggregate() when the
+     * results cannot be served from the router result cache.
+     */
+    static Status _runAggregate(OperationContext* opCtx,
+                                const Namespaces& namespaces,
+                                const AggregationRequest& request,
+                                const PrivilegeVector& privileges,
+                                BSONObjBuilder* result);
+
     static Status aggPassthrough(OperationContext*,
                                  const Namespaces&,
                                  const ShardId&,
@@ -85,6 +85,12 @@ struct ClusterClientCursorParams {
         armParams.setRemotes(std::move(remotes));
         armParams.setTailableMode(tailableMode);
         armParams.setBatchSize(batchSize);
+        if (!sort.isEmpty() && limit) {
+            // The skip is applied on top of the merged stream, so the merger has to produce
+            // 'skip' + 'limit' results. The sum has already been checked for overflow when
+            // building the requests for the shards.
+            armParams.setLimit(*limit + skip.value_or(0));
+        }
         armParams.setNss(nsString);
         armParams.setAllowPartialResults(isAllowPartialResults);
 
@@ -59,6 +59,8 @@
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
@@ -364,6 +366,27 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
     return cursorId;
 }
 
+/**
+ * Returns the key under which the results of 'query' are kept in the router result cache, or
+ * boost::none if the query is not eligible for caching.
+ */
+boost::optional<std::string> makeResultCacheKey(OperationContext* opCtx,
+                                                const CanonicalQuery& query,
+                                                const ReadPreferenceSetting& readPref) {
+    const auto& qr = query.getQueryRequest();
+    if (qr.isTailable() || qr.isAllowPartialResults() ||
+        !ClusterQueryResultCache::isEnabledForOperation(opCtx)) {
+        return boost::none;
+    }
+
+    const auto findCmd = qr.asFindCommand();
+    if (ClusterQueryResultCache::refersToTimeOfRead(findCmd)) {
+        return boost::none;
+    }
+
+    return ClusterQueryResultCache::makeKey(query.nss(), findCmd, readPref);
+}
+
 /**
  * Populates or re-populates some state of the OperationContext from what's stored on the cursor
  * and/or what's specified on the request.
@@ -415,6 +438,10 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
     }
 
     auto const catalogCache = Grid::get(opCtx)->catalogCache();
+    auto const resultCache = ClusterQueryResultCache::get(opCtx);
+    auto const clock = opCtx->getServiceContext()->getFastClockSource();
+
+    const auto resultCacheKey = makeResultCacheKey(opCtx, query, readPref);
 
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
@@ -427,9 +454,37 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
         }
 
         auto routingInfo = uassertStatusOK(routingInfoStatus);
+        const auto routingVersion = ClusterQueryResultCache::RoutingVersion::make(routingInfo);
+
+        // If the same query recently completed against the current routing table, return its
+        // results without contacting the shards.
+        if (resultCacheKey) {
+            if (auto cachedResults =
+                    resultCache->lookup(*resultCacheKey, routingVersion, clock->now())) {
+                *results = std::move(*cachedResults);
+                CurOp::get(opCtx)->debug().nreturned = results->size();
+                CurOp::get(opCtx)->debug().cursorExhausted = true;
+                return CursorId(0);
+            }
+        }
 
         try {
-            return runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            const auto generation = resultCache->getGeneration(query.nss());
+            const auto cursorId =
+                runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+
+            // Only results which were returned in full can be served from the cache.
+            if (resultCacheKey && cursorId == 0) {
+                resultCache->insert(
+                    *resultCacheKey,
+                    query.nss(),
+                    generation,
+                    routingVersion,
+                    *results,
+                    clock->now() + Milliseconds(internalQueryRouterResultCacheTTLMillis.load()));
+            }
+
+            return cursorId;
         } catch (DBException& ex) {
             if (retries >= kMaxRetries) {
                 // Check if there are no retries remaining, so the last received error can be
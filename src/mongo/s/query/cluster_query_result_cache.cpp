@@ -0,0 +1,415 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/database_version_helpers.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/s/transaction_router.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+const auto getClusterQueryResultCache =
+    ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+// Generic command arguments which do not change the documents a read returns, and so are left out
+// of the cache key. The read concern is always "majority" for reads which use the cache.
+const StringDataSet kFieldsExcludedFromKey{"$clusterTime",
+                                           "$db",
+                                           "$readPreference",
+                                           "autocommit",
+                                           "comment",
+                                           "lsid",
+                                           "maxTimeMS",
+                                           "readConcern",
+                                           "txnNumber",
+                                           "writeConcern"};
+
+// Stages whose output depends on more than the contents of the aggregated collection, or which
+// write, and so whose results must never be served from the cache.
+const StringDataSet kStagesExcludedFromCache{"$collStats",
+                                             "$currentOp",
+                                             "$indexStats",
+                                             "$listLocalSessions",
+                                             "$listSessions",
+                                             "$merge",
+                                             "$out",
+                                             "$planCacheStats",
+                                             "$sample"};
+
+bool elementRefersToTimeOfRead(const BSONElement& elem) {
+    switch (elem.type()) {
+        case String: {
+            // A variable reference is "$$<name>", optionally followed by a path.
+            auto value = elem.valueStringData();
+            if (!value.startsWith("$$")) {
+                return false;
+            }
+            const auto variable = value.substr(2, value.find('.') - 2);
+            return variable == "NOW" || variable == "CLUSTER_TIME";
+        }
+        case Object:
+        case Array:
+            for (auto&& child : elem.Obj()) {
+                if (elementRefersToTimeOfRead(child)) {
+                    return true;
+                }
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+ClusterQueryResultCache::RoutingVersion ClusterQueryResultCache::RoutingVersion::make(
+    const CachedCollectionRoutingInfo& routingInfo) {
+    RoutingVersion version;
+    if (auto cm = routingInfo.cm()) {
+        version.collectionVersion = cm->getVersion();
+    } else {
+        version.databaseVersion = routingInfo.db().databaseVersion();
+    }
+    return version;
+}
+
+bool ClusterQueryResultCache::RoutingVersion::matches(const RoutingVersion& other) const {
+    if (collectionVersion || other.collectionVersion) {
+        return collectionVersion && other.collectionVersion &&
+            *collectionVersion == *other.collectionVersion;
+    }
+
+    if (databaseVersion || other.databaseVersion) {
+        return databaseVersion && other.databaseVersion &&
+            databaseVersion::equal(*databaseVersion, *other.databaseVersion);
+    }
+
+    return true;
+}
+
+ClusterQueryResultCache::ClusterQueryResultCache()
+    : _cache(std::numeric_limits<std::size_t>::max()) {}
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return &getClusterQueryResultCache(serviceContext);
+}
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool ClusterQueryResultCache::isEnabledForOperation(OperationContext* opCtx) {
+    if (internalQueryRouterResultCacheTTLMillis.load() <= 0) {
+        return false;
+    }
+
+    if (TransactionRouter::get(opCtx)) {
+        return false;
+    }
+
+    // Reads at a specific point in time, or which must observe a previous write of the session,
+    // cannot be answered from a result computed earlier.
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    return readConcernArgs.getLevel() == repl::ReadConcernLevel::kMajorityReadConcern &&
+        !readConcernArgs.getArgsAfterClusterTime() && !readConcernArgs.getArgsAtClusterTime();
+}
+
+bool ClusterQueryResultCache::refersToTimeOfRead(const BSONObj& cmdObj) {
+    for (auto&& elem : cmdObj) {
+        if (elementRefersToTimeOfRead(elem)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ClusterQueryResultCache::hasStageExcludedFromCache(const std::vector<BSONObj>& pipeline) {
+    for (auto&& stage : pipeline) {
+        const auto stageName = stage.firstElementFieldNameStringData();
+        if (kStagesExcludedFromCache.count(stageName)) {
+            return true;
+        }
+        if (stageName != "$facet") {
+            continue;
+        }
+
+        // Malformed $facet specifications are rejected when the pipeline is parsed, so they are
+        // simply treated as not cacheable here.
+        const auto facets = stage.firstElement();
+        if (facets.type() != Object) {
+            return true;
+        }
+        for (auto&& facet : facets.Obj()) {
+            if (facet.type() != Array) {
+                return true;
+            }
+            std::vector<BSONObj> subPipeline;
+            for (auto&& subStage : facet.Obj()) {
+                if (subStage.type() != Object) {
+                    return true;
+                }
+                subPipeline.push_back(subStage.Obj());
+            }
+            if (hasStageExcludedFromCache(subPipeline)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+Status ClusterQueryResultCache::onUpdateTTLMillis(const int& newValue) {
+    if (newValue <= 0 && hasGlobalServiceContext()) {
+        get(getGlobalServiceContext())->clear();
+    }
+    return Status::OK();
+}
+
+std::string ClusterQueryResultCache::makeKey(const NamespaceString& nss,
+                                             const BSONObj& cmdObj,
+                                             const ReadPreferenceSetting& readPref) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", nss.ns());
+    {
+        BSONObjBuilder cmdBuilder(keyBuilder.subobjStart("cmd"));
+        for (auto&& elem : cmdObj) {
+            if (!kFieldsExcludedFromKey.count(elem.fieldNameStringData())) {
+                cmdBuilder.append(elem);
+            }
+        }
+    }
+    keyBuilder.append("readPreference", readPref.toInnerBSON());
+
+    const auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+boost::optional<std::vector<BSONObj>> ClusterQueryResultCache::lookup(
+    const std::string& key, const RoutingVersion& version, Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _cache.find(key);
+    if (it == _cache.end()) {
+        ++_numMisses;
+        return boost::none;
+    }
+
+    if (it->second.expiresAt <= now || !it->second.version.matches(version)) {
+        _erase(lk, it);
+        ++_numMisses;
+        return boost::none;
+    }
+
+    ++_numHits;
+    return _cache.promote(it)->second.results;
+}
+
+ClusterQueryResultCache::Generation ClusterQueryResultCache::getGeneration(
+    const NamespaceString& nss) const {
+    return _generations[_generationBucket(nss)].load();
+}
+
+void ClusterQueryResultCache::insert(const std::string& key,
+                                     const NamespaceString& nss,
+                                     Generation generation,
+                                     RoutingVersion version,
+                                     std::vector<BSONObj> results,
+                                     Date_t expiresAt) {
+    Entry entry;
+    entry.nss = nss;
+    entry.version = std::move(version);
+    entry.expiresAt = expiresAt;
+    // The key is held twice, by the cache and by the index of keys by namespace.
+    entry.sizeBytes = 2 * key.size();
+    for (auto& result : results) {
+        result = result.getOwned();
+        entry.sizeBytes += result.objsize();
+    }
+    entry.results = std::move(results);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Writes skip invalidation while the cache is disabled.
+    if (internalQueryRouterResultCacheTTLMillis.load() <= 0) {
+        return;
+    }
+
+    auto it = _cache.find(key);
+    if (it != _cache.end()) {
+        _erase(lk, it);
+    }
+
+    _sizeBytes += entry.sizeBytes;
+    _keysByNss[nss.ns()].insert(key);
+    _cache.add(key, std::move(entry));
+    _numEntries.store(_cache.size());
+
+    // A write which bumps the generation after this check either sees the entry counted above, and
+    // removes it under the mutex, or has been seen by the check.
+    if (_generations[_generationBucket(nss)].load() != generation) {
+        _erase(lk, _cache.find(key));
+        return;
+    }
+
+    _evictToLimits(lk);
+}
+
+void ClusterQueryResultCache::invalidate(const NamespaceString& nss) {
+    if (internalQueryRouterResultCacheTTLMillis.load() <= 0) {
+        return;
+    }
+
+    // Reads of 'nss' in progress may have read from the shards before the write, so they must not
+    // cache their results even if nothing is cached yet.
+    _generations[_generationBucket(nss)].fetchAndAdd(1);
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto keysIt = _keysByNss.find(nss.ns());
+    if (keysIt == _keysByNss.end()) {
+        return;
+    }
+
+    // Erasing the last entry of the namespace erases the set of its keys.
+    const auto keys = keysIt->second;
+    for (auto&& key : keys) {
+        _erase(lk, _cache.find(key));
+        ++_numInvalidations;
+    }
+}
+
+void ClusterQueryResultCache::invalidateDatabase(StringData dbName) {
+    if (internalQueryRouterResultCacheTTLMillis.load() <= 0) {
+        return;
+    }
+
+    // The collections of the database are not known, so every bucket must move on.
+    for (auto& generation : _generations) {
+        generation.fetchAndAdd(1);
+    }
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    for (auto it = _cache.begin(); it != _cache.end();) {
+        if (it->second.nss.db() == dbName) {
+            it = _erase(lk, it);
+            ++_numInvalidations;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ClusterQueryResultCache::clear() {
+    // Reads in progress must not cache their results afterwards either.
+    for (auto& generation : _generations) {
+        generation.fetchAndAdd(1);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cache.clear();
+    _keysByNss.clear();
+    _numEntries.store(0);
+    _sizeBytes = 0;
+}
+
+size_t ClusterQueryResultCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _cache.size();
+}
+
+size_t ClusterQueryResultCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+void ClusterQueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->appendNumber("entries", static_cast<long long>(_cache.size()));
+    builder->appendNumber("sizeBytes", static_cast<long long>(_sizeBytes));
+    builder->appendNumber("hits", _numHits);
+    builder->appendNumber("misses", _numMisses);
+    builder->appendNumber("evictions", _numEvictions);
+    builder->appendNumber("invalidations", _numInvalidations);
+}
+
+size_t ClusterQueryResultCache::_generationBucket(const NamespaceString& nss) {
+    return StringMapHasher{}(nss.ns()) % kNumGenerationBuckets;
+}
+
+ClusterQueryResultCache::Cache::iterator ClusterQueryResultCache::_erase(WithLock,
+                                                                       Cache::iterator it) {
+    invariant(_sizeBytes >= it->second.sizeBytes);
+    _sizeBytes -= it->second.sizeBytes;
+
+    auto keysIt = _keysByNss.find(it->second.nss.ns());
+    invariant(keysIt != _keysByNss.end());
+    keysIt->second.erase(it->first);
+    if (keysIt->second.empty()) {
+        _keysByNss.erase(keysIt);
+    }
+
+    auto next = _cache.erase(it);
+    _numEntries.store(_cache.size());
+    return next;
+}
+
+void ClusterQueryResultCache::_evictToLimits(WithLock lk) {
+    const auto maxEntries = static_cast<size_t>(internalQueryRouterResultCacheMaxEntries.load());
+    const auto maxSizeBytes =
+        static_cast<size_t>(internalQueryRouterResultCacheMaxSizeBytes.load());
+
+    // The least recently used entry is at the back of the cache.
+    while (!_cache.empty() && (_cache.size() > maxEntries || _sizeBytes > maxSizeBytes)) {
+        _erase(lk, std::prev(_cache.end()));
+        ++_numEvictions;
+    }
+}
+
+}  // namespace mongo
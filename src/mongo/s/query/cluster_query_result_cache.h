@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/database_version_gen.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class CachedCollectionRoutingInfo;
+class OperationContext;
+class ServiceContext;
+struct ReadPreferenceSetting;
+
+/**
+ * Caches the complete results of find and aggregate commands run through mongos, so that repeated
+ * read-only queries over collections which rarely change can be answered without contacting the
+ * shards.
+ *
+ * Only results which fit entirely in the first batch are cached, and only for operations which
+ * read at readConcern "majority" outside of a transaction and without a causal consistency
+ * requirement, and which do not refer to the time of the read through $$NOW or $$CLUSTER_TIME. A
+ * cached result is served only while
+ *  - it is younger than internalQueryRouterResultCacheTTLMillis,
+ *  - the routing table of the collection has the same version it was computed against, and
+ *  - this mongos has not routed a write or DDL operation on the collection since the read which
+ *    computed it started.
+ *
+ * Writes routed through other mongos instances are not observed, so the TTL bounds how stale a
+ * cached result may be. The cache is disabled, and emptied, while the TTL is 0, which is the
+ * default.
+ *
+ * This class is thread-safe.
+ */
+class ClusterQueryResultCache {
+    ClusterQueryResultCache(const ClusterQueryResultCache&) = delete;
+    ClusterQueryResultCache& operator=(const ClusterQueryResultCache&) = delete;
+
+public:
+    /**
+     * The version of the routing information a result was computed against. For a sharded
+     * collection this is the collection version, which is bumped whenever the version of any shard
+     * owning chunks of the collection changes. For an unsharded collection it is the version of the
+     * database, which changes when the database moves to another primary shard.
+     */
+    struct RoutingVersion {
+        static RoutingVersion make(const CachedCollectionRoutingInfo& routingInfo);
+
+        bool matches(const RoutingVersion& other) const;
+
+        boost::optional<ChunkVersion> collectionVersion;
+        boost::optional<DatabaseVersion> databaseVersion;
+    };
+
+    /**
+     * Counts the writes routed to a namespace. A read takes the generation of its namespace before
+     * it contacts the shards, and its results are not cached if a write may have happened since.
+     */
+    using Generation = unsigned long long;
+
+    ClusterQueryResultCache();
+
+    static ClusterQueryResultCache* get(ServiceContext* serviceContext);
+    static ClusterQueryResultCache* get(OperationContext* opCtx);
+
+    /**
+     * Returns whether the results of the read currently running on 'opCtx' may be served from, and
+     * stored in, the cache.
+     */
+    static bool isEnabledForOperation(OperationContext* opCtx);
+
+    /**
+     * Returns whether the command 'cmdObj' refers to the $$NOW or $$CLUSTER_TIME variables, whose
+     * values differ between runs, so that its results must not be cached.
+     */
+    static bool refersToTimeOfRead(const BSONObj& cmdObj);
+
+    /**
+     * Returns whether the aggregation 'pipeline' contains, at the top level or inside a $facet, a
+     * stage whose output depends on more than the contents of the aggregated collection, or which
+     * writes, so that its results must not be cached.
+     */
+    static bool hasStageExcludedFromCache(const std::vector<BSONObj>& pipeline);
+
+    /**
+     * Empties the cache when the TTL is set to 0. Writes do not invalidate cached results while
+     * the cache is disabled, so entries from before then could otherwise be served once it is
+     * enabled again.
+     */
+    static Status onUpdateTTLMillis(const int& newValue);
+
+    /**
+     * Builds the key under which the results of the command 'cmdObj' against 'nss' are cached.
+     * Fields of the command which do not affect its results, such as maxTimeMS or comment, are
+     * left out of the key.
+     */
+    static std::string makeKey(const NamespaceString& nss,
+                               const BSONObj& cmdObj,
+                               const ReadPreferenceSetting& readPref);
+
+    /**
+     * Returns the results cached under 'key' if they were computed against 'version' and have not
+     * expired as of 'now'. Stale entries found on the way are removed.
+     */
+    boost::optional<std::vector<BSONObj>> lookup(const std::string& key,
+                                                 const RoutingVersion& version,
+                                                 Date_t now);
+
+    /**
+     * Returns the current generation of 'nss', to be passed to insert() by a read which is about to
+     * contact the shards.
+     */
+    Generation getGeneration(const NamespaceString& nss) const;
+
+    /**
+     * Caches 'results' for the command with key 'key' against 'nss', replacing any previous entry.
+     * The entry expires at 'expiresAt'. Does nothing if the cache has been disabled, or if 'nss'
+     * is no longer at 'generation', since the results may then predate a write. Evicts least
+     * recently used entries as needed to stay within the configured entry and size limits.
+     */
+    void insert(const std::string& key,
+                const NamespaceString& nss,
+                Generation generation,
+                RoutingVersion version,
+                std::vector<BSONObj> results,
+                Date_t expiresAt);
+
+    /**
+     * Drops all cached results for the collection 'nss', and keeps results of reads of 'nss' which
+     * are in progress from being cached. Called when a write or DDL operation on 'nss' is routed
+     * through this mongos. Cheap while the cache is disabled or empty.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Like invalidate(), for every collection of the database 'dbName'.
+     */
+    void invalidateDatabase(StringData dbName);
+
+    /**
+     * Drops every cached result, and keeps the results of reads in progress from being cached.
+     */
+    void clear();
+
+    size_t size() const;
+
+    size_t sizeBytes() const;
+
+    /**
+     * Reports the hit, miss and eviction counters together with the current size of the cache.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        NamespaceString nss;
+        RoutingVersion version;
+        Date_t expiresAt;
+        std::vector<BSONObj> results;
+        size_t sizeBytes = 0;
+    };
+
+    using Cache = LRUCache<std::string, Entry>;
+
+    // Generations are kept for a fixed number of buckets of namespaces, so that namespaces which
+    // have nothing cached take no space. A write to a namespace prevents caching the results of
+    // reads in progress of all the namespaces of its bucket.
+    static constexpr size_t kNumGenerationBuckets = 1024;
+
+    static size_t _generationBucket(const NamespaceString& nss);
+
+    Cache::iterator _erase(WithLock, Cache::iterator it);
+
+    void _evictToLimits(WithLock);
+
+    std::array<AtomicWord<Generation>, kNumGenerationBuckets> _generations;
+
+    // Mirrors the size of '_cache', so that writes can tell without locking that there is nothing
+    // to invalidate.
+    AtomicWord<size_t> _numEntries{0};
+
+    mutable stdx::mutex _mutex;
+
+    Cache _cache;
+
+    // The keys of the entries of '_cache' for each namespace.
+    StringMap<StringSet> _keysByNss;
+
+    // Total size of the results currently held in '_cache'.
+    size_t _sizeBytes{0};
+
+    long long _numHits{0};
+    long long _numMisses{0};
+    long long _numEvictions{0};
+    long long _numInvalidations{0};
+};
+
+}  // namespace mongo
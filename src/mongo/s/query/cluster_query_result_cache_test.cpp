@@ -0,0 +1,277 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/s/database_version_helpers.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("testdb", "testcoll");
+const NamespaceString kOtherNss("testdb", "othercoll");
+
+class ClusterQueryResultCacheTest : public unittest::Test {
+protected:
+    ClusterQueryResultCacheTest()
+        : _savedTTLMillis(internalQueryRouterResultCacheTTLMillis.load()),
+          _savedMaxEntries(internalQueryRouterResultCacheMaxEntries.load()),
+          _savedMaxSizeBytes(internalQueryRouterResultCacheMaxSizeBytes.load()) {
+        internalQueryRouterResultCacheTTLMillis.store(1000);
+    }
+
+    ~ClusterQueryResultCacheTest() {
+        internalQueryRouterResultCacheTTLMillis.store(_savedTTLMillis);
+        internalQueryRouterResultCacheMaxEntries.store(_savedMaxEntries);
+        internalQueryRouterResultCacheMaxSizeBytes.store(_savedMaxSizeBytes);
+    }
+
+    static ClusterQueryResultCache::RoutingVersion shardedVersion(ChunkVersion version) {
+        ClusterQueryResultCache::RoutingVersion routingVersion;
+        routingVersion.collectionVersion = version;
+        return routingVersion;
+    }
+
+    static std::string makeFindKey(const NamespaceString& nss, const BSONObj& filter) {
+        return ClusterQueryResultCache::makeKey(
+            nss,
+            BSON("find" << nss.coll() << "filter" << filter),
+            ReadPreferenceSetting(ReadPreference::PrimaryOnly));
+    }
+
+    const Date_t _now = Date_t::fromMillisSinceEpoch(100000);
+    const ClusterQueryResultCache::RoutingVersion _version =
+        shardedVersion(ChunkVersion(1, 0, OID::gen()));
+
+    ClusterQueryResultCache _cache;
+
+    /**
+     * Caches 'results' for 'key' as a read of 'nss' which started now would.
+     */
+    void insert(const std::string& key,
+                const NamespaceString& nss,
+                const ClusterQueryResultCache::RoutingVersion& version,
+                std::vector<BSONObj> results) {
+        _cache.insert(
+            key, nss, _cache.getGeneration(nss), version, std::move(results), _now + Seconds(1));
+    }
+
+private:
+    const int _savedTTLMillis;
+    const int _savedMaxEntries;
+    const long long _savedMaxSizeBytes;
+};
+
+TEST_F(ClusterQueryResultCacheTest, LookupMissesWhenNothingCached) {
+    ASSERT_FALSE(_cache.lookup(makeFindKey(kNss, BSON("a" << 1)), _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, LookupReturnsCachedResults) {
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    insert(key, kNss, _version, {BSON("a" << 1 << "b" << 1)});
+
+    auto results = _cache.lookup(key, _version, _now);
+    ASSERT(results);
+    ASSERT_EQ(1U, results->size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 1), results->front());
+
+    ASSERT_FALSE(_cache.lookup(makeFindKey(kNss, BSON("a" << 2)), _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ExpiredEntryIsNotReturned) {
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    insert(key, kNss, _version, {BSON("a" << 1)});
+
+    ASSERT_FALSE(_cache.lookup(key, _version, _now + Seconds(1)));
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(ClusterQueryResultCacheTest, ChangedRoutingVersionIsNotReturned) {
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    insert(key, kNss, _version, {BSON("a" << 1)});
+
+    auto newVersion = *_version.collectionVersion;
+    newVersion.incMinor();
+    ASSERT_FALSE(_cache.lookup(key, shardedVersion(newVersion), _now));
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(ClusterQueryResultCacheTest, UnshardedEntryIsNotReturnedOnceCollectionIsSharded) {
+    ClusterQueryResultCache::RoutingVersion unshardedVersion;
+    unshardedVersion.databaseVersion = databaseVersion::makeNew();
+
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    insert(key, kNss, unshardedVersion, {BSON("a" << 1)});
+    ASSERT(_cache.lookup(key, unshardedVersion, _now));
+
+    ASSERT_FALSE(_cache.lookup(key, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, InvalidateOnlyDropsEntriesForNamespace) {
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    const auto otherKey = makeFindKey(kOtherNss, BSON("a" << 1));
+    insert(key, kNss, _version, {BSON("a" << 1)});
+    insert(otherKey, kOtherNss, _version, {BSON("a" << 1)});
+
+    _cache.invalidate(kNss);
+
+    ASSERT_FALSE(_cache.lookup(key, _version, _now));
+    ASSERT(_cache.lookup(otherKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, InvalidateDatabaseDropsEntriesForItsCollections) {
+    const NamespaceString otherDbNss("otherdb", "testcoll");
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+    const auto otherKey = makeFindKey(kOtherNss, BSON("a" << 1));
+    const auto otherDbKey = makeFindKey(otherDbNss, BSON("a" << 1));
+    insert(key, kNss, _version, {BSON("a" << 1)});
+    insert(otherKey, kOtherNss, _version, {BSON("a" << 1)});
+    insert(otherDbKey, otherDbNss, _version, {BSON("a" << 1)});
+
+    _cache.invalidateDatabase(kNss.db());
+
+    ASSERT_FALSE(_cache.lookup(key, _version, _now));
+    ASSERT_FALSE(_cache.lookup(otherKey, _version, _now));
+    ASSERT(_cache.lookup(otherDbKey, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultsOfReadRacingWithWriteAreNotCached) {
+    const auto key = makeFindKey(kNss, BSON("a" << 1));
+
+    // The write is routed after the read took the generation, but before it finished.
+    const auto generation = _cache.getGeneration(kNss);
+    _cache.invalidate(kNss);
+    _cache.insert(key, kNss, generation, _version, {BSON("a" << 1)}, _now + Seconds(1));
+
+    ASSERT_EQ(0U, _cache.size());
+    ASSERT_EQ(0U, _cache.sizeBytes());
+
+    // A read which starts after the write can cache its results.
+    insert(key, kNss, _version, {BSON("a" << 1)});
+    ASSERT(_cache.lookup(key, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultsAreNotCachedWhileDisabled) {
+    internalQueryRouterResultCacheTTLMillis.store(0);
+
+    insert(makeFindKey(kNss, BSON("a" << 1)), kNss, _version, {BSON("a" << 1)});
+    ASSERT_EQ(0U, _cache.size());
+}
+
+TEST_F(ClusterQueryResultCacheTest, CommandsReferringToTimeOfReadAreDetected) {
+    ASSERT_FALSE(ClusterQueryResultCache::refersToTimeOfRead(
+        BSON("find" << kNss.coll() << "filter" << BSON("a" << "$$NOWHERE"))));
+    ASSERT_TRUE(ClusterQueryResultCache::refersToTimeOfRead(
+        fromjson("{find: 'testcoll', filter: {$expr: {$lt: ['$a', '$$NOW']}}}")));
+    ASSERT_TRUE(ClusterQueryResultCache::refersToTimeOfRead(
+        fromjson("{aggregate: 'testcoll', pipeline: [{$addFields: {t: '$$CLUSTER_TIME'}}]}")));
+}
+
+TEST_F(ClusterQueryResultCacheTest, PipelinesWithExcludedStagesAreDetected) {
+    ASSERT_FALSE(ClusterQueryResultCache::hasStageExcludedFromCache(
+        {fromjson("{$match: {a: 1}}"), fromjson("{$facet: {x: [{$count: 'n'}]}}")}));
+    ASSERT_TRUE(ClusterQueryResultCache::hasStageExcludedFromCache(
+        {fromjson("{$match: {a: 1}}"), fromjson("{$sample: {size: 1}}")}));
+    ASSERT_TRUE(ClusterQueryResultCache::hasStageExcludedFromCache(
+        {fromjson("{$facet: {x: [{$count: 'n'}], y: [{$sample: {size: 1}}]}}")}));
+    ASSERT_TRUE(ClusterQueryResultCache::hasStageExcludedFromCache(
+        {fromjson("{$facet: {x: [{$facet: {y: [{$collStats: {count: {}}}]}}]}}")}));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EvictsLeastRecentlyUsedPastMaxEntries) {
+    internalQueryRouterResultCacheMaxEntries.store(2);
+
+    const auto key1 = makeFindKey(kNss, BSON("a" << 1));
+    const auto key2 = makeFindKey(kNss, BSON("a" << 2));
+    const auto key3 = makeFindKey(kNss, BSON("a" << 3));
+    insert(key1, kNss, _version, {BSON("a" << 1)});
+    insert(key2, kNss, _version, {BSON("a" << 2)});
+
+    // Using the first entry makes the second one the least recently used.
+    ASSERT(_cache.lookup(key1, _version, _now));
+    insert(key3, kNss, _version, {BSON("a" << 3)});
+
+    ASSERT_EQ(2U, _cache.size());
+    ASSERT(_cache.lookup(key1, _version, _now));
+    ASSERT_FALSE(_cache.lookup(key2, _version, _now));
+    ASSERT(_cache.lookup(key3, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EvictsLeastRecentlyUsedPastMaxSizeBytes) {
+    const std::string bigString(1024, 'x');
+    const auto key1 = makeFindKey(kNss, BSON("a" << 1));
+    const auto key2 = makeFindKey(kNss, BSON("a" << 2));
+
+    insert(key1, kNss, _version, {BSON("a" << bigString)});
+    internalQueryRouterResultCacheMaxSizeBytes.store(_cache.sizeBytes() + 100);
+
+    insert(key2, kNss, _version, {BSON("a" << bigString)});
+
+    ASSERT_EQ(1U, _cache.size());
+    ASSERT_FALSE(_cache.lookup(key1, _version, _now));
+    ASSERT(_cache.lookup(key2, _version, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultTooLargeForCacheIsNotKept) {
+    internalQueryRouterResultCacheMaxSizeBytes.store(16);
+
+    insert(makeFindKey(kNss, BSON("a" << 1)), kNss, _version, {BSON("a" << 1)});
+
+    ASSERT_EQ(0U, _cache.size());
+    ASSERT_EQ(0U, _cache.sizeBytes());
+}
+
+TEST_F(ClusterQueryResultCacheTest, KeyIgnoresArgumentsWhichDoNotAffectResults) {
+    const auto readPref = ReadPreferenceSetting(ReadPreference::PrimaryOnly);
+    const auto cmdObj = BSON("find" << kNss.coll() << "filter" << BSON("a" << 1));
+
+    ASSERT_EQ(ClusterQueryResultCache::makeKey(kNss, cmdObj, readPref),
+              ClusterQueryResultCache::makeKey(
+                  kNss,
+                  BSON("find" << kNss.coll() << "filter" << BSON("a" << 1) << "maxTimeMS" << 100
+                              << "comment"
+                              << "dashboard"),
+                  readPref));
+
+    ASSERT_NE(ClusterQueryResultCache::makeKey(kNss, cmdObj, readPref),
+              ClusterQueryResultCache::makeKey(
+                  kNss, cmdObj, ReadPreferenceSetting(ReadPreference::SecondaryPreferred)));
+    ASSERT_NE(ClusterQueryResultCache::makeKey(kNss, cmdObj, readPref),
+              ClusterQueryResultCache::makeKey(kOtherNss, cmdObj, readPref));
+}
+
+}  // namespace
+}  // namespace mongo
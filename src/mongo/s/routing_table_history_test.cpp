@@ -32,6 +32,7 @@
 #include "mongo/s/chunk_manager.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
@@ -318,5 +319,85 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+TEST_F(RoutingTableHistoryTest, UpdatingLargeRoutingTableLeavesPreviousVersionIntact) {
+    // Use enough chunks for the routing table to be split into several blocks internally
+    std::vector<BSONObj> boundaryPoints{getShardKeyPattern().globalMin()};
+    for (int i = 0; i < 2000; ++i) {
+        boundaryPoints.push_back(BSON("a" << i * 10));
+    }
+    boundaryPoints.push_back(getShardKeyPattern().globalMax());
+
+    auto rt = splitChunk(getInitialRoutingTable(), boundaryPoints);
+    ASSERT_EQ(rt->getChunkMap().size(), 2001ull);
+
+    // Split a chunk in the middle of the routing table
+    auto updatedRt = splitChunk(rt, {BSON("a" << 10000), BSON("a" << 10005), BSON("a" << 10010)});
+    ASSERT_EQ(updatedRt->getChunkMap().size(), 2002ull);
+    ASSERT_EQ(rt->getChunkMap().size(), 2001ull);
+
+    // The original routing table must not observe the split and the chunks not affected by it must
+    // be shared between the two versions
+    auto oldIt = rt->getChunkMap().begin();
+    auto newIt = updatedRt->getChunkMap().begin();
+    while (oldIt != rt->getChunkMap().end()) {
+        ASSERT(newIt != updatedRt->getChunkMap().end());
+        if (SimpleBSONObjComparator::kInstance.evaluate(oldIt->second->getMin() ==
+                                                        BSON("a" << 10000))) {
+            ASSERT_BSONOBJ_EQ(oldIt->second->getMax(), BSON("a" << 10010));
+            ASSERT_BSONOBJ_EQ(newIt->second->getMax(), BSON("a" << 10005));
+            ++newIt;
+            ASSERT_BSONOBJ_EQ(newIt->second->getMax(), BSON("a" << 10010));
+        } else {
+            ASSERT_EQ(oldIt->second.get(), newIt->second.get());
+        }
+        ++oldIt;
+        ++newIt;
+    }
+    ASSERT(newIt == updatedRt->getChunkMap().end());
+}
+
+TEST(RoutingTableHistoryShardVersionTest, ShardVersionsAreMaintainedIncrementally) {
+    const OID epoch = OID::gen();
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    const ShardId kOtherShard("otherShard");
+
+    ChunkVersion version{1, 0, epoch};
+    const ChunkVersion firstVersion = version;
+    ChunkType chunk1{kNss, {shardKeyPattern.globalMin(), BSON("a" << 10)}, version, kThisShard};
+    version.incMajor();
+    ChunkType chunk2{kNss, {BSON("a" << 10), BSON("a" << 20)}, version, kOtherShard};
+    version.incMajor();
+    ChunkType chunk3{kNss, {BSON("a" << 20), shardKeyPattern.globalMax()}, version, kThisShard};
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, {chunk1, chunk2, chunk3});
+    ASSERT_EQ(version, rt->getVersion(kThisShard));
+    ASSERT_EQ(chunk2.getVersion(), rt->getVersion(kOtherShard));
+
+    // Moving away the chunk which determined the shard version without bumping the version of any
+    // remaining chunk must fall back to the newest of the remaining chunks
+    version.incMajor();
+    ChunkType movedChunk3{kNss, chunk3.getRange(), version, kOtherShard};
+    auto rtAfterMove = rt->makeUpdated({movedChunk3});
+    ASSERT_EQ(firstVersion, rtAfterMove->getVersion(kThisShard));
+    ASSERT_EQ(version, rtAfterMove->getVersion(kOtherShard));
+
+    // Moving away the last chunk of a shard must remove it from the routing table
+    version.incMajor();
+    ChunkType movedChunk1{kNss, chunk1.getRange(), version, kOtherShard};
+    auto rtAfterSecondMove = rtAfterMove->makeUpdated({movedChunk1});
+    ASSERT_EQ(ChunkVersion(0, 0, epoch), rtAfterSecondMove->getVersion(kThisShard));
+    ASSERT_EQ(version, rtAfterSecondMove->getVersion(kOtherShard));
+
+    std::set<ShardId> shardIds;
+    rtAfterSecondMove->getAllShardIds(&shardIds);
+    ASSERT_EQ(1UL, shardIds.size());
+    ASSERT_EQ(kOtherShard, *shardIds.begin());
+
+    // The previous versions of the routing table must be unaffected
+    ASSERT_EQ(chunk3.getVersion(), rt->getVersion(kThisShard));
+    ASSERT_EQ(firstVersion, rtAfterMove->getVersion(kThisShard));
+}
+
 }  // namespace
 }  // namespace mongo
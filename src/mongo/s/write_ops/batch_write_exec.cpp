@@ -33,6 +33,9 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
@@ -172,34 +175,36 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //
         // Send all child batches
         //
+        // Only one batch is outstanding against a shard at a time. Further batches for a shard
+        // wait in its queue and are sent as soon as its outstanding batch returns, regardless of
+        // the other shards.
+        //
 
-        const size_t numToSend = childBatches.size();
-        size_t numSent = 0;
-
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        std::map<ShardId, std::deque<std::unique_ptr<TargetedWriteBatch>>> queuedBatches;
+        std::map<ShardId, std::unique_ptr<TargetedWriteBatch>> pendingBatches;
 
-            //
-            // Construct the requests.
-            //
+        // Takes ownership of newly targeted batches
+        auto queueBatches = [&](std::map<ShardId, TargetedWriteBatch*>& batches) {
+            for (auto& batch : batches) {
+                queuedBatches[batch.first].emplace_back(batch.second);
+            }
+            batches.clear();
+        };
 
+        // Returns the requests for the next batch of every shard without an outstanding one, and
+        // moves those batches to 'pendingBatches'
+        auto takeSendableRequests = [&] {
             std::vector<AsyncRequestsSender::Request> requests;
 
-            // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
+            for (auto& shardQueue : queuedBatches) {
+                const auto& targetShardId = shardQueue.first;
+                auto& batches = shardQueue.second;
 
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
+                if (batches.empty() || pendingBatches.count(targetShardId))
                     continue;
 
-                // If we already have a batch for this shard, wait until the next time
-                const auto& targetShardId = nextBatch->getEndpoint().shardName;
-
-                if (pendingBatches.count(targetShardId))
-                    continue;
+                auto nextBatch = std::move(batches.front());
+                batches.pop_front();
 
                 stats->noteTargetedShard(targetShardId);
 
@@ -227,164 +232,193 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
                 requests.emplace_back(targetShardId, request);
 
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
-
                 // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
+                pendingBatches.emplace(targetShardId, std::move(nextBatch));
             }
 
-            bool isRetryableWrite = opCtx->getTxnNumber() && !TransactionRouter::get(opCtx);
+            return requests;
+        };
+
+        queueBatches(childBatches);
+
+        bool isRetryableWrite = opCtx->getTxnNumber() && !TransactionRouter::get(opCtx);
 
-            MultiStatementTransactionRequestsSender ars(
-                opCtx,
-                Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                clientRequest.getNS().db().toString(),
-                requests,
-                kPrimaryOnlyReadPreference,
-                isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
+        MultiStatementTransactionRequestsSender ars(
+            opCtx,
+            Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+            clientRequest.getNS().db().toString(),
+            takeSendableRequests(),
+            kPrimaryOnlyReadPreference,
+            isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
+
+        // Unordered writes outside of a transaction are targeted again whenever a shard responds,
+        // so that the writes which did not fit in its batch are sent to it right away rather than
+        // in the next round. This stops as soon as anything suggests that the targeter is stale,
+        // leaving the remaining writes for the next round, after the targeter is refreshed.
+        bool retargetAsShardsRespond = !clientRequest.getWriteCommandBase().getOrdered() &&
+            !TransactionRouter::get(opCtx) && targetStatus.isOK();
+
+        while (true) {
+            for (const auto& request : takeSendableRequests()) {
+                ars.addRequest(request);
+            }
+
+            if (ars.done())
+                break;
 
             //
             // Receive the responses.
             //
 
-            while (!ars.done()) {
-                // Block until a response is available.
-                auto response = ars.next();
+            // Block until a response is available.
+            auto response = ars.next();
 
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
+            // Get the TargetedWriteBatch to find where to put the response
+            auto pendingIt = pendingBatches.find(response.shardId);
+            invariant(pendingIt != pendingBatches.end());
+            const std::unique_ptr<TargetedWriteBatch> batch = std::move(pendingIt->second);
+            pendingBatches.erase(pendingIt);
 
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
+            // First check if we were able to target a shard host.
+            if (!response.shardHostAndPort) {
+                invariant(!response.swResponse.isOK());
 
-                    // Record a resolve failure
-                    batchOp.noteBatchError(*batch,
-                                           errorFromStatus(response.swResponse.getStatus()));
+                // Record a resolve failure
+                batchOp.noteBatchError(*batch, errorFromStatus(response.swResponse.getStatus()));
 
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
-                    // and retarget the batch
-                    LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
+                // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
+                // and retarget the batch
+                LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
+                       << causedBy(response.swResponse.getStatus());
 
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
-                    continue;
-                }
+                retargetAsShardsRespond = false;
+                continue;
+            }
 
-                const auto shardHost(std::move(*response.shardHostAndPort));
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
+            const auto shardHost(std::move(*response.shardHostAndPort));
+
+            // Then check if we successfully got a response.
+            Status responseStatus = response.swResponse.getStatus();
+            BatchedCommandResponse batchedCommandResponse;
+            if (responseStatus.isOK()) {
+                std::string errMsg;
+                if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
+                                                      &errMsg) ||
+                    !batchedCommandResponse.isValid(&errMsg)) {
+                    responseStatus = {ErrorCodes::FailedToParse, errMsg};
                 }
+            }
 
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-                    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
-
-                    LOG(4) << "Write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toStatus());
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
-                        // Note: this returns a bad status if any part of the batch failed.
-                        auto batchStatus = batchedCommandResponse.toStatus();
-                        if (!batchStatus.isOK() &&
-                            batchStatus != ErrorCodes::WouldChangeOwningShard) {
-                            auto newStatus = batchStatus.withContext(
-                                str::stream() << "Encountered error from " << shardHost.toString()
-                                              << " during a transaction");
-
-                            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-
-                            // Throw when there is a transient transaction error since this
-                            // should be a top level error and not just a write error.
-                            if (hasTransientTransactionError(batchedCommandResponse)) {
-                                uassertStatusOK(newStatus);
-                            }
-
-                            abortBatch = true;
-                            break;
-                        }
-                    }
+            if (responseStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+                trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
 
-                    // Note if anything was stale
-                    const auto& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    if (!staleErrors.empty()) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
+                LOG(4) << "Write results received from " << shardHost.toString() << ": "
+                       << redact(batchedCommandResponse.toStatus());
 
-                    const auto& cannotImplicitlyCreateErrors =
-                        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
-                    if (!cannotImplicitlyCreateErrors.empty()) {
-                        // This forces the chunk manager to reload so we can attach the correct
-                        // version on retry and make sure we route to the correct shard.
-                        targeter.noteCouldNotTarget();
-
-                        // It is also possible that information about which shard is the primary
-                        // for this collection collection is stale, so refresh the database as
-                        // well.
-                        Grid::get(opCtx)->catalogCache()->invalidateDatabaseEntry(
-                            targeter.getNS().db());
-                    }
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
+
+                // If we are in a transaction, we must fail the whole batch on any error.
+                if (TransactionRouter::get(opCtx)) {
+                    // Note: this returns a bad status if any part of the batch failed.
+                    auto batchStatus = batchedCommandResponse.toStatus();
+                    if (!batchStatus.isOK() && batchStatus != ErrorCodes::WouldChangeOwningShard) {
+                        auto newStatus = batchStatus.withContext(
+                            str::stream() << "Encountered error from " << shardHost.toString()
+                                          << " during a transaction");
 
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable from " << shardHost);
-
-                    batchOp.noteBatchError(*batch, errorFromStatus(status));
-
-                    LOG(4) << "Unable to receive write results from " << shardHost
-                           << causedBy(redact(status));
-
-                    // If we are in a transaction, we must stop immediately (even for unordered).
-                    if (TransactionRouter::get(opCtx)) {
                         batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                        abortBatch = true;
 
-                        // Throw when there is a transient transaction error since this should be a
-                        // top
-                        // level error and not just a write error.
-                        if (isTransientTransactionError(status.code(), false, false)) {
-                            uassertStatusOK(status);
+                        // Throw when there is a transient transaction error since this
+                        // should be a top level error and not just a write error.
+                        if (hasTransientTransactionError(batchedCommandResponse)) {
+                            uassertStatusOK(newStatus);
                         }
 
+                        abortBatch = true;
                         break;
                     }
                 }
+
+                // Note if anything was stale
+                const auto& staleErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+                if (!staleErrors.empty()) {
+                    noteStaleResponses(staleErrors, &targeter);
+                    ++stats->numStaleBatches;
+                    retargetAsShardsRespond = false;
+                }
+
+                const auto& cannotImplicitlyCreateErrors =
+                    trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
+                if (!cannotImplicitlyCreateErrors.empty()) {
+                    // This forces the chunk manager to reload so we can attach the correct
+                    // version on retry and make sure we route to the correct shard.
+                    targeter.noteCouldNotTarget();
+
+                    // It is also possible that information about which shard is the primary
+                    // for this collection collection is stale, so refresh the database as
+                    // well.
+                    Grid::get(opCtx)->catalogCache()->invalidateDatabaseEntry(
+                        targeter.getNS().db());
+
+                    retargetAsShardsRespond = false;
+                }
+
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   batchedCommandResponse.isLastOpSet()
+                                       ? batchedCommandResponse.getLastOp()
+                                       : repl::OpTime(),
+                                   batchedCommandResponse.isElectionIdSet()
+                                       ? batchedCommandResponse.getElectionId()
+                                       : OID());
+            } else {
+                // Error occurred dispatching, note it
+                const Status status = responseStatus.withContext(
+                    str::stream() << "Write results unavailable from " << shardHost);
+
+                batchOp.noteBatchError(*batch, errorFromStatus(status));
+
+                LOG(4) << "Unable to receive write results from " << shardHost
+                       << causedBy(redact(status));
+
+                // If we are in a transaction, we must stop immediately (even for unordered).
+                if (TransactionRouter::get(opCtx)) {
+                    batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+                    abortBatch = true;
+
+                    // Throw when there is a transient transaction error since this should be a
+                    // top
+                    // level error and not just a write error.
+                    if (isTransientTransactionError(status.code(), false, false)) {
+                        uassertStatusOK(status);
+                    }
+
+                    break;
+                }
+
+                retargetAsShardsRespond = false;
+            }
+
+            if (retargetAsShardsRespond) {
+                OwnedShardBatchMap moreBatchesOwned;
+                std::map<ShardId, TargetedWriteBatch*>& moreBatches = moreBatchesOwned.mutableMap();
+
+                Status retargetStatus =
+                    batchOp.targetBatch(targeter, recordTargetErrors, &moreBatches);
+                if (!retargetStatus.isOK()) {
+                    // Leave the writes which could not be targeted for the next round
+                    targeter.noteCouldNotTarget();
+                    refreshedTargeter = true;
+                    ++stats->numTargetErrors;
+                    retargetAsShardsRespond = false;
+                }
+
+                queueBatches(moreBatches);
             }
         }
 
@@ -34,6 +34,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/logical_session_id.h"
+#include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/session_catalog_router.h"
@@ -53,6 +54,16 @@ const HostAndPort kTestConfigShardHost = HostAndPort("FakeConfigHost", 12345);
 const std::string shardName = "FakeShard";
 const int kMaxRoundsWithoutProgress = 5;
 
+/**
+ * Returns how many inserts of documents the size of 'doc' fit in a single batch sent to a shard.
+ */
+int numInsertsPerBatch(const BSONObj& doc) {
+    const int writeSizeBytes =
+        doc.objsize() + write_ops::kWriteCommandBSONArrayPerElementOverheadBytes;
+    return std::min(static_cast<int>(write_ops::kMaxWriteBatchSize),
+                    BSONObjMaxUserSize / writeSizeBytes);
+}
+
 BSONObj expectInsertsReturnStaleVersionErrorsBase(const NamespaceString& nss,
                                                   const std::vector<BSONObj>& expected,
                                                   const executor::RemoteCommandRequest& request) {
@@ -274,8 +285,53 @@ TEST_F(BatchWriteExecTest, MultiOpLarge) {
         ASSERT_EQUALS(stats.numRounds, 2);
     });
 
-    expectInsertsReturnSuccess(docsToInsert.begin(), docsToInsert.begin() + 66576);
-    expectInsertsReturnSuccess(docsToInsert.begin() + 66576, docsToInsert.end());
+    const int numInsertsInFirstBatch = numInsertsPerBatch(docsToInsert.front());
+    expectInsertsReturnSuccess(docsToInsert.begin(),
+                               docsToInsert.begin() + numInsertsInFirstBatch);
+    expectInsertsReturnSuccess(docsToInsert.begin() + numInsertsInFirstBatch, docsToInsert.end());
+
+    future.default_timed_get();
+}
+
+TEST_F(BatchWriteExecTest, MultiOpLargeUnordered) {
+    const int kNumDocsToInsert = 100'000;
+    const std::string kDocValue(200, 'x');
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(BSON("_id" << i << "someLargeKeyToWasteSpace" << kDocValue));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(operationContext(), nsTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQUALS(response.getN(), kNumDocsToInsert);
+
+        // The documents which did not fit in the first batch are sent as soon as the shard
+        // responds to it, without starting another round
+        ASSERT_EQUALS(stats.numRounds, 1);
+    });
+
+    const int numInsertsInFirstBatch = numInsertsPerBatch(docsToInsert.front());
+    expectInsertsReturnSuccess(docsToInsert.begin(),
+                               docsToInsert.begin() + numInsertsInFirstBatch);
+    expectInsertsReturnSuccess(docsToInsert.begin() + numInsertsInFirstBatch, docsToInsert.end());
 
     future.default_timed_get();
 }
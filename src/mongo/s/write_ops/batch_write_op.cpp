@@ -31,6 +31,7 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 
@@ -64,6 +65,16 @@ struct WriteErrorDetailComp {
 const int kEstUpdateOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 const int kEstDeleteOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 
+// Inserts are targeted a window of ready writes at a time, through NSTargeter::targetInserts(). The
+// window starts small and doubles each time it is used up, up to a limit, so that a call which
+// stops early, as ordered batches often do, wastes little targeting work.
+const size_t kInitialInsertTargetingWindow = 16;
+const size_t kMaxInsertTargetingWindow = 1024;
+
+// How many writes in a row an unordered batch passes over because their shard's batch is full,
+// while looking for writes to other shards, before it leaves the rest for the next round.
+const size_t kMaxUnorderedWritesPassedOver = 128;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -124,11 +135,12 @@ bool isNewBatchRequiredUnordered(const std::vector<TargetedWrite*>& writes,
 }
 
 /**
- * Helper to determine whether a number of targeted writes require a new targeted batch.
+ * Helper to determine whether a number of targeted writes require a new targeted batch. Returns the
+ * batch the writes would make too big, or nullptr if they fit.
  */
-bool wouldMakeBatchesTooBig(const std::vector<TargetedWrite*>& writes,
-                            int writeSizeBytes,
-                            const TargetedBatchMap& batchMap) {
+const TargetedWriteBatch* wouldMakeBatchesTooBig(const std::vector<TargetedWrite*>& writes,
+                                                 int writeSizeBytes,
+                                                 const TargetedBatchMap& batchMap) {
     for (const auto write : writes) {
         TargetedBatchMap::const_iterator it = batchMap.find(&write->endpoint);
         if (it == batchMap.end()) {
@@ -140,16 +152,16 @@ bool wouldMakeBatchesTooBig(const std::vector<TargetedWrite*>& writes,
 
         if (batch->getNumOps() >= write_ops::kMaxWriteBatchSize) {
             // Too many items in batch
-            return true;
+            return batch;
         }
 
         if (batch->getEstimatedSizeBytes() + writeSizeBytes > BSONObjMaxUserSize) {
             // Batch would be too big
-            return true;
+            return batch;
         }
     }
 
-    return false;
+    return nullptr;
 }
 
 /**
@@ -293,6 +305,7 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
     //
 
     const bool ordered = _clientRequest.getWriteCommandBase().getOrdered();
+    const bool isInsert = _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert;
 
     TargetedBatchMap batchMap;
     std::set<ShardId> targetedShards;
@@ -301,6 +314,15 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // The endpoints of the current window of ready inserts, in write op order
+    std::vector<StatusWith<ShardEndpoint>> insertEndpoints;
+    size_t nextInsertEndpoint = 0;
+    size_t insertTargetingWindow = kInitialInsertTargetingWindow;
+
+    // The batches which had to turn a write away, and how many writes in a row were passed over
+    std::set<const TargetedWriteBatch*> fullBatches;
+    size_t numWritesPassedOver = 0;
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -316,7 +338,22 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        if (isInsert && nextInsertEndpoint == insertEndpoints.size()) {
+            std::vector<BSONObj> docs;
+            for (size_t j = i; j < numWriteOps && docs.size() < insertTargetingWindow; ++j) {
+                if (_writeOps[j].getWriteState() == WriteOpState_Ready)
+                    docs.push_back(_writeOps[j].getWriteItem().getDocument());
+            }
+
+            insertEndpoints = targeter.targetInserts(_opCtx, docs);
+            invariant(insertEndpoints.size() == docs.size());
+            nextInsertEndpoint = 0;
+            insertTargetingWindow = std::min(insertTargetingWindow * 2, kMaxInsertTargetingWindow);
+        }
+
+        Status targetStatus = isInsert
+            ? writeOp.targetInsertWrite(std::move(insertEndpoints[nextInsertEndpoint++]), &writes)
+            : writeOp.targetWrites(_opCtx, targeter, &writes);
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -374,12 +411,23 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             write_ops::kWriteCommandBSONArrayPerElementOverheadBytes +
             (_batchTxnNum ? write_ops::kWriteCommandBSONArrayPerElementOverheadBytes + 4 : 0);
 
-        if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
+        if (auto fullBatch = wouldMakeBatchesTooBig(writes, writeSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
             writeOp.cancelWrites(nullptr);
-            break;
+
+            // Unordered writes going to other shards don't have to wait for the next round just
+            // because this shard's batch is full, but there is nothing left to look for once every
+            // batch is full, and little to find after passing over many writes in a row
+            fullBatches.insert(fullBatch);
+            if (ordered || fullBatches.size() == batchMap.size() ||
+                ++numWritesPassedOver >= kMaxUnorderedWritesPassedOver)
+                break;
+
+            continue;
         }
 
+        numWritesPassedOver = 0;
+
         if (!ordered && !batchMap.empty() &&
             isNewBatchRequiredUnordered(writes, batchMap, targetedShards)) {
             writeOp.cancelWrites(nullptr);
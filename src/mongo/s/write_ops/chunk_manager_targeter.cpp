@@ -377,8 +377,6 @@ const NamespaceString& ChunkManagerTargeter::getNS() const {
 
 StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
                                                              const BSONObj& doc) const {
-    BSONObj shardKey;
-
     if (_routingInfo->cm()) {
         //
         // Sharded collections have the following requirements for targeting:
@@ -386,36 +384,89 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
         // Inserts must contain the exact shard key.
         //
 
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+        auto swShardKey = _extractShardKeyForInsert(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
-        }
+        return _targetShardKey(swShardKey.getValue(), CollationSpec::kSimpleSpec, doc.objsize());
+    }
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+    // Target the database primary
+    if (!_routingInfo->db().primary()) {
+        return Status(ErrorCodes::NamespaceNotFound,
+                      str::stream() << "could not target insert in collection " << getNS().ns()
+                                    << "; no metadata found");
     }
 
-    // Target the shard key or database primary
-    if (!shardKey.isEmpty()) {
-        return _targetShardKey(shardKey, CollationSpec::kSimpleSpec, doc.objsize());
-    } else {
-        if (!_routingInfo->db().primary()) {
-            return Status(ErrorCodes::NamespaceNotFound,
-                          str::stream() << "could not target insert in collection " << getNS().ns()
-                                        << "; no metadata found");
+    return ShardEndpoint(_routingInfo->db().primary()->getId(), ChunkVersion::UNSHARDED());
+}
+
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    const auto& cm = _routingInfo->cm();
+    if (!cm) {
+        // Every document goes to the database primary, there is nothing to batch
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    // Extract the shard keys first, remembering which documents don't have a valid one, so that
+    // the chunks for all of the valid keys can be found in one call
+    std::vector<Status> shardKeyStatuses;
+    shardKeyStatuses.reserve(docs.size());
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+
+    for (const auto& doc : docs) {
+        auto swShardKey = _extractShardKeyForInsert(doc);
+        shardKeyStatuses.push_back(swShardKey.getStatus());
+        if (swShardKey.isOK()) {
+            shardKeys.push_back(std::move(swShardKey.getValue()));
         }
+    }
 
-        return ShardEndpoint(_routingInfo->db().primary()->getId(), ChunkVersion::UNSHARDED());
+    auto swChunks = cm->findIntersectingChunks(shardKeys, CollationSpec::kSimpleSpec);
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+
+    auto swChunkIt = swChunks.begin();
+    for (const auto& shardKeyStatus : shardKeyStatuses) {
+        if (!shardKeyStatus.isOK()) {
+            endpoints.push_back(shardKeyStatus);
+            continue;
+        }
+
+        const auto& swChunk = *swChunkIt++;
+        if (!swChunk.isOK()) {
+            endpoints.push_back(swChunk.getStatus());
+            continue;
+        }
+
+        const auto& shardId = swChunk.getValue().getShardId();
+        endpoints.push_back(ShardEndpoint(shardId, cm->getVersion(shardId)));
     }
+    invariant(swChunkIt == swChunks.end());
 
-    return Status::OK();
+    return endpoints;
+}
+
+StatusWith<BSONObj> ChunkManagerTargeter::_extractShardKeyForInsert(const BSONObj& doc) const {
+    const auto& shardKeyPattern = _routingInfo->cm()->getShardKeyPattern();
+    BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << shardKeyPattern.toString()};
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
 }
 
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
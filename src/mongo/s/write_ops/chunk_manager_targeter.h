@@ -80,6 +80,11 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Looks up the chunks for all of the documents' shard keys in a single ordered pass over the
+    // routing table. Each document fails as it would with targetInsert().
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -138,6 +143,12 @@ private:
                                                         const BSONObj& query,
                                                         const BSONObj& collation) const;
 
+    /**
+     * Returns the shard key of a document to be inserted into a sharded collection, or
+     * ShardKeyNotFound if the document does not contain the full shard key.
+     */
+    StatusWith<BSONObj> _extractShardKeyForInsert(const BSONObj& doc) const;
+
     /**
      * Returns a ShardEndpoint for an exact shard key query.
      *
@@ -85,8 +85,24 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     if (!swEndpoints.isOK())
         return swEndpoints.getStatus();
 
-    auto& endpoints = swEndpoints.getValue();
+    _addTargetedWrites(std::move(swEndpoints.getValue()), inTransaction, targetedWrites);
+    return Status::OK();
+}
+
+Status WriteOp::targetInsertWrite(StatusWith<ShardEndpoint> swEndpoint,
+                                  std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+
+    if (!swEndpoint.isOK())
+        return swEndpoint.getStatus();
 
+    _addTargetedWrites({std::move(swEndpoint.getValue())}, _inTxn, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::_addTargetedWrites(std::vector<ShardEndpoint> endpoints,
+                                 bool inTransaction,
+                                 std::vector<TargetedWrite*>* targetedWrites) {
     for (auto&& endpoint : endpoints) {
         _childOps.emplace_back(this);
 
@@ -105,7 +121,6 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     }
 
     _state = WriteOpState_Pending;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
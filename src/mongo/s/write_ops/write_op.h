@@ -122,6 +122,13 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites(), but for an insert whose endpoint has already been determined, for
+     * example by NSTargeter::targetInserts() along with the rest of its batch.
+     */
+    Status targetInsertWrite(StatusWith<ShardEndpoint> swEndpoint,
+                             std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -160,6 +167,13 @@ public:
     void setOpError(const WriteErrorDetail& error);
 
 private:
+    /**
+     * Creates a pending child write and a TargetedWrite for each of 'endpoints'.
+     */
+    void _addTargetedWrites(std::vector<ShardEndpoint> endpoints,
+                            bool inTransaction,
+                            std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Updates the op state after new information is received.
      */
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+struct BufferArena::Chunk {
+    Chunk* previous;
+    size_t size;
+
+    char* data() {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+BufferArena::BufferArena(size_t firstChunkSize) : _nextChunkSize(firstChunkSize) {}
+
+BufferArena::~BufferArena() {
+    while (_chunk) {
+        Chunk* previous = _chunk->previous;
+        std::free(_chunk);
+        _chunk = previous;
+    }
+}
+
+void* BufferArena::allocate(size_t bytes, size_t alignment) {
+    dassert(alignment && !(alignment & (alignment - 1)));
+
+    auto aligned = [&] {
+        const auto address = reinterpret_cast<uintptr_t>(_cursor);
+        return reinterpret_cast<char*>((address + alignment - 1) & ~(alignment - 1));
+    };
+
+    char* start = aligned();
+    if (!_chunk || start > _end || bytes > size_t(_end - start)) {
+        _addChunk(bytes + alignment);
+        start = aligned();
+    }
+    _cursor = start + bytes;
+    return start;
+}
+
+bool BufferArena::tryResize(void* ptr, size_t oldBytes, size_t newBytes) {
+    char* const start = static_cast<char*>(ptr);
+    if (start + oldBytes != _cursor || newBytes > size_t(_end - start))
+        return false;
+
+    _cursor = start + newBytes;
+    return true;
+}
+
+void BufferArena::deallocate(void* ptr, size_t bytes) {
+    char* const start = static_cast<char*>(ptr);
+    if (start + bytes == _cursor)
+        _cursor = start;
+}
+
+void BufferArena::clear() {
+    if (!_chunk)
+        return;
+
+    while (Chunk* previous = _chunk->previous) {
+        _bytesReserved -= previous->size;
+        _chunk->previous = previous->previous;
+        std::free(previous);
+    }
+    _cursor = _chunk->data();
+}
+
+void BufferArena::_addChunk(size_t minBytes) {
+    // Chunks double in size up to a limit, so that a long-lived arena settles into few chunks while
+    // a short-lived one does not hold much memory. Larger requests get a chunk of their own.
+    const size_t size = std::max(minBytes, _nextChunkSize);
+    _nextChunkSize = std::min(_nextChunkSize * 2, kMaxChunkSize);
+
+    auto chunk = static_cast<Chunk*>(mongoMalloc(sizeof(Chunk) + size));
+    chunk->previous = _chunk;
+    chunk->size = size;
+    _chunk = chunk;
+    _cursor = chunk->data();
+    _end = _cursor + size;
+    _bytesReserved += size;
+}
+
+}  // namespace mongo
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+/**
+ * A region allocator for short-lived buffers, such as the ones a BufBuilder grows while a document
+ * is built. Memory is carved out of large chunks by bumping a pointer and is only returned to the
+ * system when the arena is cleared or destroyed, so allocations cost a few instructions and never
+ * take a lock.
+ *
+ * The most recent allocation is special: it can be resized or released in place. A single buffer
+ * growing at the end of the arena therefore does not have to be copied, as long as the current
+ * chunk has room for it.
+ *
+ * Not thread safe.
+ */
+class BufferArena {
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+public:
+    static constexpr size_t kDefaultChunkSize = 16 * 1024;
+    static constexpr size_t kMaxChunkSize = 1024 * 1024;
+
+    explicit BufferArena(size_t firstChunkSize = kDefaultChunkSize);
+    ~BufferArena();
+
+    /**
+     * Returns 'bytes' bytes of memory aligned to 'alignment', which must be a power of two. The
+     * memory stays valid until the arena is cleared or destroyed.
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Resizes the allocation of 'oldBytes' bytes at 'ptr' to 'newBytes' bytes without moving it.
+     * Returns false, leaving the allocation untouched, if 'ptr' is not the most recent allocation
+     * or the current chunk does not have room for the new size.
+     */
+    bool tryResize(void* ptr, size_t oldBytes, size_t newBytes);
+
+    /**
+     * Gives back the allocation of 'bytes' bytes at 'ptr'. Only the most recent allocation is
+     * reused right away; the memory of any other allocation is reclaimed by clear().
+     */
+    void deallocate(void* ptr, size_t bytes);
+
+    /**
+     * Invalidates every allocation. The most recent chunk is kept so that the arena can be reused
+     * without going back to the system, and the others are freed.
+     */
+    void clear();
+
+    /**
+     * Returns the number of bytes of memory held in chunks, whether or not they are in use.
+     */
+    size_t bytesReserved() const {
+        return _bytesReserved;
+    }
+
+private:
+    struct Chunk;
+
+    void _addChunk(size_t minBytes);
+
+    Chunk* _chunk = nullptr;
+    char* _cursor = nullptr;
+    char* _end = nullptr;
+    size_t _nextChunkSize;
+    size_t _bytesReserved = 0;
+};
+
+}  // namespace mongo
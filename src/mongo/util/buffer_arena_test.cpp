@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(void* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(BufferArena, AllocationsAreDistinctAndAligned) {
+    BufferArena arena(256);
+    auto a = static_cast<char*>(arena.allocate(3, 1));
+    auto b = static_cast<char*>(arena.allocate(8, 8));
+    auto c = static_cast<char*>(arena.allocate(16, 16));
+    ASSERT(isAligned(b, 8));
+    ASSERT(isAligned(c, 16));
+    ASSERT_GTE(b, a + 3);
+    ASSERT_GTE(c, b + 8);
+
+    memset(a, 'a', 3);
+    memset(b, 'b', 8);
+    memset(c, 'c', 16);
+    ASSERT_EQ(a[2], 'a');
+    ASSERT_EQ(b[7], 'b');
+    ASSERT_EQ(c[15], 'c');
+    ASSERT_EQ(arena.bytesReserved(), 256U);
+}
+
+TEST(BufferArena, MostRecentAllocationResizesInPlace) {
+    BufferArena arena(256);
+    auto first = arena.allocate(16);
+    auto last = arena.allocate(16);
+
+    ASSERT_FALSE(arena.tryResize(first, 16, 32));
+    ASSERT(arena.tryResize(last, 16, 64));
+    ASSERT(arena.tryResize(last, 64, 8));
+    ASSERT_FALSE(arena.tryResize(last, 8, 1024));
+
+    // The shrunk allocation ends where the next one may start.
+    auto next = static_cast<char*>(arena.allocate(1, 1));
+    ASSERT_EQ(next, static_cast<char*>(last) + 8);
+}
+
+TEST(BufferArena, DeallocatingTheMostRecentAllocationReusesIt) {
+    BufferArena arena(256);
+    auto first = arena.allocate(16);
+    auto second = arena.allocate(16);
+
+    // Only the most recent allocation is given back right away.
+    arena.deallocate(first, 16);
+    arena.deallocate(second, 16);
+    ASSERT_EQ(arena.allocate(16), second);
+}
+
+TEST(BufferArena, LargeAllocationsGetTheirOwnChunk) {
+    BufferArena arena(256);
+    arena.allocate(200);
+    auto large = static_cast<char*>(arena.allocate(10 * 1024));
+    memset(large, 0, 10 * 1024);
+    ASSERT_GTE(arena.bytesReserved(), 256U + 10 * 1024);
+
+    // Small allocations which do not fit after it start another chunk, twice the size of the first.
+    arena.allocate(100);
+    ASSERT_GTE(arena.bytesReserved(), 256U + 10 * 1024 + 512);
+}
+
+TEST(BufferArena, ClearKeepsTheMostRecentChunk) {
+    BufferArena arena(256);
+    arena.allocate(200);
+    arena.allocate(400);
+    const auto reserved = arena.bytesReserved();
+    ASSERT_GT(reserved, 512U);
+
+    arena.clear();
+    ASSERT_LT(arena.bytesReserved(), reserved);
+    const auto kept = arena.bytesReserved();
+
+    // Allocations that fit in the kept chunk do not reserve more memory.
+    arena.allocate(100);
+    arena.allocate(100);
+    ASSERT_EQ(arena.bytesReserved(), kept);
+}
+
+}  // namespace
+}  // namespace mongo
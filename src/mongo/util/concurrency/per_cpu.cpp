@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/per_cpu.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace {
+
+size_t computeSlotCount() {
+    const size_t numCpus = std::max(stdx::thread::hardware_concurrency(), 1u);
+    size_t slots = 1;
+    while (slots < numCpus && slots < PerCpuSlots::kMaxSlots) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+}  // namespace
+
+size_t PerCpuSlots::count() {
+    static const size_t slots = computeSlotCount();
+    return slots;
+}
+
+size_t PerCpuSlots::current() {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        // CPU numbers are not necessarily dense, so they are folded onto the slots.
+        return static_cast<size_t>(cpu) & (count() - 1);
+    }
+#endif
+    // Without a way to ask which CPU we are running on, spread the threads over the slots.
+    static AtomicWord<unsigned> nextSlot;
+    thread_local const size_t slot = nextSlot.fetchAndAdd(1) & (count() - 1);
+    return slot;
+}
+
+}  // namespace mongo
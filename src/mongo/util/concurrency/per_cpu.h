@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+/**
+ * The slots of every PerCpu in the process: one per CPU, rounded up to a power of two and bounded
+ * by kMaxSlots.
+ */
+class PerCpuSlots {
+public:
+    static constexpr size_t kMaxSlots = 64;
+
+    static size_t count();
+
+    /**
+     * The slot of the CPU the calling thread is running on.
+     */
+    static size_t current();
+};
+
+/**
+ * Holds one instance of T per CPU, each on its own cache lines, so that threads running on
+ * different CPUs update different memory instead of bouncing a shared cache line between cores.
+ * Writers update the instance of the CPU they are running on, through local(). Readers aggregate
+ * every instance, through forEach().
+ *
+ * A thread may be moved to another CPU at any time, including between calling local() and
+ * updating the instance it returned, so T must still be safe to update concurrently, for example
+ * by holding atomics or its own lock. Those are then almost never contended.
+ */
+template <typename T>
+class PerCpu {
+public:
+    PerCpu() : _instances(new CacheAligned<T>[PerCpuSlots::count()]) {}
+
+    PerCpu(const PerCpu&) = delete;
+    PerCpu& operator=(const PerCpu&) = delete;
+
+    T& local() {
+        return _instances[PerCpuSlots::current()];
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) {
+        for (size_t i = 0; i < PerCpuSlots::count(); i++) {
+            func(static_cast<T&>(_instances[i]));
+        }
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) const {
+        for (size_t i = 0; i < PerCpuSlots::count(); i++) {
+            func(static_cast<const T&>(_instances[i]));
+        }
+    }
+
+private:
+    std::unique_ptr<CacheAligned<T>[]> _instances;
+};
+
+}  // namespace mongo
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/per_cpu.h"
+
+namespace mongo {
+namespace {
+
+TEST(PerCpuTest, SlotCountIsABoundedPowerOfTwo) {
+    const size_t slots = PerCpuSlots::count();
+    ASSERT_GTE(slots, 1U);
+    ASSERT_LTE(slots, PerCpuSlots::kMaxSlots);
+    ASSERT_EQ(0U, slots & (slots - 1));
+    ASSERT_LT(PerCpuSlots::current(), slots);
+}
+
+TEST(PerCpuTest, InstancesAreOnSeparateCacheLines) {
+    PerCpu<AtomicWord<long long>> counter;
+    std::vector<const void*> addresses;
+    counter.forEach([&](const AtomicWord<long long>& word) { addresses.push_back(&word); });
+    ASSERT_EQ(PerCpuSlots::count(), addresses.size());
+    for (size_t i = 1; i < addresses.size(); i++) {
+        const auto distance = static_cast<const char*>(addresses[i]) -
+            static_cast<const char*>(addresses[i - 1]);
+        ASSERT_GTE(static_cast<size_t>(distance), stdx::hardware_destructive_interference_size);
+    }
+}
+
+TEST(PerCpuTest, ConcurrentIncrementsAreAllCounted) {
+    const int kThreads = 8;
+    const int kIncrements = 100 * 1000;
+
+    PerCpu<AtomicWord<long long>> counter;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kIncrements; j++) {
+                counter.local().fetchAndAddRelaxed(1);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    long long total = 0;
+    counter.forEach([&](const AtomicWord<long long>& word) { total += word.loadRelaxed(); });
+    ASSERT_EQ(static_cast<long long>(kThreads) * kIncrements, total);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/util/log.h"
 
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event_utf8_encoder.h"
 #include "mongo/logger/ramlog.h"
@@ -65,6 +66,8 @@ bool rotateLogs(bool renameFiles) {
     using logger::RotatableFileManager;
     RotatableFileManager* manager = logger::globalRotatableFileManager();
     log() << "Log rotation initiated";
+    // Messages queued before the rotation belong in the file being rotated out.
+    logger::AsyncAppender::flushAll();
     RotatableFileManager::FileNameStatusPairVector result(
         manager->rotateAll(renameFiles, "." + terseCurrentTime(false)));
     for (RotatableFileManager::FileNameStatusPairVector::iterator it = result.begin();
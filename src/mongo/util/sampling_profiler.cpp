@@ -0,0 +1,338 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <ucontext.h>
+#endif
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define MONGO_SAMPLING_PROFILER_SUPPORTED
+#endif
+
+enum SlotState : unsigned { kEmpty, kWriting, kFull };
+
+struct Slot {
+    AtomicWord<unsigned> state{kEmpty};
+    SamplingProfiler::Sample sample;
+};
+
+// Allocated by the first start() and never freed, since a signal may still arrive after stop().
+Slot* buffer = nullptr;
+
+AtomicWord<unsigned long long> nextSlot{0};
+AtomicWord<unsigned long long> dropped{0};
+AtomicWord<bool> running{false};
+
+// Serializes start(), stop() and drain().
+stdx::mutex mutex;
+
+struct ThreadTag {
+    // Set while the tag is rewritten, so that the signal handler does not copy half of it.
+    volatile sig_atomic_t writing;
+    char tag[SamplingProfiler::kMaxTagLength];
+
+    // The bounds of the stack of the thread, recorded by registerThread(). The upper bound is zero
+    // until then.
+    uintptr_t stackLow;
+    volatile uintptr_t stackHigh;
+};
+
+// Trivially constructible, so that the signal handler reads it without running an initializer.
+// The initial-exec model places it in the static TLS block allocated with the thread, so reading
+// it never goes through __tls_get_addr, which may allocate and is not async-signal-safe.
+#ifdef MONGO_SAMPLING_PROFILER_SUPPORTED
+__attribute__((tls_model("initial-exec")))
+#endif
+thread_local ThreadTag threadTag;
+
+#ifdef MONGO_SAMPLING_PROFILER_SUPPORTED
+// The largest frame the unwinder steps over. A bigger step means the frame pointer register held
+// something else, and the rest of the chain cannot be trusted.
+constexpr uintptr_t kMaxFrameBytes = 100 * 1024;
+
+/**
+ * Stores the interrupted program counter, then the return addresses found by following the chain
+ * of frame pointers saved in the interrupted stack, into 'frames'. Returns how many were stored.
+ *
+ * The server is built with frame pointers, but libraries such as libc may use the frame pointer
+ * register for other purposes. Every frame pointer is therefore checked to point above the
+ * previous one and below 'stackHigh', the end of the stack of the thread, before it is read, and
+ * the walk stops at the first which does not. Since the stack is mapped from the interrupted stack
+ * pointer up to its end, no read can fault. Unlike backtrace(), this does not load a library,
+ * allocate or take a lock, so it is async-signal-safe.
+ *
+ * Only the program counter is stored if the stack bounds are unknown, or if the interrupted code
+ * was not running on the stack of its thread.
+ *
+ * A function interrupted before it has set up its frame, or a leaf function which never does,
+ * drops its caller from the stack.
+ */
+int walkFramePointers(const ucontext_t* context,
+                      uintptr_t stackLow,
+                      uintptr_t stackHigh,
+                      void** frames,
+                      int maxFrames) {
+#if defined(__x86_64__)
+    const uintptr_t pc = context->uc_mcontext.gregs[REG_RIP];
+    const uintptr_t sp = context->uc_mcontext.gregs[REG_RSP];
+    uintptr_t fp = context->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+    const uintptr_t pc = context->uc_mcontext.pc;
+    const uintptr_t sp = context->uc_mcontext.sp;
+    uintptr_t fp = context->uc_mcontext.regs[29];
+#endif
+
+    int numFrames = 0;
+    frames[numFrames++] = reinterpret_cast<void*>(pc);
+    if (sp < stackLow || sp >= stackHigh) {
+        return numFrames;
+    }
+
+    // Both ABIs save the caller's frame pointer at the frame pointer, followed by the return
+    // address.
+    uintptr_t lowerBound = sp;
+    while (numFrames < maxFrames) {
+        if (fp < lowerBound || fp - lowerBound > kMaxFrameBytes || fp % sizeof(void*) != 0 ||
+            fp > stackHigh - 2 * sizeof(void*)) {
+            break;
+        }
+
+        const auto record = reinterpret_cast<void* const*>(fp);
+        void* const returnAddress = record[1];
+        if (!returnAddress) {
+            break;
+        }
+        frames[numFrames++] = returnAddress;
+
+        // The caller's frame is above this one, so the next check also rejects loops.
+        lowerBound = fp + 2 * sizeof(void*);
+        fp = reinterpret_cast<uintptr_t>(record[0]);
+    }
+    return numFrames;
+}
+
+void handleSigprof(int, siginfo_t*, void* context) {
+    const int savedErrno = errno;
+
+    Slot& slot = buffer[nextSlot.fetchAndAdd(1) % SamplingProfiler::kBufferCapacity];
+    unsigned expected = kEmpty;
+    if (!slot.state.compareAndSwap(&expected, kWriting)) {
+        // The consumer has not drained this slot yet.
+        dropped.fetchAndAdd(1);
+        errno = savedErrno;
+        return;
+    }
+
+    // Unwinding starts from the registers of the interrupted code, so neither this handler nor the
+    // signal trampoline appear in the sample.
+    slot.sample.numFrames = walkFramePointers(static_cast<const ucontext_t*>(context),
+                                              threadTag.stackLow,
+                                              threadTag.stackHigh,
+                                              slot.sample.frames,
+                                              SamplingProfiler::kMaxFrames);
+
+    if (threadTag.writing) {
+        slot.sample.tag[0] = '\0';
+    } else {
+        std::memcpy(slot.sample.tag, threadTag.tag, sizeof(slot.sample.tag));
+    }
+
+    slot.state.store(kFull);
+    errno = savedErrno;
+}
+#endif
+
+}  // namespace
+
+bool SamplingProfiler::isSupported() {
+#ifdef MONGO_SAMPLING_PROFILER_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+}
+
+Status SamplingProfiler::start(int samplesPerSecond) {
+#ifndef MONGO_SAMPLING_PROFILER_SUPPORTED
+    return {ErrorCodes::IllegalOperation,
+            "The sampling profiler is only supported on Linux on x86-64 and ARM64"};
+#else
+    if (samplesPerSecond <= 0 || samplesPerSecond > 10000) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "The sampling rate must be between 1 and 10000 samples per "
+                                 "second, not "
+                              << samplesPerSecond};
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (!buffer) {
+        buffer = new Slot[kBufferCapacity];
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        sigemptyset(&action.sa_mask);
+        action.sa_sigaction = handleSigprof;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            const int savedErrno = errno;
+            return {ErrorCodes::InternalError,
+                    str::stream() << "Failed to install the SIGPROF handler: "
+                                  << errnoWithDescription(savedErrno)};
+        }
+    }
+
+    running.store(true);
+
+    const long intervalMicros = std::max(1000000L / samplesPerSecond, 1L);
+    struct itimerval timer;
+    timer.it_interval.tv_sec = intervalMicros / 1000000;
+    timer.it_interval.tv_usec = intervalMicros % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int savedErrno = errno;
+        running.store(false);
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to start the profiling timer: "
+                              << errnoWithDescription(savedErrno)};
+    }
+
+    return Status::OK();
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef MONGO_SAMPLING_PROFILER_SUPPORTED
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (!running.load()) {
+        return;
+    }
+
+    struct itimerval timer;
+    std::memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running.store(false);
+#endif
+}
+
+bool SamplingProfiler::isRunning() {
+    return running.load();
+}
+
+void SamplingProfiler::registerThread() {
+#ifdef MONGO_SAMPLING_PROFILER_SUPPORTED
+    if (threadTag.stackHigh) {
+        return;
+    }
+
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+        return;
+    }
+
+    void* stackAddr;
+    size_t stackSize;
+    if (pthread_attr_getstack(&attr, &stackAddr, &stackSize) == 0) {
+        // The signal handler only walks the stack once the upper bound is set.
+        threadTag.stackLow = reinterpret_cast<uintptr_t>(stackAddr);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        threadTag.stackHigh = threadTag.stackLow + stackSize;
+    }
+    pthread_attr_destroy(&attr);
+#endif
+}
+
+void SamplingProfiler::setThreadTag(StringData command, StringData ns) {
+    if (!running.loadRelaxed()) {
+        return;
+    }
+
+    registerThread();
+
+    threadTag.writing = 1;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    size_t length = std::min(command.size(), kMaxTagLength - 1);
+    std::memcpy(threadTag.tag, command.rawData(), length);
+    if (!ns.empty() && length < kMaxTagLength - 1) {
+        threadTag.tag[length++] = ' ';
+        const size_t nsLength = std::min(ns.size(), kMaxTagLength - 1 - length);
+        std::memcpy(threadTag.tag + length, ns.rawData(), nsLength);
+        length += nsLength;
+    }
+    threadTag.tag[length] = '\0';
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    threadTag.writing = 0;
+}
+
+void SamplingProfiler::clearThreadTag() {
+    threadTag.tag[0] = '\0';
+}
+
+size_t SamplingProfiler::drain(const std::function<void(const Sample&)>& consumer) {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (buffer) {
+        for (size_t i = 0; i < kBufferCapacity; i++) {
+            Slot& slot = buffer[i];
+            if (slot.state.load() != kFull) {
+                continue;
+            }
+
+            consumer(slot.sample);
+            slot.state.store(kEmpty);
+        }
+    }
+
+    return dropped.swap(0);
+}
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A process-wide statistical CPU profiler. While it runs, a timer counting the CPU time of the
+ * process raises SIGPROF in whichever thread is running when it fires. The signal handler records
+ * the stack of that thread, and the tag the thread last set, into a fixed-size buffer without
+ * allocating or locking. A single consumer, such as the FTDC collector, drains the buffer.
+ *
+ * The handler only follows the stack of a thread which has registered, so that it knows the range
+ * of addresses it may read. Samples of other threads only hold the interrupted function.
+ *
+ * Threads tag themselves with the operation they are running, so that samples can be attributed to
+ * a command and namespace.
+ *
+ * The timer is process-wide, so while the profiler runs every thread may be interrupted by SIGPROF.
+ * The handler is installed with SA_RESTART, but system calls which the kernel never restarts after
+ * a signal handler, such as poll(), epoll_wait(), select(), nanosleep() and calls on sockets with
+ * a timeout, fail with EINTR. Code which makes such calls must retry them.
+ *
+ * Stacks are unwound by following frame pointers, which is async-signal-safe but relies on the
+ * server being built with them. Only available on Linux on x86-64 and ARM64; start() fails
+ * elsewhere.
+ */
+class SamplingProfiler {
+public:
+    static constexpr int kMaxFrames = 32;
+    static constexpr size_t kMaxTagLength = 96;
+    static constexpr size_t kBufferCapacity = 4096;
+
+    struct Sample {
+        // The tag of the sampled thread when the signal arrived, null terminated.
+        char tag[kMaxTagLength];
+
+        // The return addresses of the sampled stack, innermost first.
+        void* frames[kMaxFrames];
+        int numFrames;
+    };
+
+    /**
+     * Returns whether start() can succeed on this platform.
+     */
+    static bool isSupported();
+
+    /**
+     * Starts sampling at about 'samplesPerSecond' samples for each second of CPU time the process
+     * uses, or changes the rate if already running.
+     */
+    static Status start(int samplesPerSecond);
+
+    /**
+     * Stops sampling. Samples still in the buffer may still be drained.
+     */
+    static void stop();
+
+    static bool isRunning();
+
+    /**
+     * Records the bounds of the stack of the calling thread, so that its samples include the
+     * callers of the interrupted function. Called by setThreadTag().
+     */
+    static void registerThread();
+
+    /**
+     * Tags the samples of the calling thread with "<command> <ns>", truncated to fit. Does nothing
+     * unless the profiler is running, so that operations pay nothing for it otherwise.
+     */
+    static void setThreadTag(StringData command, StringData ns);
+
+    static void clearThreadTag();
+
+    /**
+     * Passes each sample recorded since the last call to 'consumer', and frees its place in the
+     * buffer. Returns the number of samples dropped since the last call because the buffer was
+     * full. Only one thread may drain at a time.
+     */
+    static size_t drain(const std::function<void(const Sample&)>& consumer);
+};
+
+}  // namespace mongo
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+bool contains(const std::vector<std::string>& tags, const std::string& tag) {
+    return std::find(tags.begin(), tags.end(), tag) != tags.end();
+}
+
+/**
+ * Discards the samples taken so far, then uses CPU until the profiler has taken a sample tagged
+ * with 'expectedTag'. Returns the tags of the samples taken meanwhile, and adds the most frames
+ * any of them had to 'maxFrames' if given.
+ */
+std::vector<std::string> burnUntilSampled(const std::string& expectedTag,
+                                          int* maxFrames = nullptr) {
+    SamplingProfiler::drain([](const SamplingProfiler::Sample&) {});
+
+    std::vector<std::string> tags;
+    const auto deadline = Date_t::now() + Seconds(30);
+    volatile unsigned long long sink = 0;
+    while (!contains(tags, expectedTag) && Date_t::now() < deadline) {
+        for (int i = 0; i < 1000 * 1000; i++) {
+            sink = sink + i;
+        }
+
+        SamplingProfiler::drain([&](const SamplingProfiler::Sample& sample) {
+            ASSERT_GT(sample.numFrames, 0);
+            ASSERT_LTE(sample.numFrames, SamplingProfiler::kMaxFrames);
+            tags.emplace_back(sample.tag);
+            if (maxFrames) {
+                *maxFrames = std::max(*maxFrames, sample.numFrames);
+            }
+        });
+    }
+    return tags;
+}
+
+TEST(SamplingProfilerTest, RejectsInvalidRates) {
+    if (!SamplingProfiler::isSupported()) {
+        ASSERT_EQ(ErrorCodes::IllegalOperation, SamplingProfiler::start(1000));
+        return;
+    }
+
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(0));
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(-1));
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::start(1000 * 1000));
+    ASSERT_FALSE(SamplingProfiler::isRunning());
+}
+
+TEST(SamplingProfilerTest, SamplesAreTaggedWithTheOperationOfTheirThread) {
+    if (!SamplingProfiler::isSupported()) {
+        return;
+    }
+
+    ASSERT_OK(SamplingProfiler::start(1000));
+    ON_BLOCK_EXIT([] {
+        SamplingProfiler::stop();
+        SamplingProfiler::clearThreadTag();
+    });
+    ASSERT_TRUE(SamplingProfiler::isRunning());
+
+    SamplingProfiler::setThreadTag("find", "test.coll");
+    ASSERT_TRUE(contains(burnUntilSampled("find test.coll"), "find test.coll"));
+
+    SamplingProfiler::clearThreadTag();
+    const auto tags = burnUntilSampled("");
+    ASSERT_TRUE(contains(tags, ""));
+    ASSERT_FALSE(contains(tags, "find test.coll"));
+}
+
+TEST(SamplingProfilerTest, SamplesIncludeTheCallersOfTheInterruptedFunction) {
+    if (!SamplingProfiler::isSupported()) {
+        return;
+    }
+
+    ASSERT_OK(SamplingProfiler::start(1000));
+    ON_BLOCK_EXIT([] {
+        SamplingProfiler::stop();
+        SamplingProfiler::clearThreadTag();
+    });
+
+    // The samples taken in burnUntilSampled() have at least its frame and its caller's.
+    SamplingProfiler::setThreadTag("find", "test.coll");
+    int maxFrames = 0;
+    ASSERT_TRUE(contains(burnUntilSampled("find test.coll", &maxFrames), "find test.coll"));
+    ASSERT_GTE(maxFrames, 2);
+}
+
+TEST(SamplingProfilerTest, SamplesOfUnregisteredThreadsOnlyHoldTheInterruptedFunction) {
+    if (!SamplingProfiler::isSupported()) {
+        return;
+    }
+
+    ASSERT_OK(SamplingProfiler::start(1000));
+    ON_BLOCK_EXIT([] { SamplingProfiler::stop(); });
+
+    // A new thread has neither tagged its samples nor registered the bounds of its stack.
+    int maxFrames = 0;
+    stdx::thread thread([&] { burnUntilSampled("", &maxFrames); });
+    thread.join();
+    ASSERT_EQ(1, maxFrames);
+}
+
+TEST(SamplingProfilerTest, LongTagsAreTruncated) {
+    if (!SamplingProfiler::isSupported()) {
+        return;
+    }
+
+    ASSERT_OK(SamplingProfiler::start(1000));
+    ON_BLOCK_EXIT([] {
+        SamplingProfiler::stop();
+        SamplingProfiler::clearThreadTag();
+    });
+
+    const std::string ns = "test." + std::string(2 * SamplingProfiler::kMaxTagLength, 'x');
+    const std::string expectedTag =
+        ("aggregate " + ns).substr(0, SamplingProfiler::kMaxTagLength - 1);
+    SamplingProfiler::setThreadTag("aggregate", ns);
+    ASSERT_TRUE(contains(burnUntilSampled(expectedTag), expectedTag));
+}
+
+TEST(SamplingProfilerTest, TagsAreNotSetWhileStopped) {
+    if (!SamplingProfiler::isSupported()) {
+        return;
+    }
+
+    SamplingProfiler::setThreadTag("insert", "test.coll");
+
+    ASSERT_OK(SamplingProfiler::start(1000));
+    ON_BLOCK_EXIT([] { SamplingProfiler::stop(); });
+    const auto tags = burnUntilSampled("");
+    ASSERT_TRUE(contains(tags, ""));
+    ASSERT_FALSE(contains(tags, "insert test.coll"));
+}
+
+}  // namespace
+}  // namespace mongo
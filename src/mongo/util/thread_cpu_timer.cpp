@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/thread_cpu_timer.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+namespace mongo {
+
+namespace {
+
+#if defined(__linux__)
+bool readClock(long long clockId, long long* nanos) {
+    struct timespec ts;
+    if (clock_gettime(static_cast<clockid_t>(clockId), &ts) != 0) {
+        return false;
+    }
+    *nanos = static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+    return true;
+}
+#endif
+
+}  // namespace
+
+bool ThreadCPUTimer::isSupported() {
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ThreadCPUTimer::start() {
+#if defined(__linux__)
+    if (_running.load()) {
+        return;
+    }
+
+    // Unlike CLOCK_THREAD_CPUTIME_ID, the clock returned by pthread_getcpuclockid() refers to this
+    // thread even when read from another one.
+    clockid_t clockId;
+    if (pthread_getcpuclockid(pthread_self(), &clockId) != 0) {
+        return;
+    }
+    long long startNanos;
+    if (!readClock(clockId, &startNanos)) {
+        return;
+    }
+
+    // Publish the clock and start time before '_running' so that a reader which observes the
+    // timer running also observes the values it should read.
+    _clockId.store(clockId);
+    _startNanos.store(startNanos);
+    _elapsedNanos.store(0);
+    _started.store(true);
+    _running.store(true);
+#endif
+}
+
+void ThreadCPUTimer::stop() {
+#if defined(__linux__)
+    if (!_running.load()) {
+        return;
+    }
+
+    long long now;
+    if (readClock(_clockId.load(), &now)) {
+        _elapsedNanos.store(now - _startNanos.load());
+    }
+    _running.store(false);
+#endif
+}
+
+boost::optional<Microseconds> ThreadCPUTimer::elapsed() const {
+#if defined(__linux__)
+    if (!_started.load()) {
+        return boost::none;
+    }
+
+    // Read '_running' first: if the measured thread stops the timer concurrently, the frozen
+    // elapsed time has been stored before '_running' is cleared.
+    if (_running.load()) {
+        const long long startNanos = _startNanos.load();
+        long long now;
+        if (!readClock(_clockId.load(), &now)) {
+            return boost::none;
+        }
+        return Microseconds{(now - startNanos) / 1000};
+    }
+    return Microseconds{_elapsedNanos.load() / 1000};
+#else
+    return boost::none;
+#endif
+}
+
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Measures the CPU time consumed by one thread between calls to start() and stop(). Unlike a
+ * wall clock Timer, time the thread spends blocked or descheduled is not counted.
+ *
+ * start() and stop() must be called on the measured thread. elapsed() may be called from any
+ * thread, for instance by $currentOp, for as long as the measured thread is alive, so the state
+ * those calls publish is kept in atomics.
+ *
+ * Only supported on Linux; elsewhere elapsed() always returns boost::none.
+ */
+class ThreadCPUTimer {
+public:
+    /**
+     * Returns whether the CPU time of a thread can be measured on this platform.
+     */
+    static bool isSupported();
+
+    /**
+     * Starts measuring the CPU time of the calling thread. Has no effect if the timer is already
+     * running.
+     */
+    void start();
+
+    /**
+     * Stops measuring, freezing the value returned by elapsed(). Has no effect if the timer is
+     * not running.
+     */
+    void stop();
+
+    bool isRunning() const {
+        return _running.load();
+    }
+
+    /**
+     * Returns the CPU time consumed by the measured thread since start(), up to stop() if the
+     * timer has been stopped, or boost::none if it was never started or cannot be read.
+     */
+    boost::optional<Microseconds> elapsed() const;
+
+private:
+    AtomicWord<bool> _started{false};
+    AtomicWord<bool> _running{false};
+
+    // The CPU clock of the measured thread, stored as an integer so that this header does not
+    // depend on the platform's clockid_t.
+    AtomicWord<long long> _clockId{0};
+    AtomicWord<long long> _startNanos{0};
+    AtomicWord<long long> _elapsedNanos{0};
+};
+
+}  // namespace mongo
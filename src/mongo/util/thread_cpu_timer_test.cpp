@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/thread_cpu_timer.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+void burnCPU(Milliseconds duration) {
+    const auto deadline = Date_t::now() + duration;
+    volatile unsigned long long sink = 0;
+    while (Date_t::now() < deadline) {
+        for (int i = 0; i < 1000; i++) {
+            sink = sink + i;
+        }
+    }
+}
+
+TEST(ThreadCPUTimerTest, NotStartedTimerHasNoElapsedTime) {
+    ThreadCPUTimer timer;
+    ASSERT_FALSE(timer.isRunning());
+    ASSERT_FALSE(timer.elapsed());
+}
+
+TEST(ThreadCPUTimerTest, CountsTimeOnCPU) {
+    if (!ThreadCPUTimer::isSupported()) {
+        return;
+    }
+
+    ThreadCPUTimer timer;
+    timer.start();
+    ASSERT_TRUE(timer.isRunning());
+    burnCPU(Milliseconds(50));
+    auto running = timer.elapsed();
+    ASSERT_TRUE(running);
+    ASSERT_GTE(*running, Milliseconds(10));
+
+    timer.stop();
+    ASSERT_FALSE(timer.isRunning());
+    auto stopped = timer.elapsed();
+    ASSERT_TRUE(stopped);
+    ASSERT_GTE(*stopped, *running);
+
+    // The value is frozen once the timer is stopped.
+    burnCPU(Milliseconds(20));
+    ASSERT_EQ(*stopped, *timer.elapsed());
+}
+
+TEST(ThreadCPUTimerTest, DoesNotCountTimeBlocked) {
+    if (!ThreadCPUTimer::isSupported()) {
+        return;
+    }
+
+    ThreadCPUTimer timer;
+    timer.start();
+    sleepmillis(200);
+    timer.stop();
+    ASSERT_LT(*timer.elapsed(), Milliseconds(100));
+}
+
+TEST(ThreadCPUTimerTest, CanBeReadFromAnotherThread) {
+    if (!ThreadCPUTimer::isSupported()) {
+        return;
+    }
+
+    ThreadCPUTimer timer;
+    timer.start();
+    burnCPU(Milliseconds(50));
+
+    // The other thread reads the CPU time of this one, not its own.
+    boost::optional<Microseconds> elapsed;
+    stdx::thread reader([&] { elapsed = timer.elapsed(); });
+    reader.join();
+    ASSERT_TRUE(elapsed);
+    ASSERT_GTE(*elapsed, Milliseconds(10));
+}
+
+}  // namespace
+}  // namespace mongo